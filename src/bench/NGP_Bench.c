@@ -0,0 +1,140 @@
+#include "NGP_Bench.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define NGP_BENCH_MIN_NS 200000000ULL /* a run has to take at least 0.2s to be reported */
+#define NGP_BENCH_MAX_ITERATIONS 1000000000ULL
+
+static uint64_t Clock(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t NGP_BenchNow(void) { return Clock(CLOCK_MONOTONIC); }
+
+void NGP_BenchCounter(NGP_Bench* b, const char* name, double value) {
+    for (int i = 0; i < b->num_counters; i++) {
+        if (strcmp(b->counter_names[i], name) == 0) {
+            b->counters[i] = value;
+            return;
+        }
+    }
+    if (b->num_counters < NGP_BENCH_MAX_COUNTERS) {
+        b->counter_names[b->num_counters] = name;
+        b->counters[b->num_counters++]    = value;
+    }
+}
+
+void NGP_BenchSetTime(NGP_Bench* b, uint64_t ns) {
+    b->elapsed_ns  = ns;
+    b->manual_time = true;
+}
+
+static void RunCase(const NGP_BenchCase* c, NGP_Bench* b) {
+    for (uint64_t iterations = 1;; iterations *= 10) {
+        memset(b, 0, sizeof(*b));
+        b->name       = c->name;
+        b->iterations = iterations;
+
+        uint64_t cpu   = Clock(CLOCK_PROCESS_CPUTIME_ID);
+        uint64_t start = NGP_BenchNow();
+        c->fn(b);
+        if (!b->manual_time) {
+            b->elapsed_ns = NGP_BenchNow() - start;
+        }
+        b->cpu_ns = Clock(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+        if (b->elapsed_ns >= NGP_BENCH_MIN_NS || iterations >= NGP_BENCH_MAX_ITERATIONS) {
+            return;
+        }
+    }
+}
+
+static void PutString(FILE* out, const char* text) {
+    fputc('"', out);
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fprintf(out, "\\%c", *c);
+        } else if ((unsigned char)*c < 0x20) {
+            fprintf(out, "\\u%04x", (unsigned char)*c);
+        } else {
+            fputc(*c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+static void PutContext(FILE* out) {
+    char      date[64];
+    char      host[256] = "";
+    time_t    now       = time(NULL);
+    struct tm local;
+    localtime_r(&now, &local);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", &local);
+    gethostname(host, sizeof(host) - 1);
+#ifdef NDEBUG
+    const char* build = "release";
+#else
+    const char* build = "debug";
+#endif
+    fprintf(out, "{\n  \"context\": {\n    \"date\": ");
+    PutString(out, date);
+    fprintf(out, ",\n    \"host_name\": ");
+    PutString(out, host);
+    fprintf(out, ",\n    \"num_cpus\": %ld,\n", sysconf(_SC_NPROCESSORS_ONLN));
+    fprintf(out, "    \"library_build_type\": \"%s\"\n  },\n  \"benchmarks\": [", build);
+}
+
+static void PutResult(FILE* out, const NGP_Bench* b, bool first) {
+    double iterations = (double)b->iterations;
+    fprintf(out, "%s\n    {\n      \"name\": ", first ? "" : ",");
+    PutString(out, b->name);
+    fprintf(out, ",\n      \"run_name\": ");
+    PutString(out, b->name);
+    fprintf(out, ",\n      \"run_type\": \"iteration\",\n");
+    fprintf(out, "      \"iterations\": %llu,\n", (unsigned long long)b->iterations);
+    fprintf(out, "      \"real_time\": %.6g,\n", (double)b->elapsed_ns / iterations);
+    fprintf(out, "      \"cpu_time\": %.6g,\n", (double)b->cpu_ns / iterations);
+    fprintf(out, "      \"time_unit\": \"ns\"");
+    for (int c = 0; c < b->num_counters; c++) {
+        fprintf(out, ",\n      ");
+        PutString(out, b->counter_names[c]);
+        fprintf(out, ": %.6g", b->counters[c]);
+    }
+    fprintf(out, "\n    }");
+    fflush(out);
+}
+
+void NGP_BenchRun(const NGP_BenchCase* cases, int count, const char* filter, FILE* json) {
+    FILE* table = json == stdout ? stderr : stdout;
+    if (json) {
+        PutContext(json);
+    }
+    bool first = true;
+    fprintf(table, "%-40s %14s %14s\n", "benchmark", "iterations", "ns/iter");
+    for (int i = 0; i < count; i++) {
+        if (filter && !strstr(cases[i].name, filter)) {
+            continue;
+        }
+        NGP_Bench b;
+        RunCase(&cases[i], &b);
+        fprintf(table, "%-40s %14llu %14.2f", b.name, (unsigned long long)b.iterations,
+                (double)b.elapsed_ns / (double)b.iterations);
+        for (int c = 0; c < b.num_counters; c++) {
+            fprintf(table, "  %s=%.6g", b.counter_names[c], b.counters[c]);
+        }
+        fprintf(table, "\n");
+        fflush(table);
+        if (json) {
+            PutResult(json, &b, first);
+            first = false;
+        }
+    }
+    if (json) {
+        fprintf(json, "\n  ]\n}\n");
+        fflush(json);
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define NGP_BENCH_MAX_COUNTERS 4
+
+/*
+ * A small local benchmark harness. A benchmark runs its body b->iterations times, the runner keeps
+ * growing the iteration count until one run takes long enough to time, then reports ns per
+ * iteration plus any counters the benchmark set.
+ */
+typedef struct NGP_Bench {
+    const char* name;
+    uint64_t    iterations;
+    uint64_t    elapsed_ns; /* set by the runner, or by the benchmark with NGP_BenchSetTime */
+    uint64_t    cpu_ns;     /* process CPU time over the whole body, every thread included */
+    bool        manual_time;
+
+    int         num_counters;
+    const char* counter_names[NGP_BENCH_MAX_COUNTERS];
+    double      counters[NGP_BENCH_MAX_COUNTERS];
+} NGP_Bench;
+
+typedef void (*NGP_BenchFn)(NGP_Bench* b);
+
+typedef struct NGP_BenchCase {
+    const char* name;
+    NGP_BenchFn fn;
+} NGP_BenchCase;
+
+/**
+ * Returns a monotonic time in nanoseconds
+ */
+uint64_t NGP_BenchNow(void);
+
+/**
+ * Reports a named value alongside the timing, e.g. events per second or drops
+ * @param b
+ * @param name
+ * @param value
+ */
+void NGP_BenchCounter(NGP_Bench* b, const char* name, double value);
+
+/**
+ * Overrides the measured time, for benchmarks that only want to time part of their body
+ * @param b
+ * @param ns
+ */
+void NGP_BenchSetTime(NGP_Bench* b, uint64_t ns);
+
+/**
+ * Keeps the compiler from optimizing away a value the benchmark computed
+ */
+#define NGP_BenchDoNotOptimize(value) __asm__ volatile("" : : "g"(value) : "memory")
+
+/**
+ * Runs every case whose name contains filter (or all of them if filter is NULL) and prints results
+ * as a table, and also as JSON if json is set. The JSON follows Google Benchmark's layout so its
+ * tools, like compare.py, can diff two runs.
+ * @param cases
+ * @param count
+ * @param filter
+ * @param json NULL for the table only, the table goes to stderr when json is stdout
+ */
+void NGP_BenchRun(const NGP_BenchCase* cases, int count, const char* filter, FILE* json);
@@ -0,0 +1,48 @@
+#include <math.h>
+
+#include "NGP_AxisHistory.h"
+#include "NGP_Bench.h"
+
+#define TRACE 2500            /* 10 s of stick reports at 250 Hz */
+#define REPORT_NS 4000000LL   /* between reports */
+#define READ_NS 4000000LL     /* when the game reads, after the report */
+#define DISPLAY_NS 12000000LL /* when that frame is shown */
+
+/* A stand-in for a recorded aim trace: sweeps of changing speed with stops and reversals */
+static float StickAt(NGP_Timestamp time) {
+    double t = (double)time / 1e9;
+    return (float)(24000.0 * sin(t * 2.1) * sin(t * 0.37));
+}
+
+/*
+ * Every report of the trace into one pad's history, queried once per report for the display time
+ * the way a game would, against the trace's true value then. err_latest is what reading the last
+ * report costs, err_predicted what NGP_GamePadAxisAt costs, both in axis units.
+ */
+void BenchAxisHistoryPredict(NGP_Bench* b) {
+    NGP_GamePadState state       = { 0 };
+    double           latest_err  = 0.0;
+    double           predict_err = 0.0;
+    uint64_t         queries     = 0;
+    uint64_t         start       = NGP_BenchNow();
+    for (uint64_t i = 0; i < b->iterations;) {
+        NGP_AxisHistory history = { 0 };
+        for (int frame = 0; frame < TRACE && i < b->iterations; frame++, i++) {
+            state.Timestamp                      = (NGP_Timestamp)(frame + 1) * REPORT_NS;
+            state.Axes[NGP_GamePadAxisTypeLeftX] = (int16_t)lrintf(StickAt(state.Timestamp));
+            NGP_AxisHistoryPush(&history, &state);
+
+            NGP_Timestamp now       = state.Timestamp + READ_NS;
+            NGP_Timestamp target    = state.Timestamp + DISPLAY_NS;
+            float         predicted = NGP_AxisHistorySample(&history, NGP_GamePadAxisTypeLeftX,
+                                                            target, now);
+            float truth     = StickAt(target);
+            latest_err += fabs(state.Axes[NGP_GamePadAxisTypeLeftX] - truth);
+            predict_err += fabs(predicted - truth);
+            queries++;
+        }
+    }
+    NGP_BenchSetTime(b, NGP_BenchNow() - start);
+    NGP_BenchCounter(b, "err_latest", latest_err / (double)queries);
+    NGP_BenchCounter(b, "err_predicted", predict_err / (double)queries);
+}
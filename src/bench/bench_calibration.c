@@ -0,0 +1,118 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "NGP_Bench.h"
+#include "NGP_Device.h"
+
+#define VALUES 4096
+
+static int16_t             raw[VALUES];
+static int16_t             out[VALUES];
+static NGP_AxisCalibration range;
+static int16_t             table[NGP_CALIBRATION_TABLE_SIZE];
+
+static const NGP_AxisResponse response = {
+    .Type         = NGP_CurveExponential,
+    .Shape        = 2.0f,
+    .Deadzone     = 0.08f,
+    .AntiDeadzone = 0.05f,
+};
+
+/*
+ * A virtual pad's left X table as the library builds it for the response above, after a sweep
+ * that took the stick past its default range
+ */
+static bool BuildTable(void) {
+    static bool built;
+    if (built) {
+        return true;
+    }
+    uint32_t seed = 12345;
+    for (int i = 0; i < VALUES; i++) {
+        seed   = seed * 1664525u + 1013904223u;
+        raw[i] = (int16_t)(seed >> 16);
+    }
+    if (!NGP_InitializeVirtual()) {
+        return false;
+    }
+    NGP_SetCalibrationEnabled(true);
+    NGP_VirtualGamePad* pad = NGP_VirtualGamePadCreate("Bench Pad", 0, 0);
+    NGP_VirtualSync();
+    NGP_GamePad* gp = NGP_GamePadOpen(0);
+    NGP_GamePadSetAxisResponse(gp, NGP_GamePadAxisTypeLeftX, &response);
+    static const int16_t sweep[] = { 0, 29000, -31000, 0 };
+    for (size_t i = 0; i < sizeof(sweep) / sizeof(sweep[0]); i++) {
+        NGP_VirtualGamePadSetAxis(pad, NGP_GamePadAxisTypeLeftX, sweep[i]);
+        NGP_VirtualGamePadCommit(pad);
+        NGP_VirtualSync();
+    }
+    NGP_Device* device = NGP_DeviceLookup(NGP_GamePadGetID(gp));
+    built = device && device->calibration &&
+            NGP_GamePadGetAxisCalibration(gp, NGP_GamePadAxisTypeLeftX, &range);
+    if (built) {
+        /* the I/O thread is idle after the sync, range was copied out when the table was built */
+        memcpy(table, device->calibration->tables[NGP_GamePadAxisTypeLeftX], sizeof(table));
+    }
+    NGP_GamePadFree(gp);
+    NGP_SetCalibrationEnabled(false);
+    NGP_Shutdown();
+    return built;
+}
+
+/* The same mapping worked out for every value, what the table saves */
+static int16_t Calibrate(int16_t value) {
+    float offset     = (float)(value - range.Center);
+    float deflection = value >= range.Center ? offset / (float)(range.Max - range.Center)
+                                             : offset / (float)(range.Center - range.Min);
+    float magnitude  = fminf(fabsf(deflection), 1.0f);
+    float mapped     = 0.0f;
+    if (magnitude > response.Deadzone) {
+        mapped = powf((magnitude - response.Deadzone) / (1.0f - response.Deadzone), response.Shape);
+        mapped = response.AntiDeadzone + (1.0f - response.AntiDeadzone) * mapped;
+    }
+    return deflection < 0.0f ? (int16_t)lrintf(-mapped * 32768.0f)
+                             : (int16_t)lrintf(mapped * 32767.0f);
+}
+
+static void ValuesPerSecond(NGP_Bench* b) {
+    NGP_BenchCounter(b, "values/s", (double)b->iterations * VALUES * 1e9 / (double)b->elapsed_ns);
+}
+
+/* Raw stick values mapped one table load each */
+void BenchCalibrationTable(NGP_Bench* b) {
+    if (!BuildTable()) {
+        return;
+    }
+    uint64_t start = NGP_BenchNow();
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        for (int v = 0; v < VALUES; v++) {
+            out[v] = table[(uint16_t)raw[v]];
+        }
+        NGP_BenchDoNotOptimize(out[0]);
+    }
+    NGP_BenchSetTime(b, NGP_BenchNow() - start);
+    ValuesPerSecond(b);
+    int error = 0;
+    for (int v = 0; v < VALUES; v++) {
+        int e = abs(table[(uint16_t)raw[v]] - Calibrate(raw[v]));
+        error = e > error ? e : error;
+    }
+    NGP_BenchCounter(b, "max_error", (double)error); /* from sampling the curve, in axis units */
+}
+
+/* The same values through the floating point mapping */
+void BenchCalibrationFloat(NGP_Bench* b) {
+    if (!BuildTable()) {
+        return;
+    }
+    uint64_t start = NGP_BenchNow();
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        for (int v = 0; v < VALUES; v++) {
+            out[v] = Calibrate(raw[v]);
+        }
+        NGP_BenchDoNotOptimize(out[0]);
+    }
+    NGP_BenchSetTime(b, NGP_BenchNow() - start);
+    ValuesPerSecond(b);
+}
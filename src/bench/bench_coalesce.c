@@ -0,0 +1,62 @@
+#include "NGP_Bench.h"
+#include "NGP_Device.h"
+
+#define BENCH_REPORT_NS 1000000LL /* a 1 kHz pad */
+#define BENCH_FRAME_REPORTS 16    /* polled once per 60 Hz frame */
+
+/*
+ * A pad moving both sticks and triggers and streaming motion data at 1 kHz, drained by a consumer
+ * once per frame. Reports the events queued per report, the traffic coalescing and masks cut.
+ */
+static void RunCoalesce(NGP_Bench* b, NGP_Timestamp window, uint32_t mask) {
+    NGP_Device* device = NGP_DeviceAcquire();
+    if (!device || !NGP_DeviceAttach(device)) {
+        return;
+    }
+    NGP_SetAxisCoalescing(window);
+    NGP_SetEventMask(mask);
+
+    NGP_Event events[256];
+    uint64_t  received = 0;
+    while (NGP_PollEvents(events, 256) > 0) {
+    }
+    uint64_t dropped = NGP_EventsDropped();
+
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        NGP_DeviceBeginReport(device, (NGP_Timestamp)i * BENCH_REPORT_NS);
+        for (int axis = 0; axis < NGP_GamePadAxisTypeMax; axis++) {
+            NGP_DeviceSetAxis(device, (NGP_GamePadAxisType)axis, (int16_t)(i * 7 + axis));
+        }
+        float motion[3] = { (float)i, 0.0f, 9.8f };
+        NGP_DeviceSetSensor(device, NGP_GamePadSensorAccelerometer, motion);
+        NGP_DeviceSetSensor(device, NGP_GamePadSensorGyroscope, motion);
+        NGP_DevicePublish(device);
+        if (i % BENCH_FRAME_REPORTS == BENCH_FRAME_REPORTS - 1) {
+            int count;
+            while ((count = NGP_PollEvents(events, 256)) > 0) {
+                received += (uint64_t)count;
+            }
+        }
+    }
+    NGP_DeviceRelease(device);
+    int count;
+    while ((count = NGP_PollEvents(events, 256)) > 0) {
+        received += (uint64_t)count;
+    }
+
+    NGP_BenchCounter(b, "events/report", (double)received / (double)b->iterations);
+    NGP_BenchCounter(b, "dropped", (double)(NGP_EventsDropped() - dropped));
+    NGP_SetAxisCoalescing(0);
+    NGP_SetEventMask(NGP_EVENT_MASK_ALL);
+}
+
+void BenchCoalesceOff(NGP_Bench* b) { RunCoalesce(b, 0, NGP_EVENT_MASK_ALL); }
+
+void BenchCoalesceAxes(NGP_Bench* b) {
+    RunCoalesce(b, BENCH_FRAME_REPORTS * BENCH_REPORT_NS, NGP_EVENT_MASK_ALL);
+}
+
+void BenchCoalesceAxesNoSensors(NGP_Bench* b) {
+    RunCoalesce(b, BENCH_FRAME_REPORTS * BENCH_REPORT_NS,
+                NGP_EVENT_MASK_ALL & ~NGP_EVENT_MASK(NGP_EventSensorData));
+}
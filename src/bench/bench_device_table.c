@@ -0,0 +1,18 @@
+#include "NGP_Bench.h"
+#include "NGP_DeviceTable.h"
+
+/* Known pads and unknown ones alternating, like a hot-plug scan over a mixed set of devices */
+void BenchDeviceTableLookup(NGP_Bench* b) {
+    static const uint16_t ids[][2] = {
+        { USB_VENDOR_SONY, USB_PRODUCT_SONY_DS5 },
+        { USB_VENDOR_MICROSOFT, USB_PRODUCT_XBOX_ONE_SERIES_X },
+        { USB_VENDOR_SONY, USB_PRODUCT_SONY_DS4_SLIM },
+        { USB_VENDOR_NINTENDO, USB_PRODUCT_NINTENDO_SWITCH_PRO },
+    };
+    uint64_t found = 0;
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        const uint16_t* id = ids[i % 4];
+        found += NGP_DeviceInfoLookup(id[0], id[1]) != NULL;
+    }
+    NGP_BenchDoNotOptimize(found);
+}
@@ -0,0 +1,120 @@
+#include <math.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "NGP_Bench.h"
+#include "NGP_Device.h"
+
+#define BENCH_DISPATCH_PERIOD_NS 1000000LL /* a 1 kHz pad */
+#define BENCH_DISPATCH_SAMPLES 65536
+
+#define BENCH_DISPATCH_BACKLOG (2 * NGP_EVENT_QUEUE_CAPACITY) /* reports of two events each */
+
+typedef struct BenchDispatchStats {
+    int64_t  latency[BENCH_DISPATCH_SAMPLES]; /* report queued to callback, one per call */
+    int      samples;
+    uint64_t calls;
+    uint64_t events;
+    bool     timing; /* off while the backlog goes through */
+} BenchDispatchStats;
+
+static void OnEvents(const NGP_Event* events, int count, void* userdata) {
+    BenchDispatchStats* stats = userdata;
+    if (stats->timing && stats->samples < BENCH_DISPATCH_SAMPLES) {
+        stats->latency[stats->samples++] = NGP_GetTicksNS() - events[0].Timestamp;
+    }
+    stats->calls++;
+    __atomic_store_n(&stats->events, stats->events + (uint64_t)count, __ATOMIC_RELAXED);
+}
+
+static int CompareLatency(const void* a, const void* b) {
+    int64_t x = *(const int64_t*)a;
+    int64_t y = *(const int64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/* The pad's nth report, every one changes the stick and the button so each queues two events */
+static void Report(NGP_VirtualGamePad* pad, uint64_t n) {
+    NGP_VirtualGamePadSetAxis(pad, NGP_GamePadAxisTypeLeftX, (int16_t)(n & 0x7fff));
+    NGP_VirtualGamePadSetButton(pad, NGP_GamePadButtonA, n & 1);
+    NGP_VirtualGamePadCommit(pad);
+}
+
+/* Waits up to a second for the callback to have seen events */
+static void WaitForEvents(BenchDispatchStats* stats, uint64_t events) {
+    uint64_t deadline = NGP_BenchNow() + 1000000000ULL;
+    while (__atomic_load_n(&stats->events, __ATOMIC_RELAXED) < events &&
+           NGP_BenchNow() < deadline) {
+        struct timespec ts = { 0, 100000 };
+        nanosleep(&ts, NULL);
+    }
+}
+
+/*
+ * A virtual pad reporting a stick and a button at 1 kHz, delivered through NGP_SetEventCallback.
+ * Times every call from when its report was queued, jitter is the standard deviation of that.
+ * Nothing polls, so first a backlog of several queues' worth of reports goes through unthrottled
+ * to show the callback keeps receiving once the library's own cursor is a whole queue behind.
+ */
+void BenchDispatchCallback(NGP_Bench* b) {
+    static BenchDispatchStats stats;
+    stats.samples = 0;
+    stats.calls   = 0;
+    stats.events  = 0;
+    stats.timing  = false;
+    if (!NGP_InitializeVirtual()) {
+        return;
+    }
+    NGP_VirtualGamePad* pad = NGP_VirtualGamePadCreate("Bench Pad", 0, 0);
+    NGP_VirtualSync();
+    NGP_SetEventCallback(OnEvents, &stats, NGP_EVENT_MASK_ALL);
+    NGP_SetEventCallbackScheduling(1, -1); /* stays on normal scheduling without the privilege */
+
+    uint64_t dropped = NGP_EventCallbackDropped();
+    for (uint64_t n = 1; n <= BENCH_DISPATCH_BACKLOG; n++) {
+        Report(pad, n);
+        if (n % 64 == 0) {
+            NGP_VirtualSync(); /* in batches, a fast burst can outrun the callback's own cursor */
+        }
+    }
+    NGP_VirtualSync();
+    WaitForEvents(&stats, 2 * BENCH_DISPATCH_BACKLOG);
+    uint64_t backlog = __atomic_load_n(&stats.events, __ATOMIC_RELAXED);
+    dropped          = NGP_EventCallbackDropped() - dropped;
+    stats.timing     = true;
+
+    uint64_t start = NGP_BenchNow();
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        uint64_t        due = start + (i + 1) * BENCH_DISPATCH_PERIOD_NS;
+        struct timespec ts  = { (time_t)(due / 1000000000ULL), (long)(due % 1000000000ULL) };
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+        Report(pad, BENCH_DISPATCH_BACKLOG + 1 + i);
+    }
+    NGP_VirtualSync();
+    WaitForEvents(&stats, backlog + 2 * b->iterations);
+    NGP_SetEventCallback(NULL, NULL, 0);
+    NGP_SetEventCallbackScheduling(0, -1);
+    NGP_Shutdown();
+
+    /* both 0 unless the backlog was cut short */
+    NGP_BenchCounter(b, "backlog_lost", (double)(2 * BENCH_DISPATCH_BACKLOG) - (double)backlog);
+    NGP_BenchCounter(b, "backlog_dropped", (double)dropped);
+    int samples = stats.samples;
+    if (samples == 0) {
+        return;
+    }
+    double mean = 0.0;
+    for (int i = 0; i < samples; i++) {
+        mean += (double)stats.latency[i] / samples;
+    }
+    double variance = 0.0;
+    for (int i = 0; i < samples; i++) {
+        double d = (double)stats.latency[i] - mean;
+        variance += d * d / samples;
+    }
+    qsort(stats.latency, (size_t)samples, sizeof(stats.latency[0]), CompareLatency);
+    NGP_BenchCounter(b, "p50_ns", (double)stats.latency[samples / 2]);
+    NGP_BenchCounter(b, "p99_ns", (double)stats.latency[samples * 99 / 100]);
+    NGP_BenchCounter(b, "jitter_ns", sqrt(variance));
+    NGP_BenchCounter(b, "events/call", (double)stats.events / (double)stats.calls);
+}
@@ -0,0 +1,66 @@
+#include <NGP_Latency.h>
+#include <NGP_Virtual.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "NGP_Bench.h"
+#include "NGP_Enumeration.h"
+#include "NGP_Intern.h"
+
+#define TRACKED 64
+
+/*
+ * A full rescan of 64 pads where one has been swapped for another since the last scan, what a
+ * source does when it may have missed hot-plug notifications. Only the two that changed should be
+ * opened or closed.
+ */
+void BenchEnumerationScan(NGP_Bench* b) {
+    static NGP_Enumeration enumeration;
+    static const char*     keys[TRACKED * 2];
+    static const char*     present[TRACKED]; /* slot k holds keys[k] or keys[k + TRACKED] */
+    static int             devices[TRACKED * 2];
+    for (int i = 0; i < TRACKED * 2; i++) {
+        char path[32];
+        snprintf(path, sizeof(path), "/dev/input/event%d", i);
+        keys[i] = NGP_Intern(path);
+    }
+    memset(&enumeration, 0, sizeof(enumeration));
+    for (int k = 0; k < TRACKED; k++) {
+        present[k] = keys[k];
+        NGP_EnumerationAdd(&enumeration, keys[k], &devices[k]);
+    }
+
+    uint64_t added   = 0;
+    uint64_t removed = 0;
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        int swap      = (int)(i % TRACKED);
+        present[swap] = present[swap] == keys[swap] ? keys[swap + TRACKED] : keys[swap];
+
+        NGP_EnumerationBeginScan(&enumeration);
+        for (int k = 0; k < TRACKED; k++) {
+            if (!NGP_EnumerationSeen(&enumeration, present[k])) {
+                NGP_EnumerationAdd(&enumeration, present[k], &devices[k]);
+                added++;
+            }
+        }
+        void* gone[TRACKED];
+        removed += (uint64_t)NGP_EnumerationEndScan(&enumeration, gone, TRACKED);
+    }
+    NGP_BenchCounter(b, "added/scan", (double)added / (double)b->iterations);
+    NGP_BenchCounter(b, "removed/scan", (double)removed / (double)b->iterations);
+}
+
+/* NGP_InitializeVirtual to a pad's attached event, with the fake source in for a platform one */
+void BenchEnumerationFirstPad(NGP_Bench* b) {
+    uint64_t total = 0;
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        if (!NGP_InitializeVirtual()) {
+            return;
+        }
+        NGP_VirtualGamePadCreate("Bench Pad", 0, 0);
+        NGP_VirtualSync();
+        total += NGP_GetTimeToFirstGamePad();
+        NGP_Shutdown();
+    }
+    NGP_BenchCounter(b, "first_pad_us", (double)total / (double)b->iterations / 1000.0);
+}
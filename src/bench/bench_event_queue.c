@@ -0,0 +1,148 @@
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#include "NGP_Bench.h"
+#include "NGP_EventQueue.h"
+
+#define BATCH 64
+#define MAX_READERS 8
+
+static NGP_EventQueue queue;
+
+typedef struct Producer {
+    uint64_t count;
+    bool     retry; /* spin when full instead of dropping, measures the ring's peak rate */
+    bool     done;
+} Producer;
+
+typedef struct Reader {
+    Producer*            producer;
+    NGP_EventSubscriber* cursor;
+    uint64_t             received;
+} Reader;
+
+static void* ProducerThread(void* arg) {
+    Producer* p = arg;
+    NGP_Event e;
+    memset(&e, 0, sizeof(e));
+    e.Kind = NGP_EventButtonDown;
+    for (uint64_t i = 0; i < p->count; i++) {
+        e.Timestamp = (NGP_Timestamp)i;
+        while (!NGP_EventQueuePush(&queue, &e) && p->retry) {
+            sched_yield();
+        }
+    }
+    __atomic_store_n(&p->done, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static uint64_t Drain(Producer* p, NGP_EventSubscriber* cursor) {
+    NGP_Event events[BATCH];
+    uint64_t  received = 0;
+    for (;;) {
+        bool done = __atomic_load_n(&p->done, __ATOMIC_ACQUIRE);
+        int  n    = NGP_EventQueuePop(&queue, cursor, events, BATCH);
+        received += (uint64_t)n;
+        if (n == 0) {
+            if (done) {
+                return received;
+            }
+            sched_yield(); /* keeps single core machines from spinning out the producer */
+        }
+    }
+}
+
+/* Reads every event in place through its own cursor, the way a zero copy subscriber would */
+static void* ReaderThread(void* arg) {
+    Reader* r = arg;
+    for (;;) {
+        bool             done = __atomic_load_n(&r->producer->done, __ATOMIC_ACQUIRE);
+        const NGP_Event* events;
+        int              n = NGP_EventQueuePeek(&queue, r->cursor, &events);
+        for (int i = 0; i < n; i++) {
+            NGP_BenchDoNotOptimize(events[i].Timestamp);
+        }
+        NGP_EventQueueRelease(&queue, r->cursor, n);
+        r->received += (uint64_t)n;
+        if (n == 0) {
+            if (done) {
+                return NULL;
+            }
+            sched_yield();
+        }
+    }
+}
+
+static void RunProducerConsumer(NGP_Bench* b, bool retry) {
+    NGP_EventQueueReset(&queue);
+    Producer             p      = { b->iterations, retry, false };
+    NGP_EventSubscriber* cursor = NGP_EventQueueSubscribe(&queue, NGP_EventPolicyBackpressure);
+    pthread_t            thread;
+
+    uint64_t start = NGP_BenchNow();
+    pthread_create(&thread, NULL, ProducerThread, &p);
+    uint64_t received = Drain(&p, cursor);
+    pthread_join(thread, NULL);
+    uint64_t elapsed = NGP_BenchNow() - start;
+
+    NGP_BenchSetTime(b, elapsed);
+    NGP_BenchCounter(b, "events/s", (double)received * 1e9 / (double)elapsed);
+    /* with retry on, a rejected push is retried rather than lost */
+    NGP_BenchCounter(b, retry ? "ring_full" : "dropped", (double)NGP_EventQueueDropped(&queue));
+}
+
+/* One producer, readers that each see every event, its rate should not fall as readers are added */
+static void RunFanOut(NGP_Bench* b, int readers) {
+    NGP_EventQueueReset(&queue);
+    Producer  p = { b->iterations, true, false };
+    Reader    r[MAX_READERS];
+    pthread_t threads[MAX_READERS];
+    pthread_t producer;
+    for (int i = 0; i < readers; i++) {
+        r[i] = (Reader){ &p, NGP_EventQueueSubscribe(&queue, NGP_EventPolicyBackpressure), 0 };
+    }
+
+    uint64_t start = NGP_BenchNow();
+    for (int i = 0; i < readers; i++) {
+        pthread_create(&threads[i], NULL, ReaderThread, &r[i]);
+    }
+    pthread_create(&producer, NULL, ProducerThread, &p);
+    pthread_join(producer, NULL);
+    uint64_t missing = 0;
+    for (int i = 0; i < readers; i++) {
+        pthread_join(threads[i], NULL);
+        missing += b->iterations - r[i].received;
+    }
+    uint64_t elapsed = NGP_BenchNow() - start;
+
+    NGP_BenchSetTime(b, elapsed);
+    NGP_BenchCounter(b, "events/s", (double)b->iterations * 1e9 / (double)elapsed);
+    NGP_BenchCounter(b, "missing", (double)missing);
+}
+
+void BenchEventQueuePushPop(NGP_Bench* b) {
+    NGP_EventQueueReset(&queue);
+    NGP_EventSubscriber* cursor = NGP_EventQueueSubscribe(&queue, NGP_EventPolicyBackpressure);
+    NGP_Event            e;
+    NGP_Event out[BATCH];
+    memset(&e, 0, sizeof(e));
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        NGP_EventQueuePush(&queue, &e);
+        if ((i & (BATCH - 1)) == BATCH - 1) {
+            NGP_BenchDoNotOptimize(NGP_EventQueuePop(&queue, cursor, out, BATCH));
+        }
+    }
+}
+
+void BenchEventQueueSPSC(NGP_Bench* b) { RunProducerConsumer(b, true); }
+
+void BenchEventQueueSPSCDrop(NGP_Bench* b) { RunProducerConsumer(b, false); }
+
+void BenchEventQueueFanOut1(NGP_Bench* b) { RunFanOut(b, 1); }
+
+void BenchEventQueueFanOut2(NGP_Bench* b) { RunFanOut(b, 2); }
+
+void BenchEventQueueFanOut4(NGP_Bench* b) { RunFanOut(b, 4); }
+
+void BenchEventQueueFanOut8(NGP_Bench* b) { RunFanOut(b, 8); }
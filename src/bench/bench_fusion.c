@@ -0,0 +1,100 @@
+#include <NGP_GamePad.h>
+#include <math.h>
+
+#include "NGP_Bench.h"
+#include "NGP_Fusion.h"
+
+#define TRACE 4000 /* 4 s of readings at 1 kHz, two whole rocks so the trace loops smoothly */
+#define PADS 64
+#define ROCK_AMPLITUDE 0.8f /* rad */
+#define ROCK_HZ 0.5f
+
+static NGP_SensorSample trace[TRACE];
+static float            trace_angle[TRACE];
+static NGP_SensorSample lanes[TRACE][PADS];
+static NGP_Quaternion   orientations[PADS];
+
+/*
+ * A stand-in for a recorded IMU trace, a pad rocked back and forth about its X axis at 1 kHz with
+ * sensor noise, so the bench knows the true tilt and can report how far the filter is off
+ */
+static void FillTrace(void) {
+    static bool filled;
+    uint32_t    seed = 12345;
+    if (filled) {
+        return;
+    }
+    for (int i = 0; i < TRACE; i++) {
+        float t        = (float)i * 0.001f;
+        float w        = 2.0f * 3.14159265f * ROCK_HZ;
+        float angle    = ROCK_AMPLITUDE * sinf(w * t);
+        float rate     = ROCK_AMPLITUDE * w * cosf(w * t);
+        trace_angle[i] = angle;
+        for (int axis = 0; axis < 3; axis++) {
+            seed                 = seed * 1664525u + 1013904223u;
+            trace[i].Accel[axis] = ((float)(seed >> 16) / 65536.0f - 0.5f) * 0.2f;
+            seed                 = seed * 1664525u + 1013904223u;
+            trace[i].Gyro[axis]  = ((float)(seed >> 16) / 65536.0f - 0.5f) * 0.02f;
+        }
+        trace[i].Accel[1] += 9.80665f * cosf(angle);
+        trace[i].Accel[2] -= 9.80665f * sinf(angle);
+        trace[i].Gyro[0] += rate;
+        trace[i].DeltaTime = 0.001f;
+    }
+    for (int i = 0; i < TRACE; i++) {
+        for (int pad = 0; pad < PADS; pad++) {
+            lanes[i][pad] = trace[(i + pad * 61) % TRACE];
+        }
+    }
+    filled = true;
+}
+
+/* Degrees between the filter's idea of up and the trace's */
+static double TiltError(NGP_Quaternion q, float angle) {
+    float up_y = 2.0f * (q.W * q.X + q.Y * q.Z);
+    float up_z = q.W * q.W - q.X * q.X - q.Y * q.Y + q.Z * q.Z;
+    float dot  = up_y * sinf(angle) + up_z * cosf(angle);
+    return acos(dot > 1.0f ? 1.0 : (double)dot) * 180.0 / 3.14159265358979;
+}
+
+/* One pad one reading at a time, the way the I/O thread runs it */
+void BenchFusionPad(NGP_Bench* b) {
+    FillTrace();
+    NGP_Quaternion q     = { 1.0f, 0.0f, 0.0f, 0.0f };
+    double         error = 0.0;
+    uint64_t       start = NGP_BenchNow();
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        for (int s = 0; s < TRACE; s++) {
+            NGP_FuseSensorSamplesScalar(&q, &trace[s], 1);
+        }
+        NGP_BenchDoNotOptimize(q.W);
+    }
+    NGP_BenchSetTime(b, NGP_BenchNow() - start);
+    for (int s = 0; s < TRACE; s++) {
+        NGP_FuseSensorSamplesScalar(&q, &trace[s], 1);
+        error += TiltError(q, trace_angle[s]);
+    }
+    NGP_BenchCounter(b, "samples/s", (double)b->iterations * TRACE * 1e9 / (double)b->elapsed_ns);
+    NGP_BenchCounter(b, "tilt_err_deg", error / TRACE);
+}
+
+static void RunKernel(NGP_Bench* b, NGP_FuseSensorSamplesFn kernel) {
+    FillTrace();
+    for (int pad = 0; pad < PADS; pad++) {
+        orientations[pad] = (NGP_Quaternion){ 1.0f, 0.0f, 0.0f, 0.0f };
+    }
+    uint64_t start = NGP_BenchNow();
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        for (int s = 0; s < TRACE; s++) {
+            kernel(orientations, lanes[s], PADS);
+        }
+        NGP_BenchDoNotOptimize(orientations[0].W);
+    }
+    NGP_BenchSetTime(b, NGP_BenchNow() - start);
+    NGP_BenchCounter(b, "samples/s",
+                     (double)b->iterations * TRACE * PADS * 1e9 / (double)b->elapsed_ns);
+}
+
+void BenchFusionBatchScalar(NGP_Bench* b) { RunKernel(b, NGP_FuseSensorSamplesScalar); }
+
+void BenchFusionBatch(NGP_Bench* b) { RunKernel(b, NGP_FuseSensorSamplesKernel()); }
@@ -0,0 +1,67 @@
+#include <NGP_GamePad.h>
+
+#include "NGP_Bench.h"
+#include "NGP_Gesture.h"
+
+#define TRACE 500           /* 2 s of touchpad reports at 250 Hz */
+#define REPORT_NS 4000000LL /* between reports */
+
+static NGP_GamePadState trace[TRACE];
+
+static void Touch(int frame, int finger, uint8_t id, float x, float y) {
+    trace[frame].Fingers[finger] = (NGP_GamePadStateFinger){ x, y, 0.5f, 1, id };
+}
+
+/*
+ * A stand-in for a recorded touch trace: a tap, a swipe to the right, a slow drag that is neither,
+ * a two finger scroll down and a pinch apart, with idle reports in between
+ */
+static void FillTrace(void) {
+    static bool filled;
+    if (filled) {
+        return;
+    }
+    for (int i = 0; i < TRACE; i++) {
+        trace[i].Timestamp = (NGP_Timestamp)(i + 1) * REPORT_NS;
+    }
+    for (int i = 10; i < 20; i++) {
+        Touch(i, 0, 1, 0.3f, 0.5f);
+    }
+    for (int i = 50; i < 70; i++) {
+        Touch(i, 0, 2, 0.2f + 0.03f * (float)(i - 50), 0.5f);
+    }
+    for (int i = 100; i < 250; i++) {
+        Touch(i, 0, 3, 0.2f + 0.002f * (float)(i - 100), 0.3f);
+    }
+    for (int i = 300; i < 350; i++) {
+        Touch(i, 0, 4, 0.4f, 0.2f + 0.01f * (float)(i - 300));
+        Touch(i, 1, 5, 0.6f, 0.2f + 0.01f * (float)(i - 300));
+    }
+    for (int i = 400; i < 450; i++) {
+        Touch(i, 0, 6, 0.45f - 0.005f * (float)(i - 400), 0.5f);
+        Touch(i, 1, 7, 0.55f + 0.005f * (float)(i - 400), 0.5f);
+    }
+    filled = true;
+}
+
+/* Every report of the trace through one pad's tracker, the way NGP_DevicePublish feeds it */
+void BenchGestureTrace(NGP_Bench* b) {
+    FillTrace();
+    uint64_t counts[NGP_GesturePinch + 1] = { 0 };
+    uint64_t start                        = NGP_BenchNow();
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        NGP_GestureTracker tracker = { 0 };
+        for (int frame = 0; frame < TRACE; frame++) {
+            NGP_GestureEvent gestures[NGP_MAX_TOUCHPAD_FINGERS];
+            int              count = NGP_GestureUpdate(&tracker, &trace[frame], gestures);
+            for (int g = 0; g < count; g++) {
+                counts[gestures[g].Gesture]++;
+            }
+        }
+    }
+    NGP_BenchSetTime(b, NGP_BenchNow() - start);
+    NGP_BenchCounter(b, "taps", (double)counts[NGP_GestureTap] / (double)b->iterations);
+    NGP_BenchCounter(b, "swipes", (double)counts[NGP_GestureSwipe] / (double)b->iterations);
+    NGP_BenchCounter(b, "scrolls", (double)counts[NGP_GestureScroll] / (double)b->iterations);
+    NGP_BenchCounter(b, "pinches", (double)counts[NGP_GesturePinch] / (double)b->iterations);
+}
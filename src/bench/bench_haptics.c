@@ -0,0 +1,58 @@
+#include <string.h>
+
+#include "NGP_Bench.h"
+#include "NGP_Device.h"
+
+static bool BenchWriteOutput(NGP_Device* device, const NGP_DeviceOutput* output) {
+    (void)device;
+    (void)output;
+    return true;
+}
+
+static const NGP_DeviceTransport bench_transport = {
+    .WriteOutput = BenchWriteOutput,
+};
+
+/*
+ * One mixer tick per iteration on simulated time, with a new effect started every 16 ticks so
+ * about a dozen overlap in every phase of their envelopes
+ */
+void BenchHapticsMix(NGP_Bench* b) {
+    NGP_Device* device = NGP_DeviceAcquire();
+    if (!device) {
+        return;
+    }
+    device->transport = &bench_transport;
+    device->outputs   = NGP_OutputRumble | NGP_OutputTriggerRumble;
+    if (!NGP_DeviceAttach(device)) {
+        NGP_DeviceRelease(device);
+        return;
+    }
+    NGP_GamePad*      pad    = NGP_GamePadOpenID(device->id);
+    NGP_HapticsEffect effect = {
+        .SustainLevel = 40000,
+        .AttackMs     = 40,
+        .DecayMs      = 40,
+        .SustainMs    = 80,
+        .ReleaseMs    = 60,
+    };
+    NGP_Timestamp now     = 1000000000LL;
+    uint64_t      changes = 0;
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        if (i % 16 == 0) {
+            for (int motor = 0; motor < NGP_HapticsMotorMax; motor++) {
+                effect.Strength[motor] = (uint16_t)((i * 7919 + (uint64_t)motor * 104729) & 0xffff);
+            }
+            effect.Priority = (int32_t)(i / 16 % 3);
+            NGP_GamePadPlayEffect(pad, &effect);
+        }
+        uint16_t mixed[NGP_HapticsMotorMax];
+        memcpy(mixed, device->haptics_mixed, sizeof(mixed));
+        NGP_HapticsMixAt(now);
+        changes += memcmp(mixed, device->haptics_mixed, sizeof(mixed)) != 0;
+        now += 1000000000LL / NGP_HAPTICS_TICK_HZ;
+    }
+    NGP_GamePadFree(pad);
+    NGP_DeviceRelease(device);
+    NGP_BenchCounter(b, "changes/tick", (double)changes / (double)b->iterations);
+}
@@ -0,0 +1,75 @@
+#include <NGP_GamePad.h>
+
+#include "NGP_Bench.h"
+#include "NGP_Normalize.h"
+
+#define STICKS 4096
+
+static int16_t x[STICKS];
+static int16_t y[STICKS];
+static float   out_x[STICKS];
+static float   out_y[STICKS];
+
+/* Deterministic sticks spread over the whole range, including the deadzone and the corners */
+static void FillSticks(void) {
+    static bool filled;
+    uint32_t    seed = 12345;
+    if (filled) {
+        return;
+    }
+    for (int i = 0; i < STICKS; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        x[i] = (int16_t)(seed >> 16);
+        seed = seed * 1664525u + 1013904223u;
+        y[i] = (int16_t)(seed >> 16);
+    }
+    filled = true;
+}
+
+static void SticksPerSecond(NGP_Bench* b) {
+    NGP_BenchCounter(b, "sticks/s", (double)b->iterations * STICKS * 1e9 / (double)b->elapsed_ns);
+}
+
+/* The existing one stick at a time path, in doubles */
+void BenchNormalizeAxis(NGP_Bench* b) {
+    FillSticks();
+    uint64_t start = NGP_BenchNow();
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        for (int s = 0; s < STICKS; s++) {
+            NGP_Vector2 v = { x[s], y[s] };
+            NGP_Vector2 n = NormalizeAxis(v);
+            out_x[s]      = (float)n.X;
+            out_y[s]      = (float)n.Y;
+        }
+        NGP_BenchDoNotOptimize(out_x[0]);
+    }
+    NGP_BenchSetTime(b, NGP_BenchNow() - start);
+    SticksPerSecond(b);
+}
+
+static void RunKernel(NGP_Bench* b, NGP_NormalizeSticksFn kernel, NGP_DeadzoneType type) {
+    FillSticks();
+    uint64_t start = NGP_BenchNow();
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        kernel(x, y, out_x, out_y, STICKS, 0.15f, type);
+        NGP_BenchDoNotOptimize(out_x[0]);
+    }
+    NGP_BenchSetTime(b, NGP_BenchNow() - start);
+    SticksPerSecond(b);
+}
+
+void BenchNormalizeScalarRadial(NGP_Bench* b) {
+    RunKernel(b, NGP_NormalizeSticksScalar, NGP_DeadzoneRadial);
+}
+
+void BenchNormalizeBatchNone(NGP_Bench* b) {
+    RunKernel(b, NGP_NormalizeSticksKernel(), NGP_DeadzoneNone);
+}
+
+void BenchNormalizeBatchAxial(NGP_Bench* b) {
+    RunKernel(b, NGP_NormalizeSticksKernel(), NGP_DeadzoneAxial);
+}
+
+void BenchNormalizeBatchRadial(NGP_Bench* b) {
+    RunKernel(b, NGP_NormalizeSticksKernel(), NGP_DeadzoneRadial);
+}
@@ -0,0 +1,50 @@
+#include "NGP_Bench.h"
+#include "NGP_Device.h"
+#include "NGP_SonyReport.h"
+
+static uint64_t output_writes;
+
+/* Stands in for hidraw, encodes the report like the real transport but only counts it */
+static bool BenchWriteOutput(NGP_Device* device, const NGP_DeviceOutput* output) {
+    (void)device;
+    uint8_t report[NGP_SONY_OUTPUT_REPORT_LEN];
+    NGP_BenchDoNotOptimize(NGP_SonyEncodeOutput(NGP_SonyModelDS5, true, output, report));
+    output_writes++;
+    return true;
+}
+
+static int BenchReadFeature(NGP_Device* device, uint8_t* data, size_t size) {
+    (void)device;
+    (void)data;
+    (void)size;
+    return -1;
+}
+
+static const NGP_DeviceTransport bench_transport = {
+    .WriteOutput = BenchWriteOutput,
+    .ReadFeature = BenchReadFeature,
+};
+
+/* An LED update every iteration, flushed the way the I/O thread would between pumps */
+void BenchOutputSetLED(NGP_Bench* b) {
+    NGP_Device* device = NGP_DeviceAcquire();
+    if (!device) {
+        return;
+    }
+    device->transport = &bench_transport;
+    device->outputs   = NGP_OutputLED | NGP_OutputRumble;
+    if (!NGP_DeviceAttach(device)) {
+        NGP_DeviceRelease(device);
+        return;
+    }
+    output_writes = 0;
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        NGP_OutputSetLED(device->id, (uint8_t)i, (uint8_t)(i >> 8), 0);
+        if (i % 64 == 63) {
+            NGP_OutputFlush();
+        }
+    }
+    NGP_OutputFlush();
+    NGP_DeviceRelease(device);
+    NGP_BenchCounter(b, "writes/call", (double)output_writes / (double)b->iterations);
+}
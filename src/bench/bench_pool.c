@@ -0,0 +1,47 @@
+#include "NGP_Bench.h"
+#include "NGP_Device.h"
+
+static void DrainEvents(void) {
+    NGP_Event events[64];
+    while (NGP_PollEvents(events, 64) > 0) {
+    }
+}
+
+/* One pad attaching, being opened and closed by the application and detaching again */
+static void HotplugCycle(void) {
+    NGP_VirtualGamePad* pad = NGP_VirtualGamePadCreate("Bench Pad", 0x054c, 0x0ce6);
+    NGP_VirtualSync();
+    NGP_GamePad* handle = NGP_GamePadOpen(NGP_NumGamePads() - 1);
+    NGP_GamePadFree(handle);
+    NGP_VirtualGamePadDestroy(pad);
+    NGP_VirtualSync();
+    DrainEvents();
+}
+
+/* Attach, open, close and detach once the pools have warmed up, test_pool checks none allocate */
+void BenchPoolHotplug(NGP_Bench* b) {
+    if (!NGP_InitializeVirtual()) {
+        return;
+    }
+    HotplugCycle();
+    uint64_t start = NGP_BenchNow();
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        HotplugCycle();
+    }
+    NGP_BenchSetTime(b, NGP_BenchNow() - start);
+    NGP_Shutdown();
+}
+
+void BenchPoolOpenClose(NGP_Bench* b) {
+    NGP_Device* device = NGP_DeviceAcquire();
+    if (!device || !NGP_DeviceAttach(device)) {
+        return;
+    }
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        NGP_GamePad* handle = NGP_GamePadOpenID(device->id);
+        NGP_BenchDoNotOptimize(handle);
+        NGP_GamePadFree(handle);
+    }
+    NGP_DeviceRelease(device);
+    DrainEvents();
+}
@@ -0,0 +1,141 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "NGP_Bench.h"
+#include "NGP_RecordingFormat.h"
+
+#define BENCH_FRAMES 100000
+
+/* One pad at 1 kHz with both sticks moving, motion data, and a button every few frames */
+static void MakeFrame(int i, NGP_GamePadState* state) {
+    state->Timestamp                       = (NGP_Timestamp)i * 1000000;
+    state->Axes[NGP_GamePadAxisTypeLeftX]  = (int16_t)(sinf(i * 0.01f) * 30000);
+    state->Axes[NGP_GamePadAxisTypeLeftY]  = (int16_t)(cosf(i * 0.01f) * 30000);
+    state->Axes[NGP_GamePadAxisTypeRightX] = (int16_t)(sinf(i * 0.003f) * 12000);
+    state->Buttons                         = (i / 50) & 1 ? 1u << NGP_GamePadButtonA : 0;
+    state->Gyro[0]                         = sinf(i * 0.02f);
+    state->Accel[2]                        = 9.8f + cosf(i * 0.05f) * 0.1f;
+}
+
+/* Builds an in memory recording, the same bytes NGP_StartRecording would write */
+static uint8_t* MakeRecording(int frames, size_t* size) {
+    uint8_t* data = malloc(NGP_RECORDING_HEADER_SIZE + NGP_RECORDING_MAX_DEVICE +
+                           (size_t)frames * NGP_RECORDING_MAX_FRAME);
+    uint8_t* p    = data + NGP_RecordingEncodeHeader(data);
+
+    NGP_Device device;
+    memset(&device, 0, sizeof(device));
+    device.name   = "Bench Pad";
+    device.serial = "";
+    p += NGP_RecordingEncodeDevice(p, 0, &device);
+
+    NGP_GamePadState prev, state;
+    NGP_Timestamp    last_time = 0;
+    memset(&prev, 0, sizeof(prev));
+    memset(&state, 0, sizeof(state));
+    for (int i = 0; i < frames; i++) {
+        MakeFrame(i, &state);
+        p += NGP_RecordingEncodeFrame(p, 0, &last_time, &prev, &state);
+        prev = state;
+    }
+    *size = (size_t)(p - data);
+    return data;
+}
+
+void BenchRecordingEncode(NGP_Bench* b) {
+    static NGP_GamePadState frames[1024];
+    for (int i = 0; i < 1024; i++) {
+        MakeFrame(i, &frames[i]);
+    }
+    uint8_t       out[NGP_RECORDING_MAX_FRAME];
+    NGP_Timestamp last_time = 0;
+    size_t        bytes     = 0;
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        bytes += NGP_RecordingEncodeFrame(out, 0, &last_time, &frames[(i - 1) & 1023],
+                                          &frames[i & 1023]);
+        NGP_BenchDoNotOptimize(out);
+    }
+    NGP_BenchCounter(b, "bytes/frame", b->iterations ? (double)bytes / b->iterations : 0.0);
+}
+
+/* Ingest: decoding a mapped recording frame by frame, the replay source's inner loop */
+void BenchRecordingIngest(NGP_Bench* b) {
+    size_t   size;
+    uint8_t* data = MakeRecording(BENCH_FRAMES, &size);
+
+    NGP_GamePadState    state;
+    NGP_RecordingReader reader;
+    NGP_RecordingRecord record;
+    uint64_t            frames = 0;
+    uint64_t            start  = NGP_BenchNow();
+    while (frames < b->iterations) {
+        NGP_RecordingReaderInit(&reader, data, size);
+        memset(&state, 0, sizeof(state));
+        while (frames < b->iterations && NGP_RecordingNext(&reader, &record) > 0) {
+            if (record.type == NGP_RecordTypeFrame) {
+                NGP_RecordingReadFrame(&reader, &state);
+                frames++;
+            } else {
+                NGP_RecordingDeviceInfo info;
+                NGP_RecordingReadDevice(&reader, &info);
+            }
+        }
+        NGP_BenchDoNotOptimize(state);
+    }
+    uint64_t elapsed = NGP_BenchNow() - start;
+    NGP_BenchSetTime(b, elapsed);
+
+    double seconds = elapsed / 1e9;
+    NGP_BenchCounter(b, "frames/s", seconds > 0 ? frames / seconds : 0.0);
+    NGP_BenchCounter(b, "MB/s", seconds > 0 ? frames * ((double)size / BENCH_FRAMES) / seconds / 1e6
+                                            : 0.0);
+    NGP_BenchCounter(b, "bytes/frame", (double)size / BENCH_FRAMES);
+    free(data);
+}
+
+/*
+ * Replay: the recording played back at full speed through the replay source, the I/O thread and
+ * the event queue, the whole input path short of the OS
+ */
+void BenchRecordingReplay(NGP_Bench* b) {
+    /* iterations are powers of ten, so a file of up to BENCH_FRAMES frames divides them evenly */
+    int      frames = b->iterations < BENCH_FRAMES ? (int)b->iterations : BENCH_FRAMES;
+    size_t   size;
+    uint8_t* data = MakeRecording(frames, &size);
+    char     path[64];
+    snprintf(path, sizeof(path), "/tmp/ngp-bench-%d.ngpr", (int)getpid());
+    FILE* file  = fopen(path, "wb");
+    bool  wrote = file && fwrite(data, 1, size, file) == size;
+    if (file) {
+        wrote = fclose(file) == 0 && wrote;
+    }
+    free(data);
+    if (!wrote) {
+        remove(path);
+        return;
+    }
+
+    NGP_Event events[256];
+    uint64_t  received = 0;
+    uint64_t  start    = NGP_BenchNow();
+    for (uint64_t run = 0; run < b->iterations / (uint64_t)frames; run++) {
+        if (!NGP_InitializeReplay(path, NGP_ReplaySpeedMax)) {
+            break;
+        }
+        for (;;) {
+            bool finished = NGP_ReplayFinished(); /* before the poll, so nothing is left behind */
+            int  count    = NGP_PollEvents(events, 256);
+            received += (uint64_t)(count > 0 ? count : 0);
+            if (count <= 0 && finished) {
+                break;
+            }
+        }
+        NGP_Shutdown();
+    }
+    NGP_BenchSetTime(b, NGP_BenchNow() - start);
+    remove(path);
+    NGP_BenchCounter(b, "events/frame", (double)received / (double)b->iterations);
+}
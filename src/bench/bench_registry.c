@@ -0,0 +1,34 @@
+#include "NGP_Bench.h"
+#include "NGP_Registry.h"
+
+/* A full registry, the worst case for the linked list this replaced */
+static void FillRegistry(NGP_Registry* registry, NGP_GamePadID* ids) {
+    static int items[NGP_REGISTRY_CAPACITY];
+    NGP_RegistryInit(registry);
+    for (int i = 0; i < NGP_REGISTRY_CAPACITY; i++) {
+        ids[i] = NGP_RegistryInsert(registry, &items[i]);
+    }
+}
+
+void BenchRegistryLookup(NGP_Bench* b) {
+    NGP_Registry  registry;
+    NGP_GamePadID ids[NGP_REGISTRY_CAPACITY];
+    FillRegistry(&registry, ids);
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        void* item = NGP_RegistryLookup(&registry, ids[(i * 7) % NGP_REGISTRY_CAPACITY]);
+        NGP_BenchDoNotOptimize(item);
+    }
+}
+
+/* A pad in the middle of the order dropping off and reconnecting, like a flaky Bluetooth link */
+void BenchRegistryReconnect(NGP_Bench* b) {
+    NGP_Registry  registry;
+    NGP_GamePadID ids[NGP_REGISTRY_CAPACITY];
+    FillRegistry(&registry, ids);
+    int slot = NGP_REGISTRY_CAPACITY / 2;
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        void* item = NGP_RegistryRemove(&registry, ids[slot]);
+        ids[slot]  = NGP_RegistryInsert(&registry, item);
+    }
+    NGP_BenchDoNotOptimize(ids[slot]);
+}
@@ -0,0 +1,60 @@
+#include <stdio.h>
+#include <unistd.h>
+
+#include "NGP_Bench.h"
+#include "NGP_Device.h"
+
+#define BENCH_SHARED_PADS 8
+
+/*
+ * A client walking and copying every pad out of the shared segment while the I/O thread keeps
+ * publishing virtual frames into it, what an overlay process does once per displayed frame
+ */
+void BenchSharedStateRead(NGP_Bench* b) {
+    static NGP_VirtualGamePad* pads[BENCH_SHARED_PADS];
+    char                       name[NGP_SHARED_NAME_LEN];
+    snprintf(name, sizeof(name), "/ngp-bench-%d", (int)getpid());
+    if (!NGP_InitializeVirtual()) {
+        return;
+    }
+    for (int i = 0; i < BENCH_SHARED_PADS; i++) {
+        pads[i] = NGP_VirtualGamePadCreate("Bench Pad", 0, 0);
+    }
+    NGP_VirtualSync();
+    NGP_SharedStateClient* client = NGP_StartSharedState(name) ? NGP_SharedStateOpen(name) : NULL;
+    if (!client) {
+        NGP_StopSharedState();
+        NGP_Shutdown();
+        return;
+    }
+
+    NGP_Event events[256];
+    uint64_t  copies = 0;
+    uint64_t  misses = 0;
+    uint64_t  start  = NGP_BenchNow();
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        if (i % 64 == 0) {
+            NGP_VirtualGamePad* pad = pads[(i / 64) % BENCH_SHARED_PADS];
+            NGP_VirtualGamePadSetAxis(pad, NGP_GamePadAxisTypeLeftX, (int16_t)i);
+            NGP_VirtualGamePadCommit(pad);
+            while (NGP_PollEvents(events, 256) > 0) {
+            }
+        }
+        for (int slot = NGP_SharedStateNextGamePad(client, -1); slot >= 0;
+             slot     = NGP_SharedStateNextGamePad(client, slot)) {
+            NGP_SharedGamePad pad;
+            if (NGP_SharedStateRead(client, slot, &pad)) {
+                copies++;
+            } else {
+                misses++;
+            }
+        }
+    }
+    NGP_BenchSetTime(b, NGP_BenchNow() - start);
+    NGP_BenchCounter(b, "pads/read", (double)copies / (double)b->iterations);
+    NGP_BenchCounter(b, "misses", (double)misses);
+
+    NGP_SharedStateClose(client);
+    NGP_StopSharedState();
+    NGP_Shutdown();
+}
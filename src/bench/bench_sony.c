@@ -0,0 +1,44 @@
+#include <string.h>
+
+#include "NGP_Bench.h"
+#include "NGP_SonyReport.h"
+
+/* Reports with both fingers down, moving sticks and motion data, so no branch is skipped */
+static void MakeReport(uint8_t* data, size_t size, uint8_t report_id, size_t header) {
+    memset(data, 0, size);
+    data[0] = report_id;
+    for (size_t i = header; i < size; i++) {
+        data[i] = (uint8_t)(i * 37);
+    }
+}
+
+static void BenchSonyParse(NGP_Bench*    b,
+                           NGP_SonyModel model,
+                           uint8_t       report_id,
+                           size_t        size,
+                           size_t        header) {
+    uint8_t          data[128];
+    NGP_GamePadState state;
+    memset(&state, 0, sizeof(state));
+    MakeReport(data, size, report_id, header);
+    uint64_t start = NGP_BenchNow();
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        data[header] = (uint8_t)i; /* left stick X, keeps the compiler from hoisting the parse */
+        NGP_SonyParseReport(model, data, size, &state);
+        NGP_BenchDoNotOptimize(state);
+    }
+    uint64_t elapsed = NGP_BenchNow() - start;
+    NGP_BenchSetTime(b, elapsed);
+    /* single threaded, so this is reports per second per core */
+    NGP_BenchCounter(b, "reports/s", elapsed ? b->iterations * 1e9 / (double)elapsed : 0.0);
+}
+
+void BenchSonyDS4USB(NGP_Bench* b) { BenchSonyParse(b, NGP_SonyModelDS4, 0x01, 64, 1); }
+
+void BenchSonyDS4Bluetooth(NGP_Bench* b) { BenchSonyParse(b, NGP_SonyModelDS4, 0x11, 78, 3); }
+
+void BenchSonyDS5USB(NGP_Bench* b) { BenchSonyParse(b, NGP_SonyModelDS5, 0x01, 64, 1); }
+
+void BenchSonyDS5Bluetooth(NGP_Bench* b) { BenchSonyParse(b, NGP_SonyModelDS5, 0x31, 78, 2); }
+
+void BenchSonyShort(NGP_Bench* b) { BenchSonyParse(b, NGP_SonyModelDS5, 0x01, 10, 1); }
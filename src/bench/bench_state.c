@@ -0,0 +1,89 @@
+#include <NGP_GamePad.h>
+
+#include "NGP_Bench.h"
+#include "NGP_Device.h"
+
+/* A pad that is attached without a device source behind it, enough for the read paths */
+static NGP_GamePad* OpenBenchPad(void) {
+    static NGP_GamePad* pad;
+    if (!pad) {
+        NGP_Device* device = NGP_DeviceAcquire();
+        device->vendor_id  = 1;
+        device->product_id = 1;
+        NGP_DeviceAttach(device);
+        NGP_DeviceSetAxis(device, NGP_GamePadAxisTypeLeftX, 1200);
+        NGP_DeviceSetButton(device, NGP_GamePadButtonA, true);
+        NGP_DevicePublish(device);
+        pad = NGP_GamePadOpen(NGP_NumGamePads() - 1);
+    }
+    return pad;
+}
+
+void BenchStateSnapshot(NGP_Bench* b) {
+    NGP_GamePad*     pad = OpenBenchPad();
+    NGP_GamePadState state;
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        NGP_GamePadGetState(pad, &state);
+        NGP_BenchDoNotOptimize(state);
+    }
+}
+
+/* The same information read the old way, one call per axis and button */
+void BenchStateGetters(NGP_Bench* b) {
+    NGP_GamePad* pad = OpenBenchPad();
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        int32_t sum = 0;
+        for (int axis = 0; axis < NGP_GamePadAxisTypeMax; axis++) {
+            sum += NGP_GamePadAxis(pad, (NGP_GamePadAxisType)axis);
+        }
+        for (int button = 0; button < NGP_GamePadButtonMax; button++) {
+            sum += NGP_GamePadButton(pad, (NGP_GamePadButtonType)button);
+        }
+        NGP_BenchDoNotOptimize(sum);
+    }
+}
+
+/* Presses a different button every frame and lets go of the one before */
+static void PublishButtonFrame(NGP_GamePad* pad, uint64_t frame) {
+    NGP_Device* device = NGP_DeviceLookup(NGP_GamePadGetID(pad));
+    NGP_DeviceSetButton(device, (NGP_GamePadButtonType)(frame % NGP_GamePadButtonMax), true);
+    NGP_DeviceSetButton(device, (NGP_GamePadButtonType)((frame + 1) % NGP_GamePadButtonMax), false);
+    NGP_DevicePublish(device);
+}
+
+/* A frame of button logic on the masks: what is held, what went down, and a chord */
+void BenchStateButtonMasks(NGP_Bench* b) {
+    NGP_GamePad* pad   = OpenBenchPad();
+    uint32_t     chord = NGP_BUTTON_MASK(NGP_GamePadButtonA) | NGP_BUTTON_MASK(NGP_GamePadButtonB);
+    uint32_t     presses = 0;
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        PublishButtonFrame(pad, i);
+        uint32_t held = NGP_GamePadButtons(pad);
+        presses += (uint32_t)__builtin_popcount(NGP_GamePadButtonsPressed(pad));
+        presses += NGP_GamePadChordPressed(pad, chord);
+        NGP_BenchDoNotOptimize(held);
+    }
+    NGP_BenchCounter(b, "presses/frame", (double)presses / (double)b->iterations);
+}
+
+/* The same frame with one call per button, diffed against the last frame by hand */
+void BenchStateButtonGetters(NGP_Bench* b) {
+    NGP_GamePad* pad = OpenBenchPad();
+    uint8_t      last[NGP_GamePadButtonMax];
+    uint32_t     presses = 0;
+    for (int button = 0; button < NGP_GamePadButtonMax; button++) {
+        last[button] = NGP_GamePadButton(pad, (NGP_GamePadButtonType)button);
+    }
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        PublishButtonFrame(pad, i);
+        for (int button = 0; button < NGP_GamePadButtonMax; button++) {
+            uint8_t held = NGP_GamePadButton(pad, (NGP_GamePadButtonType)button);
+            presses += held && !last[button];
+            last[button] = held;
+        }
+        presses += last[NGP_GamePadButtonA] && last[NGP_GamePadButtonB] &&
+                   (i % NGP_GamePadButtonMax == NGP_GamePadButtonA ||
+                    i % NGP_GamePadButtonMax == NGP_GamePadButtonB);
+    }
+    NGP_BenchCounter(b, "presses/frame", (double)presses / (double)b->iterations);
+}
@@ -0,0 +1,54 @@
+#include "NGP_Bench.h"
+#include "NGP_Device.h"
+
+#define BENCH_VIRTUAL_PADS 1024
+
+/* Frames from a thousand virtual pads through the I/O thread and out of the event queue */
+void BenchVirtualFrames(NGP_Bench* b) {
+    static NGP_VirtualGamePad* pads[BENCH_VIRTUAL_PADS];
+    if (!NGP_InitializeVirtual()) {
+        return;
+    }
+    for (int i = 0; i < BENCH_VIRTUAL_PADS; i++) {
+        pads[i] = NGP_VirtualGamePadCreate("Bench Pad", 0, 0);
+    }
+    NGP_VirtualSync();
+
+    NGP_Event events[256];
+    uint64_t  received = 0;
+    while (NGP_PollEvents(events, 256) > 0) {
+    }
+    uint64_t dropped = NGP_EventsDropped();
+
+    uint64_t start = NGP_BenchNow();
+    for (uint64_t i = 0; i < b->iterations; i++) {
+        NGP_VirtualGamePad* pad   = pads[i % BENCH_VIRTUAL_PADS];
+        int16_t             value = (int16_t)(i / BENCH_VIRTUAL_PADS + 1);
+        NGP_VirtualGamePadSetAxis(pad, NGP_GamePadAxisTypeLeftX, value);
+        NGP_VirtualGamePadCommit(pad);
+        if (i % BENCH_VIRTUAL_PADS == BENCH_VIRTUAL_PADS - 1) {
+            /* one frame from every pad fits the event queue, wait for it and drain it */
+            NGP_VirtualSync();
+            int count;
+            while ((count = NGP_PollEvents(events, 256)) > 0) {
+                received += (uint64_t)count;
+            }
+        }
+    }
+    NGP_VirtualSync();
+    int count;
+    while ((count = NGP_PollEvents(events, 256)) > 0) {
+        received += (uint64_t)count;
+    }
+    NGP_BenchSetTime(b, NGP_BenchNow() - start);
+
+    NGP_BenchCounter(b, "events", (double)received);
+    NGP_BenchCounter(b, "dropped", (double)(NGP_EventsDropped() - dropped));
+
+    NGP_LatencyStats stats;
+    if (NGP_GetLatencyStats(NGP_DeviceAtIndex(0), &stats)) {
+        NGP_BenchCounter(b, "p50_ns", (double)stats.Stages[NGP_LatencyStageTotal].P50);
+        NGP_BenchCounter(b, "p99_ns", (double)stats.Stages[NGP_LatencyStageTotal].P99);
+    }
+    NGP_Shutdown();
+}
@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "NGP_Bench.h"
+
+void BenchAxisHistoryPredict(NGP_Bench* b);
+void BenchCalibrationTable(NGP_Bench* b);
+void BenchCalibrationFloat(NGP_Bench* b);
+void BenchCoalesceOff(NGP_Bench* b);
+void BenchCoalesceAxes(NGP_Bench* b);
+void BenchCoalesceAxesNoSensors(NGP_Bench* b);
+void BenchDeviceTableLookup(NGP_Bench* b);
+void BenchDispatchCallback(NGP_Bench* b);
+void BenchEnumerationScan(NGP_Bench* b);
+void BenchEnumerationFirstPad(NGP_Bench* b);
+void BenchEventQueuePushPop(NGP_Bench* b);
+void BenchEventQueueSPSC(NGP_Bench* b);
+void BenchEventQueueSPSCDrop(NGP_Bench* b);
+void BenchEventQueueFanOut1(NGP_Bench* b);
+void BenchEventQueueFanOut2(NGP_Bench* b);
+void BenchEventQueueFanOut4(NGP_Bench* b);
+void BenchEventQueueFanOut8(NGP_Bench* b);
+void BenchStateSnapshot(NGP_Bench* b);
+void BenchStateGetters(NGP_Bench* b);
+void BenchStateButtonMasks(NGP_Bench* b);
+void BenchStateButtonGetters(NGP_Bench* b);
+void BenchFusionPad(NGP_Bench* b);
+void BenchFusionBatchScalar(NGP_Bench* b);
+void BenchFusionBatch(NGP_Bench* b);
+void BenchGestureTrace(NGP_Bench* b);
+void BenchHapticsMix(NGP_Bench* b);
+void BenchNormalizeAxis(NGP_Bench* b);
+void BenchNormalizeScalarRadial(NGP_Bench* b);
+void BenchNormalizeBatchNone(NGP_Bench* b);
+void BenchNormalizeBatchAxial(NGP_Bench* b);
+void BenchNormalizeBatchRadial(NGP_Bench* b);
+void BenchOutputSetLED(NGP_Bench* b);
+void BenchPoolHotplug(NGP_Bench* b);
+void BenchPoolOpenClose(NGP_Bench* b);
+void BenchRecordingEncode(NGP_Bench* b);
+void BenchRecordingIngest(NGP_Bench* b);
+void BenchRecordingReplay(NGP_Bench* b);
+void BenchRegistryLookup(NGP_Bench* b);
+void BenchRegistryReconnect(NGP_Bench* b);
+void BenchSharedStateRead(NGP_Bench* b);
+void BenchSonyDS4USB(NGP_Bench* b);
+void BenchSonyDS4Bluetooth(NGP_Bench* b);
+void BenchSonyDS5USB(NGP_Bench* b);
+void BenchSonyDS5Bluetooth(NGP_Bench* b);
+void BenchSonyShort(NGP_Bench* b);
+void BenchVirtualFrames(NGP_Bench* b);
+
+static const NGP_BenchCase cases[] = {
+    { "axis_history/predict", BenchAxisHistoryPredict },
+    { "calibration/table", BenchCalibrationTable },
+    { "calibration/float", BenchCalibrationFloat },
+    { "coalesce/off", BenchCoalesceOff },
+    { "coalesce/axes", BenchCoalesceAxes },
+    { "coalesce/axes_no_sensors", BenchCoalesceAxesNoSensors },
+    { "device_table/lookup", BenchDeviceTableLookup },
+    { "dispatch/callback", BenchDispatchCallback },
+    { "enumeration/scan", BenchEnumerationScan },
+    { "enumeration/first_pad", BenchEnumerationFirstPad },
+    { "event_queue/push_pop", BenchEventQueuePushPop },
+    { "event_queue/spsc", BenchEventQueueSPSC },
+    { "event_queue/spsc_drop", BenchEventQueueSPSCDrop },
+    { "event_queue/fan_out_1", BenchEventQueueFanOut1 },
+    { "event_queue/fan_out_2", BenchEventQueueFanOut2 },
+    { "event_queue/fan_out_4", BenchEventQueueFanOut4 },
+    { "event_queue/fan_out_8", BenchEventQueueFanOut8 },
+    { "state/snapshot", BenchStateSnapshot },
+    { "state/getters", BenchStateGetters },
+    { "state/button_masks", BenchStateButtonMasks },
+    { "state/button_getters", BenchStateButtonGetters },
+    { "fusion/pad", BenchFusionPad },
+    { "fusion/batch_scalar", BenchFusionBatchScalar },
+    { "fusion/batch", BenchFusionBatch },
+    { "gesture/trace", BenchGestureTrace },
+    { "haptics/mix", BenchHapticsMix },
+    { "normalize/NormalizeAxis", BenchNormalizeAxis },
+    { "normalize/scalar_radial", BenchNormalizeScalarRadial },
+    { "normalize/batch_none", BenchNormalizeBatchNone },
+    { "normalize/batch_axial", BenchNormalizeBatchAxial },
+    { "normalize/batch_radial", BenchNormalizeBatchRadial },
+    { "output/set_led", BenchOutputSetLED },
+    { "pool/hotplug", BenchPoolHotplug },
+    { "pool/open_close", BenchPoolOpenClose },
+    { "recording/encode", BenchRecordingEncode },
+    { "recording/ingest", BenchRecordingIngest },
+    { "recording/replay", BenchRecordingReplay },
+    { "registry/lookup", BenchRegistryLookup },
+    { "registry/reconnect", BenchRegistryReconnect },
+    { "shared_state/read", BenchSharedStateRead },
+    { "sony/ds4_usb", BenchSonyDS4USB },
+    { "sony/ds4_bluetooth", BenchSonyDS4Bluetooth },
+    { "sony/ds5_usb", BenchSonyDS5USB },
+    { "sony/ds5_bluetooth", BenchSonyDS5Bluetooth },
+    { "sony/short", BenchSonyShort },
+    { "virtual/frames", BenchVirtualFrames },
+};
+
+/* ngp_bench [--json=PATH] [filter], PATH - writes the JSON to stdout and the table to stderr */
+int main(int argc, char** argv) {
+    const char* filter = NULL;
+    const char* path   = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--json=", 7) == 0) {
+            path = argv[i] + 7;
+        } else {
+            filter = argv[i];
+        }
+    }
+    FILE* json = NULL;
+    if (path) {
+        json = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+        if (!json) {
+            fprintf(stderr, "ngp_bench: cannot write %s\n", path);
+            return 1;
+        }
+    }
+    NGP_BenchRun(cases, (int)(sizeof(cases) / sizeof(cases[0])), filter, json);
+    if (json && json != stdout) {
+        fclose(json);
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+/*
+Native Game Pad
+Copyright (C) 2021 Christopher Cooper <christopher.michael.cooper@gmail.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "NGP_GamePad.h"
+#include "NGP_Types.h"
+
+/*
+ * Calibration. While it is on, the library learns where each pad's sticks rest and how far every
+ * axis reaches as the pad is used, and maps raw values through that and the axis' response curve
+ * before they reach the state and the events. The mapping is baked into a table of every raw value
+ * per axis, so a report costs one lookup per axis. What is learned is kept per model and serial
+ * number, a pad that reconnects picks up where it left off, and NGP_SaveCalibrations keeps it
+ * across runs. Until a pad has reached further, its axes read full at 3/4 of their nominal range.
+ */
+#define NGP_MAX_CURVE_POINTS 8
+
+typedef enum {
+    NGP_CurveLinear,
+    NGP_CurveExponential, /* out = in ^ Shape, above 1 gives finer control near the center */
+    NGP_CurveSCurve,      /* in^Shape / (in^Shape + (1 - in)^Shape), above 1 is flat at both ends */
+    NGP_CurveSpline,      /* a smooth curve through Points, monotonic between them */
+} NGP_CurveType;
+
+/**
+ * How an axis' calibrated deflection, from 0 at rest to 1 at its furthest, maps to its value.
+ * Sticks apply it to each direction alike.
+ */
+typedef struct {
+    NGP_CurveType Type;
+    float         Shape;      /* NGP_CurveExponential and NGP_CurveSCurve, above 0 */
+    int           PointCount; /* NGP_CurveSpline, 0 to NGP_MAX_CURVE_POINTS */
+    float         Points[NGP_MAX_CURVE_POINTS][2]; /* in, out pairs between 0 and 1, in rising */
+    float         Deadzone;     /* deflection read as 0, the curve spans what is left, 0 to < 1 */
+    float         AntiDeadzone; /* value the axis jumps to leaving the deadzone, 0 to < 1 */
+} NGP_AxisResponse;
+
+/* The raw values an axis rests at and reaches, a trigger rests at its Min */
+typedef struct {
+    int16_t Min;
+    int16_t Center;
+    int16_t Max;
+} NGP_AxisCalibration;
+
+/**
+ * Turns calibration on or off for every game pad. It takes effect at each pad's next report.
+ * @param enabled
+ */
+extern DECLSPEC void NGPCALL NGP_SetCalibrationEnabled(bool enabled);
+
+/**
+ * Sets the response curve of one of the game pad's axes, kept with its calibration
+ * @param p
+ * @param axis
+ * @param response or NULL for linear without deadzones
+ * @return false if the game pad is detached or the response is out of range
+ */
+extern DECLSPEC bool NGPCALL NGP_GamePadSetAxisResponse(NGP_GamePad*            p,
+                                                        NGP_GamePadAxisType     axis,
+                                                        const NGP_AxisResponse* response);
+
+/**
+ * Returns what has been learned about one of the game pad's axes so far
+ * @param p
+ * @param axis
+ * @param calibration
+ * @return false if the game pad is detached
+ */
+extern DECLSPEC bool NGPCALL NGP_GamePadGetAxisCalibration(NGP_GamePad*         p,
+                                                           NGP_GamePadAxisType  axis,
+                                                           NGP_AxisCalibration* calibration);
+
+/**
+ * Forgets what has been learned about the game pad, e.g. after its sticks were replaced. Response
+ * curves are kept.
+ * @param p
+ * @return false if the game pad is detached
+ */
+extern DECLSPEC bool NGPCALL NGP_GamePadResetCalibration(NGP_GamePad* p);
+
+/**
+ * Writes the calibration of every pad seen since the library was loaded to a text file. Response
+ * curves are the application's to restore.
+ * @param path
+ * @return false if the file could not be written
+ */
+extern DECLSPEC bool NGPCALL NGP_SaveCalibrations(const char* path);
+
+/**
+ * Reads calibrations written by NGP_SaveCalibrations, replacing what was learned for those pads
+ * @param path
+ * @return false if the file is missing or not a calibration file, nothing is loaded then
+ */
+extern DECLSPEC bool NGPCALL NGP_LoadCalibrations(const char* path);
@@ -41,6 +41,7 @@ freely, subject to the following restrictions:
 */
 #pragma once
 
+#include <stdbool.h>
 #include "NGP_Types.h"
 
 typedef enum {
@@ -58,8 +59,13 @@ typedef enum {
     NGP_EventTouchpadMotion,
     // NGP_SensorEvent
     NGP_EventSensorData,
+    // NGP_GestureEvent
+    NGP_EventTouchpadGesture,
 } NGP_EventType;
 
+#define NGP_EVENT_MASK(type) (1u << (type))
+#define NGP_EVENT_MASK_ALL 0xffffffffu
+
 typedef struct {
     NGP_GamePadButtonType Button;
     uint8_t               State;
@@ -74,13 +80,37 @@ typedef struct {
 } NGP_AxisEvent;
 
 typedef struct {
-    double X;
-    double Y;
+    double  X;
+    double  Y;
+    uint8_t Finger; /* which of the state's Fingers the contact is in */
+    uint8_t ID;     /* the contact's tracking id, the same from its down event to its up event */
 } NGP_TouchpadEvent;
 
 typedef struct {
+    NGP_GamePadSensorType Sensor;
+    float                 Data[3]; /* m/s^2 for the accelerometer, rad/s for the gyroscope */
 } NGP_SensorEvent;
 
+typedef enum {
+    NGP_GestureTap,    /* one finger down and up again without moving */
+    NGP_GestureSwipe,  /* one finger flicked across the pad and lifted */
+    NGP_GestureScroll, /* two fingers moving together, one event per report they moved in */
+    NGP_GesturePinch,  /* two fingers moving apart or together, one event per report */
+} NGP_GestureType;
+
+/*
+ * Positions are normalized to 0..1 like the state's Fingers, distances are in the same units so a
+ * touchpad width across is 1 even though the pad is wider than it is tall
+ */
+typedef struct {
+    NGP_GestureType Gesture;
+    float           X;     /* where the tap or swipe ended, or the midpoint of the two fingers */
+    float           Y;
+    float           DX;    /* a swipe's velocity per second, a scroll's move since its last event */
+    float           DY;
+    float           Scale; /* a pinch's spread over the spread at its last event, 1 otherwise */
+} NGP_GestureEvent;
+
 typedef struct {
     union {
         NGP_DeviceEvent   DeviceEvent;
@@ -88,8 +118,182 @@ typedef struct {
         NGP_AxisEvent     AxisEvent;
         NGP_TouchpadEvent TouchpadEvent;
         NGP_SensorEvent   SensorEvent;
+        NGP_GestureEvent  GestureEvent;
     } Event;
     NGP_GamePadID GamePadID;
-    NGP_Timestamp Timestamp;
+    NGP_Timestamp Timestamp;        /* when the report behind the event was received */
+    NGP_Timestamp EnqueueTimestamp; /* when the I/O thread queued the event */
+    NGP_Timestamp DequeueTimestamp; /* when NGP_PollEvent(s) returned the event */
     NGP_EventType Kind;
-} NGP_Event;
\ No newline at end of file
+} NGP_Event;
+
+/* Event times are in nanoseconds from NGP_GetTicksNS, see NGP_Latency.h */
+
+/**
+ * Takes the oldest pending event off the library's event queue. Events are produced by the
+ * library's I/O thread and should be consumed from one thread only.
+ * @param event filled in when an event was pending
+ * @return true if an event was returned
+ */
+extern DECLSPEC bool NGPCALL NGP_PollEvent(NGP_Event* event);
+
+/**
+ * Takes up to max pending events off the library's event queue, oldest first
+ * @param events
+ * @param max
+ * @return the number of events written to events
+ */
+extern DECLSPEC int NGPCALL NGP_PollEvents(NGP_Event* events, int max);
+
+/**
+ * Returns how many events were dropped because the queue was full when they were produced, plus
+ * how many NGP_PollEvent(s) lost to overwriting while its policy is NGP_EventPolicyDropOldest
+ * @return
+ */
+extern DECLSPEC uint64_t NGPCALL NGP_EventsDropped(void);
+
+/*
+ * Every event is written once into one shared ring. NGP_PollEvent(s) reads it through the library's
+ * own cursor, and any number of subscribers up to NGP_MAX_EVENT_SUBSCRIBERS read it through theirs,
+ * so readers never take events from each other. A policy decides what a reader that falls a whole
+ * ring behind costs.
+ */
+typedef enum {
+    /* nothing it has not read is overwritten, new events are dropped for every reader instead */
+    NGP_EventPolicyBackpressure,
+    /* the ring never waits for it, unread events are overwritten and it skips over them */
+    NGP_EventPolicyDropOldest,
+} NGP_EventPolicy;
+
+#define NGP_MAX_EVENT_SUBSCRIBERS 15
+
+typedef struct NGP_EventSubscriber NGP_EventSubscriber;
+
+/**
+ * Chooses the policy of the cursor NGP_PollEvent(s) reads through, NGP_EventPolicyBackpressure by
+ * default. Programs that only read through subscribers should set NGP_EventPolicyDropOldest so the
+ * unread library cursor never holds the ring up. While an event callback is set that is automatic:
+ * the policy only applies from the first NGP_PollEvent(s) after NGP_Initialize. Call it from the
+ * thread that polls.
+ * @param policy
+ */
+extern DECLSPEC void NGPCALL NGP_SetEventPolicy(NGP_EventPolicy policy);
+
+/**
+ * Adds a reader that sees every event queued from now on, at its own pace. Each subscriber should
+ * be read from one thread only.
+ * @param policy
+ * @return the subscriber or NULL when NGP_MAX_EVENT_SUBSCRIBERS are already subscribed
+ */
+extern DECLSPEC NGP_EventSubscriber* NGPCALL NGP_SubscribeEvents(NGP_EventPolicy policy);
+
+/**
+ * Removes a subscriber, it must not be used afterwards
+ * @param subscriber
+ */
+extern DECLSPEC void NGPCALL NGP_UnsubscribeEvents(NGP_EventSubscriber* subscriber);
+
+/**
+ * Copies up to max of the subscriber's unread events, oldest first
+ * @param subscriber
+ * @param events
+ * @param max
+ * @return the number of events written to events
+ */
+extern DECLSPEC int NGPCALL NGP_SubscriberPollEvents(NGP_EventSubscriber* subscriber,
+                                                     NGP_Event*           events,
+                                                     int                  max);
+
+/**
+ * Points at the subscriber's oldest unread events inside the ring itself, without copying them.
+ * They stay unread until NGP_SubscriberReleaseEvents.
+ * @param subscriber
+ * @param events set to the first unread event
+ * @return how many events follow it contiguously, there may be more after a release
+ */
+extern DECLSPEC int NGPCALL NGP_SubscriberPeekEvents(NGP_EventSubscriber* subscriber,
+                                                     const NGP_Event**    events);
+
+/**
+ * Marks the first count events of the last peek as read
+ * @param subscriber
+ * @param count
+ * @return false if a NGP_EventPolicyDropOldest subscriber fell so far behind that the ring
+ * overwrote them while they were being read, they must then be discarded and count as dropped
+ */
+extern DECLSPEC bool NGPCALL NGP_SubscriberReleaseEvents(NGP_EventSubscriber* subscriber,
+                                                         int                  count);
+
+/**
+ * Returns how many events a NGP_EventPolicyDropOldest subscriber lost to overwriting. Events a full
+ * ring dropped for every reader are counted by NGP_EventsDropped.
+ * @param subscriber
+ * @return
+ */
+extern DECLSPEC uint64_t NGPCALL NGP_SubscriberEventsDropped(NGP_EventSubscriber* subscriber);
+
+/**
+ * Chooses which kinds of event are queued, the rest are never produced. State getters are not
+ * affected. For example NGP_EVENT_MASK_ALL & ~NGP_EVENT_MASK(NGP_EventSensorData).
+ * @param mask NGP_EVENT_MASK bits of the wanted NGP_EventTypes, NGP_EVENT_MASK_ALL by default
+ */
+extern DECLSPEC void NGPCALL NGP_SetEventMask(uint32_t mask);
+
+/**
+ * Returns the mask set by NGP_SetEventMask
+ * @return
+ */
+extern DECLSPEC uint32_t NGPCALL NGP_GetEventMask(void);
+
+/**
+ * Coalesces axis events for frame locked consumers. Once an axis of a pad changes, its event is
+ * held back until window nanoseconds have passed and then queued once with the latest value, so
+ * at most one event per pad and axis is queued per window. Button events are never held back or
+ * merged, and the held back axis events of a pad are queued ahead of its next button event.
+ * @param window nanoseconds, 0 (the default) queues every change as it happens
+ */
+extern DECLSPEC void NGPCALL NGP_SetAxisCoalescing(NGP_Timestamp window);
+
+/**
+ * Receives the events of one report, or of one attach or detach, all from the same pad
+ * @param events only valid during the call
+ * @param count at least 1
+ * @param userdata as passed to NGP_SetEventCallback
+ */
+typedef void (*NGP_EventCallback)(const NGP_Event* events, int count, void* userdata);
+
+/**
+ * Pushes events to a callback as they happen instead of waiting for the next NGP_PollEvent(s). The
+ * callback runs on a dispatch thread of its own, woken as soon as the I/O thread has queued a whole
+ * report, and reads the event queue through its own cursor, so polling and subscribers are not
+ * affected. A callback too slow to keep up loses its oldest events rather than holding the queue
+ * up. A program that never polls does not hold it up either, but once it has called
+ * NGP_PollEvent(s) it must keep polling: while its backpressure cursor is a whole queue behind,
+ * new events are dropped for the callback too. Either loss is counted by
+ * NGP_EventCallbackDropped. It stays set across NGP_Shutdown and NGP_Initialize. Call it from one
+ * thread at a time, and never from the callback itself.
+ * @param callback NULL stops the dispatch thread, no call is running once this returns
+ * @param userdata
+ * @param mask NGP_EVENT_MASK bits of the kinds to deliver, of those NGP_SetEventMask lets through
+ * @return false if the dispatch thread could not be started
+ */
+extern DECLSPEC bool NGPCALL NGP_SetEventCallback(NGP_EventCallback callback,
+                                                  void*             userdata,
+                                                  uint32_t          mask);
+
+/**
+ * Chooses how the dispatch thread is scheduled. Takes effect right away while a callback is set and
+ * otherwise once one is.
+ * @param priority 1 to 99 for SCHED_FIFO at that priority, 0 (the default) for normal scheduling
+ * @param cpu the CPU to pin the thread to, -1 (the default) for any. Linux only.
+ * @return false if the OS refused it for the running dispatch thread, which usually needs
+ * CAP_SYS_NICE or an RLIMIT_RTPRIO for a real time priority
+ */
+extern DECLSPEC bool NGPCALL NGP_SetEventCallbackScheduling(int priority, int cpu);
+
+/**
+ * Returns how many events the callback lost, because it fell a whole queue behind or because the
+ * queue was full for NGP_PollEvent(s)
+ * @return
+ */
+extern DECLSPEC uint64_t NGPCALL NGP_EventCallbackDropped(void);
@@ -59,16 +59,55 @@ typedef struct {
     float   Pressure;
 } NGP_TouchpadFinger;
 
+#define NGP_MAX_TOUCHPAD_FINGERS 2
+
+/**
+ * One touchpad contact as stored in NGP_GamePadState, X and Y are normalized to 0..1
+ */
+typedef struct {
+    float   X;
+    float   Y;
+    float   Pressure;
+    uint8_t State; /* 1 while the finger is down */
+    uint8_t ID;    /* tracking id, stays the same while the finger stays down */
+} NGP_GamePadStateFinger;
+
+/**
+ * An orientation as a unit quaternion. It rotates vectors from the pad's frame into a world frame
+ * with X to the right, Y forward and Z up, so the identity is the pad lying flat with its handles
+ * towards the player. Yaw is relative to where the pad pointed when tracking started.
+ */
+typedef struct {
+    float W;
+    float X;
+    float Y;
+    float Z;
+} NGP_Quaternion;
+
+/**
+ * A complete, consistent frame of game pad state, as published by the I/O thread after each report
+ */
+typedef struct {
+    NGP_Timestamp          Timestamp; /* when the report this frame came from was received */
+    uint64_t               Sequence;  /* increments with every published frame */
+    int16_t                Axes[NGP_GamePadAxisTypeMax];
+    uint32_t               Buttons; /* bit n is set while NGP_GamePadButtonType n is down */
+    NGP_GamePadStateFinger Fingers[NGP_MAX_TOUCHPAD_FINGERS];
+    float                  Accel[3]; /* m/s^2 */
+    float                  Gyro[3];  /* rad/s */
+    NGP_Quaternion         Orientation; /* fused from Accel and Gyro, 0 without motion sensors */
+} NGP_GamePadState;
+
 typedef struct {
     uint8_t R;
     uint8_t G;
     uint8_t B;
 } NGP_Color;
 
-const NGP_Color NGP_Red;
-const NGP_Color NGP_Green;
-const NGP_Color NGP_Blue;
-const NGP_Color NGP_Purple;
+extern DECLSPEC const NGP_Color NGP_Red;
+extern DECLSPEC const NGP_Color NGP_Green;
+extern DECLSPEC const NGP_Color NGP_Blue;
+extern DECLSPEC const NGP_Color NGP_Purple;
 
 typedef struct {
     double X;
@@ -79,21 +118,97 @@ DECLSPEC double NGPCALL      clamp(double v, double low, double high);
 DECLSPEC double NGPCALL      normalize_axis_double(double d);
 DECLSPEC NGP_Vector2 NGPCALL NormalizeAxis(NGP_Vector2 v);
 
+typedef enum {
+    NGP_DeadzoneNone,
+    NGP_DeadzoneAxial,  /* each axis is zeroed and rescaled on its own */
+    NGP_DeadzoneRadial, /* the stick's distance from center is zeroed and rescaled */
+} NGP_DeadzoneType;
+
+/**
+ * Normalizes count sticks at once into -1..1, the same mapping as NormalizeAxis, then applies a
+ * deadzone and rescales what is left so output still reaches 1 at full tilt. Uses AVX2, SSE2 or
+ * NEON where available. Inputs and outputs are separate X and Y arrays; outputs may not alias inputs.
+ * @param x raw X values, as found in NGP_GamePadState.Axes
+ * @param y raw Y values
+ * @param out_x
+ * @param out_y
+ * @param count number of sticks
+ * @param deadzone fraction of the range to ignore around center, 0 to less than 1
+ * @param type
+ */
+DECLSPEC void NGPCALL NGP_NormalizeSticks(const int16_t* x,
+                                          const int16_t* y,
+                                          float*         out_x,
+                                          float*         out_y,
+                                          int            count,
+                                          float          deadzone,
+                                          NGP_DeadzoneType type);
+
+/**
+ * One motion sensor reading, in the same units and axes as NGP_GamePadState
+ */
+typedef struct {
+    float Accel[3];  /* m/s^2 */
+    float Gyro[3];   /* rad/s, with any bias already removed */
+    float DeltaTime; /* seconds since the previous reading */
+    float Reserved;  /* keeps readings 32 bytes apart for the SIMD kernels */
+} NGP_SensorSample;
+
+/**
+ * Advances count independent orientations by one reading each, with the same Madgwick filter the
+ * library runs for every pad. Meant for replaying buffered readings of many pads at once, a pad's
+ * own readings depend on each other and have to go through one call per reading. Uses SSE2 where
+ * available, NEON only in builds configured with NGP_FUSION_NEON.
+ * @param orientations updated in place, start from the identity or NGP_GamePadState.Orientation
+ * @param samples one per orientation
+ * @param count
+ */
+DECLSPEC void NGPCALL NGP_FuseSensorSamples(NGP_Quaternion*         orientations,
+                                           const NGP_SensorSample* samples,
+                                           int                     count);
+
 typedef struct NGP_GamePad NGP_GamePad;
 
-extern DECLSPEC void NGPCALL NGP_Initialize(void);
+/**
+ * Starts the library. Device I/O runs on a thread owned by the library, this returns once the game
+ * pads that are already connected have been enumerated.
+ * @return true on success
+ */
+extern DECLSPEC bool NGPCALL NGP_Initialize(void);
+
+/**
+ * Stops and joins the library's I/O thread and releases every device. Open game pads report as
+ * detached afterwards but still have to be freed.
+ */
+extern DECLSPEC void NGPCALL NGP_Shutdown(void);
 
 
 extern DECLSPEC int NGPCALL NGP_NumGamePads();
 
 /**
- * Returns a new NGP_GamePad* on success or a nullptr on failure
- * @param joystickIndex the SDL joystick index for this game pad
+ * Returns a new NGP_GamePad* on success or a nullptr on failure. Indices run from 0 to
+ * NGP_NumGamePads() - 1. A pad keeps its index while it stays attached, except that when a pad
+ * detaches, the pad at the last index moves into the index it left.
+ * @param index
  * @return NGP_GamePad* or null
  */
 
 extern DECLSPEC NGP_GamePad* NGPCALL NGP_GamePadOpen(int index);
 
+/**
+ * Opens the game pad an event's GamePadID refers to
+ * @param id
+ * @return NGP_GamePad* or null if that pad is no longer attached, or too many handles are open
+ */
+extern DECLSPEC NGP_GamePad* NGPCALL NGP_GamePadOpenID(NGP_GamePadID id);
+
+/**
+ * Returns the id events for this game pad carry. Ids are never reused for another pad.
+ * @param p
+ * @return
+ */
+extern DECLSPEC NGP_GamePadID NGPCALL NGP_GamePadGetID(NGP_GamePad* p);
+
 /**
  * Frees a gamepad that was opened
  * @param p
@@ -183,6 +298,15 @@ extern DECLSPEC int32_t NGPCALL NGP_GamePadJoystickID(NGP_GamePad* p);
  */
 // SDL_GameController* NGP_GamePadSDL_GameController(NGP_GamePad* p);
 
+/**
+ * Copies the latest complete frame of state for this game pad in one call. The copy never mixes
+ * two reports, unlike reading the same fields through the individual getters below.
+ * @param p
+ * @param state
+ * @return false if the game pad is no longer attached, state is zeroed then
+ */
+extern DECLSPEC bool NGPCALL NGP_GamePadGetState(NGP_GamePad* p, NGP_GamePadState* state);
+
 /**
  * Returns the value of the thumbstick left x axis
  * @param p
@@ -228,6 +352,22 @@ extern DECLSPEC NGP_Vector2 NGPCALL NGP_GamePadLeftStick(NGP_GamePad* p);
  */
 extern DECLSPEC NGP_Vector2 NGPCALL NGP_GamePadRightStick(NGP_GamePad* p);
 
+/**
+ * Returns the pad's orientation, fused from its accelerometer and gyroscope on the I/O thread at
+ * the rate the pad reports them. The gyroscope's bias is learned whenever the pad rests.
+ * @param p
+ * @return the orientation, all 0 if the game pad is detached or has no motion sensors
+ */
+extern DECLSPEC NGP_Quaternion NGPCALL NGP_GamePadOrientation(NGP_GamePad* p);
+
+/**
+ * Makes the pad's current heading the forward direction again, keeping its tilt. Takes effect with
+ * the next sensor reading.
+ * @param p
+ * @return false if the game pad is detached
+ */
+extern DECLSPEC bool NGPCALL NGP_GamePadResetOrientation(NGP_GamePad* p);
+
 /**
  * Returns the left rear trigger state
  * @param p
@@ -250,6 +390,37 @@ extern DECLSPEC int16_t NGPCALL NGP_GamePadAxisTriggerRight(NGP_GamePad* p);
  */
 extern DECLSPEC int16_t NGPCALL NGP_GamePadAxis(NGP_GamePad* p, NGP_GamePadAxisType axis);
 
+/**
+ * Returns an axis as it is at a given time rather than as of the last report, e.g. at the time the
+ * frame being built will be displayed. The library keeps the axes of each pad's last 16 reports.
+ * Between two of them the value is interpolated, past the last one it is predicted along the slope
+ * of the last two, at most 32 ms ahead. A pad that has gone without a report for twice its usual
+ * interval is taken to have stopped and is not predicted.
+ * @param p
+ * @param axis
+ * @param target a time from NGP_GetTicksNS, like the events' Timestamp
+ * @return the value, 0 if the game pad is detached
+ */
+extern DECLSPEC int16_t NGPCALL NGP_GamePadAxisAt(NGP_GamePad*        p,
+                                                  NGP_GamePadAxisType axis,
+                                                  NGP_Timestamp       target);
+
+/**
+ * Returns the X and Y data for the left thumbstick at a given time, see NGP_GamePadAxisAt
+ * @param p
+ * @param target
+ * @return
+ */
+extern DECLSPEC NGP_Vector2 NGPCALL NGP_GamePadLeftStickAt(NGP_GamePad* p, NGP_Timestamp target);
+
+/**
+ * Returns the X and Y data for the right thumbstick at a given time, see NGP_GamePadAxisAt
+ * @param p
+ * @param target
+ * @return
+ */
+extern DECLSPEC NGP_Vector2 NGPCALL NGP_GamePadRightStickAt(NGP_GamePad* p, NGP_Timestamp target);
+
 /**
  * Returns the game pad vendor ID, if there is one.
  * @param p
@@ -273,12 +444,13 @@ extern DECLSPEC uint16_t NGPCALL NGP_GamePadProductVersion(NGP_GamePad* p);
 
 /**
  * Start a rumble effect on the given game pad for the given duration in milliseconds.
- * Range is from 0 to 65535 for low_freq and high_freq
+ * Range is from 0 to 65535 for low_freq and high_freq. The effect is mixed with the ones
+ * started by NGP_GamePadPlayEffect, a later call replaces it.
  * @param p
  * @param low_freq
  * @param high_freq
- * @param duration_ms
- * @return
+ * @param duration_ms how long until the motors stop, 0 keeps them running until the next call
+ * @return 0 on success, -1 if the game pad is detached or cannot rumble
  */
 extern DECLSPEC int NGPCALL NGP_GamePadRumble(NGP_GamePad* p,
                                               uint16_t     low_freq,
@@ -293,12 +465,12 @@ extern DECLSPEC int NGPCALL NGP_GamePadRumble(NGP_GamePad* p,
 extern DECLSPEC bool NGPCALL NGP_GamePadRumbleSupported(NGP_GamePad* p);
 
 /**
- * Starts a rumble effect in the game pad triggers if supported
+ * Starts a rumble effect in the game pad triggers if supported, a later call replaces it
  * @param p
  * @param left
  * @param right
- * @param duration_ms
- * @return
+ * @param duration_ms 0 keeps them running until the next call
+ * @return 0 on success, -1 if the game pad is detached or has no trigger motors
  */
 extern DECLSPEC int NGPCALL NGP_GamePadRumbleTriggers(NGP_GamePad* p,
                                                       uint16_t     left,
@@ -316,8 +488,8 @@ extern DECLSPEC bool NGPCALL NGP_GamePadRumbleTriggersSupported(NGP_GamePad* p);
  * Start a rumble effect in the left trigger
  * @param p
  * @param left
- * @param duration_ms
- * @return
+ * @param duration_ms 0 keeps it running until the next call
+ * @return 0 on success, -1 if the game pad is detached or has no trigger motors
  */
 extern DECLSPEC int NGPCALL NGP_GamePadRumbleLeftTrigger(NGP_GamePad* p,
                                                          uint16_t     left,
@@ -327,8 +499,8 @@ extern DECLSPEC int NGPCALL NGP_GamePadRumbleLeftTrigger(NGP_GamePad* p,
  * Start a rumble effect in the right trigger
  * @param p
  * @param right
- * @param duration_ms
- * @return
+ * @param duration_ms 0 keeps it running until the next call
+ * @return 0 on success, -1 if the game pad is detached or has no trigger motors
  */
 extern DECLSPEC int NGPCALL NGP_GamePadRumbleRightTrigger(NGP_GamePad* p,
                                                           uint16_t     right,
@@ -342,23 +514,42 @@ extern DECLSPEC int NGPCALL NGP_GamePadRumbleRightTrigger(NGP_GamePad* p,
 extern DECLSPEC bool NGPCALL NGP_GamePadHasLED(NGP_GamePad* p);
 
 /**
- * Set the LED to the given RGB values
+ * Set the LED to the given RGB values. The write is queued and sent from the library's I/O
+ * thread, so calling this every frame is fine: only the latest colour is ever written.
  * @param p
  * @param red
  * @param green
  * @param blue
- * @return
+ * @return false if the game pad is detached or has no LED
  */
 extern DECLSPEC bool NGPCALL NGP_GamePadSetLED(NGP_GamePad* p, uint8_t red, uint8_t green, uint8_t blue);
 
 /**
- * Set the LED to the given Color
+ * Set the LED to the given Color, see NGP_GamePadSetLED
  * @param p
  * @param c
- * @return
+ * @return false if the game pad is detached or has no LED
  */
 extern DECLSPEC bool NGPCALL NGP_GamePadSetLEDColor(NGP_GamePad* p, NGP_Color c);
 
+/**
+ * Receives the outcome of one output report write, which carries a pad's latest LED colour and
+ * rumble together
+ * @param id the pad written to
+ * @param sent false if the write failed, the latest values are written again one output interval
+ * later and reported again then
+ * @param userdata as passed to NGP_SetOutputCallback
+ */
+typedef void (*NGP_OutputCallback)(NGP_GamePadID id, bool sent, void* userdata);
+
+/**
+ * Sets a callback run after every output report write. It runs on the library's I/O thread, so
+ * keep it short, input is not read while it runs. Never call this from the callback itself.
+ * @param callback NULL for none, no call to the previous one is running once this returns
+ * @param userdata
+ */
+extern DECLSPEC void NGPCALL NGP_SetOutputCallback(NGP_OutputCallback callback, void* userdata);
+
 /**
  * Return the current status of the button on the given controller
  * @param p
@@ -367,6 +558,43 @@ extern DECLSPEC bool NGPCALL NGP_GamePadSetLEDColor(NGP_GamePad* p, NGP_Color c)
  */
 extern DECLSPEC uint8_t NGPCALL NGP_GamePadButton(NGP_GamePad* p, NGP_GamePadButtonType button);
 
+/* The bit of a button in the masks below, OR them together for a chord */
+#define NGP_BUTTON_MASK(button) (1u << (button))
+
+/**
+ * Returns every button held, bit n set while NGP_GamePadButtonType n is down, and starts a new
+ * frame for the handle: NGP_GamePadButtonsPressed and NGP_GamePadButtonsReleased then report what
+ * changed between the previous call and this one. Call it once per frame per handle.
+ * @param p
+ * @return the mask, 0 if the game pad is detached
+ */
+extern DECLSPEC uint32_t NGPCALL NGP_GamePadButtons(NGP_GamePad* p);
+
+/**
+ * Returns the buttons that went down between the handle's last two NGP_GamePadButtons calls, even
+ * those that already went back up
+ * @param p
+ * @return the mask
+ */
+extern DECLSPEC uint32_t NGPCALL NGP_GamePadButtonsPressed(NGP_GamePad* p);
+
+/**
+ * Returns the buttons that went up between the handle's last two NGP_GamePadButtons calls, even
+ * those that already went back down
+ * @param p
+ * @return the mask
+ */
+extern DECLSPEC uint32_t NGPCALL NGP_GamePadButtonsReleased(NGP_GamePad* p);
+
+/**
+ * Returns whether every button of a chord is held as of the handle's frame and the last of them
+ * went down in it, so a chord is reported once per time it is made
+ * @param p
+ * @param chord NGP_BUTTON_MASK of each button ORed together
+ * @return
+ */
+extern DECLSPEC bool NGPCALL NGP_GamePadChordPressed(NGP_GamePad* p, uint32_t chord);
+
 /**
  * Return the game pad button name for a given button
  * @param button
@@ -0,0 +1,86 @@
+/*
+Native Game Pad
+Copyright (C) 2021 Christopher Cooper <christopher.michael.cooper@gmail.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "NGP_GamePad.h"
+#include "NGP_Types.h"
+
+/*
+ * Haptics. Any number of effects can play on a game pad at once, the library mixes them per motor
+ * at NGP_HAPTICS_TICK_HZ on its I/O thread and only writes to the pad when the mix changes. On each
+ * motor only the highest priority effects playing on it are heard, effects of equal priority add
+ * up. NGP_GamePadRumble and the trigger rumble calls play effects too, each replacing the one the
+ * previous call of the same function started.
+ */
+#define NGP_HAPTICS_TICK_HZ 250
+#define NGP_HAPTICS_INFINITE UINT32_MAX /* SustainMs that holds an effect until it is stopped */
+
+typedef enum {
+    NGP_HapticsMotorLow,  /* the heavy, low frequency motor in the left grip */
+    NGP_HapticsMotorHigh, /* the light, high frequency motor in the right grip */
+    NGP_HapticsMotorLeftTrigger,
+    NGP_HapticsMotorRightTrigger,
+    NGP_HapticsMotorMax,
+} NGP_HapticsMotor;
+
+/**
+ * An ADSR envelope scaled by a peak strength per motor. The strength ramps from 0 to the peak over
+ * AttackMs, falls to SustainLevel over DecayMs, holds for SustainMs and falls to 0 over ReleaseMs.
+ */
+typedef struct {
+    uint16_t Strength[NGP_HapticsMotorMax]; /* peak strength, 0 to 65535 */
+    uint16_t SustainLevel;                  /* fraction of the peak, 0 to 65535 for 0 to 1 */
+    uint32_t AttackMs;
+    uint32_t DecayMs;
+    uint32_t SustainMs; /* or NGP_HAPTICS_INFINITE */
+    uint32_t ReleaseMs; /* also how long an effect takes to fade out when stopped early */
+    int32_t  Priority;  /* higher wins, the rumble calls play at 0 */
+} NGP_HapticsEffect;
+
+typedef int32_t NGP_HapticsEffectID;
+
+#define NGP_INVALID_HAPTICS_EFFECT_ID (-1)
+
+/**
+ * Starts an effect on the game pad, from any thread. Motors the pad does not have are ignored.
+ * @param p
+ * @param effect
+ * @return an id for NGP_GamePadStopEffect, or NGP_INVALID_HAPTICS_EFFECT_ID if the game pad is
+ * detached, cannot rumble or already plays 64 effects
+ */
+extern DECLSPEC NGP_HapticsEffectID NGPCALL NGP_GamePadPlayEffect(NGP_GamePad*             p,
+                                                                  const NGP_HapticsEffect* effect);
+
+/**
+ * Moves an effect to its release, it fades out over its ReleaseMs
+ * @param p
+ * @param effect
+ * @return false if the effect has already finished
+ */
+extern DECLSPEC bool NGPCALL NGP_GamePadStopEffect(NGP_GamePad* p, NGP_HapticsEffectID effect);
+
+/**
+ * Stops every effect on the game pad at once, without their release
+ * @param p
+ */
+extern DECLSPEC void NGPCALL NGP_GamePadStopAllEffects(NGP_GamePad* p);
@@ -0,0 +1,78 @@
+/*
+Native Game Pad
+Copyright (C) 2021 Christopher Cooper <christopher.michael.cooper@gmail.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "NGP_Types.h"
+
+/*
+ * Input latency. Each NGP_Event carries three times, all read from the clock behind NGP_GetTicksNS.
+ * Timestamp is when the OS handed the library the report, EnqueueTimestamp is when the I/O thread
+ * queued the event and DequeueTimestamp is when NGP_PollEvent(s) returned it. NGP_PollEvent(s)
+ * also add the differences to a histogram per pad and stage, NGP_GetLatencyStats reads them.
+ */
+typedef enum {
+    NGP_LatencyStageDelivery, /* report to enqueue, the OS waking the library up plus decoding */
+    NGP_LatencyStageQueue,    /* enqueue to dequeue, how long the event waited for the app */
+    NGP_LatencyStageTotal,    /* report to dequeue */
+    NGP_LatencyStageMax,
+} NGP_LatencyStage;
+
+/**
+ * Percentiles are read from a log-linear histogram and are within about 3% of the exact value
+ */
+typedef struct {
+    uint64_t Count;
+    uint64_t P50; /* ns */
+    uint64_t P99; /* ns */
+    uint64_t Max; /* ns, exact */
+} NGP_LatencyStageStats;
+
+typedef struct {
+    NGP_LatencyStageStats Stages[NGP_LatencyStageMax];
+} NGP_LatencyStats;
+
+/**
+ * Returns a monotonic time in nanoseconds, the clock event and state timestamps are taken from
+ */
+extern DECLSPEC NGP_Timestamp NGPCALL NGP_GetTicksNS(void);
+
+/**
+ * Fills in the latency of every event polled for the pad so far. Can be called from any thread,
+ * but the numbers are only exact when called from the thread that polls events.
+ * @param id
+ * @param stats
+ * @return false if no event for the pad has been polled yet
+ */
+extern DECLSPEC bool NGPCALL NGP_GetLatencyStats(NGP_GamePadID id, NGP_LatencyStats* stats);
+
+/**
+ * Clears every pad's histograms, call from the thread that polls events
+ */
+extern DECLSPEC void NGPCALL NGP_ResetLatencyStats(void);
+
+/**
+ * Returns how long the first game pad took to attach after NGP_Initialize was called, from the
+ * start of enumeration to the pad's attached event being queued
+ * @return ns, 0 until a pad has attached
+ */
+extern DECLSPEC NGP_Timestamp NGPCALL NGP_GetTimeToFirstGamePad(void);
@@ -0,0 +1,61 @@
+/*
+Native Game Pad
+Copyright (C) 2021 Christopher Cooper <christopher.michael.cooper@gmail.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "NGP_Types.h"
+
+typedef void* (*NGP_MallocFunc)(size_t size);
+typedef void* (*NGP_CallocFunc)(size_t count, size_t size);
+typedef void* (*NGP_ReallocFunc)(void* ptr, size_t size);
+typedef void (*NGP_FreeFunc)(void* ptr);
+
+/**
+ * Replaces the functions the library allocates with, the C library's by default. Must be called
+ * before anything else in the library, memory it already holds is not moved over.
+ *
+ * Allocations are front loaded: device records, backend records and NGP_GamePad handles come from
+ * fixed capacity pools that only allocate the first time they grow, and pad names and serials are
+ * interned once per distinct string. Once every pad has been seen, attaching, detaching, opening
+ * and closing pads does not call these at all.
+ * @param malloc_func
+ * @param calloc_func
+ * @param realloc_func
+ * @param free_func
+ * @return false if any of them is NULL
+ */
+extern DECLSPEC bool NGPCALL NGP_SetMemoryFunctions(NGP_MallocFunc  malloc_func,
+                                                    NGP_CallocFunc  calloc_func,
+                                                    NGP_ReallocFunc realloc_func,
+                                                    NGP_FreeFunc    free_func);
+
+/**
+ * Returns the functions set by NGP_SetMemoryFunctions, any of the pointers may be NULL
+ * @param malloc_func
+ * @param calloc_func
+ * @param realloc_func
+ * @param free_func
+ */
+extern DECLSPEC void NGPCALL NGP_GetMemoryFunctions(NGP_MallocFunc*  malloc_func,
+                                                    NGP_CallocFunc*  calloc_func,
+                                                    NGP_ReallocFunc* realloc_func,
+                                                    NGP_FreeFunc*    free_func);
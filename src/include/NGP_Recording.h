@@ -0,0 +1,60 @@
+/*
+Native Game Pad
+Copyright (C) 2021 Christopher Cooper <christopher.michael.cooper@gmail.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include "NGP_Types.h"
+
+typedef enum {
+    NGP_ReplaySpeedRealTime, /* frames are delivered with the gaps they were recorded with */
+    NGP_ReplaySpeedMax,      /* as fast as the event queue is drained, nothing is ever dropped */
+} NGP_ReplaySpeed;
+
+/**
+ * Starts writing every attached game pad and every frame they report to a recording file. Pads
+ * that attach or detach while recording are recorded too.
+ * @param path
+ * @return false if the file could not be created or a recording is already running
+ */
+extern DECLSPEC bool NGPCALL NGP_StartRecording(const char* path);
+
+/**
+ * Finishes and closes the current recording, if any
+ */
+extern DECLSPEC void NGPCALL NGP_StopRecording(void);
+
+/**
+ * Initializes the library with a recording in place of the platform's devices. The recorded pads
+ * attach and report through the usual NGP_GamePad and NGP_PollEvent API, frame for frame as they
+ * were recorded. At either speed frames keep their recorded spacing: each is stamped with the
+ * time the first frame was delivered plus its recorded offset from it, so motion fusion, gestures
+ * and axis history come out the same on every run. Shut down with NGP_Shutdown like after
+ * NGP_Initialize.
+ * @param path a file written by NGP_StartRecording, mapped rather than read
+ * @param speed
+ * @return false if the file is missing or not a recording, or the library is already running
+ */
+extern DECLSPEC bool NGPCALL NGP_InitializeReplay(const char* path, NGP_ReplaySpeed speed);
+
+/**
+ * Returns whether the replay started by NGP_InitializeReplay has delivered its last frame
+ */
+extern DECLSPEC bool NGPCALL NGP_ReplayFinished(void);
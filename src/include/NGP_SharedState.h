@@ -0,0 +1,100 @@
+/*
+Native Game Pad
+Copyright (C) 2021 Christopher Cooper <christopher.michael.cooper@gmail.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "NGP_GamePad.h"
+#include "NGP_Types.h"
+
+/*
+ * Live pad state for other processes. The library writes every attached pad's latest frame into a
+ * POSIX shared memory object, each pad under its own sequence lock, and clients in any process map
+ * it read only. A client read is a copy out of the mapping with no system call and never holds up
+ * the library, so an overlay or telemetry process can watch pads without opening them itself.
+ */
+
+#define NGP_SHARED_NAME_LEN 64
+
+typedef struct {
+    NGP_GamePadID    ID; /* the id the exporting process knows the pad by */
+    uint16_t         VendorID;
+    uint16_t         ProductID;
+    char             Name[NGP_SHARED_NAME_LEN]; /* cut short if longer */
+    NGP_GamePadState State;
+} NGP_SharedGamePad;
+
+typedef struct NGP_SharedStateClient NGP_SharedStateClient;
+
+/**
+ * Starts publishing every attached game pad and every frame they report into a shared memory
+ * object, creating or replacing it. Pads that attach or detach meanwhile are published too.
+ * @param name a shm_open name such as "/ngp-state"
+ * @return false if the object could not be created or an export is already running
+ */
+extern DECLSPEC bool NGPCALL NGP_StartSharedState(const char* name);
+
+/**
+ * Stops publishing and removes the shared memory object. Clients still attached see it as stopped.
+ */
+extern DECLSPEC void NGPCALL NGP_StopSharedState(void);
+
+/**
+ * Attaches read only to the shared memory object of a process running NGP_StartSharedState. Does
+ * not need NGP_Initialize.
+ * @param name
+ * @return the client or NULL if there is no such object or it was written by an incompatible build
+ */
+extern DECLSPEC NGP_SharedStateClient* NGPCALL NGP_SharedStateOpen(const char* name);
+
+/**
+ * Detaches from the shared memory object
+ * @param client
+ */
+extern DECLSPEC void NGPCALL NGP_SharedStateClose(NGP_SharedStateClient* client);
+
+/**
+ * Returns whether the exporting process is still publishing, false once it called
+ * NGP_StopSharedState. A process that died without stopping still reads as live.
+ * @param client
+ * @return
+ */
+extern DECLSPEC bool NGPCALL NGP_SharedStateIsLive(const NGP_SharedStateClient* client);
+
+/**
+ * Walks the slots that hold a pad: start with -1, pass each result back in until -1 is returned
+ * @param client
+ * @param slot
+ * @return the next slot after slot holding a pad, or -1
+ */
+extern DECLSPEC int NGPCALL NGP_SharedStateNextGamePad(const NGP_SharedStateClient* client,
+                                                       int                          slot);
+
+/**
+ * Copies the pad in a slot, consistent even while the library is writing it
+ * @param client
+ * @param slot from NGP_SharedStateNextGamePad
+ * @param pad
+ * @return false if the slot is empty or kept changing under the copy
+ */
+extern DECLSPEC bool NGPCALL NGP_SharedStateRead(const NGP_SharedStateClient* client,
+                                                 int                          slot,
+                                                 NGP_SharedGamePad*           pad);
@@ -135,6 +135,7 @@ typedef enum {
     NGP_GamePadAxisTypeRightY,
     NGP_GamePadAxisTypeTriggerLeft,
     NGP_GamePadAxisTypeTriggerRight,
+    NGP_GamePadAxisTypeMax,
 } NGP_GamePadAxisType;
 
 /**
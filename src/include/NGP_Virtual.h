@@ -0,0 +1,126 @@
+/*
+Native Game Pad
+Copyright (C) 2021 Christopher Cooper <christopher.michael.cooper@gmail.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "NGP_Types.h"
+
+/*
+ * Virtual game pads, for running without hardware. NGP_InitializeVirtual starts the library with
+ * virtual pads in place of the platform's devices. They attach, report and detach through the same
+ * NGP_GamePad and NGP_PollEvent API as real pads.
+ *
+ * The NGP_VirtualGamePad* functions can be called from any thread. They queue the change for the
+ * library's I/O thread, which applies it like a backend decoding a report. Changes become visible
+ * to NGP_GamePadGetState together when NGP_VirtualGamePadCommit is called, and events for them are
+ * queued in the order they were made.
+ */
+typedef struct NGP_VirtualGamePad NGP_VirtualGamePad;
+
+/**
+ * Initializes the library with no devices but virtual ones. Shut down with NGP_Shutdown, which
+ * detaches and frees every virtual pad that is left.
+ * @return false if the library is already running
+ */
+extern DECLSPEC bool NGPCALL NGP_InitializeVirtual(void);
+
+/**
+ * Creates and attaches a virtual pad
+ * @param name
+ * @param vendor_id
+ * @param product_id
+ * @return the pad, or NULL if the library was not initialized with NGP_InitializeVirtual or
+ * 4096 virtual pads already exist
+ */
+extern DECLSPEC NGP_VirtualGamePad* NGPCALL NGP_VirtualGamePadCreate(const char* name,
+                                                                     uint16_t    vendor_id,
+                                                                     uint16_t    product_id);
+
+/**
+ * Detaches and frees a virtual pad. The pointer must not be used afterwards.
+ * @param pad
+ */
+extern DECLSPEC void NGPCALL NGP_VirtualGamePadDestroy(NGP_VirtualGamePad* pad);
+
+extern DECLSPEC void NGPCALL NGP_VirtualGamePadSetAxis(NGP_VirtualGamePad* pad,
+                                                       NGP_GamePadAxisType axis,
+                                                       int16_t             value);
+
+extern DECLSPEC void NGPCALL NGP_VirtualGamePadSetButton(NGP_VirtualGamePad*   pad,
+                                                         NGP_GamePadButtonType button,
+                                                         bool                  pressed);
+
+/**
+ * Puts a finger down on, moves it on or lifts it from the pad's touchpad
+ * @param pad
+ * @param finger 0 or 1
+ * @param down
+ * @param x 0 to 1, left to right
+ * @param y 0 to 1, top to bottom
+ * @param pressure 0 to 1
+ */
+extern DECLSPEC void NGPCALL NGP_VirtualGamePadSetFinger(NGP_VirtualGamePad* pad,
+                                                         int                 finger,
+                                                         bool                down,
+                                                         float               x,
+                                                         float               y,
+                                                         float               pressure);
+
+/**
+ * @param pad
+ * @param sensor
+ * @param data m/s^2 for the accelerometer, rad/s for the gyroscope
+ */
+extern DECLSPEC void NGPCALL NGP_VirtualGamePadSetSensor(NGP_VirtualGamePad*   pad,
+                                                         NGP_GamePadSensorType sensor,
+                                                         const float           data[3]);
+
+/**
+ * Publishes every change made since the last commit as one frame, like the end of a HID report
+ * @param pad
+ */
+extern DECLSPEC void NGPCALL NGP_VirtualGamePadCommit(NGP_VirtualGamePad* pad);
+
+/**
+ * Waits until the I/O thread has applied every change queued before this call
+ */
+extern DECLSPEC void NGPCALL NGP_VirtualSync(void);
+
+/**
+ * Runs a script of virtual pad commands on the calling thread, one per line:
+ *
+ *   create <pad> [name]            creates pad number <pad> (0-255, the script's own numbering)
+ *   destroy <pad>
+ *   axis <pad> <axis> <value>      axis is leftx, lefty, rightx, righty, lefttrigger or righttrigger
+ *   button <pad> <button> <0|1>    button is a name from NGP_GamePadButtonName
+ *   touch <pad> <finger> <0|1> <x> <y> [pressure]
+ *   sensor <pad> <accel|gyro> <x> <y> <z>
+ *   commit <pad>
+ *   sync
+ *   wait <milliseconds>
+ *
+ * Blank lines and lines starting with # are skipped. Pads the script created and did not destroy
+ * are left attached.
+ * @param script
+ * @return 0 on success, or the number of the first line that could not be run
+ */
+extern DECLSPEC int NGPCALL NGP_VirtualRunScript(const char* script);
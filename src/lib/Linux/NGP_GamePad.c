@@ -0,0 +1,736 @@
+/*
+Native Game Pad
+Copyright (C) 2021 Christopher Cooper <christopher.michael.cooper@gmail.com>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+The code below dealing with GamePads on Linux is original, but the evdev capability checks
+follow the approach SDL takes in its Linux joystick driver:
+
+Simple DirectMedia Layer
+Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifdef __linux__
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/hidraw.h>
+#include <linux/input.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <NGP_GamePad.h>
+#include <NGP_USB_IDS.h>
+#include "../NGP_Device.h"
+#include "../NGP_DeviceTable.h"
+#include "../NGP_Enumeration.h"
+#include "../NGP_Runtime.h"
+#include "../NGP_SonyReport.h"
+
+#define NGP_DEV_INPUT "/dev/input"
+#define NGP_EPOLL_MAX_EVENTS 32
+#define BUF_LEN 256
+/* room for any directory entry name after the longest prefix one is joined to, /dev/input/ */
+#define NGP_DEV_PATH_LEN (sizeof(NGP_DEV_INPUT "/") + sizeof(((struct dirent*)0)->d_name))
+#define NGP_MAX_IO_DEVICES 64 /* physical pads, the device table itself holds far more */
+
+/* epoll user data for the fds that are not game pads */
+#define NGP_EPOLL_INOTIFY UINT64_MAX
+#define NGP_EPOLL_WAKE (UINT64_MAX - 1)
+/* set on a pad's index when the fd is its hidraw node rather than its evdev node */
+#define NGP_EPOLL_HIDRAW (1ULL << 32)
+#define NGP_HIDRAW_REPORT_LEN 128
+
+#define NGP_NBITS(x) ((((x)-1) / (sizeof(long) * 8)) + 1)
+#define NGP_TEST_BIT(nr, addr) \
+    ((((addr)[(nr) / (sizeof(long) * 8)]) >> ((nr) % (sizeof(long) * 8))) & 1UL)
+
+typedef struct NGP_IODevice {
+    int         fd;        /* evdev handle, the one we read input from */
+    int         hidraw_fd; /* matching hidraw node for feature/output reports, or -1 */
+    const char* path;      /* interned, the key the pad is tracked under */
+    NGP_Device* device;
+
+    /* DualShock 4 and DualSense pads are read from hidraw, which also carries touch and motion */
+    const NGP_DeviceInfo* info; /* the pad's device table entry, or NULL */
+    NGP_SonyModel         sony;
+
+    NGP_FeatureRead serial_read;      /* the pad is attached once this one completes */
+    NGP_FeatureRead calibration_read; /* switches Bluetooth Sony pads to full reports */
+
+    struct input_absinfo abs[ABS_CNT]; /* ranges, used to rescale into the NGP axis range */
+    bool                 dropping;     /* since SYN_DROPPED, until the next SYN_REPORT re-reads */
+} NGP_IODevice;
+
+typedef struct NGP_DeviceManager {
+    NGP_IODevice    io_devices[NGP_MAX_IO_DEVICES];
+    NGP_Enumeration known; /* the pads in io_devices by evdev path */
+    int             epoll_fd;
+    int          inotify_fd;
+    int          wake_fd;
+} NGP_DeviceManager;
+
+static NGP_DeviceManager manager;
+
+/*
+ * evdev key codes for each NGP_GamePadButtonType, following the kernel gamepad API
+ * (Documentation/input/gamepad.rst). BTN_TRIGGER_HAPPY1-4 are d-pad buttons on xpad,
+ * BTN_TRIGGER_HAPPY5-8 are the Elite paddles.
+ */
+static NGP_GamePadButtonType ButtonForKey(uint16_t code) {
+    switch (code) {
+        case BTN_SOUTH:
+            return NGP_GamePadButtonA;
+        case BTN_EAST:
+            return NGP_GamePadButtonB;
+        case BTN_WEST:
+            return NGP_GamePadButtonX;
+        case BTN_NORTH:
+            return NGP_GamePadButtonY;
+        case BTN_SELECT:
+            return NGP_GamePadButtonBack;
+        case BTN_MODE:
+            return NGP_GamePadButtonGuide;
+        case BTN_START:
+            return NGP_GamePadButtonStart;
+        case BTN_THUMBL:
+            return NGP_GamePadButtonLeftStick;
+        case BTN_THUMBR:
+            return NGP_GamePadButtonRightStick;
+        case BTN_TL:
+            return NGP_GamePadButtonLeftShoulder;
+        case BTN_TR:
+            return NGP_GamePadButtonRightShoulder;
+        case BTN_DPAD_UP:
+        case BTN_TRIGGER_HAPPY3:
+            return NGP_GamePadButtonDPadUp;
+        case BTN_DPAD_DOWN:
+        case BTN_TRIGGER_HAPPY4:
+            return NGP_GamePadButtonDPadDown;
+        case BTN_DPAD_LEFT:
+        case BTN_TRIGGER_HAPPY1:
+            return NGP_GamePadButtonDPadLeft;
+        case BTN_DPAD_RIGHT:
+        case BTN_TRIGGER_HAPPY2:
+            return NGP_GamePadButtonDPadRight;
+        case KEY_RECORD:
+            return NGP_GamePadButtonMisc1;
+        case BTN_TRIGGER_HAPPY5:
+            return NGP_GamePadButtonPaddle1;
+        case BTN_TRIGGER_HAPPY6:
+            return NGP_GamePadButtonPaddle2;
+        case BTN_TRIGGER_HAPPY7:
+            return NGP_GamePadButtonPaddle3;
+        case BTN_TRIGGER_HAPPY8:
+            return NGP_GamePadButtonPaddle4;
+        default:
+            return NGP_GamePadButtonInvalid;
+    }
+}
+
+static int AxisForAbs(uint16_t code) {
+    switch (code) {
+        case ABS_X:
+            return NGP_GamePadAxisTypeLeftX;
+        case ABS_Y:
+            return NGP_GamePadAxisTypeLeftY;
+        case ABS_RX:
+            return NGP_GamePadAxisTypeRightX;
+        case ABS_RY:
+            return NGP_GamePadAxisTypeRightY;
+        case ABS_Z:
+        case ABS_BRAKE:
+            return NGP_GamePadAxisTypeTriggerLeft;
+        case ABS_RZ:
+        case ABS_GAS:
+            return NGP_GamePadAxisTypeTriggerRight;
+        default:
+            return -1;
+    }
+}
+
+/* Rescales an evdev absolute value into the NGP range, sticks are signed and triggers are 0..max */
+static int16_t ScaleAxis(const struct input_absinfo* info, int axis, int32_t value) {
+    int64_t range = (int64_t)info->maximum - info->minimum;
+    if (range <= 0) {
+        return 0;
+    }
+    if (value < info->minimum) {
+        value = info->minimum;
+    } else if (value > info->maximum) {
+        value = info->maximum;
+    }
+    int64_t v = (int64_t)value - info->minimum;
+    if (axis >= NGP_GamePadAxisTypeTriggerLeft) {
+        return (int16_t)(v * NGP_THUMBSTICK_AXIS_MAX / range);
+    }
+    return (int16_t)(v * (NGP_THUMBSTICK_AXIS_MAX - NGP_THUMBSTICK_AXIS_MIN) / range +
+                     NGP_THUMBSTICK_AXIS_MIN);
+}
+
+static void SetHat(NGP_Device* device, uint16_t code, int32_t value) {
+    if (code == ABS_HAT0X) {
+        NGP_DeviceSetButton(device, NGP_GamePadButtonDPadLeft, value < 0);
+        NGP_DeviceSetButton(device, NGP_GamePadButtonDPadRight, value > 0);
+    } else if (code == ABS_HAT0Y) {
+        NGP_DeviceSetButton(device, NGP_GamePadButtonDPadUp, value < 0);
+        NGP_DeviceSetButton(device, NGP_GamePadButtonDPadDown, value > 0);
+    }
+}
+
+static void HandleAbs(NGP_IODevice* io, uint16_t code, int32_t value) {
+    if (code == ABS_HAT0X || code == ABS_HAT0Y) {
+        SetHat(io->device, code, value);
+        return;
+    }
+    int axis = AxisForAbs(code);
+    if (axis >= 0) {
+        NGP_DeviceSetAxis(io->device, axis, ScaleAxis(&io->abs[code], axis, value));
+    }
+}
+
+/* Re-reads the full device state, used on open and after the kernel drops events */
+static void SyncDeviceState(NGP_IODevice* io) {
+    unsigned long keys[NGP_NBITS(KEY_CNT)] = { 0 };
+    if (ioctl(io->fd, EVIOCGKEY(sizeof(keys)), keys) >= 0) {
+        for (uint16_t code = BTN_MISC; code < KEY_CNT; code++) {
+            NGP_GamePadButtonType button = ButtonForKey(code);
+            if (button != NGP_GamePadButtonInvalid) {
+                NGP_DeviceSetButton(io->device, button, NGP_TEST_BIT(code, keys));
+            }
+        }
+        NGP_DeviceSetButton(io->device, NGP_GamePadButtonMisc1, NGP_TEST_BIT(KEY_RECORD, keys));
+    }
+    for (uint16_t code = 0; code < ABS_CNT; code++) {
+        if (io->abs[code].maximum == io->abs[code].minimum) {
+            continue;
+        }
+        struct input_absinfo info;
+        if (ioctl(io->fd, EVIOCGABS(code), &info) >= 0) {
+            HandleAbs(io, code, info.value);
+        }
+    }
+    NGP_DeviceBeginReport(io->device, NGP_GetTicksNS());
+    NGP_DevicePublish(io->device);
+}
+static bool IsGamePad(int fd) {
+    unsigned long evbit[NGP_NBITS(EV_CNT)]   = { 0 };
+    unsigned long keybit[NGP_NBITS(KEY_CNT)] = { 0 };
+    unsigned long absbit[NGP_NBITS(ABS_CNT)] = { 0 };
+
+    if (ioctl(fd, EVIOCGBIT(0, sizeof(evbit)), evbit) < 0 ||
+        ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keybit)), keybit) < 0 ||
+        ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(absbit)), absbit) < 0) {
+        return false;
+    }
+    if (!NGP_TEST_BIT(EV_KEY, evbit) || !NGP_TEST_BIT(EV_ABS, evbit)) {
+        return false;
+    }
+    /* Filter out touchpads and motion sensors that share a vendor/product with the pad */
+    return NGP_TEST_BIT(BTN_GAMEPAD, keybit) && NGP_TEST_BIT(ABS_X, absbit) &&
+           NGP_TEST_BIT(ABS_Y, absbit);
+}
+
+/* Finds /dev/hidrawN for /dev/input/eventN through sysfs, the hid device is the grandparent */
+static int OpenHidraw(const char* event_path) {
+    const char* name = strrchr(event_path, '/');
+    char        sys_path[BUF_LEN];
+    snprintf(sys_path, sizeof(sys_path), "/sys/class/input/%s/device/device/hidraw",
+             name ? name + 1 : event_path);
+
+    DIR* dir = opendir(sys_path);
+    if (!dir) {
+        return -1;
+    }
+    int            fd = -1;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, "hidraw", 6) == 0) {
+            char dev_path[NGP_DEV_PATH_LEN];
+            snprintf(dev_path, sizeof(dev_path), "/dev/%s", entry->d_name);
+            fd = open(dev_path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+            break;
+        }
+    }
+    closedir(dir);
+    return fd;
+}
+
+/* Feature and output reports go through hidraw, the evdev node has no way to send them */
+static int LinuxReadFeature(NGP_Device* device, uint8_t* data, size_t size) {
+    NGP_IODevice* io = device->backend;
+    return io->hidraw_fd < 0 ? -1 : ioctl(io->hidraw_fd, HIDIOCGFEATURE(size), data);
+}
+
+static bool LinuxWriteOutput(NGP_Device* device, const NGP_DeviceOutput* output) {
+    NGP_IODevice* io        = device->backend;
+    bool          bluetooth = device->bus == NGP_HARDWARE_BUS_BLUETOOTH;
+    uint8_t       report[NGP_SONY_OUTPUT_REPORT_LEN];
+    /* not io->sony, which is cleared again when input falls back to evdev */
+    size_t size = NGP_SonyEncodeOutput(io->info->sony, bluetooth, output, report);
+    return size > 0 && write(io->hidraw_fd, report, size) == (ssize_t)size;
+}
+
+static const NGP_DeviceTransport linux_transport = {
+    .WriteOutput = LinuxWriteOutput,
+    .ReadFeature = LinuxReadFeature,
+};
+
+/* Returns the feature report that holds the serial when evdev does not know it, or 0 */
+static uint8_t ReadSerial(NGP_IODevice* io) {
+    NGP_Device* device = io->device;
+    char        serial[NGP_NAME_LEN];
+    if (ioctl(io->fd, EVIOCGUNIQ(sizeof(serial)), serial) < 0) {
+        serial[0] = '\0';
+    }
+    serial[sizeof(serial) - 1] = '\0';
+    device->serial             = NGP_Intern(serial);
+    if (device->serial[0] != '\0' || !device->transport) {
+        return 0;
+    }
+    return io->info->serial_report;
+}
+
+static bool GetDeviceInfo(NGP_IODevice* io) {
+    NGP_Device*     device = io->device;
+    struct input_id id;
+    if (ioctl(io->fd, EVIOCGID, &id) < 0) {
+        return false;
+    }
+    device->bus        = id.bustype;
+    device->vendor_id  = id.vendor;
+    device->product_id = id.product;
+    device->version    = id.version;
+
+    char name[NGP_NAME_LEN];
+    if (ioctl(io->fd, EVIOCGNAME(sizeof(name)), name) < 0) {
+        name[0] = '\0';
+    }
+    name[sizeof(name) - 1] = '\0';
+    device->name           = NGP_Intern(name);
+
+    memset(io->abs, 0, sizeof(io->abs));
+    for (uint16_t code = 0; code < ABS_CNT; code++) {
+        if (AxisForAbs(code) >= 0 || code == ABS_HAT0X || code == ABS_HAT0Y) {
+            ioctl(io->fd, EVIOCGABS(code), &io->abs[code]);
+        }
+    }
+
+    NGP_DeviceMakeGUID(device);
+    return true;
+}
+
+static NGP_IODevice* FreeIODevice(void) {
+    for (int i = 0; i < NGP_MAX_IO_DEVICES; i++) {
+        if (!manager.io_devices[i].device) {
+            return &manager.io_devices[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Switches DualShock 4 and DualSense pads over to hidraw input and output. Over Bluetooth they
+ * only send the short report until a feature report is read, the calibration report (0x05) is the
+ * usual one.
+ */
+static void OpenSonyReports(NGP_IODevice* io) {
+    NGP_Device* device = io->device;
+    if (io->hidraw_fd < 0) {
+        return;
+    }
+    io->info = NGP_DeviceInfoLookup(device->vendor_id, device->product_id);
+    if (!io->info || io->info->sony == NGP_SonyModelNone) {
+        return;
+    }
+    io->sony          = io->info->sony;
+    device->touchpads = io->info->touchpads;
+    device->transport = &linux_transport;
+    device->outputs   = io->info->outputs;
+    if (device->bus == NGP_HARDWARE_BUS_BLUETOOTH) {
+        NGP_OutputQueueRead(&io->calibration_read, device, 0x05, NULL, NULL);
+    }
+}
+
+static void CloseIODevice(NGP_IODevice* io) {
+    if (io->hidraw_fd >= 0) {
+        close(io->hidraw_fd);
+    }
+    close(io->fd);
+    io->fd        = -1;
+    io->hidraw_fd = -1;
+}
+
+static void RemoveDevice(NGP_IODevice* io) {
+    NGP_EnumerationRemove(&manager.known, io->path);
+    epoll_ctl(manager.epoll_fd, EPOLL_CTL_DEL, io->fd, NULL);
+    if (io->sony != NGP_SonyModelNone) {
+        epoll_ctl(manager.epoll_fd, EPOLL_CTL_DEL, io->hidraw_fd, NULL);
+    }
+    CloseIODevice(io);
+    NGP_DeviceRelease(io->device);
+    io->device = NULL;
+}
+
+static void AttachIODevice(NGP_IODevice* io) {
+    if (!NGP_DeviceAttach(io->device)) {
+        RemoveDevice(io);
+    }
+}
+
+static void SerialRead(NGP_Device* device, const uint8_t* data, int length, void* userdata) {
+    /* Same as the MacOS backend, the serial is the Bluetooth address in reverse byte order */
+    if (length >= 7) {
+        char serial[18];
+        snprintf(serial, sizeof(serial), "%.2x-%.2x-%.2x-%.2x-%.2x-%.2x", data[6], data[5], data[4],
+                 data[3], data[2], data[1]);
+        device->serial = NGP_Intern(serial);
+    }
+    AttachIODevice(userdata);
+}
+
+/* Opens a device node that is not tracked yet, path is interned */
+static void AddDevice(const char* path) {
+    if (NGP_EnumerationFind(&manager.known, path)) {
+        return;
+    }
+    NGP_IODevice* io = FreeIODevice();
+    if (!io) {
+        return;
+    }
+    int fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        return; /* udev may not have fixed up the permissions yet, IN_ATTRIB will retry */
+    }
+    if (!IsGamePad(fd)) {
+        close(fd);
+        return;
+    }
+    /* stamp events on the NGP_GetTicksNS clock rather than the wall clock */
+    int clock_id = CLOCK_MONOTONIC;
+    ioctl(fd, EVIOCSCLOCKID, &clock_id);
+    NGP_Device* device = NGP_DeviceAcquire();
+    if (!device) {
+        close(fd);
+        return;
+    }
+
+    io->fd        = fd;
+    io->hidraw_fd = -1;
+    io->device    = device;
+    io->info      = NULL;
+    io->sony      = NGP_SonyModelNone;
+    io->path      = path;
+    io->dropping  = false;
+    device->backend = io;
+    if (!GetDeviceInfo(io)) {
+        goto fail;
+    }
+    io->hidraw_fd = OpenHidraw(path);
+    OpenSonyReports(io);
+    uint8_t serial_report = ReadSerial(io);
+    SyncDeviceState(io);
+
+    struct epoll_event ev = { .events = EPOLLIN, .data.u64 = (uint64_t)(io - manager.io_devices) };
+    if (!NGP_EnumerationAdd(&manager.known, path, io)) {
+        goto fail;
+    }
+    if (epoll_ctl(manager.epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        NGP_EnumerationRemove(&manager.known, path);
+        goto fail;
+    }
+    if (io->sony != NGP_SonyModelNone) {
+        ev.data.u64 |= NGP_EPOLL_HIDRAW;
+        if (epoll_ctl(manager.epoll_fd, EPOLL_CTL_ADD, io->hidraw_fd, &ev) < 0) {
+            io->sony = NGP_SonyModelNone; /* fall back to evdev, without touch and motion */
+        }
+    }
+    /* reading the serial can take a while over Bluetooth, so it is queued and attaches the pad */
+    if (!serial_report ||
+        !NGP_OutputQueueRead(&io->serial_read, device, serial_report, SerialRead, io)) {
+        AttachIODevice(io);
+    }
+    return;
+
+fail:
+    CloseIODevice(io);
+    NGP_DeviceRelease(device);
+    io->device = NULL;
+}
+
+static NGP_Timestamp EventTime(const struct input_event* e) {
+    return (NGP_Timestamp)e->input_event_sec * 1000000000LL +
+           (NGP_Timestamp)e->input_event_usec * 1000LL;
+}
+
+static void ReadDevice(NGP_IODevice* io) {
+    struct input_event events[64];
+    for (;;) {
+        ssize_t len = read(io->fd, events, sizeof(events));
+        if (len < 0) {
+            if (errno == ENODEV) {
+                RemoveDevice(io);
+            }
+            return;
+        }
+        size_t count = (size_t)len / sizeof(events[0]);
+        if (io->sony != NGP_SonyModelNone) {
+            count = 0; /* drained for ENODEV only, hidraw delivers the same input */
+            if ((size_t)len == sizeof(events)) {
+                continue;
+            }
+        }
+        for (size_t i = 0; i < count; i++) {
+            const struct input_event* e = &events[i];
+            /* every event of a report carries the report's time, the setters stamp it on theirs */
+            NGP_DeviceBeginReport(io->device, EventTime(e));
+            switch (e->type) {
+                case EV_KEY:
+                    if (!io->dropping) {
+                        NGP_DeviceSetButton(io->device, ButtonForKey(e->code), e->value != 0);
+                    }
+                    break;
+                case EV_ABS:
+                    if (!io->dropping) {
+                        HandleAbs(io, e->code, e->value);
+                    }
+                    break;
+                case EV_SYN:
+                    if (e->code == SYN_DROPPED) {
+                        /* what is left of the report is incomplete, the next SYN_REPORT ends it */
+                        io->dropping = true;
+                    } else if (e->code == SYN_REPORT && io->dropping) {
+                        io->dropping = false;
+                        SyncDeviceState(io);
+                    } else if (e->code == SYN_REPORT) {
+                        NGP_DevicePublish(io->device);
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        if (count < sizeof(events) / sizeof(events[0])) {
+            return;
+        }
+    }
+}
+
+static void ReadHidraw(NGP_IODevice* io) {
+    uint8_t data[NGP_HIDRAW_REPORT_LEN];
+    for (;;) {
+        ssize_t len = read(io->hidraw_fd, data, sizeof(data));
+        if (len <= 0) {
+            return; /* EAGAIN, or the pad is gone and the evdev node will report ENODEV */
+        }
+        /* hidraw reports carry no time of their own, reading them is the closest there is */
+        NGP_Timestamp    received = NGP_GetTicksNS();
+        NGP_GamePadState report   = io->device->state;
+        if (NGP_SonyParseReport(io->sony, data, (size_t)len, &report)) {
+            NGP_DeviceBeginReport(io->device, received);
+            NGP_DeviceApplyState(io->device, &report);
+            NGP_DevicePublish(io->device);
+        }
+    }
+}
+
+static bool IsEventNode(const char* name) { return strncmp(name, "event", 5) == 0; }
+
+static void ScanDevices(void);
+
+static void ReadInotify(void) {
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    for (;;) {
+        ssize_t len = read(manager.inotify_fd, buf, sizeof(buf));
+        if (len <= 0) {
+            return;
+        }
+        for (char* ptr = buf; ptr < buf + len;) {
+            const struct inotify_event* e = (const struct inotify_event*)ptr;
+            ptr += sizeof(struct inotify_event) + e->len;
+            if (e->mask & IN_Q_OVERFLOW) {
+                ScanDevices(); /* notifications were lost, diff against what is there instead */
+                continue;
+            }
+            if (e->len == 0 || !IsEventNode(e->name)) {
+                continue;
+            }
+            char path[NGP_DEV_PATH_LEN];
+            snprintf(path, sizeof(path), NGP_DEV_INPUT "/%s", e->name);
+            if (e->mask & (IN_CREATE | IN_MOVED_TO | IN_ATTRIB)) {
+                AddDevice(NGP_Intern(path));
+            } else if (e->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                NGP_IODevice* io = NGP_EnumerationFind(&manager.known, NGP_Intern(path));
+                if (io) {
+                    RemoveDevice(io);
+                }
+            }
+        }
+    }
+}
+
+static int EventNodeFilter(const struct dirent* entry) { return IsEventNode(entry->d_name); }
+
+/* Opens the pads a full scan finds that are not tracked yet and removes those it no longer finds */
+static void ScanDevices(void) {
+    struct dirent** entries;
+    int             n = scandir(NGP_DEV_INPUT, &entries, EventNodeFilter, versionsort);
+    if (n < 0) {
+        return;
+    }
+    NGP_EnumerationBeginScan(&manager.known);
+    for (int i = 0; i < n; i++) {
+        char path[NGP_DEV_PATH_LEN];
+        snprintf(path, sizeof(path), NGP_DEV_INPUT "/%s", entries[i]->d_name);
+        const char* key = NGP_Intern(path);
+        if (!NGP_EnumerationSeen(&manager.known, key)) {
+            AddDevice(key);
+        }
+        free(entries[i]);
+    }
+    free(entries);
+
+    void* gone[NGP_MAX_IO_DEVICES];
+    int   count = NGP_EnumerationEndScan(&manager.known, gone, NGP_MAX_IO_DEVICES);
+    for (int i = 0; i < count; i++) {
+        RemoveDevice(gone[i]);
+    }
+}
+
+static void CloseFd(int* fd) {
+    if (*fd >= 0) {
+        close(*fd);
+        *fd = -1;
+    }
+}
+
+static void LinuxClose(void* userdata) {
+    (void)userdata;
+    for (int i = 0; i < NGP_MAX_IO_DEVICES; i++) {
+        if (manager.io_devices[i].device) {
+            RemoveDevice(&manager.io_devices[i]);
+        }
+    }
+    CloseFd(&manager.inotify_fd);
+    CloseFd(&manager.wake_fd);
+    CloseFd(&manager.epoll_fd);
+}
+
+static bool LinuxOpen(void* userdata) {
+    (void)userdata;
+    manager.inotify_fd = -1;
+    manager.wake_fd    = -1;
+    manager.epoll_fd   = epoll_create1(EPOLL_CLOEXEC);
+    if (manager.epoll_fd < 0) {
+        return false;
+    }
+
+    manager.wake_fd       = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    struct epoll_event ev = { .events = EPOLLIN, .data.u64 = NGP_EPOLL_WAKE };
+    if (manager.wake_fd < 0 || epoll_ctl(manager.epoll_fd, EPOLL_CTL_ADD, manager.wake_fd, &ev) < 0) {
+        LinuxClose(userdata);
+        return false;
+    }
+
+    /* Watch before enumerating so a pad plugged in during the scan is not missed */
+    manager.inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (manager.inotify_fd >= 0) {
+        if (inotify_add_watch(manager.inotify_fd, NGP_DEV_INPUT,
+                              IN_CREATE | IN_DELETE | IN_ATTRIB | IN_MOVED_TO | IN_MOVED_FROM) <
+            0) {
+            CloseFd(&manager.inotify_fd);
+        } else {
+            ev.data.u64 = NGP_EPOLL_INOTIFY;
+            epoll_ctl(manager.epoll_fd, EPOLL_CTL_ADD, manager.inotify_fd, &ev);
+        }
+    }
+
+    ScanDevices();
+    return true;
+}
+
+/* Input and hot-plug both arrive through epoll, nothing is polled */
+static void LinuxPump(void* userdata, int timeout_ms) {
+    (void)userdata;
+    struct epoll_event events[NGP_EPOLL_MAX_EVENTS];
+    int                n = epoll_wait(manager.epoll_fd, events, NGP_EPOLL_MAX_EVENTS, timeout_ms);
+    for (int i = 0; i < n; i++) {
+        uint64_t data = events[i].data.u64;
+        if (data == NGP_EPOLL_INOTIFY) {
+            ReadInotify();
+        } else if (data == NGP_EPOLL_WAKE) {
+            uint64_t value;
+            while (read(manager.wake_fd, &value, sizeof(value)) > 0) {
+            }
+        } else if (data & NGP_EPOLL_HIDRAW) {
+            NGP_IODevice* io = &manager.io_devices[data & ~NGP_EPOLL_HIDRAW];
+            if (io->device && io->sony != NGP_SonyModelNone) {
+                ReadHidraw(io);
+            }
+        } else if (manager.io_devices[data].device) {
+            ReadDevice(&manager.io_devices[data]);
+        }
+    }
+}
+
+static void LinuxWake(void* userdata) {
+    (void)userdata;
+    uint64_t one = 1;
+    if (write(manager.wake_fd, &one, sizeof(one)) < 0) {
+        /* the counter is already non-zero, the thread is waking up anyway */
+    }
+}
+
+static const NGP_DeviceSource linux_source = {
+    .name  = "linux",
+    .Open  = LinuxOpen,
+    .Pump  = LinuxPump,
+    .Wake  = LinuxWake,
+    .Close = LinuxClose,
+};
+
+const NGP_DeviceSource* NGP_PlatformDeviceSource(void) { return &linux_source; }
+
+#endif
@@ -0,0 +1,32 @@
+#include <NGP_GamePad.h>
+#include <stdio.h>
+#include <unistd.h>
+int main() {
+    NGP_Initialize();
+
+    int num_gamepads = NGP_NumGamePads();
+    printf("Found %d game pads\n", num_gamepads);
+    for (int i = 0; i < num_gamepads; i++) {
+        NGP_GamePad* p = NGP_GamePadOpen(i);
+        printf("%s %04x:%04x\n", NGP_GamePadName(p), NGP_GamePadVendor(p), NGP_GamePadProduct(p));
+        printf("%d\n", NGP_GamePadIsAttached(p));
+        NGP_GamePadFree(p);
+    }
+
+    // print the first pad for a few seconds, handy with a uinput pad on the other end
+    NGP_GamePad* p = NGP_GamePadOpen(0);
+    for (int frame = 0; p && frame < 50; frame++) {
+        printf("left (%6d, %6d) right (%6d, %6d) triggers (%5d, %5d) a %d b %d\n",
+               NGP_GamePadAxisLeftX(p), NGP_GamePadAxisLeftY(p), NGP_GamePadAxisRightX(p),
+               NGP_GamePadAxisRightY(p), NGP_GamePadAxisTriggerLeft(p),
+               NGP_GamePadAxisTriggerRight(p), NGP_GamePadButton(p, NGP_GamePadButtonA),
+               NGP_GamePadButton(p, NGP_GamePadButtonB));
+        usleep(100000);
+    }
+    if (p) {
+        NGP_GamePadFree(p);
+    }
+
+    NGP_Shutdown();
+    return 0;
+}
@@ -48,26 +48,44 @@ freely, subject to the following restrictions:
 
 #include <NGP_GamePad.h>
 #import <NGP_USB_IDS.h>
-#include "CHSinglyLinkedList.h"
+#include "../NGP_Device.h"
+#include "../NGP_DeviceTable.h"
+#include "../NGP_Enumeration.h"
+#include "../NGP_Pool.h"
+#include "../NGP_Registry.h"
+#include "../NGP_Runtime.h"
+#include "../NGP_SonyReport.h"
 
 CFStringRef NGP_DARWIN_RUN_LOOP = CFSTR("NGP_DARWIN_RUN_LOOP");
-#define NGP_HARDWARE_BUS_USB 0x03
-#define NGP_HARDWARE_BUS_BLUETOOTH 0x05
 #define BUF_LEN 256
+#define NGP_HID_REPORT_LEN 128
 
-typedef struct NGP_DeviceGUID {
-    uint8_t data[16];
-} NGP_DeviceGUID;
+/*
+ * Every IOHID device we kept, keyed by a registry handle so the removal callback finds it in O(1),
+ * and by IORegistry entry id so a device IOHIDManager reports again is not opened twice
+ */
+typedef struct NGP_DeviceContextManager {
+    NGP_Registry    devices;
+    NGP_Enumeration known;
+    uint64_t        id_counter;
+} NGP_DeviceContextManager;
+
+typedef struct NGP_DeviceContext {
+    NGP_DeviceContextManager* manager;
+    NGP_GamePadID             device_id;
+} NGP_DeviceContext;
 
 typedef struct NGP_IODevice {
     IOHIDDeviceRef deviceRef; /* HIDManager device handle */
+    NGP_Device*    ngp_device; /* the shared record the public API reads from */
     NGP_DeviceGUID guid;
 
-    char  product[BUF_LEN]; /* name of product */
-    char  manufacturer[BUF_LEN];
-    char* serial;
+    const char* product; /* name of product, these three are interned */
+    const char* manufacturer;
+    const char* serial;
 
-    uint64_t instance_id;
+    uint64_t    instance_id;
+    const char* key; /* interned IORegistry entry id, see NGP_DeviceContextManager */
 
     uint32_t usage; /* usage page from IOUSBHID Parser.h which defines general usage */
     uint32_t usagePage; /* usage within above page from IOUSBHID Parser.h which defines specific usage */
@@ -75,10 +93,20 @@ typedef struct NGP_IODevice {
     int32_t vendor_id;
     int32_t product_id;
     int32_t version;
+    bool    bluetooth; /* output reports are framed differently over Bluetooth */
     bool    removed;
     bool    runLoopAttached; /* is 'deviceRef' attached to a CFRunLoop? */
+
+    NGP_SonyModel   sony;                       /* DS4/DS5 input reports are decoded by us */
+    uint8_t         report[NGP_HID_REPORT_LEN]; /* IOHID writes each input report here */
+    NGP_FeatureRead serial_read;                /* the pad is attached once this one completes */
+
+    NGP_DeviceContext context; /* handed to the removal callback, which FreeDevice unregisters */
 } NGP_IODevice;
 
+/* Hot plugging takes its records from here rather than the heap */
+static NGP_Pool device_pool = NGP_POOL_INIT(NGP_IODevice, 64, NGP_MAX_GAMEPADS);
+
 static int hid_get_feature_report(NGP_IODevice* dev, unsigned char* data, CFIndex length) {
     CFIndex  len = length;
     IOReturn res;
@@ -96,7 +124,6 @@ static int hid_get_feature_report(NGP_IODevice* dev, unsigned char* data, CFInde
     res =
         IOHIDDeviceGetReport(dev->deviceRef, kIOHIDReportTypeFeature, report_number, /* Report ID */
                              data, &len);
-    NSLog(@"IOHIDDeviceGetReport response: %s", mach_error_string(res));
     if (res != kIOReturnSuccess) {
         return -1;
     }
@@ -108,25 +135,28 @@ static int hid_get_feature_report(NGP_IODevice* dev, unsigned char* data, CFInde
     return (int)len;
 }
 
-static int ReadFeatureReport(NGP_IODevice* dev, uint8_t report_id, uint8_t* report, CFIndex length) {
-    memset(report, 0, length);
-    report[0] = report_id;
-    return hid_get_feature_report(dev, report, length);
+/*
+ * Feature and output reports for the output queue. They block until the pad answers, which is
+ * why they only ever run from NGP_OutputFlush rather than from the IOHIDManager callbacks.
+ */
+static int MacReadFeature(NGP_Device* device, uint8_t* data, size_t size) {
+    return hid_get_feature_report(device->backend, data, (CFIndex)size);
 }
 
-static void PrintDevice(NGP_IODevice* device) {
-    NSLog(@"product: %s", device->product);
-    NSLog(@"manufacturer: %s", device->manufacturer);
-    NSLog(@"serial: %s", device->serial);
-    NSLog(@"%llu", device->instance_id);
-    NSLog(@"%d", device->vendor_id);
-    NSLog(@"%d", device->product_id);
-    NSLog(@"%d", device->version);
-    for (uint8_t u = 0; u < 16; u++) {
-        NSLog(@"%c", device->guid.data[u]);
-    }
+static bool MacWriteOutput(NGP_Device* device, const NGP_DeviceOutput* output) {
+    NGP_IODevice* dev       = device->backend;
+    bool          bluetooth = device->bus == NGP_HARDWARE_BUS_BLUETOOTH;
+    uint8_t       report[NGP_SONY_OUTPUT_REPORT_LEN];
+    size_t        size = NGP_SonyEncodeOutput(dev->sony, bluetooth, output, report);
+    return size > 0 && IOHIDDeviceSetReport(dev->deviceRef, kIOHIDReportTypeOutput, report[0],
+                                            report, (CFIndex)size) == kIOReturnSuccess;
 }
 
+static const NGP_DeviceTransport darwin_transport = {
+    .WriteOutput = MacWriteOutput,
+    .ReadFeature = MacReadFeature,
+};
+
 static void FreeDevice(NGP_IODevice* removeDevice) {
     if (removeDevice) {
         if (removeDevice->deviceRef) {
@@ -140,70 +170,64 @@ static void FreeDevice(NGP_IODevice* removeDevice) {
                 IOHIDDeviceUnscheduleFromRunLoop(removeDevice->deviceRef, CFRunLoopGetCurrent(),
                                                  NGP_DARWIN_RUN_LOOP);
             }
+            /* the record goes back to the pool, its context must not reach the callback again */
+            IOHIDDeviceRegisterRemovalCallback(removeDevice->deviceRef, NULL, NULL);
             CFRelease(removeDevice->deviceRef);
             removeDevice->deviceRef = NULL;
         }
-        free(removeDevice->serial);
-        free(removeDevice);
+        if (removeDevice->ngp_device) {
+            NGP_DeviceRelease(removeDevice->ngp_device);
+        }
+        NGP_PoolFree(&device_pool, removeDevice);
     }
 }
 
-typedef struct NGP_DeviceContextManager {
-    CHSinglyLinkedList* device_list;
-    uint64_t            id_counter;
-} NGP_DeviceContextManager;
-
-typedef struct NGP_DeviceContext {
-    NGP_DeviceContextManager* manager;
-    id                        device_id;
-} NGP_DeviceContext;
-
-static CHSinglyLinkedList* NewSinglyLinkedList() { return CFRetain(CHSinglyLinkedList.alloc.init); }
-
-static void DeviceContextManagerFreeList(NGP_DeviceContextManager* manager) {
-    CHSinglyLinkedList* l = manager->device_list;
-    NSEnumerator*       e = [l objectEnumerator];
-    NSValue*            c;
-    c = [e nextObject];
-    while (c) {
-        FreeDevice([(c) pointerValue]);
-        CFRelease(c);
-        c = [e nextObject];
-    }
-    [l removeAllObjects];
-    CFRelease(l);
+static void DeviceContextManagerInit(NGP_DeviceContextManager* manager) {
+    NGP_RegistryInit(&manager->devices);
+    memset(&manager->known, 0, sizeof(manager->known));
+    manager->id_counter = 0;
 }
 
-#define NewDeviceContextManager() \
-    { NewSinglyLinkedList(), 0 }
+static NGP_GamePadID DeviceContextManagerInsert(NGP_DeviceContextManager* manager,
+                                                NGP_IODevice*             device) {
+    NGP_GamePadID id = NGP_RegistryInsert(&manager->devices, device);
+    if (id != NGP_INVALID_GAMEPAD_ID) {
+        device->instance_id = manager->id_counter++;
+    }
+    return id;
+}
 
-static id DeviceContextManagerInsert(NGP_DeviceContextManager* manager, NGP_IODevice* device) {
-    device->instance_id = manager->id_counter;
-    id val              = CFRetain([NSValue valueWithPointer:device]);
-    [manager->device_list addObject:(val)];
-    manager->id_counter++;
-    return val;
+static NGP_IODevice* DeviceContextManagerRemove(NGP_DeviceContextManager* manager,
+                                                NGP_GamePadID             id) {
+    NGP_IODevice* device = NGP_RegistryRemove(&manager->devices, id);
+    if (device) {
+        NGP_EnumerationRemove(&manager->known, device->key);
+    }
+    return device;
 }
 
-NSUInteger DeviceContextManagerIndexForObject(NGP_DeviceContextManager* manager, id val) {
-    return [manager->device_list indexOfObject:val];
+static void DeviceContextManagerFreeList(NGP_DeviceContextManager* manager) {
+    while (manager->devices.count > 0) {
+        FreeDevice(DeviceContextManagerRemove(manager, NGP_RegistryAt(&manager->devices, 0)));
+    }
 }
 
-NGP_IODevice* DeviceContextManagerRemove(NGP_DeviceContextManager* manager, id val) {
-    NSValue*   value;
-    NSUInteger index     = [manager->device_list indexOfObject:val];
-    value                = [manager->device_list objectAtIndex:index];
-    NGP_IODevice* device = [value pointerValue];
-    [manager->device_list removeObject:val];
-    return device;
+/* The IORegistry entry id outlives nothing but the device itself, which makes it a stable key */
+static const char* DeviceKey(IOHIDDeviceRef hidDevice) {
+    uint64_t entry_id = 0;
+    char     key[32];
+    if (IORegistryEntryGetRegistryEntryID(IOHIDDeviceGetService(hidDevice), &entry_id) !=
+        KERN_SUCCESS) {
+        return NULL;
+    }
+    snprintf(key, sizeof(key), "%llx", (unsigned long long)entry_id);
+    return NGP_Intern(key);
 }
 
 @interface AppDelegate : NSObject <NSApplicationDelegate>
 @end
 
-@implementation AppDelegate {
-    bool initialized;
-}
+@implementation AppDelegate
 - (void)applicationDidFinishLaunching:(NSNotification*)notification {
     NSEvent* dummyEvent = [NSEvent otherEventWithType:NSEventTypeApplicationDefined
                                              location:NSZeroPoint
@@ -215,54 +239,17 @@ NGP_IODevice* DeviceContextManagerRemove(NGP_DeviceContextManager* manager, id v
                                                 data1:0
                                                 data2:0];
     [NSApp postEvent:dummyEvent atStart:TRUE];
-    usleep(5000);
     [NSApp stop:nil];
-    NSLog(@"returning from applicationDidFinishLaunching");
-    initialized = true;
 }
-
-- (void)applicationDidUpdate:(NSNotification*)notification {
-    NSLog(@"application became active");
-    if (!initialized) {
-        NSLog(@"Not initialized, returning");
-        return;
-    }
-    NSEvent* dummyEvent = [NSEvent otherEventWithType:NSEventTypeApplicationDefined
-                                             location:NSZeroPoint
-                                        modifierFlags:(NSEventModifierFlags)0
-                                            timestamp:0
-                                         windowNumber:0
-                                              context:nil
-                                              subtype:0
-                                                data1:0
-                                                data2:0];
-    [NSApp postEvent:dummyEvent atStart:TRUE];
-    NSLog(@"starting controller discovery");
-    [GCController startWirelessControllerDiscoveryWithCompletionHandler:nil];
-    NSLog(@"Sleeping while controller discovery runs...");
-    sleep(1);
-    NSLog(@"Stopping controller discovery");
-    [GCController stopWirelessControllerDiscovery];
-    NSLog(@"Stopping application");
-    [NSApp stop:nil];
-}
-
 @end
 
-void NGP_ReinitializeGamepads(void) {
-    if (NSApp) {
-        NSLog(@"Rerunning\n");
-        [NSApp run];
-    }
-    NSLog(@"Looping through controllers array");
-    for (GCController* c in [GCController controllers]) {
-        if (@available(macOS 11.3, *)) {
-            if ([c.extendedGamepad isKindOfClass:[GCDualSenseGamepad class]]) {
-                NSLog(@"We've found a dual sense gamepad!");
-                NSLog(@"%@", c.extendedGamepad.description);
-            }
-        }
-    }
+/*
+ * Wireless discovery runs in the background for as long as GameController keeps it going, pads it
+ * pairs show up through IOHIDManager like any other, so nothing waits for it
+ */
+static void StartWirelessDiscovery(void) {
+    [GCController startWirelessControllerDiscoveryWithCompletionHandler:^{
+    }];
 }
 
 static CFDictionaryRef CreateHIDDeviceMatchDictionary(const UInt32 page,
@@ -351,42 +338,26 @@ static bool GetDeviceInfo(IOHIDDeviceRef hidDevice, NGP_IODevice* device) {
     }
     device->version = version;
 
+    refCF = IOHIDDeviceGetProperty(hidDevice, CFSTR(kIOHIDTransportKey));
+    device->bluetooth =
+        refCF && CFGetTypeID(refCF) == CFStringGetTypeID() &&
+        CFStringCompare(refCF, CFSTR(kIOHIDTransportBluetoothValue), 0) == kCFCompareEqualTo;
+
     /* get device name */
     refCF = IOHIDDeviceGetProperty(hidDevice, CFSTR(kIOHIDManufacturerKey));
     if ((!refCF) || (!CFStringGetCString(refCF, manufacturer_string, sizeof(manufacturer_string),
                                          kCFStringEncodingUTF8))) {
         manufacturer_string[0] = '\0';
     }
-    strlcpy(device->manufacturer, manufacturer_string, sizeof(device->manufacturer));
+    device->manufacturer = NGP_Intern(manufacturer_string);
 
     refCF = IOHIDDeviceGetProperty(hidDevice, CFSTR(kIOHIDProductKey));
     if ((!refCF) ||
         (!CFStringGetCString(refCF, product_string, sizeof(product_string), kCFStringEncodingUTF8))) {
         product_string[0] = '\0';
     }
-    strlcpy(device->product, product_string, sizeof(device->product));
-#define USB_PACKET_LENGTH 64
-    uint8_t data[USB_PACKET_LENGTH * 2];
-
-    /* Read the serial number (Bluetooth address in reverse byte order)
-       This will also enable enhanced reports over Bluetooth
-    */
-    NSLog(@"vendor id: %d", device->vendor_id);
-    NSLog(@"product id: %d", device->product_id);
-    NSLog(@"%u", device->vendor_id == NGP_USB_Vendor_Sony);
-    NSLog(@"%u", device->product_id == NGP_USB_Product_SonyDS5);
-    if (device->vendor_id == NGP_USB_Vendor_Sony && device->product_id == NGP_USB_Product_SonyDS5) {
-        int sn_resp = ReadFeatureReport(device, NGP_USB_PS5_SerialRequestKey, data, sizeof(data));
-    if (sn_resp >= 7) {
-            char serial[18];
-
-            snprintf(serial, sizeof(serial), "%.2x-%.2x-%.2x-%.2x-%.2x-%.2x", data[6], data[5],
-                     data[4], data[3], data[2], data[1]);
-            device->serial = strdup(serial);
-        } else {
-            NSLog(@"Failed to get serial number, %d", sn_resp);
-        }
-    }
+    device->product = NGP_Intern(product_string);
+    device->serial  = "";
 
 
     //    if (device->serial && strlen(device->serial) == 12) {
@@ -426,20 +397,89 @@ static bool GetDeviceInfo(IOHIDDeviceRef hidDevice, NGP_IODevice* device) {
     return true;
 }
 
+static void SonyInputReportCallback(void*           ctx,
+                                    IOReturn        res,
+                                    void*           sender,
+                                    IOHIDReportType type,
+                                    uint32_t        report_id,
+                                    uint8_t*        report,
+                                    CFIndex         length) {
+    NGP_IODevice* device = ctx;
+    if (res != kIOReturnSuccess || !device->ngp_device) {
+        return;
+    }
+    NGP_GamePadState state = device->ngp_device->state;
+    if (NGP_SonyParseReport(device->sony, report, (size_t)length, &state)) {
+        NGP_DeviceBeginReport(device->ngp_device, NGP_GetTicksNS());
+        NGP_DeviceApplyState(device->ngp_device, &state);
+        NGP_DevicePublish(device->ngp_device);
+    }
+}
+
+static void SerialRead(NGP_Device* d, const uint8_t* data, int length, void* userdata) {
+    NGP_IODevice* device = userdata;
+    /* The serial number is the Bluetooth address in reverse byte order */
+    if (length >= 7) {
+        char serial[18];
+        snprintf(serial, sizeof(serial), "%.2x-%.2x-%.2x-%.2x-%.2x-%.2x", data[6], data[5], data[4],
+                 data[3], data[2], data[1]);
+        device->serial = NGP_Intern(serial);
+        d->serial      = device->serial;
+    }
+    NGP_DeviceAttach(d);
+}
+
+/*
+ * Copies what GetDeviceInfo found into the backend independent record and publishes it. Sony pads
+ * are published once their serial has been read, which also enables full reports over Bluetooth.
+ */
+static void AttachDevice(NGP_IODevice* device) {
+    NGP_Device* d = NGP_DeviceAcquire();
+    if (!d) {
+        return;
+    }
+    d->guid       = device->guid;
+    d->bus        = (device->bluetooth || !device->vendor_id || !device->product_id)
+                        ? NGP_HARDWARE_BUS_BLUETOOTH
+                        : NGP_HARDWARE_BUS_USB;
+    d->vendor_id  = (uint16_t)device->vendor_id;
+    d->product_id = (uint16_t)device->product_id;
+    d->version    = (uint16_t)device->version;
+    d->backend    = device;
+    d->name       = device->product;
+    d->serial     = device->serial;
+
+    device->ngp_device = d;
+
+    const NGP_DeviceInfo* info = NGP_DeviceInfoLookup(d->vendor_id, d->product_id);
+    if (!info || info->sony == NGP_SonyModelNone) {
+        NGP_DeviceAttach(d);
+        return;
+    }
+    device->sony = info->sony;
+    d->touchpads = info->touchpads;
+    d->transport = &darwin_transport;
+    d->outputs   = info->outputs;
+    IOHIDDeviceRegisterInputReportCallback(device->deviceRef, device->report,
+                                           sizeof(device->report), SonyInputReportCallback, device);
+    if (!info->serial_report ||
+        !NGP_OutputQueueRead(&device->serial_read, d, info->serial_report, SerialRead, device)) {
+        NGP_DeviceAttach(d);
+    }
+}
+
 static void GamePadDeviceWasRemovedCallback(void* ctx, IOReturn res, void* sender) {
     NGP_DeviceContext* dev_ctx = (NGP_DeviceContext*)(ctx);
     NGP_IODevice*      device  = DeviceContextManagerRemove(dev_ctx->manager, dev_ctx->device_id);
-    NSLog(@"Device was removed:");
-    PrintDevice(device);
-    FreeDevice(device);
-    free(dev_ctx);
+    if (device) {
+        FreeDevice(device);
+    }
 }
 
 static void GamePadDeviceWasAddedCallback(void*          ctx,
                                           IOReturn       res,
                                           void*          sender,
                                           IOHIDDeviceRef ioHIDDeviceObject) {
-    NSLog(@"Device was added:");
     if (res != kIOReturnSuccess) {
         printf("Device return was not successful, was %d", res);
         return;
@@ -447,22 +487,35 @@ static void GamePadDeviceWasAddedCallback(void*          ctx,
 
     NGP_DeviceContextManager* manager = (NGP_DeviceContextManager*)(ctx);
 
-    NGP_IODevice* device;
-    device = (NGP_IODevice*)calloc(1, sizeof(NGP_IODevice));
-    assert(device);
+    /* only the one device is looked at, the ones already open are left alone */
+    const char* key = DeviceKey(ioHIDDeviceObject);
+    if (key && NGP_EnumerationFind(&manager->known, key)) {
+        return;
+    }
+
+    NGP_IODevice* device = NGP_PoolAlloc(&device_pool);
+    if (!device) {
+        return;
+    }
 
     if (!GetDeviceInfo(ioHIDDeviceObject, device)) {
         FreeDevice(device);
         return; /* not a device we care about, probably. */
     }
 
-    id val = DeviceContextManagerInsert(manager, device);
-
-    NGP_DeviceContext* dev_ctx = calloc(1, sizeof(NGP_DeviceContext));
-    assert(dev_ctx);
+    NGP_GamePadID device_id = DeviceContextManagerInsert(manager, device);
+    if (device_id == NGP_INVALID_GAMEPAD_ID) {
+        FreeDevice(device);
+        return;
+    }
+    if (key && NGP_EnumerationAdd(&manager->known, key, device)) {
+        device->key = key;
+    }
+    AttachDevice(device);
 
-    dev_ctx->device_id = val;
-    dev_ctx->manager   = manager;
+    NGP_DeviceContext* dev_ctx = &device->context;
+    dev_ctx->device_id         = device_id;
+    dev_ctx->manager           = manager;
 
     /* Get notified when this device is disconnected. */
     IOHIDDeviceRegisterRemovalCallback(ioHIDDeviceObject, GamePadDeviceWasRemovedCallback, dev_ctx);
@@ -472,15 +525,6 @@ static void GamePadDeviceWasAddedCallback(void*          ctx,
     }
 
     device->runLoopAttached = true;
-    NSLog(@"Printing device info");
-    PrintDevice(device);
-
-
-    NSLog(@"Starting game pad reinitialization");
-    NGP_ReinitializeGamepads();
-    NSLog(@"Finished initializing");
-
-
 }
 
 static bool ConfigureHIDManager(IOHIDManagerRef           hidman,
@@ -525,62 +569,87 @@ static IOHIDManagerRef CreateHIDManager(NGP_DeviceContextManager* context_manage
 }
 
 
-void NGP_Initialize(void) {
-    NGP_DeviceContextManager manager     = NewDeviceContextManager();
-    IOHIDManagerRef          hid_manager = CreateHIDManager(&manager);
+typedef struct NGP_MacSource {
+    NGP_DeviceContextManager manager;
+    IOHIDManagerRef          hid_manager;
+    CFRunLoopRef             runloop;     /* the I/O thread's run loop */
+    CFRunLoopSourceRef       wake_source; /* signalled by Wake so a stop request is never lost */
+} NGP_MacSource;
+
+static NGP_MacSource mac_source;
 
+static void WakeSourcePerform(void* info) { /* no-op, returning from the run loop is the point */ }
+
+/* NSApp has to be set up from the main thread, which is the one calling NGP_Initialize */
+static bool MacSetup(void* userdata) {
     NSApplication* app = [NSApplication sharedApplication];
     [app setActivationPolicy:NSApplicationActivationPolicyAccessory];
     AppDelegate* delegate = [[[AppDelegate alloc] init] autorelease];
     [app setDelegate:delegate];
     [app run];
-
-    NSLog(@"Looping through controllers on initialization");
-    for (GCController* c in [GCController controllers]) {
-        if (@available(macOS 11.3, *)) {
-            if ([c.extendedGamepad isKindOfClass:[GCDualSenseGamepad class]]) {
-                NSLog(@"We've found a dual sense gamepad!");
-                NSLog(@"%@", c.extendedGamepad.description);
-            }
-        }
-    }
-
-    for (;;) {
-        // running the darwin run loop is what actually lets our callbacks fire and lets us
-        // detect when controllers are unplugged, etc
-        while (CFRunLoopRunInMode(NGP_DARWIN_RUN_LOOP, 0, TRUE) == kCFRunLoopRunHandledSource) {
-            printf("in cf runloop\n");
-        }
-        usleep(500);
-    }
-    IOHIDManagerClose(hid_manager, kIOHIDOptionsTypeNone);
+    StartWirelessDiscovery();
+    return true;
 }
 
+static bool MacOpen(void* userdata) {
+    NGP_MacSource* source = userdata;
 
-int NGP_NumGamePads() { return (int)GCController.controllers.count; }
+    CFRunLoopSourceContext wake_context = { 0 };
+    wake_context.perform                = WakeSourcePerform;
 
-struct NGP_GamePad {
-    GCController* controller;
-    NGP_IODevice* device;
-};
+    source->runloop     = CFRunLoopGetCurrent();
+    source->wake_source = CFRunLoopSourceCreate(kCFAllocatorDefault, 0, &wake_context);
+    CFRunLoopAddSource(source->runloop, source->wake_source, NGP_DARWIN_RUN_LOOP);
 
-NGP_GamePad* NGP_GamePadOpen(int index) {
-    NGP_GamePad* gp = malloc(sizeof(NGP_GamePad));
-    gp->controller  = CFRetain(GCController.controllers[(NSUInteger)index]);
-    return gp;
+    DeviceContextManagerInit(&source->manager);
+    source->hid_manager = CreateHIDManager(&source->manager);
+    if (!source->hid_manager) {
+        CFRunLoopRemoveSource(source->runloop, source->wake_source, NGP_DARWIN_RUN_LOOP);
+        CFRelease(source->wake_source);
+        DeviceContextManagerFreeList(&source->manager);
+        return false;
+    }
+    return true;
 }
 
-void NGP_GamePadFree(NGP_GamePad* gp) {
-    CFRelease(gp->controller);
-    free(gp);
+/* Running the darwin run loop is what actually lets our callbacks fire and lets us detect when
+ * controllers are unplugged, etc */
+static void MacPump(void* userdata, int timeout_ms) {
+    CFTimeInterval seconds = timeout_ms < 0 ? 1.0e10 : timeout_ms / 1000.0;
+    CFRunLoopRunInMode(NGP_DARWIN_RUN_LOOP, seconds, TRUE);
 }
 
-const char* NGP_GamePadName(NGP_GamePad* gp) { return gp->controller.productCategory.UTF8String; }
-
-bool NGP_GamePadIsAttached(NGP_GamePad* gp) { return gp->controller.attachedToDevice; }
+static void MacWake(void* userdata) {
+    NGP_MacSource* source = userdata;
+    CFRunLoopSourceSignal(source->wake_source);
+    CFRunLoopWakeUp(source->runloop);
+}
 
-const char* NGP_GamePadSerial(NGP_GamePad* gp) {
-    id device_id = gp->controller.physicalInputProfile.device;
+static void MacClose(void* userdata) {
+    NGP_MacSource* source = userdata;
+    dispatch_async(dispatch_get_main_queue(), ^{
+      [GCController stopWirelessControllerDiscovery];
+    });
+    IOHIDManagerUnscheduleFromRunLoop(source->hid_manager, source->runloop, NGP_DARWIN_RUN_LOOP);
+    IOHIDManagerClose(source->hid_manager, kIOHIDOptionsTypeNone);
+    CFRelease(source->hid_manager);
+    source->hid_manager = NULL;
+    DeviceContextManagerFreeList(&source->manager);
+    CFRunLoopRemoveSource(source->runloop, source->wake_source, NGP_DARWIN_RUN_LOOP);
+    CFRelease(source->wake_source);
+    source->wake_source = NULL;
 }
 
+static const NGP_DeviceSource darwin_source = {
+    .name     = "darwin",
+    .userdata = &mac_source,
+    .Setup    = MacSetup,
+    .Open     = MacOpen,
+    .Pump     = MacPump,
+    .Wake     = MacWake,
+    .Close    = MacClose,
+};
+
+const NGP_DeviceSource* NGP_PlatformDeviceSource(void) { return &darwin_source; }
+
 #endif
\ No newline at end of file
@@ -12,6 +12,6 @@ int main() {
         NGP_GamePadFree(p);
     }
 
-
+    NGP_Shutdown();
     return 0;
 }
\ No newline at end of file
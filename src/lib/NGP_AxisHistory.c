@@ -0,0 +1,45 @@
+#include "NGP_AxisHistory.h"
+
+#define MASK (NGP_AXIS_HISTORY - 1)
+
+static float Clamp(NGP_GamePadAxisType axis, float value) {
+    /* triggers only ever read 0 to 32767 */
+    float low = axis >= NGP_GamePadAxisTypeTriggerLeft ? 0.0f : -32768.0f;
+    return value < low ? low : value > 32767.0f ? 32767.0f : value;
+}
+
+float NGP_AxisHistorySample(const NGP_AxisHistory* history,
+                            NGP_GamePadAxisType    axis,
+                            NGP_Timestamp          target,
+                            NGP_Timestamp          now) {
+    uint32_t count = history->count;
+    if (!count) {
+        return 0.0f;
+    }
+    uint32_t              kept   = count < NGP_AXIS_HISTORY ? count : NGP_AXIS_HISTORY;
+    const NGP_AxisSample* newest = &history->samples[(count - 1) & MASK];
+    if (target >= newest->time) {
+        if (kept < 2) {
+            return newest->axes[axis];
+        }
+        const NGP_AxisSample* before = &history->samples[(count - 2) & MASK];
+        NGP_Timestamp         gap    = newest->time - before->time;
+        if (now - newest->time > 2 * gap) {
+            return newest->axes[axis];
+        }
+        NGP_Timestamp ahead = target - newest->time;
+        ahead               = ahead < NGP_AXIS_PREDICT_MAX_NS ? ahead : NGP_AXIS_PREDICT_MAX_NS;
+        float slope = (float)(newest->axes[axis] - before->axes[axis]) / (float)gap;
+        return Clamp(axis, newest->axes[axis] + slope * (float)ahead);
+    }
+    /* walk back to the pair around target, the history is short and target is usually recent */
+    for (uint32_t i = 1; i < kept; i++) {
+        const NGP_AxisSample* after  = &history->samples[(count - i) & MASK];
+        const NGP_AxisSample* before = &history->samples[(count - i - 1) & MASK];
+        if (target >= before->time) {
+            float t = (float)(target - before->time) / (float)(after->time - before->time);
+            return before->axes[axis] + (after->axes[axis] - before->axes[axis]) * t;
+        }
+    }
+    return history->samples[(count - kept) & MASK].axes[axis];
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include "NGP_Internal.h"
+
+#define NGP_AXIS_HISTORY 16                /* power of two, 64 ms of a 250 Hz pad */
+#define NGP_AXIS_PREDICT_MAX_NS 32000000LL /* farthest past the last report it extrapolates */
+
+typedef struct NGP_AxisSample {
+    NGP_Timestamp time; /* the report's */
+    int16_t       axes[NGP_GamePadAxisTypeMax];
+} NGP_AxisSample;
+
+/*
+ * The axes of a pad's most recent reports, newest at count - 1. Written by NGP_DevicePublish under
+ * the device's sequence lock, so a reader copies it whole along with the frame it belongs to.
+ */
+typedef struct NGP_AxisHistory {
+    NGP_AxisSample samples[NGP_AXIS_HISTORY];
+    uint32_t       count; /* reports pushed, only the last NGP_AXIS_HISTORY are kept */
+} NGP_AxisHistory;
+
+/**
+ * Adds a report's axes, replacing the newest sample when the report has the same time
+ * @param history
+ * @param state
+ */
+static inline void NGP_AxisHistoryPush(NGP_AxisHistory* history, const NGP_GamePadState* state) {
+    NGP_AxisSample* newest = &history->samples[(history->count - 1) & (NGP_AXIS_HISTORY - 1)];
+    if (history->count && state->Timestamp < newest->time) {
+        history->count = 0; /* a clock that went back, e.g. a replay started over */
+    }
+    if (!history->count || state->Timestamp != newest->time) {
+        newest = &history->samples[history->count++ & (NGP_AXIS_HISTORY - 1)];
+    }
+    newest->time = state->Timestamp;
+    memcpy(newest->axes, state->Axes, sizeof(newest->axes));
+}
+
+/**
+ * Returns the axis at target: interpolated between the reports around it, the oldest kept value
+ * before them, and past the newest extrapolated along the slope of the last two reports. Backends
+ * like evdev only report changes, so a pad that has not reported for twice its last interval by
+ * now is taken to have stopped and is not extrapolated.
+ * @param history
+ * @param axis
+ * @param target
+ * @param now
+ * @return the value, within the axis' range, 0 with no reports
+ */
+float NGP_AxisHistorySample(const NGP_AxisHistory* history,
+                            NGP_GamePadAxisType    axis,
+                            NGP_Timestamp          target,
+                            NGP_Timestamp          now);
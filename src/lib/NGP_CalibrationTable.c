@@ -0,0 +1,455 @@
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "NGP_Device.h"
+#include "NGP_Intern.h"
+#include "NGP_Pool.h"
+
+#define NGP_CALIBRATION_FILE_HEADER "# NGP calibration 1"
+#define NGP_CALIBRATION_LINE_LEN (32 + NGP_GamePadAxisTypeMax * 3 * 7 + NGP_NAME_LEN + 2)
+#define NGP_CALIBRATION_STICKS NGP_GamePadAxisTypeTriggerLeft /* the axes before it are sticks */
+#define NGP_CALIBRATION_ALL_AXES ((1u << NGP_GamePadAxisTypeMax) - 1)
+
+/*
+ * What is known about one pad, found by its GUID and serial. Entries are never freed, so a device's
+ * tables can keep pointing at theirs. The ranges are the I/O thread's, copied in whenever it
+ * rebuilds a table. The API changes them and the responses under the same lock and bumps version,
+ * the device's tables then copy everything back out.
+ */
+struct NGP_CalibrationEntry {
+    NGP_DeviceGUID        guid;
+    const char*           serial; /* interned */
+    NGP_AxisCalibration   ranges[NGP_GamePadAxisTypeMax];
+    NGP_AxisResponse      responses[NGP_GamePadAxisTypeMax];
+    uint32_t              version;
+    NGP_CalibrationEntry* next;
+};
+
+bool NGP_CalibrationEnabled;
+
+static pthread_mutex_t       entries_lock = PTHREAD_MUTEX_INITIALIZER;
+static NGP_CalibrationEntry* entries;
+
+/* Recycled rather than freed, so pads coming and going do not reach the allocator */
+static NGP_Pool tables_pool = NGP_POOL_INIT(NGP_CalibrationTables, 1, NGP_MAX_GAMEPADS);
+
+static void DefaultRanges(NGP_AxisCalibration ranges[NGP_GamePadAxisTypeMax]) {
+    for (int axis = 0; axis < NGP_GamePadAxisTypeMax; axis++) {
+        int16_t min  = axis < NGP_CALIBRATION_STICKS ? -NGP_CALIBRATION_EXTENT : 0;
+        ranges[axis] = (NGP_AxisCalibration){ min, 0, NGP_CALIBRATION_EXTENT };
+    }
+}
+
+/* Returns the pad's entry, adding it the first time the pad is seen. Called with entries_lock. */
+static NGP_CalibrationEntry* FindEntry(const NGP_DeviceGUID* guid, const char* serial) {
+    for (NGP_CalibrationEntry* entry = entries; entry; entry = entry->next) {
+        if (memcmp(&entry->guid, guid, sizeof(*guid)) == 0 && strcmp(entry->serial, serial) == 0) {
+            return entry;
+        }
+    }
+    NGP_CalibrationEntry* entry =
+        NGP_MallocPermanent(sizeof(*entry), _Alignof(NGP_CalibrationEntry));
+    if (!entry) {
+        return NULL;
+    }
+    memset(entry, 0, sizeof(*entry)); /* linear responses without deadzones */
+    entry->guid   = *guid;
+    entry->serial = NGP_Intern(serial);
+    DefaultRanges(entry->ranges);
+    entry->next = entries;
+    entries     = entry;
+    return entry;
+}
+
+/* The knots of a spline response with the tangents that keep it monotonic between them */
+static int SplineKnots(const NGP_AxisResponse* response, float* x, float* y, float* tangent) {
+    int knots  = 0;
+    x[knots]   = 0.0f;
+    y[knots++] = 0.0f;
+    for (int i = 0; i < response->PointCount; i++) {
+        x[knots]   = response->Points[i][0];
+        y[knots++] = response->Points[i][1];
+    }
+    x[knots]   = 1.0f;
+    y[knots++] = 1.0f;
+
+    float slope[NGP_MAX_CURVE_POINTS + 1];
+    for (int k = 0; k + 1 < knots; k++) {
+        slope[k] = (y[k + 1] - y[k]) / (x[k + 1] - x[k]);
+    }
+    tangent[0]         = slope[0];
+    tangent[knots - 1] = slope[knots - 2];
+    for (int k = 1; k + 1 < knots; k++) {
+        /* the harmonic mean of the slopes either side never overshoots, flat where they turn */
+        float a    = slope[k - 1];
+        float b    = slope[k];
+        tangent[k] = a * b > 0.0f ? 2.0f * a * b / (a + b) : 0.0f;
+    }
+    return knots;
+}
+
+/* Samples the response curve at NGP_CALIBRATION_CURVE_STEPS + 1 deflections from 0 to 1 */
+static void BuildCurve(float* curve, const NGP_AxisResponse* response) {
+    float x[NGP_MAX_CURVE_POINTS + 2];
+    float y[NGP_MAX_CURVE_POINTS + 2];
+    float tangent[NGP_MAX_CURVE_POINTS + 2];
+    int   knots   = response->Type == NGP_CurveSpline ? SplineKnots(response, x, y, tangent) : 0;
+    int   segment = 0;
+    for (int i = 0; i <= NGP_CALIBRATION_CURVE_STEPS; i++) {
+        float in  = (float)i / NGP_CALIBRATION_CURVE_STEPS;
+        float out = in;
+        switch (response->Type) {
+            case NGP_CurveExponential:
+                out = powf(in, response->Shape);
+                break;
+            case NGP_CurveSCurve: {
+                float rising  = powf(in, response->Shape);
+                float falling = powf(1.0f - in, response->Shape);
+                out           = rising / (rising + falling);
+                break;
+            }
+            case NGP_CurveSpline: {
+                while (segment < knots - 2 && in > x[segment + 1]) {
+                    segment++;
+                }
+                float h  = x[segment + 1] - x[segment];
+                float s  = (in - x[segment]) / h;
+                float s2 = s * s;
+                float s3 = s2 * s;
+                out      = (2 * s3 - 3 * s2 + 1) * y[segment] + (3 * s2 - 2 * s3) * y[segment + 1] +
+                      ((s3 - 2 * s2 + s) * tangent[segment] + (s3 - s2) * tangent[segment + 1]) * h;
+                break;
+            }
+            default:
+                break;
+        }
+        curve[i] = fminf(fmaxf(out, 0.0f), 1.0f);
+    }
+}
+
+/* Fills the axis' table from its range, deadzones and curve */
+static void BuildTable(NGP_CalibrationTables* c, int axis) {
+    const NGP_AxisCalibration* range    = &c->ranges[axis];
+    const NGP_AxisResponse*    response = &c->responses[axis];
+    const float*               curve    = c->curves[axis];
+    bool                       trigger  = axis >= NGP_CALIBRATION_STICKS;
+    int                        center   = trigger ? range->Min : range->Center;
+    float below = (float)(center > range->Min ? center - range->Min : 1);
+    float above = (float)(range->Max > center ? range->Max - center : 1);
+
+    for (int i = 0; i < NGP_CALIBRATION_TABLE_SIZE; i++) {
+        int   raw        = (int16_t)i;
+        float deflection = raw >= center ? (float)(raw - center) / above
+                           : trigger     ? 0.0f
+                                         : (float)(raw - center) / below;
+        float magnitude  = fminf(fabsf(deflection), 1.0f);
+        float value      = 0.0f;
+        if (magnitude > response->Deadzone) {
+            float position = (magnitude - response->Deadzone) / (1.0f - response->Deadzone) *
+                             NGP_CALIBRATION_CURVE_STEPS;
+            int step = position < NGP_CALIBRATION_CURVE_STEPS ? (int)position
+                                                              : NGP_CALIBRATION_CURVE_STEPS - 1;
+            value    = curve[step] + (curve[step + 1] - curve[step]) * (position - (float)step);
+            value    = response->AntiDeadzone + (1.0f - response->AntiDeadzone) * value;
+        }
+        c->tables[axis][i] = deflection < 0.0f ? (int16_t)lrintf(-value * 32768.0f)
+                                               : (int16_t)lrintf(value * 32767.0f);
+    }
+}
+
+/*
+ * A stick that holds still near 0 for NGP_CALIBRATION_REST_REPORTS reports is resting, where it
+ * sat on average is its center from then on
+ */
+static void LearnCenters(NGP_CalibrationTables* c) {
+    for (int axis = 0; axis < NGP_CALIBRATION_STICKS; axis++) {
+        int raw = c->raw[axis];
+        if (abs(raw) > NGP_CALIBRATION_REST_RANGE ||
+            abs(raw - c->rest_from[axis]) > NGP_CALIBRATION_REST_JITTER) {
+            c->rest_from[axis]    = (int16_t)raw;
+            c->rest_reports[axis] = 0;
+            c->rest_sum[axis]     = 0;
+            continue;
+        }
+        c->rest_sum[axis] += raw;
+        if (++c->rest_reports[axis] < NGP_CALIBRATION_REST_REPORTS) {
+            continue;
+        }
+        int center            = c->rest_sum[axis] / NGP_CALIBRATION_REST_REPORTS;
+        c->rest_reports[axis] = 0;
+        c->rest_sum[axis]     = 0;
+        /* the last few units are noise, not worth a new table */
+        if (abs(center - c->ranges[axis].Center) > NGP_CALIBRATION_REST_JITTER / 8) {
+            c->ranges[axis].Center = (int16_t)center;
+            c->stale |= (uint8_t)(1u << axis);
+        }
+    }
+}
+
+/* Copies the entry's ranges and responses in, every table then needs building */
+static void Sync(NGP_CalibrationTables* c) {
+    pthread_mutex_lock(&entries_lock);
+    c->version = c->entry->version;
+    memcpy(c->ranges, c->entry->ranges, sizeof(c->ranges));
+    memcpy(c->responses, c->entry->responses, sizeof(c->responses));
+    pthread_mutex_unlock(&entries_lock);
+    for (int axis = 0; axis < NGP_GamePadAxisTypeMax; axis++) {
+        BuildCurve(c->curves[axis], &c->responses[axis]);
+    }
+    c->stale = NGP_CALIBRATION_ALL_AXES;
+}
+
+static NGP_CalibrationTables* Start(NGP_Device* device) {
+    NGP_CalibrationTables* c = NGP_PoolAlloc(&tables_pool);
+    if (!c) {
+        return NULL;
+    }
+    pthread_mutex_lock(&entries_lock);
+    c->entry = FindEntry(&device->guid, device->serial);
+    if (c->entry) {
+        c->version = c->entry->version - 1; /* so the first pass copies the entry in */
+    }
+    pthread_mutex_unlock(&entries_lock);
+    if (!c->entry) {
+        NGP_PoolFree(&tables_pool, c);
+        return NULL;
+    }
+    memcpy(c->raw, device->state.Axes, sizeof(c->raw)); /* raw while calibration was off */
+    device->calibration = c;
+    return c;
+}
+
+void NGP_DeviceFreeCalibration(NGP_Device* device) {
+    NGP_PoolFree(&tables_pool, device->calibration);
+    device->calibration = NULL;
+}
+
+void NGP_DeviceCalibrate(NGP_Device* device) {
+    NGP_CalibrationTables* c = device->calibration;
+    if (!__atomic_load_n(&NGP_CalibrationEnabled, __ATOMIC_RELAXED)) {
+        if (!c) {
+            return; /* turned off again since the caller looked */
+        }
+        int16_t raw[NGP_GamePadAxisTypeMax];
+        memcpy(raw, c->raw, sizeof(raw));
+        NGP_DeviceFreeCalibration(device);
+        for (int axis = 0; axis < NGP_GamePadAxisTypeMax; axis++) {
+            NGP_DeviceSetAxis(device, (NGP_GamePadAxisType)axis, raw[axis]);
+        }
+        return;
+    }
+    if (!c && !(c = Start(device))) {
+        return;
+    }
+    LearnCenters(c);
+    bool          changed = __atomic_load_n(&c->entry->version, __ATOMIC_ACQUIRE) != c->version;
+    NGP_Timestamp now     = device->state.Timestamp;
+    if (changed) {
+        Sync(c);
+    } else if (!c->stale || (now >= c->built && now - c->built < NGP_CALIBRATION_REBUILD_NS)) {
+        return; /* a range still growing as the stick sweeps out is rebuilt at most this often */
+    }
+
+    uint8_t stale = c->stale;
+    c->stale      = 0;
+    c->built      = now;
+    for (uint8_t bits = stale; bits; bits &= bits - 1) {
+        int axis = __builtin_ctz(bits);
+        if (axis >= NGP_CALIBRATION_STICKS) {
+            c->ranges[axis].Center = c->ranges[axis].Min;
+        }
+        BuildTable(c, axis);
+    }
+    pthread_mutex_lock(&entries_lock);
+    if (c->entry->version == c->version) {
+        memcpy(c->entry->ranges, c->ranges, sizeof(c->ranges));
+    }
+    pthread_mutex_unlock(&entries_lock);
+    for (uint8_t bits = stale; bits; bits &= bits - 1) {
+        int axis = __builtin_ctz(bits);
+        NGP_DeviceSetAxis(device, (NGP_GamePadAxisType)axis, c->raw[axis]);
+    }
+}
+
+/* Takes entries_lock and returns the entry of the pad behind the handle, NULL once detached */
+static NGP_CalibrationEntry* LockEntry(NGP_GamePad* p, NGP_GamePadAxisType axis) {
+    NGP_Device* device = NGP_DeviceLookup(NGP_GamePadGetID(p));
+    if (!device || axis < 0 || axis >= NGP_GamePadAxisTypeMax) {
+        return NULL;
+    }
+    pthread_mutex_lock(&entries_lock);
+    NGP_CalibrationEntry* entry = FindEntry(&device->guid, device->serial);
+    if (!entry) {
+        pthread_mutex_unlock(&entries_lock);
+    }
+    return entry;
+}
+
+/* Hands a change to the entry over to the I/O thread, called with entries_lock */
+static void Changed(NGP_CalibrationEntry* entry) {
+    __atomic_store_n(&entry->version, entry->version + 1, __ATOMIC_RELEASE);
+}
+
+static bool ValidResponse(const NGP_AxisResponse* response) {
+    if (!(response->Deadzone >= 0.0f && response->Deadzone < 1.0f) ||
+        !(response->AntiDeadzone >= 0.0f && response->AntiDeadzone < 1.0f)) {
+        return false;
+    }
+    switch (response->Type) {
+        case NGP_CurveLinear:
+            return true;
+        case NGP_CurveExponential:
+        case NGP_CurveSCurve:
+            return response->Shape > 0.0f && response->Shape < INFINITY;
+        case NGP_CurveSpline:
+            if (response->PointCount < 0 || response->PointCount > NGP_MAX_CURVE_POINTS) {
+                return false;
+            }
+            for (int i = 0; i < response->PointCount; i++) {
+                float in   = response->Points[i][0];
+                float out  = response->Points[i][1];
+                float last = i > 0 ? response->Points[i - 1][0] : 0.0f;
+                if (!(in > last && in < 1.0f) || !(out >= 0.0f && out <= 1.0f)) {
+                    return false;
+                }
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+DECLSPEC void NGPCALL NGP_SetCalibrationEnabled(bool enabled) {
+    __atomic_store_n(&NGP_CalibrationEnabled, enabled, __ATOMIC_RELAXED);
+}
+
+DECLSPEC bool NGPCALL NGP_GamePadSetAxisResponse(NGP_GamePad*            p,
+                                                 NGP_GamePadAxisType     axis,
+                                                 const NGP_AxisResponse* response) {
+    static const NGP_AxisResponse linear = { NGP_CurveLinear };
+    if (response && !ValidResponse(response)) {
+        return false;
+    }
+    NGP_CalibrationEntry* entry = LockEntry(p, axis);
+    if (!entry) {
+        return false;
+    }
+    entry->responses[axis] = response ? *response : linear;
+    Changed(entry);
+    pthread_mutex_unlock(&entries_lock);
+    return true;
+}
+
+DECLSPEC bool NGPCALL NGP_GamePadGetAxisCalibration(NGP_GamePad*         p,
+                                                    NGP_GamePadAxisType  axis,
+                                                    NGP_AxisCalibration* calibration) {
+    NGP_CalibrationEntry* entry = calibration ? LockEntry(p, axis) : NULL;
+    if (!entry) {
+        return false;
+    }
+    *calibration = entry->ranges[axis];
+    pthread_mutex_unlock(&entries_lock);
+    return true;
+}
+
+DECLSPEC bool NGPCALL NGP_GamePadResetCalibration(NGP_GamePad* p) {
+    NGP_CalibrationEntry* entry = LockEntry(p, NGP_GamePadAxisTypeLeftX);
+    if (!entry) {
+        return false;
+    }
+    DefaultRanges(entry->ranges);
+    Changed(entry);
+    pthread_mutex_unlock(&entries_lock);
+    return true;
+}
+
+/*
+ * The file is text, the header line then a line per pad: its GUID in hex, the Min, Center and Max
+ * of each axis, and its serial if it has one.
+ */
+DECLSPEC bool NGPCALL NGP_SaveCalibrations(const char* path) {
+    FILE* file = path ? fopen(path, "w") : NULL;
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "%s\n", NGP_CALIBRATION_FILE_HEADER);
+    pthread_mutex_lock(&entries_lock);
+    for (const NGP_CalibrationEntry* entry = entries; entry; entry = entry->next) {
+        for (size_t i = 0; i < sizeof(entry->guid.data); i++) {
+            fprintf(file, "%02x", entry->guid.data[i]);
+        }
+        for (int axis = 0; axis < NGP_GamePadAxisTypeMax; axis++) {
+            const NGP_AxisCalibration* range = &entry->ranges[axis];
+            fprintf(file, " %d %d %d", range->Min, range->Center, range->Max);
+        }
+        fprintf(file, "%s%s\n", *entry->serial ? " " : "", entry->serial);
+    }
+    pthread_mutex_unlock(&entries_lock);
+    bool ok = !ferror(file);
+    return fclose(file) == 0 && ok;
+}
+
+/* Reads one pad's line, false unless it is complete and its ranges make sense */
+static bool ParseLine(const char*         line,
+                      NGP_DeviceGUID*     guid,
+                      NGP_AxisCalibration ranges[NGP_GamePadAxisTypeMax],
+                      char                serial[NGP_NAME_LEN]) {
+    for (size_t i = 0; i < sizeof(guid->data); i++, line += 2) {
+        unsigned int byte;
+        if (sscanf(line, "%2x", &byte) != 1) {
+            return false;
+        }
+        guid->data[i] = (uint8_t)byte;
+    }
+    for (int axis = 0; axis < NGP_GamePadAxisTypeMax; axis++) {
+        int min, center, max, used;
+        if (sscanf(line, " %d %d %d%n", &min, &center, &max, &used) != 3 || min < INT16_MIN ||
+            max > INT16_MAX || !(min <= center && center <= max && min < max)) {
+            return false;
+        }
+        ranges[axis] = (NGP_AxisCalibration){ (int16_t)min, (int16_t)center, (int16_t)max };
+        line += used;
+    }
+    line += *line == ' ';
+    snprintf(serial, NGP_NAME_LEN, "%.*s", (int)strcspn(line, "\r\n"), line);
+    return true;
+}
+
+DECLSPEC bool NGPCALL NGP_LoadCalibrations(const char* path) {
+    FILE* file = path ? fopen(path, "r") : NULL;
+    if (!file) {
+        return false;
+    }
+    char line[NGP_CALIBRATION_LINE_LEN];
+    bool ok = fgets(line, sizeof(line), file) &&
+              strncmp(line, NGP_CALIBRATION_FILE_HEADER, strlen(NGP_CALIBRATION_FILE_HEADER)) == 0;
+
+    /* the first pass only checks, so a bad line leaves every pad as it was */
+    for (int pass = 0; ok && pass < 2; pass++) {
+        long start = ftell(file);
+        while (ok && fgets(line, sizeof(line), file)) {
+            NGP_DeviceGUID      guid;
+            NGP_AxisCalibration ranges[NGP_GamePadAxisTypeMax];
+            char                serial[NGP_NAME_LEN];
+            if (line[0] == '\n' || line[0] == '#') {
+                continue;
+            }
+            ok = ParseLine(line, &guid, ranges, serial);
+            if (ok && pass == 1) {
+                pthread_mutex_lock(&entries_lock);
+                NGP_CalibrationEntry* entry = FindEntry(&guid, serial);
+                if (entry) {
+                    memcpy(entry->ranges, ranges, sizeof(entry->ranges));
+                    Changed(entry);
+                }
+                pthread_mutex_unlock(&entries_lock);
+            }
+        }
+        ok = ok && !ferror(file) && fseek(file, start, SEEK_SET) == 0;
+    }
+    fclose(file);
+    return ok;
+}
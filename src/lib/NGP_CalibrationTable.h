@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+#include "NGP_Internal.h"
+
+#define NGP_CALIBRATION_TABLE_SIZE 65536 /* one entry per raw value, indexed by (uint16_t)raw */
+#define NGP_CALIBRATION_CURVE_STEPS 1024 /* samples of the response curve the tables interpolate */
+#define NGP_CALIBRATION_EXTENT 24576     /* the reach assumed until an axis goes further */
+#define NGP_CALIBRATION_REBUILD_NS 100000000LL /* how often a growing range rebuilds its table */
+#define NGP_CALIBRATION_REST_RANGE 2048   /* how far from 0 a resting stick may sit */
+#define NGP_CALIBRATION_REST_JITTER 96    /* how far a resting stick wanders */
+#define NGP_CALIBRATION_REST_REPORTS 250  /* reports held still before it counts as resting */
+
+/* What is known about one pad, kept for the life of the process, see NGP_CalibrationTable.c */
+typedef struct NGP_CalibrationEntry NGP_CalibrationEntry;
+
+/*
+ * A device's calibration while it is on, owned by the I/O thread. Raw values go through the
+ * axis' table on their way into the state, and the ranges learned from them are copied back to
+ * the entry whenever a table is rebuilt.
+ */
+typedef struct NGP_CalibrationTables {
+    int16_t               tables[NGP_GamePadAxisTypeMax][NGP_CALIBRATION_TABLE_SIZE];
+    float                 curves[NGP_GamePadAxisTypeMax][NGP_CALIBRATION_CURVE_STEPS + 1];
+    NGP_AxisResponse      responses[NGP_GamePadAxisTypeMax];
+    NGP_AxisCalibration   ranges[NGP_GamePadAxisTypeMax];
+    int16_t               raw[NGP_GamePadAxisTypeMax]; /* the last value each axis reported */
+    int16_t               rest_from[NGP_GamePadAxisTypeMax]; /* where the stick last stopped */
+    uint16_t              rest_reports[NGP_GamePadAxisTypeMax];
+    int32_t               rest_sum[NGP_GamePadAxisTypeMax];
+    uint8_t               stale; /* axes whose range moved since their table was built */
+    uint32_t              version; /* of the entry the ranges and responses were copied from */
+    NGP_Timestamp         built;
+    NGP_CalibrationEntry* entry;
+} NGP_CalibrationTables;
+
+/**
+ * Maps a raw axis value to its calibrated one, widening the axis' range if the value lies beyond it
+ * @param c
+ * @param axis
+ * @param raw
+ * @return the calibrated value, from the table as it was last built
+ */
+static inline int16_t NGP_CalibrationApply(NGP_CalibrationTables* c,
+                                           NGP_GamePadAxisType    axis,
+                                           int16_t                raw) {
+    NGP_AxisCalibration* range = &c->ranges[axis];
+    c->raw[axis]               = raw;
+    if (raw < range->Min || raw > range->Max) {
+        if (raw < range->Min) {
+            range->Min = raw;
+        } else {
+            range->Max = raw;
+        }
+        c->stale |= (uint8_t)(1u << axis);
+    }
+    return c->tables[axis][(uint16_t)raw];
+}
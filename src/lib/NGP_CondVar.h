@@ -0,0 +1,51 @@
+#pragma once
+
+#include <pthread.h>
+#include <time.h>
+#include "NGP_Internal.h"
+
+/*
+ * Timed waits on a condition variable against the NGP_GetTicksNS clock. A plain
+ * pthread_cond_timedwait times out against the wall clock, which can be stepped while it waits and
+ * so stretch the wait or cut it short.
+ */
+
+/**
+ * Initializes a condition variable NGP_CondWaitUntil may wait on, once before it is first used
+ * @param cond
+ */
+static inline void NGP_CondInit(pthread_cond_t* cond) {
+#ifdef __APPLE__
+    pthread_cond_init(cond, NULL); /* waited on with a relative timeout instead */
+#else
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+#endif
+}
+
+/**
+ * Waits for the condition variable to be signaled or the deadline to pass, whichever is first
+ * @param cond initialized with NGP_CondInit
+ * @param lock held by the caller
+ * @param deadline NGP_GetTicksNS time
+ */
+static inline void NGP_CondWaitUntil(pthread_cond_t*  cond,
+                                     pthread_mutex_t* lock,
+                                     NGP_Timestamp    deadline) {
+    struct timespec ts;
+#ifdef __APPLE__
+    NGP_Timestamp left = deadline - NGP_GetTicksNS();
+    left               = left > 0 ? left : 0;
+    ts.tv_sec          = (time_t)(left / 1000000000LL);
+    ts.tv_nsec         = (long)(left % 1000000000LL);
+    pthread_cond_timedwait_relative_np(cond, lock, &ts);
+#else
+    /* NGP_GetTicksNS reads CLOCK_MONOTONIC here, the clock NGP_CondInit set */
+    ts.tv_sec  = (time_t)(deadline / 1000000000LL);
+    ts.tv_nsec = (long)(deadline % 1000000000LL);
+    pthread_cond_timedwait(cond, lock, &ts);
+#endif
+}
@@ -0,0 +1,273 @@
+#include "NGP_Device.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#include "NGP_Pool.h"
+
+#define NGP_DEVICE_CHUNK 64 /* records are allocated 64 at a time, the first time one is needed */
+#define NGP_DEVICE_CHUNKS (NGP_MAX_GAMEPADS / NGP_DEVICE_CHUNK)
+
+/*
+ * Records are never freed, only recycled, so a handle that outlives its pad still points at valid
+ * memory. The free masks mirror the registry's: bit n of word w is record w*64+n.
+ */
+static NGP_Device*     chunks[NGP_DEVICE_CHUNKS];
+static uint64_t        free_words[NGP_DEVICE_CHUNKS];
+static uint64_t        free_summary;
+static bool            devices_ready;
+static NGP_Registry    registry;
+static pthread_mutex_t devices_lock = PTHREAD_MUTEX_INITIALIZER; /* serializes registry updates */
+static uint64_t        id_counter;
+
+/* Records with pending_axes set, laid out like the free masks and only touched on the I/O thread */
+static uint64_t pending_words[NGP_DEVICE_CHUNKS];
+static uint64_t pending_summary;
+
+NGP_Timestamp NGP_AxisCoalescingWindow;
+
+static void InitDevices(void) {
+    memset(free_words, 0xff, sizeof(free_words));
+    free_summary = ~0ULL;
+    NGP_RegistryInit(&registry);
+    devices_ready = true;
+}
+
+static NGP_Device* RecordAt(int index) {
+    NGP_Device** chunk = &chunks[index / NGP_DEVICE_CHUNK];
+    if (!*chunk) {
+        size_t size = sizeof(NGP_Device) * NGP_DEVICE_CHUNK;
+        if (!(*chunk = NGP_MallocPermanent(size, _Alignof(NGP_Device)))) {
+            return NULL;
+        }
+        memset(*chunk, 0, size);
+    }
+    return &(*chunk)[index % NGP_DEVICE_CHUNK];
+}
+
+NGP_Device* NGP_DeviceAcquire(void) {
+    NGP_Device* device = NULL;
+    pthread_mutex_lock(&devices_lock);
+    if (!devices_ready) {
+        InitDevices();
+    }
+    if (free_summary) {
+        int word  = __builtin_ctzll(free_summary);
+        int index = word * 64 + __builtin_ctzll(free_words[word]);
+        device    = RecordAt(index);
+        if (device) {
+            free_words[word] &= ~(1ULL << (index % 64));
+            if (free_words[word] == 0) {
+                free_summary &= ~(1ULL << word);
+            }
+            /* the sequence carries over so a reader holding a stale handle never sees it go back */
+            NGP_SeqLock lock = device->lock;
+            memset(device, 0, sizeof(*device));
+            device->lock   = lock;
+            device->name   = "";
+            device->serial = "";
+            device->id     = NGP_INVALID_GAMEPAD_ID;
+            device->index  = (uint16_t)index;
+            device->in_use = true;
+        }
+    }
+    pthread_mutex_unlock(&devices_lock);
+    return device;
+}
+
+bool NGP_DeviceAttach(NGP_Device* device) {
+    pthread_mutex_lock(&devices_lock);
+    NGP_GamePadID id = NGP_RegistryInsert(&registry, device);
+    if (id != NGP_INVALID_GAMEPAD_ID) {
+        device->id          = id;
+        device->instance_id = id_counter++;
+        __atomic_store_n(&device->attached, true, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&devices_lock);
+    if (id == NGP_INVALID_GAMEPAD_ID) {
+        return false;
+    }
+    NGP_PushEvent(NGP_EventGamePadAttached, id, NULL);
+    if (__atomic_load_n(&NGP_DispatchEnabled, __ATOMIC_RELAXED)) {
+        NGP_DispatchReady();
+    }
+    NGP_LatencyPadAttached();
+    if (__atomic_load_n(&NGP_RecordingEnabled, __ATOMIC_RELAXED)) {
+        NGP_RecordDeviceFrame(device);
+    }
+    if (__atomic_load_n(&NGP_SharedStateEnabled, __ATOMIC_RELAXED)) {
+        NGP_SharedStatePublish(device);
+    }
+    return true;
+}
+
+void NGP_DeviceRelease(NGP_Device* device) {
+    if (device->pending_axes) {
+        NGP_DeviceFlushAxes(device);
+    }
+    if (device->calibration) {
+        NGP_DeviceFreeCalibration(device);
+    }
+    if (device->attached) {
+        NGP_PushEvent(NGP_EventGamePadDetached, device->id, NULL);
+        if (__atomic_load_n(&NGP_DispatchEnabled, __ATOMIC_RELAXED)) {
+            NGP_DispatchReady();
+        }
+        if (__atomic_load_n(&NGP_RecordingEnabled, __ATOMIC_RELAXED)) {
+            NGP_RecordDeviceRemoved(device);
+        }
+        if (__atomic_load_n(&NGP_SharedStateEnabled, __ATOMIC_RELAXED)) {
+            NGP_SharedStateRemove(device);
+        }
+    }
+    pthread_mutex_lock(&devices_lock);
+    if (device->attached) {
+        NGP_RegistryRemove(&registry, device->id);
+    }
+    /* after the registry, so no request can slip in behind them */
+    NGP_HapticsCancel(device);
+    NGP_OutputCancel(device);
+    __atomic_store_n(&device->attached, false, __ATOMIC_RELEASE);
+    device->in_use  = false;
+    device->backend = NULL;
+    free_words[device->index / 64] |= 1ULL << (device->index % 64);
+    free_summary |= 1ULL << (device->index / 64);
+    pthread_mutex_unlock(&devices_lock);
+}
+
+int NGP_DeviceCount(void) {
+    pthread_mutex_lock(&devices_lock);
+    if (!devices_ready) {
+        InitDevices();
+    }
+    int count = registry.count;
+    pthread_mutex_unlock(&devices_lock);
+    return count;
+}
+
+NGP_GamePadID NGP_DeviceAtIndex(int index) {
+    pthread_mutex_lock(&devices_lock);
+    if (!devices_ready) {
+        InitDevices();
+    }
+    NGP_GamePadID id = NGP_RegistryAt(&registry, index);
+    pthread_mutex_unlock(&devices_lock);
+    return id;
+}
+
+NGP_Device* NGP_DeviceLookup(NGP_GamePadID id) { return NGP_RegistryLookup(&registry, id); }
+
+void NGP_DeviceApplyState(NGP_Device* device, const NGP_GamePadState* report) {
+    for (int axis = 0; axis < NGP_GamePadAxisTypeMax; axis++) {
+        NGP_DeviceSetAxis(device, (NGP_GamePadAxisType)axis, report->Axes[axis]);
+    }
+    uint32_t changed = report->Buttons ^ device->state.Buttons;
+    while (changed) {
+        int button = __builtin_ctz(changed);
+        changed &= changed - 1;
+        NGP_DeviceSetButton(device, (NGP_GamePadButtonType)button, report->Buttons & (1u << button));
+    }
+    for (int i = 0; device->touchpads && i < NGP_MAX_TOUCHPAD_FINGERS; i++) {
+        NGP_DeviceSetFinger(device, i, &report->Fingers[i]);
+    }
+    NGP_DeviceSetSensor(device, NGP_GamePadSensorAccelerometer, report->Accel);
+    NGP_DeviceSetSensor(device, NGP_GamePadSensorGyroscope, report->Gyro);
+}
+
+void NGP_DeviceCoalesceAxis(NGP_Device* device, NGP_GamePadAxisType axis, int16_t previous) {
+    uint8_t bit = (uint8_t)(1u << axis);
+    if (device->pending_axes & bit) {
+        return; /* the last value wins, the event will carry whatever the axis holds at the flush */
+    }
+    device->pending_from[axis] = previous;
+    if (!device->pending_axes) {
+        device->pending_deadline =
+            device->state.Timestamp + __atomic_load_n(&NGP_AxisCoalescingWindow, __ATOMIC_RELAXED);
+        pending_words[device->index / 64] |= 1ULL << (device->index % 64);
+        pending_summary |= 1ULL << (device->index / 64);
+    }
+    device->pending_axes |= bit;
+}
+
+void NGP_DeviceFlushAxes(NGP_Device* device) {
+    uint8_t pending      = device->pending_axes;
+    device->pending_axes = 0;
+    pending_words[device->index / 64] &= ~(1ULL << (device->index % 64));
+    if (pending_words[device->index / 64] == 0) {
+        pending_summary &= ~(1ULL << (device->index / 64));
+    }
+    while (pending) {
+        int axis = __builtin_ctz(pending);
+        pending &= pending - 1;
+        int16_t value = device->state.Axes[axis];
+        if (value == device->pending_from[axis]) {
+            continue; /* moved and came back within the window */
+        }
+        NGP_Event e;
+        e.Event.AxisEvent.AxisType = (NGP_GamePadAxisType)axis;
+        e.Event.AxisEvent.Data     = value;
+        e.Timestamp                = device->state.Timestamp;
+        NGP_PushEvent(NGP_EventAxis, device->id, &e);
+    }
+}
+
+DECLSPEC void NGPCALL NGP_SetAxisCoalescing(NGP_Timestamp window) {
+    __atomic_store_n(&NGP_AxisCoalescingWindow, window > 0 ? window : 0, __ATOMIC_RELAXED);
+}
+
+int NGP_DeviceFlushDue(void) {
+    if (!pending_summary) {
+        return -1;
+    }
+    NGP_Timestamp now      = NGP_GetTicksNS();
+    NGP_Timestamp next     = INT64_MAX;
+    bool          flushall = __atomic_load_n(&NGP_AxisCoalescingWindow, __ATOMIC_RELAXED) == 0;
+    for (uint64_t summary = pending_summary; summary; summary &= summary - 1) {
+        int word = __builtin_ctzll(summary);
+        for (uint64_t bits = pending_words[word]; bits; bits &= bits - 1) {
+            int         index  = word * 64 + __builtin_ctzll(bits);
+            NGP_Device* device = &chunks[index / NGP_DEVICE_CHUNK][index % NGP_DEVICE_CHUNK];
+            if (flushall || device->pending_deadline <= now) {
+                NGP_DeviceFlushAxes(device);
+            } else if (device->pending_deadline < next) {
+                next = device->pending_deadline;
+            }
+        }
+    }
+    if (__atomic_load_n(&NGP_DispatchEnabled, __ATOMIC_RELAXED)) {
+        NGP_DispatchReady();
+    }
+    if (next == INT64_MAX) {
+        return -1;
+    }
+    return (int)((next - now + 999999) / 1000000); /* rounded up, waking early would just spin */
+}
+
+void NGP_DeviceMakeGUID(NGP_Device* device) {
+    uint16_t* guid16 = (uint16_t*)device->guid.data;
+
+    memset(device->guid.data, 0, sizeof(device->guid.data));
+    *guid16++ = NGP_SwapLE16(device->bus);
+    *guid16++ = 0;
+    if (device->vendor_id && device->product_id) {
+        *guid16++ = NGP_SwapLE16(device->vendor_id);
+        *guid16++ = 0;
+        *guid16++ = NGP_SwapLE16(device->product_id);
+        *guid16++ = 0;
+        *guid16++ = NGP_SwapLE16(device->version);
+        *guid16++ = 0;
+    } else {
+        strncpy((char*)guid16, device->name, sizeof(device->guid.data) - 4);
+    }
+}
+
+void NGP_DeviceTrackGestures(NGP_Device* device) {
+    NGP_GestureEvent gestures[NGP_MAX_TOUCHPAD_FINGERS];
+    int              count = NGP_GestureUpdate(&device->gestures, &device->state, gestures);
+    for (int i = 0; i < count; i++) {
+        NGP_Event e;
+        e.Event.GestureEvent = gestures[i];
+        e.Timestamp          = device->state.Timestamp;
+        NGP_PushEvent(NGP_EventTouchpadGesture, device->id, &e);
+    }
+}
@@ -0,0 +1,422 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "NGP_AxisHistory.h"
+#include "NGP_CalibrationTable.h"
+#include "NGP_EventQueue.h"
+#include "NGP_Intern.h"
+#include "NGP_Internal.h"
+#include "NGP_Fusion.h"
+#include "NGP_Gesture.h"
+#include "NGP_Output.h"
+#include "NGP_Registry.h"
+#include "NGP_SeqLock.h"
+
+#define NGP_MAX_GAMEPADS NGP_REGISTRY_CAPACITY
+#define NGP_NAME_LEN 256 /* longest name or serial a backend reads, with its NUL */
+
+#define NGP_HARDWARE_BUS_USB 0x03
+#define NGP_HARDWARE_BUS_BLUETOOTH 0x05
+#define NGP_HARDWARE_BUS_VIRTUAL 0x06
+
+typedef struct NGP_DeviceGUID {
+    uint8_t data[16];
+} NGP_DeviceGUID;
+
+/*
+ * A frame's buttons along with a two bit count per button of how often it went down and up so
+ * far, bit 0 of every count in the first mask and bit 1 in the second. Whoever kept an earlier
+ * copy finds every button that went down or up since with a few bit operations, even when it went
+ * down and up again in between, missing only a button tapped a multiple of 4 times.
+ */
+typedef struct NGP_ButtonEdges {
+    uint32_t held;
+    uint32_t presses[2];
+    uint32_t releases[2];
+} NGP_ButtonEdges;
+
+/* Counts one more edge for every button in mask */
+static inline void NGP_ButtonEdgesCount(uint32_t count[2], uint32_t mask) {
+    count[1] ^= count[0] & mask;
+    count[0] ^= mask;
+}
+
+/* Returns the buttons whose count moved between two copies */
+static inline uint32_t NGP_ButtonEdgesSince(const uint32_t now[2], const uint32_t before[2]) {
+    return (now[0] ^ before[0]) | (now[1] ^ before[1]);
+}
+
+/*
+ * The backend independent record for one game pad. Device sources fill in the info fields between
+ * NGP_DeviceAcquire and NGP_DeviceAttach and update the state from the I/O thread, the public
+ * NGP_GamePad* getters only ever read from here.
+ */
+typedef struct NGP_Device {
+    NGP_DeviceGUID guid;
+
+    const char* name;   /* interned, see NGP_Intern, "" rather than NULL when unknown */
+    const char* serial; /* interned, "" when unknown */
+
+    NGP_GamePadID id;          /* registry handle, carried by every event for this pad */
+    uint64_t      instance_id; /* never reused, for NGP_GamePadJoystickID */
+
+    uint16_t bus;
+    uint16_t vendor_id;
+    uint16_t product_id;
+    uint16_t version;
+
+    uint8_t touchpads; /* how many touchpads the state's Fingers belong to, 0 or 1 */
+
+    uint16_t index; /* which record this is, for returning it to the free list */
+    bool     in_use;
+    bool     attached;
+    void*    backend; /* the device source's own record for this pad */
+
+    /* the I/O thread's working copy, updated field by field as a report is decoded */
+    NGP_GamePadState state;
+    NGP_ButtonEdges  edges; /* the counts, held is only filled in when they are published */
+
+    /*
+     * Axes changed since their last event while NGP_SetAxisCoalescing is on, the value each had in
+     * that event and the report time they are due at. Only touched on the I/O thread.
+     */
+    uint8_t       pending_axes;
+    int16_t       pending_from[NGP_GamePadAxisTypeMax];
+    NGP_Timestamp pending_deadline;
+
+    /* how LED and rumble requests reach the pad, NULL and 0 unless the source can write to it */
+    const NGP_DeviceTransport* transport;
+    uint8_t                    outputs; /* NGP_OutputType bits the transport can write */
+
+    /* the output queue's state for the pad, guarded by its lock, see NGP_Output.c */
+    uint8_t            output_dirty;
+    bool               output_queued;
+    NGP_DeviceOutput   output;
+    NGP_Timestamp      output_due; /* earliest time the next write may go out */
+    struct NGP_Device* output_link;
+    NGP_DeviceOutput   output_sent; /* what the last successful write said, I/O thread only */
+
+    /* playing haptics effects, guarded by the mixer's lock, see NGP_Haptics.c */
+    NGP_HapticsPlaying* effects;
+    int                 effect_count;
+    bool                haptics_queued;
+    struct NGP_Device*  haptics_link;
+    NGP_HapticsEffectID haptics_slots[NGP_HapticsSlotMax]; /* the rumble calls' effects, or 0 */
+    uint16_t            haptics_mixed[NGP_HapticsMotorMax]; /* the last mix, I/O thread only */
+
+    NGP_Fusion         fusion;   /* turns Accel and Gyro into the state's Orientation */
+    NGP_GestureTracker gestures; /* turns Fingers into gesture events, I/O thread only */
+
+    NGP_CalibrationTables* calibration; /* NULL while calibration is off, I/O thread only */
+
+    /* the last complete frame, copied from state by NGP_DevicePublish and read by the getters */
+    _Alignas(NGP_CACHE_LINE) NGP_SeqLock lock;
+    NGP_GamePadState published;
+    NGP_AxisHistory  history; /* the axes of the frames before it too, for NGP_GamePadAxisAt */
+    NGP_ButtonEdges  published_edges;
+} NGP_Device;
+
+/* Set while NGP_StartRecording is active, the device table then hands every frame to the recorder */
+extern bool NGP_RecordingEnabled;
+
+/* Set while NGP_StartSharedState is active, the device table then hands every frame to it */
+extern bool NGP_SharedStateEnabled;
+
+/* Set by NGP_SetCalibrationEnabled, devices then map their axes through calibration tables */
+extern bool NGP_CalibrationEnabled;
+
+/* The window set by NGP_SetAxisCoalescing, 0 while every axis change is queued as it happens */
+extern NGP_Timestamp NGP_AxisCoalescingWindow;
+
+/**
+ * Holds back an axis event until the device's coalescing window closes, called by
+ * NGP_DeviceSetAxis after it changed the value
+ * @param device
+ * @param axis
+ * @param previous the value before the change
+ */
+void NGP_DeviceCoalesceAxis(NGP_Device* device, NGP_GamePadAxisType axis, int16_t previous);
+
+/**
+ * Queues one event for every pending axis whose value differs from its last event
+ * @param device
+ */
+void NGP_DeviceFlushAxes(NGP_Device* device);
+
+/**
+ * Flushes every device whose coalescing window has closed, called by the I/O thread between pumps
+ * @return how long until the next window closes in ms, for the next pump's timeout, or -1
+ */
+int NGP_DeviceFlushDue(void);
+
+/**
+ * Advances the device's gesture tracker to its working state and queues the gestures it completes
+ * @param device
+ */
+void NGP_DeviceTrackGestures(NGP_Device* device);
+
+/**
+ * Learns from the device's last report and brings its calibration tables up to date, allocating
+ * them when calibration was turned on and freeing them when it was turned off. Called on the I/O
+ * thread before a frame is published, axes whose table changed are mapped again.
+ * @param device
+ */
+void NGP_DeviceCalibrate(NGP_Device* device);
+
+/**
+ * Frees the device's calibration tables, if any, without mapping its axes back
+ * @param device
+ */
+void NGP_DeviceFreeCalibration(NGP_Device* device);
+
+/**
+ * Records the device's working state as a frame, adding the device to the recording first if it is
+ * new to it. Called on the I/O thread.
+ * @param device
+ */
+void NGP_RecordDeviceFrame(const NGP_Device* device);
+
+/**
+ * Records that the device is going away
+ * @param device
+ */
+void NGP_RecordDeviceRemoved(const NGP_Device* device);
+
+/**
+ * Writes the device's working state into its shared memory slot, along with its ids and name if
+ * the slot held another pad. Called on the I/O thread.
+ * @param device
+ */
+void NGP_SharedStatePublish(const NGP_Device* device);
+
+/**
+ * Empties the device's shared memory slot
+ * @param device
+ */
+void NGP_SharedStateRemove(const NGP_Device* device);
+
+/**
+ * Claims a free, zeroed device record. It is not visible to NGP_NumGamePads until attached.
+ * @return the record or NULL if every slot is taken
+ */
+NGP_Device* NGP_DeviceAcquire(void);
+
+/**
+ * Publishes a filled in device record, registering it under a new id
+ * @param device
+ * @return false if the registry is full, the record stays acquired but invisible
+ */
+bool NGP_DeviceAttach(NGP_Device* device);
+
+/**
+ * Detaches the device and returns its record to the free slots. Open NGP_GamePad handles to it
+ * report as detached from then on.
+ * @param device
+ */
+void NGP_DeviceRelease(NGP_Device* device);
+
+/**
+ * Returns the number of attached devices
+ */
+int NGP_DeviceCount(void);
+
+/**
+ * Returns the id of the index-th attached device, see NGP_GamePadOpen for how indices move
+ * @param index
+ * @return the id or NGP_INVALID_GAMEPAD_ID
+ */
+NGP_GamePadID NGP_DeviceAtIndex(int index);
+
+/**
+ * Returns the attached device with the given id, lock free
+ * @param id
+ * @return the device or NULL once it has been released
+ */
+NGP_Device* NGP_DeviceLookup(NGP_GamePadID id);
+
+/**
+ * Fills the GUID from the bus, vendor, product and version, or from the name when there are no ids
+ * @param device
+ */
+void NGP_DeviceMakeGUID(NGP_Device* device);
+
+/**
+ * Updates the working state to a fully decoded report, queueing events for whatever changed
+ * @param device
+ * @param report
+ */
+void NGP_DeviceApplyState(NGP_Device* device, const NGP_GamePadState* report);
+
+/**
+ * Starts decoding a report, the events queued for it and the frame it publishes carry its time
+ * @param device
+ * @param timestamp when the OS received the report, on the NGP_GetTicksNS clock
+ */
+static inline void NGP_DeviceBeginReport(NGP_Device* device, NGP_Timestamp timestamp) {
+    device->state.Timestamp = timestamp;
+}
+
+/**
+ * Makes the working state visible to readers as one frame, called at the end of every report
+ * @param device
+ */
+static inline void NGP_DevicePublish(NGP_Device* device) {
+    /* pads without motion sensors never set Accel, a resting pad with them still reads 1 g */
+    const float* accel = device->state.Accel;
+    if (accel[0] != 0.0f || accel[1] != 0.0f || accel[2] != 0.0f) {
+        NGP_FusionUpdate(&device->fusion, &device->state);
+    }
+    if (device->gestures.dirty) {
+        NGP_DeviceTrackGestures(device);
+    }
+    if (device->calibration || __atomic_load_n(&NGP_CalibrationEnabled, __ATOMIC_RELAXED)) {
+        NGP_DeviceCalibrate(device);
+    }
+    device->state.Sequence++;
+    NGP_SeqLockWriteBegin(&device->lock);
+    device->published = device->state;
+    NGP_AxisHistoryPush(&device->history, &device->state);
+    device->edges.held      = device->state.Buttons;
+    device->published_edges = device->edges;
+    NGP_SeqLockWriteEnd(&device->lock);
+    if (__atomic_load_n(&NGP_RecordingEnabled, __ATOMIC_RELAXED) && device->attached) {
+        NGP_RecordDeviceFrame(device);
+    }
+    if (__atomic_load_n(&NGP_SharedStateEnabled, __ATOMIC_RELAXED) && device->attached) {
+        NGP_SharedStatePublish(device);
+    }
+    if (device->pending_axes && device->state.Timestamp >= device->pending_deadline) {
+        NGP_DeviceFlushAxes(device);
+    }
+    if (__atomic_load_n(&NGP_DispatchEnabled, __ATOMIC_RELAXED)) {
+        NGP_DispatchReady();
+    }
+}
+
+/**
+ * Copies the last published frame, safe from any thread
+ * @param device
+ * @param state
+ */
+static inline void NGP_DeviceReadState(const NGP_Device* device, NGP_GamePadState* state) {
+    NGP_SeqLockRead(&device->lock, state, &device->published, sizeof(*state));
+}
+
+/**
+ * Copies the buttons of the last published frame and their edge counts, safe from any thread
+ * @param device
+ * @param edges
+ */
+static inline void NGP_DeviceReadButtons(const NGP_Device* device, NGP_ButtonEdges* edges) {
+    NGP_SeqLockRead(&device->lock, edges, &device->published_edges, sizeof(*edges));
+}
+
+/* The setters below run on the I/O thread and queue an event for every change once attached */
+
+static inline void NGP_DeviceSetAxis(NGP_Device* device, NGP_GamePadAxisType axis, int16_t value) {
+    if (device->calibration) {
+        value = NGP_CalibrationApply(device->calibration, axis, value);
+    }
+    int16_t previous = device->state.Axes[axis];
+    if (previous == value) {
+        return;
+    }
+    device->state.Axes[axis] = value;
+    if (device->attached) {
+        if (__atomic_load_n(&NGP_AxisCoalescingWindow, __ATOMIC_RELAXED)) {
+            NGP_DeviceCoalesceAxis(device, axis, previous);
+            return;
+        }
+        NGP_Event e;
+        e.Event.AxisEvent.AxisType = axis;
+        e.Event.AxisEvent.Data     = value;
+        e.Timestamp                = device->state.Timestamp;
+        NGP_PushEvent(NGP_EventAxis, device->id, &e);
+    }
+}
+
+static inline void NGP_DeviceSetButton(NGP_Device*           device,
+                                       NGP_GamePadButtonType button,
+                                       bool                  pressed) {
+    if (button == NGP_GamePadButtonInvalid) {
+        return;
+    }
+    uint32_t mask    = 1u << button;
+    uint32_t buttons = pressed ? (device->state.Buttons | mask) : (device->state.Buttons & ~mask);
+    if (buttons == device->state.Buttons) {
+        return;
+    }
+    device->state.Buttons = buttons;
+    NGP_ButtonEdgesCount(pressed ? device->edges.presses : device->edges.releases, mask);
+    if (device->attached) {
+        if (device->pending_axes) {
+            NGP_DeviceFlushAxes(device); /* so a stick move never lands after a later press */
+        }
+        NGP_Event e;
+        e.Event.ButtonEvent.Button = button;
+        e.Event.ButtonEvent.State  = pressed;
+        e.Timestamp                = device->state.Timestamp;
+        NGP_PushEvent(pressed ? NGP_EventButtonDown : NGP_EventButtonUp, device->id, &e);
+    }
+}
+
+static inline void NGP_DevicePushFinger(NGP_Device*                   device,
+                                        NGP_EventType                 kind,
+                                        int                           index,
+                                        const NGP_GamePadStateFinger* finger) {
+    NGP_Event e;
+    e.Event.TouchpadEvent.X      = finger->X;
+    e.Event.TouchpadEvent.Y      = finger->Y;
+    e.Event.TouchpadEvent.Finger = (uint8_t)index;
+    e.Event.TouchpadEvent.ID     = finger->ID;
+    e.Timestamp                  = device->state.Timestamp;
+    NGP_PushEvent(kind, device->id, &e);
+}
+
+static inline void NGP_DeviceSetFinger(NGP_Device*                   device,
+                                       int                           index,
+                                       const NGP_GamePadStateFinger* finger) {
+    NGP_GamePadStateFinger* current = &device->state.Fingers[index];
+    if (memcmp(current, finger, sizeof(*finger)) == 0) {
+        return;
+    }
+    NGP_GamePadStateFinger previous = *current;
+    *current                        = *finger;
+    if (!device->attached || !(previous.State || finger->State)) {
+        return;
+    }
+    device->gestures.dirty = true;
+    if (previous.State && (!finger->State || finger->ID != previous.ID)) {
+        /* an up carries the id it went down with, a new contact in the slot lifts the old one */
+        if (!finger->State) {
+            previous.X = finger->X;
+            previous.Y = finger->Y;
+        }
+        NGP_DevicePushFinger(device, NGP_EventTouchpadUp, index, &previous);
+    }
+    if (finger->State) {
+        NGP_DevicePushFinger(device,
+                             previous.State && finger->ID == previous.ID ? NGP_EventTouchpadMotion
+                                                                         : NGP_EventTouchpadDown,
+                             index, finger);
+    }
+}
+
+static inline void NGP_DeviceSetSensor(NGP_Device*           device,
+                                       NGP_GamePadSensorType sensor,
+                                       const float           data[3]) {
+    float* current = sensor == NGP_GamePadSensorGyroscope ? device->state.Gyro : device->state.Accel;
+    if (memcmp(current, data, sizeof(float) * 3) == 0) {
+        return;
+    }
+    memcpy(current, data, sizeof(float) * 3);
+    if (device->attached) {
+        NGP_Event e;
+        e.Event.SensorEvent.Sensor = sensor;
+        memcpy(e.Event.SensorEvent.Data, data, sizeof(float) * 3);
+        e.Timestamp = device->state.Timestamp;
+        NGP_PushEvent(NGP_EventSensorData, device->id, &e);
+    }
+}
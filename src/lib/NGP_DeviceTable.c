@@ -0,0 +1,24 @@
+#include "NGP_DeviceTable.h"
+
+#define NGP_DEVICE_INFO(name, vendor, product, sony, touchpads, outputs, serial_report) \
+    static const NGP_DeviceInfo name##_info = {                                         \
+        vendor, product, sony, touchpads, outputs, serial_report,                       \
+    };
+NGP_DEVICE_TABLE(NGP_DEVICE_INFO)
+#undef NGP_DEVICE_INFO
+
+#define NGP_DEVICE_KEY(vendor, product) ((uint32_t)(vendor) << 16 | (uint32_t)(product))
+
+const NGP_DeviceInfo* NGP_DeviceInfoLookup(uint16_t vendor_id, uint16_t product_id) {
+/* a pad listed twice is a duplicate case label, so the table cannot disagree with itself */
+#define NGP_DEVICE_CASE(name, vendor, product, ...) \
+    case NGP_DEVICE_KEY(vendor, product):           \
+        return &name##_info;
+
+    switch (NGP_DEVICE_KEY(vendor_id, product_id)) {
+        NGP_DEVICE_TABLE(NGP_DEVICE_CASE)
+        default:
+            return NULL;
+    }
+#undef NGP_DEVICE_CASE
+}
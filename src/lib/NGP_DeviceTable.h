@@ -0,0 +1,41 @@
+#pragma once
+
+#include <NGP_USB_IDS.h>
+#include <stdint.h>
+#include "NGP_Internal.h"
+#include "NGP_Output.h"
+#include "NGP_SonyReport.h"
+
+/*
+ * Every pad that needs more than the backend's generic handling, one X(name, vendor, product,
+ * report parser, touchpads, outputs, serial report) per line, kept sorted by vendor then product.
+ * A backend looks its pad up once while attaching and copies what it needs into the device record,
+ * so the capability getters stay plain field reads.
+ */
+#define NGP_DEVICE_TABLE(X)                                                                      \
+    X(SonyDS4, USB_VENDOR_SONY, USB_PRODUCT_SONY_DS4, NGP_SonyModelDS4, 1,                       \
+      NGP_OutputLED | NGP_OutputRumble, NGP_USB_PS4_SerialRequestKey)                            \
+    X(SonyDS4Slim, USB_VENDOR_SONY, USB_PRODUCT_SONY_DS4_SLIM, NGP_SonyModelDS4, 1,              \
+      NGP_OutputLED | NGP_OutputRumble, NGP_USB_PS4_SerialRequestKey)                            \
+    X(SonyDS4Dongle, USB_VENDOR_SONY, USB_PRODUCT_SONY_DS4_DONGLE, NGP_SonyModelDS4, 1,          \
+      NGP_OutputLED | NGP_OutputRumble, 0)                                                       \
+    X(SonyDS5, USB_VENDOR_SONY, USB_PRODUCT_SONY_DS5, NGP_SonyModelDS5, 1,                       \
+      NGP_OutputLED | NGP_OutputRumble, NGP_USB_PS5_SerialRequestKey)
+
+typedef struct NGP_DeviceInfo {
+    uint16_t      vendor_id;
+    uint16_t      product_id;
+    NGP_SonyModel sony;          /* which report layout the input reports use, if any */
+    uint8_t       touchpads;     /* for NGP_Device.touchpads */
+    uint8_t       outputs;       /* NGP_OutputType bits for NGP_Device.outputs */
+    uint8_t       serial_report; /* feature report holding the serial when the OS has none, or 0 */
+} NGP_DeviceInfo;
+
+/**
+ * Returns the table entry for a pad, the lookup is a switch the compiler turns into a jump table or
+ * a binary search
+ * @param vendor_id
+ * @param product_id
+ * @return the entry, or NULL if the pad only gets the generic handling
+ */
+const NGP_DeviceInfo* NGP_DeviceInfoLookup(uint16_t vendor_id, uint16_t product_id);
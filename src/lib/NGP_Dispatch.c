@@ -0,0 +1,218 @@
+#ifdef __linux__
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* pthread_setaffinity_np */
+#endif
+#endif
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "NGP_EventQueue.h"
+
+#define NGP_DISPATCH_BATCH 256 /* events taken off the ring at a time, far more than one report */
+
+/*
+ * The push side of the event queue. The dispatch thread reads the ring through a cursor of its own
+ * but only up to ready, which the I/O thread moves once a report's events are all queued, and it
+ * hands each report's events to the callback in one call. It sleeps on cond while it has caught
+ * up, the I/O thread only takes the lock to signal it while sleeping is set.
+ */
+typedef struct NGP_Dispatch {
+    pthread_mutex_t      lock; /* guards the thread's start and stop, and its sleep */
+    pthread_cond_t       cond;
+    pthread_t            thread;
+    bool                 running;
+    bool                 stop;
+    bool                 sleeping;
+    uint64_t             ready; /* events before this one belong to finished reports */
+    NGP_EventSubscriber* cursor;
+    NGP_EventCallback    callback; /* only changed while the thread is stopped */
+    void*                userdata;
+    uint32_t             mask;
+    int                  priority;
+    int                  cpu;
+    uint64_t             dropped; /* lost by earlier cursors, the current one counts its own */
+    uint64_t             queue_dropped; /* the ring's own drop count when the cursor was taken */
+} NGP_Dispatch;
+
+bool NGP_DispatchEnabled;
+
+static NGP_Dispatch dispatch = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+    .cpu  = -1,
+};
+
+void NGP_DispatchReady(void) {
+    uint64_t tail = __atomic_load_n(&NGP_GetEventQueue()->tail, __ATOMIC_RELAXED);
+    if (__atomic_load_n(&dispatch.ready, __ATOMIC_RELAXED) == tail) {
+        return;
+    }
+    /* both sequentially consistent, pairs with the thread setting sleeping before it reads ready */
+    __atomic_store_n(&dispatch.ready, tail, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&dispatch.sleeping, __ATOMIC_SEQ_CST)) {
+        pthread_mutex_lock(&dispatch.lock);
+        pthread_cond_signal(&dispatch.cond);
+        pthread_mutex_unlock(&dispatch.lock);
+    }
+}
+
+static bool ApplyScheduling(pthread_t thread, int priority, int cpu) {
+    struct sched_param param = { .sched_priority = priority };
+    bool ok = pthread_setschedparam(thread, priority > 0 ? SCHED_FIFO : SCHED_OTHER, &param) == 0;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (cpu >= 0) {
+        CPU_SET(cpu, &set);
+    } else {
+        long cpus = sysconf(_SC_NPROCESSORS_CONF);
+        for (long i = 0; i < cpus && i < CPU_SETSIZE; i++) {
+            CPU_SET(i, &set);
+        }
+    }
+    ok = pthread_setaffinity_np(thread, sizeof(set), &set) == 0 && ok;
+#else
+    ok = cpu < 0 && ok; /* no way to pin a thread to one CPU */
+#endif
+    return ok;
+}
+
+/* Calls back once per report in events, skipping the kinds the mask leaves out */
+static void Deliver(NGP_Event* events, int count) {
+    NGP_Timestamp now = NGP_GetTicksNS();
+    for (int start = 0; start < count;) {
+        int end  = start;
+        int kept = 0;
+        for (; end < count && events[end].GamePadID == events[start].GamePadID &&
+               events[end].Timestamp == events[start].Timestamp;
+             end++) {
+            if (dispatch.mask & NGP_EVENT_MASK(events[end].Kind)) {
+                events[start + kept]                  = events[end];
+                events[start + kept].DequeueTimestamp = now;
+                kept++;
+            }
+        }
+        if (kept) {
+            dispatch.callback(&events[start], kept, dispatch.userdata);
+        }
+        start = end;
+    }
+}
+
+/* Where the last report in events starts, events from start on may be followed by more */
+static int LastReport(const NGP_Event* events, int count) {
+    int start = count - 1;
+    while (start > 0 && events[start - 1].GamePadID == events[count - 1].GamePadID &&
+           events[start - 1].Timestamp == events[count - 1].Timestamp) {
+        start--;
+    }
+    return start;
+}
+
+static void* DispatchThread(void* arg) {
+    (void)arg;
+    NGP_EventQueue* queue = NGP_GetEventQueue();
+    NGP_Event       events[NGP_DISPATCH_BATCH];
+    int             held = 0; /* the start of a report the last batch cut off */
+
+    while (!__atomic_load_n(&dispatch.stop, __ATOMIC_ACQUIRE)) {
+        uint64_t head  = __atomic_load_n(&dispatch.cursor->head, __ATOMIC_RELAXED);
+        uint64_t ready = __atomic_load_n(&dispatch.ready, __ATOMIC_ACQUIRE);
+        if (ready > head) {
+            uint64_t wanted = ready - head;
+            int      room   = NGP_DISPATCH_BATCH - held;
+            int      max    = wanted < (uint64_t)room ? (int)wanted : room;
+            int      count  = held + NGP_EventQueuePop(queue, dispatch.cursor, events + held, max);
+            int      end    = count;
+            if (count == NGP_DISPATCH_BATCH &&
+                ready > __atomic_load_n(&dispatch.cursor->head, __ATOMIC_RELAXED)) {
+                /* the last report may go on past the batch, unless it fills all of it */
+                end = LastReport(events, count);
+                end = end > 0 ? end : count;
+            }
+            Deliver(events, end);
+            held = count - end;
+            memmove(events, events + end, (size_t)held * sizeof(events[0]));
+            continue;
+        }
+
+        pthread_mutex_lock(&dispatch.lock);
+        __atomic_store_n(&dispatch.sleeping, true, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&dispatch.ready, __ATOMIC_SEQ_CST) == ready &&
+            !__atomic_load_n(&dispatch.stop, __ATOMIC_ACQUIRE)) {
+            pthread_cond_wait(&dispatch.cond, &dispatch.lock);
+        }
+        __atomic_store_n(&dispatch.sleeping, false, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&dispatch.lock);
+    }
+    return NULL;
+}
+
+/* Overwritten before the callback got to them, or never queued because a poller was full */
+static uint64_t CursorDropped(void) {
+    return NGP_SubscriberEventsDropped(dispatch.cursor) +
+           (NGP_EventQueueDropped(NGP_GetEventQueue()) - dispatch.queue_dropped);
+}
+
+static void StopThread(void) {
+    if (!dispatch.running) {
+        return;
+    }
+    __atomic_store_n(&NGP_DispatchEnabled, false, __ATOMIC_RELAXED);
+    NGP_EventQueueUpdateLibraryCursor(true);
+    pthread_mutex_lock(&dispatch.lock);
+    __atomic_store_n(&dispatch.stop, true, __ATOMIC_RELEASE);
+    pthread_cond_signal(&dispatch.cond);
+    pthread_mutex_unlock(&dispatch.lock);
+    pthread_join(dispatch.thread, NULL);
+    dispatch.dropped += CursorDropped();
+    NGP_UnsubscribeEvents(dispatch.cursor);
+    dispatch.cursor  = NULL;
+    dispatch.running = false;
+}
+
+DECLSPEC bool NGPCALL NGP_SetEventCallback(NGP_EventCallback callback,
+                                           void*             userdata,
+                                           uint32_t          mask) {
+    StopThread();
+    if (!callback) {
+        return true;
+    }
+    dispatch.cursor = NGP_SubscribeEvents(NGP_EventPolicyDropOldest);
+    if (!dispatch.cursor) {
+        return false;
+    }
+    dispatch.callback      = callback;
+    dispatch.userdata      = userdata;
+    dispatch.mask          = mask;
+    dispatch.stop          = false;
+    dispatch.queue_dropped = NGP_EventQueueDropped(NGP_GetEventQueue());
+    /* nothing queued before the callback was set is delivered */
+    __atomic_store_n(&dispatch.ready, dispatch.cursor->head, __ATOMIC_RELAXED);
+    if (pthread_create(&dispatch.thread, NULL, DispatchThread, NULL) != 0) {
+        NGP_UnsubscribeEvents(dispatch.cursor);
+        dispatch.cursor = NULL;
+        return false;
+    }
+    /* a refusal leaves it on normal scheduling, NGP_SetEventCallbackScheduling reports it */
+    if (dispatch.priority > 0 || dispatch.cpu >= 0) {
+        ApplyScheduling(dispatch.thread, dispatch.priority, dispatch.cpu);
+    }
+    dispatch.running = true;
+    __atomic_store_n(&NGP_DispatchEnabled, true, __ATOMIC_RELAXED);
+    NGP_EventQueueUpdateLibraryCursor(true);
+    return true;
+}
+
+DECLSPEC bool NGPCALL NGP_SetEventCallbackScheduling(int priority, int cpu) {
+    dispatch.priority = priority;
+    dispatch.cpu      = cpu;
+    return !dispatch.running || ApplyScheduling(dispatch.thread, priority, cpu);
+}
+
+DECLSPEC uint64_t NGPCALL NGP_EventCallbackDropped(void) {
+    return dispatch.dropped + (dispatch.cursor ? CursorDropped() : 0);
+}
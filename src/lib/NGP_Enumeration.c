@@ -0,0 +1,94 @@
+#include "NGP_Enumeration.h"
+
+#define MASK (NGP_ENUMERATION_CAPACITY - 1)
+
+static uint32_t Home(const char* key) {
+    uint64_t h = (uint64_t)(uintptr_t)key * 0x9e3779b97f4a7c15ULL;
+    return (uint32_t)(h >> 32) & MASK;
+}
+
+static int Slot(const NGP_Enumeration* enumeration, const char* key) {
+    if (!key) {
+        return -1;
+    }
+    for (uint32_t i = Home(key), probes = 0; probes < NGP_ENUMERATION_CAPACITY;
+         i = (i + 1) & MASK, probes++) {
+        const char* k = enumeration->entries[i].key;
+        if (k == key) {
+            return (int)i;
+        }
+        if (!k) {
+            return -1;
+        }
+    }
+    return -1;
+}
+
+void* NGP_EnumerationFind(const NGP_Enumeration* enumeration, const char* key) {
+    int slot = Slot(enumeration, key);
+    return slot < 0 ? NULL : enumeration->entries[slot].device;
+}
+
+bool NGP_EnumerationAdd(NGP_Enumeration* enumeration, const char* key, void* device) {
+    /* kept at most half full so probes stay short */
+    if (!key || enumeration->count >= NGP_ENUMERATION_CAPACITY / 2 || Slot(enumeration, key) >= 0) {
+        return false;
+    }
+    uint32_t i = Home(key);
+    while (enumeration->entries[i].key) {
+        i = (i + 1) & MASK;
+    }
+    enumeration->entries[i] = (NGP_EnumerationEntry){ key, device, enumeration->scan };
+    enumeration->count++;
+    return true;
+}
+
+/* Backward shift deletion, so lookups never need tombstones */
+static void Delete(NGP_Enumeration* enumeration, uint32_t hole) {
+    for (uint32_t i = (hole + 1) & MASK; enumeration->entries[i].key; i = (i + 1) & MASK) {
+        uint32_t home = Home(enumeration->entries[i].key);
+        /* moves back unless its home lies cyclically in (hole, i] */
+        if (((i - home) & MASK) >= ((i - hole) & MASK)) {
+            enumeration->entries[hole] = enumeration->entries[i];
+            hole                       = i;
+        }
+    }
+    enumeration->entries[hole].key    = NULL;
+    enumeration->entries[hole].device = NULL;
+    enumeration->count--;
+}
+
+void* NGP_EnumerationRemove(NGP_Enumeration* enumeration, const char* key) {
+    int slot = Slot(enumeration, key);
+    if (slot < 0) {
+        return NULL;
+    }
+    void* device = enumeration->entries[slot].device;
+    Delete(enumeration, (uint32_t)slot);
+    return device;
+}
+
+void NGP_EnumerationBeginScan(NGP_Enumeration* enumeration) { enumeration->scan++; }
+
+bool NGP_EnumerationSeen(NGP_Enumeration* enumeration, const char* key) {
+    int slot = Slot(enumeration, key);
+    if (slot < 0) {
+        return false;
+    }
+    enumeration->entries[slot].scan = enumeration->scan;
+    return true;
+}
+
+int NGP_EnumerationEndScan(NGP_Enumeration* enumeration, void** gone, int max) {
+    int count = 0;
+    for (uint32_t i = 0; i < NGP_ENUMERATION_CAPACITY && count < max;) {
+        NGP_EnumerationEntry* entry = &enumeration->entries[i];
+        if (entry->key && entry->scan != enumeration->scan) {
+            gone[count++] = entry->device;
+            Delete(enumeration, i); /* may shift another entry into slot i, look at it again */
+        } else {
+            i++;
+        }
+    }
+    return count;
+}
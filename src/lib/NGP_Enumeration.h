@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "NGP_Internal.h"
+
+#define NGP_ENUMERATION_CAPACITY 256 /* power of two, twice the devices a source can track */
+
+typedef struct NGP_EnumerationEntry {
+    const char* key;    /* interned, NULL for an empty slot */
+    void*       device; /* the source's own record */
+    uint32_t    scan;   /* the last scan that saw it */
+} NGP_EnumerationEntry;
+
+/*
+ * The devices a source tracks, keyed by an interned string that stays the same for as long as the
+ * OS keeps the device, like its device node or IORegistry entry id. Hot-plug notifications add and
+ * remove one key at a time. A full scan, which a source only needs when it opens or may have missed
+ * notifications, is diffed against the table so only the devices that came or went are touched.
+ * Keys are compared by pointer, which interning makes safe. Only used from the I/O thread.
+ */
+typedef struct NGP_Enumeration {
+    NGP_EnumerationEntry entries[NGP_ENUMERATION_CAPACITY]; /* open addressing, linear probing */
+    int                  count;
+    uint32_t             scan;
+} NGP_Enumeration;
+
+/**
+ * Returns the device tracked under key
+ * @param enumeration
+ * @param key interned
+ * @return the device or NULL
+ */
+void* NGP_EnumerationFind(const NGP_Enumeration* enumeration, const char* key);
+
+/**
+ * Starts tracking a device, as seen by the current scan if one is running
+ * @param enumeration
+ * @param key interned
+ * @param device
+ * @return false if the key is already tracked or the table is full
+ */
+bool NGP_EnumerationAdd(NGP_Enumeration* enumeration, const char* key, void* device);
+
+/**
+ * Stops tracking a device
+ * @param enumeration
+ * @param key interned
+ * @return the device it was tracked with or NULL
+ */
+void* NGP_EnumerationRemove(NGP_Enumeration* enumeration, const char* key);
+
+/**
+ * Starts a full scan, every device is presumed gone until NGP_EnumerationSeen says otherwise
+ * @param enumeration
+ */
+void NGP_EnumerationBeginScan(NGP_Enumeration* enumeration);
+
+/**
+ * Marks a device the scan found
+ * @param enumeration
+ * @param key interned
+ * @return false if it is not tracked yet, the source should open it and add it
+ */
+bool NGP_EnumerationSeen(NGP_Enumeration* enumeration, const char* key);
+
+/**
+ * Finishes a scan, removing the devices it did not see
+ * @param enumeration
+ * @param gone filled with the removed devices, for the source to close
+ * @param max
+ * @return how many were removed, more than max are left for the next call
+ */
+int NGP_EnumerationEndScan(NGP_Enumeration* enumeration, void** gone, int max);
@@ -0,0 +1,282 @@
+#include "NGP_EventQueue.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#define LIBRARY_CURSOR 0 /* the cursor NGP_PollEvent(s) reads through */
+
+static NGP_EventQueue event_queue = {
+    .gating      = 1u << LIBRARY_CURSOR,
+    .subscribers = { [LIBRARY_CURSOR] = { .policy = NGP_EventPolicyBackpressure, .in_use = true } },
+};
+static uint32_t        event_mask     = NGP_EVENT_MASK_ALL;
+static pthread_mutex_t subscribe_lock = PTHREAD_MUTEX_INITIALIZER; /* guards in_use */
+static uint8_t         library_policy = NGP_EventPolicyBackpressure; /* set by NGP_SetEventPolicy */
+static bool            library_polled; /* since NGP_Initialize, see UpdateLibraryPolicy */
+
+NGP_EventSubscriber* NGP_EventQueueSubscribe(NGP_EventQueue* q, NGP_EventPolicy policy) {
+    NGP_EventSubscriber* s = NULL;
+    pthread_mutex_lock(&subscribe_lock);
+    for (int i = 0; i < NGP_EVENT_QUEUE_SUBSCRIBERS; i++) {
+        if (!q->subscribers[i].in_use) {
+            s = &q->subscribers[i];
+            break;
+        }
+    }
+    if (s) {
+        uint64_t tail  = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+        s->cached_tail = tail;
+        s->dropped     = 0;
+        s->policy      = NGP_EventPolicyDropOldest;
+        s->in_use      = true;
+        __atomic_store_n(&s->head, tail, __ATOMIC_RELEASE);
+        NGP_EventQueueSetPolicy(q, s, policy);
+    }
+    pthread_mutex_unlock(&subscribe_lock);
+    return s;
+}
+
+void NGP_EventQueueUnsubscribe(NGP_EventQueue* q, NGP_EventSubscriber* s) {
+    pthread_mutex_lock(&subscribe_lock);
+    NGP_EventQueueSetPolicy(q, s, NGP_EventPolicyDropOldest);
+    s->in_use = false;
+    pthread_mutex_unlock(&subscribe_lock);
+}
+
+void NGP_EventQueueSetPolicy(NGP_EventQueue* q, NGP_EventSubscriber* s, NGP_EventPolicy policy) {
+    uint32_t bit = 1u << (s - q->subscribers);
+    s->policy    = (uint8_t)policy;
+    if (policy == NGP_EventPolicyBackpressure) {
+        __atomic_fetch_or(&q->gating, bit, __ATOMIC_RELEASE);
+    } else {
+        __atomic_fetch_and(&q->gating, ~bit, __ATOMIC_RELEASE);
+    }
+}
+
+/* Skips a cursor that fell more than a ring behind up to the oldest event still in the ring */
+static uint64_t CatchUp(NGP_EventSubscriber* s, uint64_t head) {
+    if (s->cached_tail - head > NGP_EVENT_QUEUE_CAPACITY) {
+        uint64_t lost = s->cached_tail - NGP_EVENT_QUEUE_CAPACITY - head;
+        __atomic_store_n(&s->dropped, s->dropped + lost, __ATOMIC_RELAXED);
+        head += lost;
+    }
+    return head;
+}
+
+/* How many events from head on the producer overwrote or started overwriting, after a read */
+static uint64_t Overwritten(const NGP_EventQueue* q, uint64_t head) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    uint64_t claim  = __atomic_load_n(&q->claim, __ATOMIC_RELAXED);
+    uint64_t oldest = claim > NGP_EVENT_QUEUE_CAPACITY ? claim - NGP_EVENT_QUEUE_CAPACITY : 0;
+    return oldest > head ? oldest - head : 0;
+}
+
+int NGP_EventQueuePop(NGP_EventQueue* q, NGP_EventSubscriber* s, NGP_Event* out, int max) {
+    uint64_t head = s->head;
+    int      count;
+    for (;;) {
+        if (s->cached_tail - head < (uint64_t)max) {
+            s->cached_tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+            head           = CatchUp(s, head);
+        }
+        uint64_t available = s->cached_tail - head;
+        count              = available < (uint64_t)max ? (int)available : max;
+        if (count <= 0) {
+            count = 0;
+            break;
+        }
+
+        /* at most two contiguous runs, one up to the end of the ring and one from its start */
+        uint64_t start = head & (NGP_EVENT_QUEUE_CAPACITY - 1);
+        uint64_t first = NGP_EVENT_QUEUE_CAPACITY - start;
+        if (first > (uint64_t)count) {
+            first = (uint64_t)count;
+        }
+        memcpy(out, &q->events[start], first * sizeof(NGP_Event));
+        memcpy(out + first, &q->events[0], ((uint64_t)count - first) * sizeof(NGP_Event));
+
+        uint64_t lost = s->policy == NGP_EventPolicyDropOldest ? Overwritten(q, head) : 0;
+        if (!lost) {
+            break;
+        }
+        /* overtaken mid copy, keep whatever was copied intact and read again if nothing was */
+        __atomic_store_n(&s->dropped, s->dropped + lost, __ATOMIC_RELAXED);
+        head += lost;
+        s->cached_tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE); /* head may have passed it */
+        if (lost < (uint64_t)count) {
+            count -= (int)lost;
+            memmove(out, out + lost, (size_t)count * sizeof(NGP_Event));
+            break;
+        }
+    }
+    __atomic_store_n(&s->head, head + (uint64_t)count, __ATOMIC_RELEASE);
+    return count;
+}
+
+int NGP_EventQueuePeek(NGP_EventQueue* q, NGP_EventSubscriber* s, const NGP_Event** events) {
+    s->cached_tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+    uint64_t head  = CatchUp(s, s->head);
+    if (head != s->head) {
+        __atomic_store_n(&s->head, head, __ATOMIC_RELEASE);
+    }
+    uint64_t start     = head & (NGP_EVENT_QUEUE_CAPACITY - 1);
+    uint64_t available = s->cached_tail - head;
+    uint64_t run       = NGP_EVENT_QUEUE_CAPACITY - start;
+    *events            = &q->events[start];
+    return (int)(available < run ? available : run);
+}
+
+bool NGP_EventQueueRelease(NGP_EventQueue* q, NGP_EventSubscriber* s, int count) {
+    uint64_t head = s->head;
+    bool     kept = s->policy != NGP_EventPolicyDropOldest || Overwritten(q, head) == 0;
+    if (!kept) {
+        __atomic_store_n(&s->dropped, s->dropped + (uint64_t)count, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&s->head, head + (uint64_t)count, __ATOMIC_RELEASE);
+    return kept;
+}
+
+uint64_t NGP_EventQueueDropped(const NGP_EventQueue* q) {
+    return __atomic_load_n(&q->dropped, __ATOMIC_RELAXED);
+}
+
+void NGP_EventQueueReset(NGP_EventQueue* q) {
+    q->tail          = 0;
+    q->claim         = 0;
+    q->cached_gate   = 0;
+    q->cached_gating = 0;
+    q->dropped       = 0;
+    q->gating        = 0;
+    memset(q->subscribers, 0, sizeof(q->subscribers));
+}
+
+NGP_EventQueue* NGP_GetEventQueue(void) { return &event_queue; }
+
+/*
+ * A program that takes its events from the callback may never poll, and an unread backpressure
+ * cursor would stop the ring, and with it the callback, a whole ring in. So while a callback is set
+ * the library cursor is overtaken like a drop oldest one until NGP_PollEvent(s) is first called,
+ * and only then takes on its policy. Called with subscribe_lock held.
+ */
+static void UpdateLibraryPolicy(void) {
+    NGP_EventSubscriber* s      = &event_queue.subscribers[LIBRARY_CURSOR];
+    bool                 bypass = !library_polled && __atomic_load_n(&NGP_DispatchEnabled,
+                                                                      __ATOMIC_RELAXED);
+    NGP_EventPolicy      policy = bypass ? NGP_EventPolicyDropOldest
+                                         : (NGP_EventPolicy)library_policy;
+    if (policy == s->policy) {
+        return;
+    }
+    NGP_EventQueueSetPolicy(&event_queue, s, policy);
+    if (policy == NGP_EventPolicyBackpressure) {
+        /* whatever was overtaken before it started holding the ring up is lost */
+        uint64_t lost = Overwritten(&event_queue, s->head);
+        __atomic_store_n(&s->dropped, s->dropped + lost, __ATOMIC_RELAXED);
+        __atomic_store_n(&s->head, s->head + lost, __ATOMIC_RELEASE);
+        s->cached_tail = __atomic_load_n(&event_queue.tail, __ATOMIC_ACQUIRE);
+    }
+}
+
+static NGP_EventSubscriber* LibraryCursor(void) {
+    if (!__atomic_load_n(&library_polled, __ATOMIC_RELAXED)) {
+        pthread_mutex_lock(&subscribe_lock);
+        __atomic_store_n(&library_polled, true, __ATOMIC_RELAXED);
+        UpdateLibraryPolicy();
+        pthread_mutex_unlock(&subscribe_lock);
+    }
+    return &event_queue.subscribers[LIBRARY_CURSOR];
+}
+
+void NGP_EventQueueUpdateLibraryCursor(bool keep_polled) {
+    pthread_mutex_lock(&subscribe_lock);
+    __atomic_store_n(&library_polled, keep_polled && library_polled, __ATOMIC_RELAXED);
+    UpdateLibraryPolicy();
+    pthread_mutex_unlock(&subscribe_lock);
+}
+
+void NGP_PushEvent(NGP_EventType kind, NGP_GamePadID id, NGP_Event* event) {
+    if (!(__atomic_load_n(&event_mask, __ATOMIC_RELAXED) & NGP_EVENT_MASK(kind))) {
+        return;
+    }
+    NGP_Event e;
+    if (!event) {
+        memset(&e, 0, sizeof(e));
+        event = &e;
+    }
+    event->Kind             = kind;
+    event->GamePadID        = id;
+    event->EnqueueTimestamp = NGP_GetTicksNS();
+    if (!event->Timestamp) {
+        /* attach, detach and anything else that did not come from a report */
+        event->Timestamp = event->EnqueueTimestamp;
+    }
+    NGP_EventQueuePush(&event_queue, event);
+}
+
+DECLSPEC bool NGPCALL NGP_PollEvent(NGP_Event* event) {
+    if (NGP_EventQueuePop(&event_queue, LibraryCursor(), event, 1) != 1) {
+        return false;
+    }
+    NGP_LatencyRecordEvents(event, 1);
+    return true;
+}
+
+DECLSPEC int NGPCALL NGP_PollEvents(NGP_Event* events, int max) {
+    int count = NGP_EventQueuePop(&event_queue, LibraryCursor(), events, max);
+    NGP_LatencyRecordEvents(events, count);
+    return count;
+}
+
+DECLSPEC uint64_t NGPCALL NGP_EventsDropped(void) {
+    return NGP_EventQueueDropped(&event_queue) +
+           NGP_SubscriberEventsDropped(&event_queue.subscribers[LIBRARY_CURSOR]);
+}
+
+DECLSPEC void NGPCALL NGP_SetEventPolicy(NGP_EventPolicy policy) {
+    pthread_mutex_lock(&subscribe_lock);
+    library_policy = (uint8_t)policy;
+    UpdateLibraryPolicy();
+    pthread_mutex_unlock(&subscribe_lock);
+}
+
+DECLSPEC NGP_EventSubscriber* NGPCALL NGP_SubscribeEvents(NGP_EventPolicy policy) {
+    return NGP_EventQueueSubscribe(&event_queue, policy);
+}
+
+DECLSPEC void NGPCALL NGP_UnsubscribeEvents(NGP_EventSubscriber* subscriber) {
+    if (subscriber && subscriber != &event_queue.subscribers[LIBRARY_CURSOR]) {
+        NGP_EventQueueUnsubscribe(&event_queue, subscriber);
+    }
+}
+
+DECLSPEC int NGPCALL NGP_SubscriberPollEvents(NGP_EventSubscriber* subscriber,
+                                              NGP_Event*           events,
+                                              int                  max) {
+    int           count = NGP_EventQueuePop(&event_queue, subscriber, events, max);
+    NGP_Timestamp now   = count > 0 ? NGP_GetTicksNS() : 0;
+    for (int i = 0; i < count; i++) {
+        events[i].DequeueTimestamp = now;
+    }
+    return count;
+}
+
+DECLSPEC int NGPCALL NGP_SubscriberPeekEvents(NGP_EventSubscriber* subscriber,
+                                              const NGP_Event**    events) {
+    return NGP_EventQueuePeek(&event_queue, subscriber, events);
+}
+
+DECLSPEC bool NGPCALL NGP_SubscriberReleaseEvents(NGP_EventSubscriber* subscriber, int count) {
+    return NGP_EventQueueRelease(&event_queue, subscriber, count);
+}
+
+DECLSPEC uint64_t NGPCALL NGP_SubscriberEventsDropped(NGP_EventSubscriber* subscriber) {
+    return __atomic_load_n(&subscriber->dropped, __ATOMIC_RELAXED);
+}
+
+DECLSPEC void NGPCALL NGP_SetEventMask(uint32_t mask) {
+    __atomic_store_n(&event_mask, mask, __ATOMIC_RELAXED);
+}
+
+DECLSPEC uint32_t NGPCALL NGP_GetEventMask(void) {
+    return __atomic_load_n(&event_mask, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "NGP_Internal.h"
+
+#define NGP_CACHE_LINE 64
+#define NGP_EVENT_QUEUE_CAPACITY 4096 /* must be a power of two */
+#define NGP_EVENT_QUEUE_SUBSCRIBERS (NGP_MAX_EVENT_SUBSCRIBERS + 1) /* and the library's own */
+
+/* One reader's cursor into the ring, owned by the thread reading through it */
+struct NGP_EventSubscriber {
+    _Alignas(NGP_CACHE_LINE) uint64_t head; /* next event to read, written by the reader */
+    uint64_t cached_tail;                   /* reader's view of tail */
+    uint64_t dropped;                       /* overwritten before they were read */
+    uint8_t  policy;                        /* NGP_EventPolicy */
+    bool     in_use;
+};
+
+/*
+ * Fixed capacity single producer broadcast ring of NGP_Events. The I/O thread writes each event
+ * once and every subscriber reads it in place through its own cursor, so adding readers costs the
+ * producer nothing unless they ask to hold it up. Each cursor sits on its own cache line and keeps
+ * a cached copy of tail, the producer keeps a cached copy of the slowest backpressure cursor, so
+ * shared lines are only touched when a cached view says the ring looks full or empty.
+ *
+ * A backpressure cursor is never overtaken, a full ring drops the new event and counts it instead.
+ * Drop oldest cursors are overtaken freely. The producer announces each slot it is about to
+ * overwrite in claim before writing it, seqlock style, and readers check claim after copying, so a
+ * reader that was overtaken mid copy finds out and counts the lost events rather than using them.
+ */
+typedef struct NGP_EventQueue {
+    _Alignas(NGP_CACHE_LINE) uint64_t tail; /* next event to write, written by the producer */
+    uint64_t claim;          /* one past the event being written, ahead of tail while it is */
+    uint64_t cached_gate;    /* producer's view of the slowest backpressure head */
+    uint32_t cached_gating;  /* the gating mask cached_gate was taken for */
+    uint64_t dropped;
+
+    _Alignas(NGP_CACHE_LINE) uint32_t gating; /* bit n set while cursor n is backpressure */
+
+    NGP_EventSubscriber subscribers[NGP_EVENT_QUEUE_SUBSCRIBERS];
+
+    _Alignas(NGP_CACHE_LINE) NGP_Event events[NGP_EVENT_QUEUE_CAPACITY];
+} NGP_EventQueue;
+
+/**
+ * Producer side. Returns the head of the slowest backpressure cursor, or tail if there is none.
+ * @param q
+ */
+static inline uint64_t NGP_EventQueueGate(NGP_EventQueue* q) {
+    uint32_t gating = __atomic_load_n(&q->gating, __ATOMIC_ACQUIRE);
+    uint64_t gate   = q->tail;
+    for (uint32_t bits = gating; bits; bits &= bits - 1) {
+        const NGP_EventSubscriber* s    = &q->subscribers[__builtin_ctz(bits)];
+        uint64_t                   head = __atomic_load_n(&s->head, __ATOMIC_ACQUIRE);
+        if (head < gate) {
+            gate = head;
+        }
+    }
+    q->cached_gate   = gate;
+    q->cached_gating = gating;
+    return gate;
+}
+
+/**
+ * Producer side. Copies the event into the ring.
+ * @param q
+ * @param event
+ * @return false if a backpressure cursor was a whole ring behind and the event was dropped
+ */
+static inline bool NGP_EventQueuePush(NGP_EventQueue* q, const NGP_Event* event) {
+    uint64_t tail   = q->tail;
+    uint32_t gating = __atomic_load_n(&q->gating, __ATOMIC_RELAXED);
+    if (gating &&
+        (gating != q->cached_gating || tail - q->cached_gate >= NGP_EVENT_QUEUE_CAPACITY)) {
+        /* heads only move forward and new cursors start at tail, so a stale gate is a safe one */
+        if (tail - NGP_EventQueueGate(q) >= NGP_EVENT_QUEUE_CAPACITY) {
+            __atomic_store_n(&q->dropped, q->dropped + 1, __ATOMIC_RELAXED);
+            return false;
+        }
+    }
+    __atomic_store_n(&q->claim, tail + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    q->events[tail & (NGP_EVENT_QUEUE_CAPACITY - 1)] = *event;
+    __atomic_store_n(&q->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/**
+ * Producer side. Returns how many events can be pushed before a backpressure cursor is full.
+ * @param q
+ */
+static inline uint64_t NGP_EventQueueSpace(NGP_EventQueue* q) {
+    uint64_t used = q->tail - NGP_EventQueueGate(q);
+    return used < NGP_EVENT_QUEUE_CAPACITY ? NGP_EVENT_QUEUE_CAPACITY - used : 0;
+}
+
+/**
+ * Claims a free cursor that starts at the current tail, safe from any thread
+ * @param q
+ * @param policy
+ * @return the cursor or NULL if every one is taken
+ */
+NGP_EventSubscriber* NGP_EventQueueSubscribe(NGP_EventQueue* q, NGP_EventPolicy policy);
+
+/**
+ * Returns a cursor to the free ones
+ * @param q
+ * @param s
+ */
+void NGP_EventQueueUnsubscribe(NGP_EventQueue* q, NGP_EventSubscriber* s);
+
+/**
+ * Changes whether a cursor holds the producer up, called from the cursor's reader
+ * @param q
+ * @param s
+ * @param policy
+ */
+void NGP_EventQueueSetPolicy(NGP_EventQueue* q, NGP_EventSubscriber* s, NGP_EventPolicy policy);
+
+/**
+ * Reader side. Copies up to max of the cursor's unread events out of the ring in order.
+ * @param q
+ * @param s
+ * @param out
+ * @param max
+ * @return the number of events copied
+ */
+int NGP_EventQueuePop(NGP_EventQueue* q, NGP_EventSubscriber* s, NGP_Event* out, int max);
+
+/**
+ * Reader side. Points at the cursor's oldest unread events in the ring.
+ * @param q
+ * @param s
+ * @param events
+ * @return how many unread events follow contiguously
+ */
+int NGP_EventQueuePeek(NGP_EventQueue* q, NGP_EventSubscriber* s, const NGP_Event** events);
+
+/**
+ * Reader side. Moves the cursor past count peeked events.
+ * @param q
+ * @param s
+ * @param count
+ * @return false if they were overwritten while being read
+ */
+bool NGP_EventQueueRelease(NGP_EventQueue* q, NGP_EventSubscriber* s, int count);
+
+/**
+ * Returns the number of events dropped because a backpressure cursor was full
+ * @param q
+ */
+uint64_t NGP_EventQueueDropped(const NGP_EventQueue* q);
+
+/**
+ * Drops everything in the ring, zeroes the counters and frees every cursor. Only safe while
+ * nothing is pushing or reading.
+ * @param q
+ */
+void NGP_EventQueueReset(NGP_EventQueue* q);
+
+/**
+ * The ring the I/O thread publishes into, NGP_PollEvent reads it through the first cursor
+ */
+NGP_EventQueue* NGP_GetEventQueue(void);
+
+/**
+ * Works out again whether the library cursor holds the ring up, called when a callback is set or
+ * cleared and by NGP_Shutdown
+ * @param keep_polled false to forget that NGP_PollEvent(s) was called, as NGP_Shutdown does
+ */
+void NGP_EventQueueUpdateLibraryCursor(bool keep_polled);
+
+/**
+ * Pushes an event for the device onto the library's ring, called from the I/O thread
+ * @param kind
+ * @param id
+ * @param event filled in by the caller except for GamePadID, Kind and EnqueueTimestamp, may be NULL
+ */
+void NGP_PushEvent(NGP_EventType kind, NGP_GamePadID id, NGP_Event* event);
+
+/* Set while NGP_SetEventCallback has a callback, the I/O thread then calls NGP_DispatchReady */
+extern bool NGP_DispatchEnabled;
+
+/**
+ * Hands every event queued so far to the dispatch thread, waking it if it sleeps. Called by the I/O
+ * thread once a report's events are all queued, so a callback never sees half a report.
+ */
+void NGP_DispatchReady(void);
+
+/**
+ * Stamps DequeueTimestamp on events just taken off the library's ring and adds their latencies to
+ * the per pad histograms, called from NGP_PollEvent(s)
+ * @param events
+ * @param count
+ */
+void NGP_LatencyRecordEvents(NGP_Event* events, int count);
+
+/**
+ * Starts the clock NGP_GetTimeToFirstGamePad reads, called as a device source starts
+ */
+void NGP_LatencyStartEnumeration(void);
+
+/**
+ * Stops the clock NGP_GetTimeToFirstGamePad reads if it is still running, called on every attach
+ */
+void NGP_LatencyPadAttached(void);
@@ -0,0 +1,376 @@
+#include "NGP_Fusion.h"
+
+#include <math.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define NGP_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(NGP_FUSION_NEON)
+/* opt in until the NEON kernel has been built and checked against the scalar one on ARM */
+#define NGP_NEON 1
+#include <arm_neon.h>
+#endif
+
+#define STANDARD_GRAVITY 9.80665f
+#define REST_GRAVITY_TOLERANCE 0.5f /* m/s^2 off 1 g and the pad is being moved */
+#define REST_GYRO_MAX 0.1f          /* rad/s, faster than any bias */
+#define REST_GYRO_NOISE 0.03f       /* rad/s a resting reading strays from the window's mean */
+
+/*
+ * Madgwick's IMU filter, gradient descent towards the orientation whose gravity matches the
+ * accelerometer, on top of integrating the gyroscope. The pad reports Y up and Z towards the
+ * player, the filter works with Z up, so readings are swapped into (X, -Z, Y) on the way in.
+ * Gradient terms are Madgwick's divided by 2, which the normalization cancels.
+ */
+static inline float InvSqrt(float v) { return v > 0.0f ? 1.0f / sqrtf(v) : 0.0f; }
+
+static void FuseScalar(NGP_Quaternion* q, const NGP_SensorSample* sample) {
+    float ax = sample->Accel[0];
+    float ay = -sample->Accel[2];
+    float az = sample->Accel[1];
+    float gx = sample->Gyro[0];
+    float gy = -sample->Gyro[2];
+    float gz = sample->Gyro[1];
+    float q0 = q->W;
+    float q1 = q->X;
+    float q2 = q->Y;
+    float q3 = q->Z;
+
+    float d0 = -0.5f * (q1 * gx + q2 * gy + q3 * gz);
+    float d1 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+    float d2 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+    float d3 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+    float an = InvSqrt(ax * ax + ay * ay + az * az);
+    if (an > 0.0f) {
+        ax *= an;
+        ay *= an;
+        az *= an;
+        float k  = q1 * q1 + q2 * q2;
+        float m  = q0 * q0 + q3 * q3 - 1.0f + 2.0f * k + az;
+        float s0 = 2.0f * q0 * k + (q2 * ax - q1 * ay);
+        float s1 = 2.0f * q1 * m - (q3 * ax + q0 * ay);
+        float s2 = 2.0f * q2 * m + (q0 * ax - q3 * ay);
+        float s3 = 2.0f * q3 * k - (q1 * ax + q2 * ay);
+        float sn = InvSqrt(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3) * NGP_FUSION_BETA;
+        d0 -= sn * s0;
+        d1 -= sn * s1;
+        d2 -= sn * s2;
+        d3 -= sn * s3;
+    }
+
+    float dt = sample->DeltaTime;
+    q0 += d0 * dt;
+    q1 += d1 * dt;
+    q2 += d2 * dt;
+    q3 += d3 * dt;
+    float qn = InvSqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    q->W     = q0 * qn;
+    q->X     = q1 * qn;
+    q->Y     = q2 * qn;
+    q->Z     = q3 * qn;
+}
+
+void NGP_FuseSensorSamplesScalar(NGP_Quaternion*         orientations,
+                                 const NGP_SensorSample* samples,
+                                 int                     count) {
+    for (int i = 0; i < count; i++) {
+        FuseScalar(&orientations[i], &samples[i]);
+    }
+}
+
+#if NGP_X86
+
+static inline __m128 InvSqrtSSE(__m128 v) {
+    __m128 r = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(v));
+    return _mm_and_ps(r, _mm_cmpgt_ps(v, _mm_setzero_ps()));
+}
+
+/* FuseScalar on four orientations at once, q, a and g hold one component of all four per vector */
+static inline void FuseSSE(__m128 q[4], __m128 a[3], const __m128 g[3], __m128 dt) {
+    __m128 half = _mm_set1_ps(0.5f);
+    __m128 two  = _mm_set1_ps(2.0f);
+
+    __m128 d0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(q[1], g[0]), _mm_mul_ps(q[2], g[1])),
+                           _mm_mul_ps(q[3], g[2]));
+    __m128 d1 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(q[0], g[0]), _mm_mul_ps(q[2], g[2])),
+                           _mm_mul_ps(q[3], g[1]));
+    __m128 d2 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(q[0], g[1]), _mm_mul_ps(q[1], g[2])),
+                           _mm_mul_ps(q[3], g[0]));
+    __m128 d3 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(q[0], g[2]), _mm_mul_ps(q[1], g[1])),
+                           _mm_mul_ps(q[2], g[0]));
+    d0        = _mm_mul_ps(d0, _mm_set1_ps(-0.5f));
+    d1        = _mm_mul_ps(d1, half);
+    d2        = _mm_mul_ps(d2, half);
+    d3        = _mm_mul_ps(d3, half);
+
+    __m128 an = InvSqrtSSE(_mm_add_ps(_mm_add_ps(_mm_mul_ps(a[0], a[0]), _mm_mul_ps(a[1], a[1])),
+                                      _mm_mul_ps(a[2], a[2])));
+    __m128 ax = _mm_mul_ps(a[0], an);
+    __m128 ay = _mm_mul_ps(a[1], an);
+    __m128 az = _mm_mul_ps(a[2], an);
+    __m128 k  = _mm_add_ps(_mm_mul_ps(q[1], q[1]), _mm_mul_ps(q[2], q[2]));
+    __m128 m  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(q[0], q[0]), _mm_mul_ps(q[3], q[3])),
+                           _mm_add_ps(_mm_sub_ps(_mm_mul_ps(two, k), _mm_set1_ps(1.0f)), az));
+    __m128 s0 = _mm_add_ps(_mm_mul_ps(two, _mm_mul_ps(q[0], k)),
+                           _mm_sub_ps(_mm_mul_ps(q[2], ax), _mm_mul_ps(q[1], ay)));
+    __m128 s1 = _mm_sub_ps(_mm_mul_ps(two, _mm_mul_ps(q[1], m)),
+                           _mm_add_ps(_mm_mul_ps(q[3], ax), _mm_mul_ps(q[0], ay)));
+    __m128 s2 = _mm_add_ps(_mm_mul_ps(two, _mm_mul_ps(q[2], m)),
+                           _mm_sub_ps(_mm_mul_ps(q[0], ax), _mm_mul_ps(q[3], ay)));
+    __m128 s3 = _mm_sub_ps(_mm_mul_ps(two, _mm_mul_ps(q[3], k)),
+                           _mm_add_ps(_mm_mul_ps(q[1], ax), _mm_mul_ps(q[2], ay)));
+    __m128 sn = InvSqrtSSE(_mm_add_ps(_mm_add_ps(_mm_mul_ps(s0, s0), _mm_mul_ps(s1, s1)),
+                                      _mm_add_ps(_mm_mul_ps(s2, s2), _mm_mul_ps(s3, s3))));
+    /* lanes without an accelerometer reading only integrate the gyro */
+    sn = _mm_and_ps(_mm_mul_ps(sn, _mm_set1_ps(NGP_FUSION_BETA)),
+                    _mm_cmpgt_ps(an, _mm_setzero_ps()));
+    d0 = _mm_sub_ps(d0, _mm_mul_ps(sn, s0));
+    d1 = _mm_sub_ps(d1, _mm_mul_ps(sn, s1));
+    d2 = _mm_sub_ps(d2, _mm_mul_ps(sn, s2));
+    d3 = _mm_sub_ps(d3, _mm_mul_ps(sn, s3));
+
+    q[0]      = _mm_add_ps(q[0], _mm_mul_ps(d0, dt));
+    q[1]      = _mm_add_ps(q[1], _mm_mul_ps(d1, dt));
+    q[2]      = _mm_add_ps(q[2], _mm_mul_ps(d2, dt));
+    q[3]      = _mm_add_ps(q[3], _mm_mul_ps(d3, dt));
+    __m128 qn = InvSqrtSSE(_mm_add_ps(_mm_add_ps(_mm_mul_ps(q[0], q[0]), _mm_mul_ps(q[1], q[1])),
+                                      _mm_add_ps(_mm_mul_ps(q[2], q[2]), _mm_mul_ps(q[3], q[3]))));
+    for (int i = 0; i < 4; i++) {
+        q[i] = _mm_mul_ps(q[i], qn);
+    }
+}
+
+static void FuseSensorSamplesSSE2(NGP_Quaternion*         orientations,
+                                  const NGP_SensorSample* samples,
+                                  int                     count) {
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        /* transpose four readings of (ax ay az gx | gy gz dt -) and four (w x y z) into lanes */
+        const float* s  = (const float*)(samples + i);
+        __m128       s0 = _mm_loadu_ps(s), s1 = _mm_loadu_ps(s + 8);
+        __m128       s2 = _mm_loadu_ps(s + 16), s3 = _mm_loadu_ps(s + 24);
+        __m128       t0 = _mm_loadu_ps(s + 4), t1 = _mm_loadu_ps(s + 12);
+        __m128       t2 = _mm_loadu_ps(s + 20), t3 = _mm_loadu_ps(s + 28);
+        _MM_TRANSPOSE4_PS(s0, s1, s2, s3);
+        _MM_TRANSPOSE4_PS(t0, t1, t2, t3);
+        float* o    = (float*)(orientations + i);
+        __m128 q[4] = { _mm_loadu_ps(o), _mm_loadu_ps(o + 4), _mm_loadu_ps(o + 8),
+                        _mm_loadu_ps(o + 12) };
+        _MM_TRANSPOSE4_PS(q[0], q[1], q[2], q[3]);
+
+        __m128 a[3] = { s0, _mm_sub_ps(_mm_setzero_ps(), s2), s1 };
+        __m128 g[3] = { s3, _mm_sub_ps(_mm_setzero_ps(), t1), t0 };
+        FuseSSE(q, a, g, t2);
+
+        _MM_TRANSPOSE4_PS(q[0], q[1], q[2], q[3]);
+        _mm_storeu_ps(o, q[0]);
+        _mm_storeu_ps(o + 4, q[1]);
+        _mm_storeu_ps(o + 8, q[2]);
+        _mm_storeu_ps(o + 12, q[3]);
+    }
+    NGP_FuseSensorSamplesScalar(orientations + i, samples + i, count - i);
+}
+
+#elif NGP_NEON
+
+static inline float32x4_t InvSqrtNEON(float32x4_t v) {
+    float32x4_t r    = vdivq_f32(vdupq_n_f32(1.0f), vsqrtq_f32(v));
+    uint32x4_t  keep = vcgtq_f32(v, vdupq_n_f32(0.0f));
+    return vreinterpretq_f32_u32(vandq_u32(keep, vreinterpretq_u32_f32(r)));
+}
+
+/* FuseScalar on four orientations at once, q, a and g hold one component of all four per vector */
+static inline void FuseNEON(float32x4_t       q[4],
+                            float32x4_t       a[3],
+                            const float32x4_t g[3],
+                            float32x4_t       dt) {
+    float32x4_t d0 = vaddq_f32(vaddq_f32(vmulq_f32(q[1], g[0]), vmulq_f32(q[2], g[1])),
+                               vmulq_f32(q[3], g[2]));
+    float32x4_t d1 = vsubq_f32(vaddq_f32(vmulq_f32(q[0], g[0]), vmulq_f32(q[2], g[2])),
+                               vmulq_f32(q[3], g[1]));
+    float32x4_t d2 = vaddq_f32(vsubq_f32(vmulq_f32(q[0], g[1]), vmulq_f32(q[1], g[2])),
+                               vmulq_f32(q[3], g[0]));
+    float32x4_t d3 = vsubq_f32(vaddq_f32(vmulq_f32(q[0], g[2]), vmulq_f32(q[1], g[1])),
+                               vmulq_f32(q[2], g[0]));
+    d0             = vmulq_n_f32(d0, -0.5f);
+    d1             = vmulq_n_f32(d1, 0.5f);
+    d2             = vmulq_n_f32(d2, 0.5f);
+    d3             = vmulq_n_f32(d3, 0.5f);
+
+    float32x4_t an = InvSqrtNEON(vaddq_f32(vaddq_f32(vmulq_f32(a[0], a[0]), vmulq_f32(a[1], a[1])),
+                                           vmulq_f32(a[2], a[2])));
+    float32x4_t ax = vmulq_f32(a[0], an);
+    float32x4_t ay = vmulq_f32(a[1], an);
+    float32x4_t az = vmulq_f32(a[2], an);
+    float32x4_t k  = vaddq_f32(vmulq_f32(q[1], q[1]), vmulq_f32(q[2], q[2]));
+    float32x4_t m  = vaddq_f32(vaddq_f32(vmulq_f32(q[0], q[0]), vmulq_f32(q[3], q[3])),
+                               vaddq_f32(vsubq_f32(vmulq_n_f32(k, 2.0f), vdupq_n_f32(1.0f)), az));
+    float32x4_t s0 = vaddq_f32(vmulq_n_f32(vmulq_f32(q[0], k), 2.0f),
+                               vsubq_f32(vmulq_f32(q[2], ax), vmulq_f32(q[1], ay)));
+    float32x4_t s1 = vsubq_f32(vmulq_n_f32(vmulq_f32(q[1], m), 2.0f),
+                               vaddq_f32(vmulq_f32(q[3], ax), vmulq_f32(q[0], ay)));
+    float32x4_t s2 = vaddq_f32(vmulq_n_f32(vmulq_f32(q[2], m), 2.0f),
+                               vsubq_f32(vmulq_f32(q[0], ax), vmulq_f32(q[3], ay)));
+    float32x4_t s3 = vsubq_f32(vmulq_n_f32(vmulq_f32(q[3], k), 2.0f),
+                               vaddq_f32(vmulq_f32(q[1], ax), vmulq_f32(q[2], ay)));
+    float32x4_t sn = InvSqrtNEON(vaddq_f32(vaddq_f32(vmulq_f32(s0, s0), vmulq_f32(s1, s1)),
+                                           vaddq_f32(vmulq_f32(s2, s2), vmulq_f32(s3, s3))));
+    /* lanes without an accelerometer reading only integrate the gyro */
+    uint32x4_t has_a = vcgtq_f32(an, vdupq_n_f32(0.0f));
+    sn               = vmulq_n_f32(sn, NGP_FUSION_BETA);
+    sn               = vreinterpretq_f32_u32(vandq_u32(has_a, vreinterpretq_u32_f32(sn)));
+    d0 = vsubq_f32(d0, vmulq_f32(sn, s0));
+    d1 = vsubq_f32(d1, vmulq_f32(sn, s1));
+    d2 = vsubq_f32(d2, vmulq_f32(sn, s2));
+    d3 = vsubq_f32(d3, vmulq_f32(sn, s3));
+
+    q[0]           = vaddq_f32(q[0], vmulq_f32(d0, dt));
+    q[1]           = vaddq_f32(q[1], vmulq_f32(d1, dt));
+    q[2]           = vaddq_f32(q[2], vmulq_f32(d2, dt));
+    q[3]           = vaddq_f32(q[3], vmulq_f32(d3, dt));
+    float32x4_t qq = vaddq_f32(vaddq_f32(vmulq_f32(q[0], q[0]), vmulq_f32(q[1], q[1])),
+                               vaddq_f32(vmulq_f32(q[2], q[2]), vmulq_f32(q[3], q[3])));
+    float32x4_t qn = InvSqrtNEON(qq);
+    for (int i = 0; i < 4; i++) {
+        q[i] = vmulq_f32(q[i], qn);
+    }
+}
+
+static void FuseSensorSamplesNEON(NGP_Quaternion*         orientations,
+                                  const NGP_SensorSample* samples,
+                                  int                     count) {
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        /* two readings per vld4q, lane pairs (ax gy) (ay gz) (az dt) (gx -), then unzipped */
+        const float*  s  = (const float*)(samples + i);
+        float32x4x4_t lo   = vld4q_f32(s);
+        float32x4x4_t hi   = vld4q_f32(s + 16);
+        float32x4_t   a[3] = {
+            vuzp1q_f32(lo.val[0], hi.val[0]),
+            vnegq_f32(vuzp1q_f32(lo.val[2], hi.val[2])),
+            vuzp1q_f32(lo.val[1], hi.val[1]),
+        };
+        float32x4_t g[3] = {
+            vuzp1q_f32(lo.val[3], hi.val[3]),
+            vnegq_f32(vuzp2q_f32(lo.val[1], hi.val[1])),
+            vuzp2q_f32(lo.val[0], hi.val[0]),
+        };
+        float32x4_t   dt = vuzp2q_f32(lo.val[2], hi.val[2]);
+        float*        o  = (float*)(orientations + i);
+        float32x4x4_t q  = vld4q_f32(o);
+        FuseNEON(q.val, a, g, dt);
+        vst4q_f32(o, q);
+    }
+    NGP_FuseSensorSamplesScalar(orientations + i, samples + i, count - i);
+}
+
+#endif
+
+static NGP_FuseSensorSamplesFn fuse_kernel;
+static const char*             fuse_kernel_name;
+
+static void SelectKernel(void) {
+    NGP_FuseSensorSamplesFn kernel = NGP_FuseSensorSamplesScalar;
+    const char*             name   = "scalar";
+#if NGP_X86
+    kernel = FuseSensorSamplesSSE2;
+    name   = "sse2";
+#elif NGP_NEON
+    kernel = FuseSensorSamplesNEON;
+    name   = "neon";
+#endif
+    fuse_kernel_name = name;
+    __atomic_store_n(&fuse_kernel, kernel, __ATOMIC_RELEASE);
+}
+
+NGP_FuseSensorSamplesFn NGP_FuseSensorSamplesKernel(void) {
+    NGP_FuseSensorSamplesFn kernel = __atomic_load_n(&fuse_kernel, __ATOMIC_ACQUIRE);
+    if (!kernel) {
+        SelectKernel();
+        kernel = fuse_kernel;
+    }
+    return kernel;
+}
+
+const char* NGP_FuseSensorSamplesKernelName(void) {
+    NGP_FuseSensorSamplesKernel();
+    return fuse_kernel_name;
+}
+
+DECLSPEC void NGPCALL NGP_FuseSensorSamples(NGP_Quaternion*         orientations,
+                                           const NGP_SensorSample* samples,
+                                           int                     count) {
+    NGP_FuseSensorSamplesKernel()(orientations, samples, count);
+}
+
+/* The orientation with the pad's current tilt and no yaw, rotating gravity's reading onto Z */
+static NGP_Quaternion TiltOnly(const float accel[3]) {
+    float ax = accel[0];
+    float ay = -accel[2];
+    float az = accel[1];
+    float an = InvSqrt(ax * ax + ay * ay + az * az);
+    float w  = 1.0f + az * an;
+    if (w < 1e-6f) {
+        return (NGP_Quaternion){ 0.0f, 1.0f, 0.0f, 0.0f }; /* upside down, half a turn about X */
+    }
+    NGP_Quaternion q = { w, ay * an, -ax * an, 0.0f };
+    float          n = InvSqrt(q.W * q.W + q.X * q.X + q.Y * q.Y);
+    q.W *= n;
+    q.X *= n;
+    q.Y *= n;
+    return q;
+}
+
+/* Averages the gyro over still stretches into its bias, a moving pad restarts the window */
+static void LearnBias(NGP_Fusion* fusion, const float accel[3], const float gyro[3]) {
+    float g     = sqrtf(accel[0] * accel[0] + accel[1] * accel[1] + accel[2] * accel[2]);
+    bool  still = fabsf(g - STANDARD_GRAVITY) < REST_GRAVITY_TOLERANCE;
+    for (int i = 0; i < 3 && still; i++) {
+        float mean = fusion->rest_count ? fusion->rest_sum[i] / (float)fusion->rest_count : gyro[i];
+        still      = fabsf(gyro[i]) < REST_GYRO_MAX && fabsf(gyro[i] - mean) < REST_GYRO_NOISE;
+    }
+    if (!still) {
+        memset(fusion->rest_sum, 0, sizeof(fusion->rest_sum));
+        fusion->rest_count = 0;
+        return;
+    }
+    for (int i = 0; i < 3; i++) {
+        fusion->rest_sum[i] += gyro[i];
+    }
+    if (++fusion->rest_count == NGP_FUSION_REST_SAMPLES) {
+        for (int i = 0; i < 3; i++) {
+            fusion->bias[i]     = fusion->rest_sum[i] / NGP_FUSION_REST_SAMPLES;
+            fusion->rest_sum[i] = 0.0f;
+        }
+        fusion->rest_count = 0;
+    }
+}
+
+void NGP_FusionUpdate(NGP_Fusion* fusion, NGP_GamePadState* state) {
+    if (memcmp(fusion->accel, state->Accel, sizeof(fusion->accel)) == 0 &&
+        memcmp(fusion->gyro, state->Gyro, sizeof(fusion->gyro)) == 0) {
+        return; /* a report without motion data, e.g. the short Bluetooth one */
+    }
+    memcpy(fusion->accel, state->Accel, sizeof(fusion->accel));
+    memcpy(fusion->gyro, state->Gyro, sizeof(fusion->gyro));
+    LearnBias(fusion, state->Accel, state->Gyro);
+
+    NGP_Timestamp gap   = state->Timestamp - fusion->last;
+    bool          start = !fusion->last;
+    fusion->last        = state->Timestamp;
+    if (__atomic_exchange_n(&fusion->reset, false, __ATOMIC_ACQ_REL) || start) {
+        state->Orientation = TiltOnly(state->Accel);
+        return;
+    }
+    NGP_SensorSample sample = { .DeltaTime = 0.0f };
+    if (gap > 0 && gap <= NGP_FUSION_MAX_GAP_NS) {
+        sample.DeltaTime = (float)gap * 1e-9f;
+    }
+    for (int i = 0; i < 3; i++) {
+        sample.Accel[i] = state->Accel[i];
+        sample.Gyro[i]  = state->Gyro[i] - fusion->bias[i];
+    }
+    FuseScalar(&state->Orientation, &sample);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "NGP_Internal.h"
+
+#define NGP_FUSION_BETA 0.05f            /* Madgwick's gain, how hard gravity corrects drift */
+#define NGP_FUSION_MAX_GAP_NS 50000000LL /* longer gaps between readings are not integrated */
+#define NGP_FUSION_REST_SAMPLES 512      /* still readings averaged into a new gyro bias */
+
+/*
+ * The kernels behind NGP_FuseSensorSamples. Each one handles any count, the SIMD kernels finish the
+ * remainder with the scalar one. Exposed so ngp_bench can compare them.
+ */
+typedef void (*NGP_FuseSensorSamplesFn)(NGP_Quaternion*         orientations,
+                                        const NGP_SensorSample* samples,
+                                        int                     count);
+
+void NGP_FuseSensorSamplesScalar(NGP_Quaternion*         orientations,
+                                 const NGP_SensorSample* samples,
+                                 int                     count);
+
+/**
+ * Returns the fastest kernel the running CPU supports
+ */
+NGP_FuseSensorSamplesFn NGP_FuseSensorSamplesKernel(void);
+
+/**
+ * Returns the name of the kernel NGP_FuseSensorSamplesKernel picked, e.g. "sse2"
+ */
+const char* NGP_FuseSensorSamplesKernelName(void);
+
+/* One pad's filter, updated on the I/O thread as its readings arrive */
+typedef struct NGP_Fusion {
+    float         accel[3]; /* the last reading fused, a frame repeating it carries no new one */
+    float         gyro[3];
+    float         bias[3]; /* gyro bias, learned while the pad rests */
+    float         rest_sum[3];
+    uint32_t      rest_count;
+    NGP_Timestamp last; /* when the last reading arrived, 0 before the first */
+    bool          reset; /* set from any thread by NGP_GamePadResetOrientation */
+} NGP_Fusion;
+
+/**
+ * Fuses the frame's Accel and Gyro into its Orientation if they are a new reading, called for every
+ * frame of a pad with motion sensors before it is published
+ * @param fusion
+ * @param state
+ */
+void NGP_FusionUpdate(NGP_Fusion* fusion, NGP_GamePadState* state);
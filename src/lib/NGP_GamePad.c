@@ -1,6 +1,13 @@
 
 #include <NGP_GamePad.h>
 #include <NGP_Types.h>
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include "NGP_Device.h"
+#include "NGP_Pool.h"
+
+#define NGP_MAX_OPEN_GAMEPADS (NGP_MAX_GAMEPADS * 4)
 
 DECLSPEC double NGPCALL clamp(double v, double low, double high) {
   return v < low ? low : v > high ? high : v;
@@ -20,4 +27,334 @@ DECLSPEC NGP_Vector2 NGPCALL NormalizeAxis(NGP_Vector2 v) {
 const NGP_Color NGP_Red = {255, 0, 0};
 const NGP_Color NGP_Green = {0, 255, 0};
 const NGP_Color NGP_Blue = {0, 0, 255};
-const NGP_Color NGP_Purple = {150, 100, 255};
\ No newline at end of file
+const NGP_Color NGP_Purple = {150, 100, 255};
+
+static const char* NGP_GamePadButtonNames[NGP_GamePadButtonMax] = {
+    "a",         "b",          "x",           "y",        "back",         "guide",
+    "start",     "leftstick",  "rightstick",  "leftshoulder", "rightshoulder", "dpup",
+    "dpdown",    "dpleft",     "dpright",     "misc1",    "paddle1",      "paddle2",
+    "paddle3",   "paddle4",    "touchpad",
+};
+
+DECLSPEC const char* NGPCALL NGP_GamePadButtonName(NGP_GamePadButtonType button) {
+  if (button <= NGP_GamePadButtonInvalid || button >= NGP_GamePadButtonMax) {
+    return NULL;
+  }
+  return NGP_GamePadButtonNames[button];
+}
+
+
+/*
+ * The public game pad API, shared by every backend. Handles only hold the device's registry id,
+ * which stops resolving once the pad is released, so a reused record is never mistaken for the
+ * original pad.
+ */
+struct NGP_GamePad {
+  NGP_GamePadID   id;
+  NGP_ButtonEdges edges;    /* as of the last NGP_GamePadButtons */
+  uint32_t        pressed;  /* between that call and the one before */
+  uint32_t        released;
+};
+
+static NGP_Pool handle_pool = NGP_POOL_INIT(NGP_GamePad, 256, NGP_MAX_OPEN_GAMEPADS);
+
+DECLSPEC int NGPCALL NGP_NumGamePads() { return NGP_DeviceCount(); }
+
+DECLSPEC NGP_GamePad* NGPCALL NGP_GamePadOpen(int index) {
+  return NGP_GamePadOpenID(NGP_DeviceAtIndex(index));
+}
+
+DECLSPEC NGP_GamePad* NGPCALL NGP_GamePadOpenID(NGP_GamePadID id) {
+  NGP_Device* device = NGP_DeviceLookup(id);
+  if (!device) {
+    return NULL;
+  }
+  NGP_GamePad* gp = NGP_PoolAlloc(&handle_pool);
+  if (gp) {
+    gp->id = id;
+    NGP_DeviceReadButtons(device, &gp->edges); /* so the first frame only has what comes next */
+  }
+  return gp;
+}
+
+DECLSPEC void NGPCALL NGP_GamePadFree(NGP_GamePad* gp) { NGP_PoolFree(&handle_pool, gp); }
+
+/* Returns the device behind the handle, or NULL once it has been unplugged */
+static NGP_Device* GamePadDevice(NGP_GamePad* gp) { return gp ? NGP_DeviceLookup(gp->id) : NULL; }
+
+DECLSPEC NGP_GamePadID NGPCALL NGP_GamePadGetID(NGP_GamePad* gp) {
+  return gp ? gp->id : NGP_INVALID_GAMEPAD_ID;
+}
+
+DECLSPEC bool NGPCALL NGP_GamePadIsAttached(NGP_GamePad* gp) { return GamePadDevice(gp) != NULL; }
+
+DECLSPEC const char* NGPCALL NGP_GamePadName(NGP_GamePad* gp) {
+  NGP_Device* device = GamePadDevice(gp);
+  return device ? device->name : NULL;
+}
+
+DECLSPEC const char* NGPCALL NGP_GamePadSerial(NGP_GamePad* gp) {
+  NGP_Device* device = GamePadDevice(gp);
+  return device && device->serial[0] ? device->serial : NULL;
+}
+
+DECLSPEC int NGPCALL NGP_GamePadPlayerIndex(NGP_GamePad* gp) {
+  (void)gp;
+  return -1;
+}
+
+DECLSPEC int NGPCALL NGP_GamePadNumTouchpads(NGP_GamePad* gp) {
+  NGP_Device* device = GamePadDevice(gp);
+  return device ? device->touchpads : 0;
+}
+
+DECLSPEC int NGPCALL NGP_GamePadNumTouchpadFingers(NGP_GamePad* gp, int touchpad) {
+  NGP_Device* device = GamePadDevice(gp);
+  return device && touchpad >= 0 && touchpad < device->touchpads ? NGP_MAX_TOUCHPAD_FINGERS : 0;
+}
+
+DECLSPEC NGP_TouchpadFinger NGPCALL NGP_GamePadTouchpadFingerData(NGP_GamePad* gp,
+                                                                  int touchpad,
+                                                                  int finger) {
+  NGP_TouchpadFinger f = {touchpad, finger, -1, 0, 0.0f, 0.0f, 0.0f};
+  NGP_GamePadState state;
+  if (finger < 0 || finger >= NGP_GamePadNumTouchpadFingers(gp, touchpad) ||
+      !NGP_GamePadGetState(gp, &state)) {
+    return f;
+  }
+  f.ReturnValue = 0;
+  f.State = state.Fingers[finger].State;
+  f.X = state.Fingers[finger].X;
+  f.Y = state.Fingers[finger].Y;
+  f.Pressure = state.Fingers[finger].Pressure;
+  return f;
+}
+
+DECLSPEC int32_t NGPCALL NGP_GamePadJoystickID(NGP_GamePad* gp) {
+  NGP_Device* device = GamePadDevice(gp);
+  return device ? (int32_t)device->instance_id : -1;
+}
+
+DECLSPEC bool NGPCALL NGP_GamePadGetState(NGP_GamePad* gp, NGP_GamePadState* state) {
+  NGP_Device* device = GamePadDevice(gp);
+  if (!device) {
+    memset(state, 0, sizeof(*state));
+    return false;
+  }
+  NGP_DeviceReadState(device, state);
+  return true;
+}
+
+DECLSPEC int16_t NGPCALL NGP_GamePadAxis(NGP_GamePad* gp, NGP_GamePadAxisType axis) {
+  NGP_GamePadState state;
+  if (axis < NGP_GamePadAxisTypeLeftX || axis >= NGP_GamePadAxisTypeMax ||
+      !NGP_GamePadGetState(gp, &state)) {
+    return 0;
+  }
+  return state.Axes[axis];
+}
+
+DECLSPEC int16_t NGPCALL NGP_GamePadAxisLeftX(NGP_GamePad* gp) {
+  return NGP_GamePadAxis(gp, NGP_GamePadAxisTypeLeftX);
+}
+
+DECLSPEC int16_t NGPCALL NGP_GamePadAxisLeftY(NGP_GamePad* gp) {
+  return NGP_GamePadAxis(gp, NGP_GamePadAxisTypeLeftY);
+}
+
+DECLSPEC int16_t NGPCALL NGP_GamePadAxisRightX(NGP_GamePad* gp) {
+  return NGP_GamePadAxis(gp, NGP_GamePadAxisTypeRightX);
+}
+
+DECLSPEC int16_t NGPCALL NGP_GamePadAxisRightY(NGP_GamePad* gp) {
+  return NGP_GamePadAxis(gp, NGP_GamePadAxisTypeRightY);
+}
+
+DECLSPEC int16_t NGPCALL NGP_GamePadAxisTriggerLeft(NGP_GamePad* gp) {
+  return NGP_GamePadAxis(gp, NGP_GamePadAxisTypeTriggerLeft);
+}
+
+DECLSPEC int16_t NGPCALL NGP_GamePadAxisTriggerRight(NGP_GamePad* gp) {
+  return NGP_GamePadAxis(gp, NGP_GamePadAxisTypeTriggerRight);
+}
+
+/* Both axes of a stick come from the same frame */
+DECLSPEC NGP_Vector2 NGPCALL NGP_GamePadLeftStick(NGP_GamePad* gp) {
+  NGP_GamePadState state;
+  NGP_GamePadGetState(gp, &state);
+  NGP_Vector2 v = {state.Axes[NGP_GamePadAxisTypeLeftX], state.Axes[NGP_GamePadAxisTypeLeftY]};
+  return v;
+}
+
+DECLSPEC NGP_Vector2 NGPCALL NGP_GamePadRightStick(NGP_GamePad* gp) {
+  NGP_GamePadState state;
+  NGP_GamePadGetState(gp, &state);
+  NGP_Vector2 v = {state.Axes[NGP_GamePadAxisTypeRightX], state.Axes[NGP_GamePadAxisTypeRightY]};
+  return v;
+}
+
+/* The whole history is copied at once, so both axes of a stick come from the same reports */
+static bool GamePadHistory(NGP_GamePad* gp, NGP_AxisHistory* history) {
+  NGP_Device* device = GamePadDevice(gp);
+  if (!device) {
+    history->count = 0;
+    return false;
+  }
+  NGP_SeqLockRead(&device->lock, history, &device->history, sizeof(*history));
+  return true;
+}
+
+DECLSPEC int16_t NGPCALL NGP_GamePadAxisAt(NGP_GamePad*        gp,
+                                           NGP_GamePadAxisType axis,
+                                           NGP_Timestamp       target) {
+  NGP_AxisHistory history;
+  if (axis < NGP_GamePadAxisTypeLeftX || axis >= NGP_GamePadAxisTypeMax ||
+      !GamePadHistory(gp, &history)) {
+    return 0;
+  }
+  return (int16_t)lrintf(NGP_AxisHistorySample(&history, axis, target, NGP_GetTicksNS()));
+}
+
+DECLSPEC NGP_Vector2 NGPCALL NGP_GamePadLeftStickAt(NGP_GamePad* gp, NGP_Timestamp target) {
+  NGP_AxisHistory history;
+  GamePadHistory(gp, &history);
+  NGP_Timestamp now = NGP_GetTicksNS();
+  NGP_Vector2   v   = {NGP_AxisHistorySample(&history, NGP_GamePadAxisTypeLeftX, target, now),
+                       NGP_AxisHistorySample(&history, NGP_GamePadAxisTypeLeftY, target, now)};
+  return v;
+}
+
+DECLSPEC NGP_Vector2 NGPCALL NGP_GamePadRightStickAt(NGP_GamePad* gp, NGP_Timestamp target) {
+  NGP_AxisHistory history;
+  GamePadHistory(gp, &history);
+  NGP_Timestamp now = NGP_GetTicksNS();
+  NGP_Vector2   v   = {NGP_AxisHistorySample(&history, NGP_GamePadAxisTypeRightX, target, now),
+                       NGP_AxisHistorySample(&history, NGP_GamePadAxisTypeRightY, target, now)};
+  return v;
+}
+
+DECLSPEC NGP_Quaternion NGPCALL NGP_GamePadOrientation(NGP_GamePad* gp) {
+  NGP_GamePadState state;
+  NGP_GamePadGetState(gp, &state);
+  return state.Orientation;
+}
+
+DECLSPEC bool NGPCALL NGP_GamePadResetOrientation(NGP_GamePad* gp) {
+  NGP_Device* device = GamePadDevice(gp);
+  if (!device) {
+    return false;
+  }
+  __atomic_store_n(&device->fusion.reset, true, __ATOMIC_RELEASE);
+  return true;
+}
+
+DECLSPEC uint16_t NGPCALL NGP_GamePadVendor(NGP_GamePad* gp) {
+  NGP_Device* device = GamePadDevice(gp);
+  return device ? device->vendor_id : 0;
+}
+
+DECLSPEC uint16_t NGPCALL NGP_GamePadProduct(NGP_GamePad* gp) {
+  NGP_Device* device = GamePadDevice(gp);
+  return device ? device->product_id : 0;
+}
+
+DECLSPEC uint16_t NGPCALL NGP_GamePadProductVersion(NGP_GamePad* gp) {
+  NGP_Device* device = GamePadDevice(gp);
+  return device ? device->version : 0;
+}
+
+DECLSPEC uint8_t NGPCALL NGP_GamePadButton(NGP_GamePad* gp, NGP_GamePadButtonType button) {
+  NGP_GamePadState state;
+  if (button <= NGP_GamePadButtonInvalid || button >= NGP_GamePadButtonMax ||
+      !NGP_GamePadGetState(gp, &state)) {
+    return 0;
+  }
+  return (state.Buttons >> button) & 1;
+}
+
+DECLSPEC uint32_t NGPCALL NGP_GamePadButtons(NGP_GamePad* gp) {
+  NGP_Device* device = GamePadDevice(gp);
+  if (!device) {
+    if (gp) {
+      gp->pressed    = 0;
+      gp->released   = gp->edges.held; /* whatever was held let go with the pad */
+      gp->edges.held = 0;
+    }
+    return 0;
+  }
+  NGP_ButtonEdges edges;
+  NGP_DeviceReadButtons(device, &edges);
+  gp->pressed  = NGP_ButtonEdgesSince(edges.presses, gp->edges.presses);
+  gp->released = NGP_ButtonEdgesSince(edges.releases, gp->edges.releases);
+  gp->edges    = edges;
+  return edges.held;
+}
+
+DECLSPEC uint32_t NGPCALL NGP_GamePadButtonsPressed(NGP_GamePad* gp) {
+  return gp ? gp->pressed : 0;
+}
+
+DECLSPEC uint32_t NGPCALL NGP_GamePadButtonsReleased(NGP_GamePad* gp) {
+  return gp ? gp->released : 0;
+}
+
+DECLSPEC bool NGPCALL NGP_GamePadChordPressed(NGP_GamePad* gp, uint32_t chord) {
+  return gp && chord && (gp->edges.held & chord) == chord && (gp->pressed & chord);
+}
+
+DECLSPEC bool NGPCALL NGP_GamePadHasLED(NGP_GamePad* gp) {
+  NGP_Device* device = GamePadDevice(gp);
+  return device && (device->outputs & NGP_OutputLED);
+}
+
+DECLSPEC bool NGPCALL NGP_GamePadSetLED(NGP_GamePad* gp, uint8_t red, uint8_t green, uint8_t blue) {
+  return gp && NGP_OutputSetLED(gp->id, red, green, blue);
+}
+
+DECLSPEC bool NGPCALL NGP_GamePadSetLEDColor(NGP_GamePad* gp, NGP_Color c) {
+  return NGP_GamePadSetLED(gp, c.R, c.G, c.B);
+}
+
+DECLSPEC bool NGPCALL NGP_GamePadRumbleSupported(NGP_GamePad* gp) {
+  NGP_Device* device = GamePadDevice(gp);
+  return device && (device->outputs & NGP_OutputRumble);
+}
+
+DECLSPEC int NGPCALL NGP_GamePadRumble(NGP_GamePad* gp,
+                                       uint16_t low_freq,
+                                       uint16_t high_freq,
+                                       uint32_t duration_ms) {
+  uint16_t strength[NGP_HapticsMotorMax] = {low_freq, high_freq, 0, 0};
+  return gp && NGP_HapticsPlaySlot(gp->id, NGP_HapticsSlotRumble, strength, duration_ms) ? 0 : -1;
+}
+
+DECLSPEC bool NGPCALL NGP_GamePadRumbleTriggersSupported(NGP_GamePad* gp) {
+  NGP_Device* device = GamePadDevice(gp);
+  return device && (device->outputs & NGP_OutputTriggerRumble);
+}
+
+DECLSPEC int NGPCALL NGP_GamePadRumbleLeftTrigger(NGP_GamePad* gp,
+                                                  uint16_t left,
+                                                  uint32_t duration_ms) {
+  uint16_t strength[NGP_HapticsMotorMax] = {0, 0, left, 0};
+  return gp && NGP_HapticsPlaySlot(gp->id, NGP_HapticsSlotLeftTrigger, strength, duration_ms)
+             ? 0
+             : -1;
+}
+
+DECLSPEC int NGPCALL NGP_GamePadRumbleRightTrigger(NGP_GamePad* gp,
+                                                   uint16_t right,
+                                                   uint32_t duration_ms) {
+  uint16_t strength[NGP_HapticsMotorMax] = {0, 0, 0, right};
+  return gp && NGP_HapticsPlaySlot(gp->id, NGP_HapticsSlotRightTrigger, strength, duration_ms)
+             ? 0
+             : -1;
+}
+
+DECLSPEC int NGPCALL NGP_GamePadRumbleTriggers(NGP_GamePad* gp,
+                                               uint16_t left,
+                                               uint16_t right,
+                                               uint32_t duration_ms) {
+  int result = NGP_GamePadRumbleLeftTrigger(gp, left, duration_ms);
+  return NGP_GamePadRumbleRightTrigger(gp, right, duration_ms) == 0 ? result : -1;
+}
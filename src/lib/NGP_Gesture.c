@@ -0,0 +1,167 @@
+#include "NGP_Gesture.h"
+
+#include <math.h>
+
+#define VELOCITY_SMOOTHING 0.5f /* weight of the newest report's velocity in the estimate */
+
+static void Begin(NGP_TouchTrack* track, const NGP_GamePadStateFinger* finger, NGP_Timestamp now) {
+    track->x       = finger->X;
+    track->y       = finger->Y;
+    track->start_x = finger->X;
+    track->start_y = finger->Y;
+    track->vx      = 0.0f;
+    track->vy      = 0.0f;
+    track->travel  = 0.0f;
+    track->start   = now;
+    track->moved   = now;
+    track->id      = finger->ID;
+    track->down    = true;
+}
+
+static void Move(NGP_TouchTrack* track, const NGP_GamePadStateFinger* finger, NGP_Timestamp now) {
+    float dx = finger->X - track->x;
+    float dy = finger->Y - track->y;
+    if (dx == 0.0f && dy == 0.0f) {
+        return; /* only the pressure changed */
+    }
+    if (now > track->moved) {
+        float dt = (float)(now - track->moved) * 1e-9f;
+        track->vx += VELOCITY_SMOOTHING * (dx / dt - track->vx);
+        track->vy += VELOCITY_SMOOTHING * (dy / dt - track->vy);
+    }
+    track->x     = finger->X;
+    track->y     = finger->Y;
+    track->moved = now;
+
+    float from_x = track->x - track->start_x;
+    float from_y = track->y - track->start_y;
+    float travel = sqrtf(from_x * from_x + from_y * from_y);
+    if (travel > track->travel) {
+        track->travel = travel;
+    }
+}
+
+/* Classifies a single finger touch as it lifts */
+static bool End(const NGP_TouchTrack* track, NGP_Timestamp now, NGP_GestureEvent* gesture) {
+    gesture->X     = track->x;
+    gesture->Y     = track->y;
+    gesture->DX    = 0.0f;
+    gesture->DY    = 0.0f;
+    gesture->Scale = 1.0f;
+    if (track->travel <= NGP_GESTURE_TAP_SLOP && now - track->start <= NGP_GESTURE_TAP_NS) {
+        gesture->Gesture = NGP_GestureTap;
+        return true;
+    }
+    if (track->travel < NGP_GESTURE_SWIPE_TRAVEL || now - track->moved > NGP_GESTURE_STALE_NS) {
+        return false;
+    }
+    float speed = sqrtf(track->vx * track->vx + track->vy * track->vy);
+    if (speed < NGP_GESTURE_SWIPE_SPEED) {
+        return false;
+    }
+    gesture->Gesture = NGP_GestureSwipe;
+    gesture->DX      = track->vx;
+    gesture->DY      = track->vy;
+    return true;
+}
+
+static float Spread(const NGP_TouchTrack* a, const NGP_TouchTrack* b) {
+    float dx = a->x - b->x;
+    float dy = a->y - b->y;
+    return sqrtf(dx * dx + dy * dy);
+}
+
+/* Follows two fingers that are both down, deciding once whether they scroll or pinch */
+static bool TwoFingers(NGP_GestureTracker* tracker, NGP_GestureEvent* gesture) {
+    const NGP_TouchTrack* a      = &tracker->tracks[0];
+    const NGP_TouchTrack* b      = &tracker->tracks[1];
+    float                 x      = (a->x + b->x) * 0.5f;
+    float                 y      = (a->y + b->y) * 0.5f;
+    float                 spread = Spread(a, b);
+    if (tracker->two_finger == NGP_TwoFingerNone) {
+        tracker->two_finger    = NGP_TwoFingerPending;
+        tracker->anchor_x      = x;
+        tracker->anchor_y      = y;
+        tracker->anchor_spread = spread;
+        return false;
+    }
+
+    float dx = x - tracker->anchor_x;
+    float dy = y - tracker->anchor_y;
+    if (tracker->two_finger == NGP_TwoFingerPending) {
+        if (fabsf(spread - tracker->anchor_spread) > NGP_GESTURE_TWO_FINGER_SLOP) {
+            tracker->two_finger = NGP_TwoFingerPinch;
+        } else if (sqrtf(dx * dx + dy * dy) > NGP_GESTURE_TWO_FINGER_SLOP) {
+            tracker->two_finger = NGP_TwoFingerScroll;
+        } else {
+            return false;
+        }
+    }
+
+    gesture->X     = x;
+    gesture->Y     = y;
+    gesture->DX    = 0.0f;
+    gesture->DY    = 0.0f;
+    gesture->Scale = 1.0f;
+    if (tracker->two_finger == NGP_TwoFingerScroll) {
+        if (dx == 0.0f && dy == 0.0f) {
+            return false;
+        }
+        gesture->Gesture = NGP_GestureScroll;
+        gesture->DX      = dx;
+        gesture->DY      = dy;
+    } else {
+        if (spread == tracker->anchor_spread || tracker->anchor_spread == 0.0f) {
+            tracker->anchor_spread = spread;
+            return false;
+        }
+        gesture->Gesture = NGP_GesturePinch;
+        gesture->Scale   = spread / tracker->anchor_spread;
+    }
+    tracker->anchor_x      = x;
+    tracker->anchor_y      = y;
+    tracker->anchor_spread = spread;
+    return true;
+}
+
+int NGP_GestureUpdate(NGP_GestureTracker*     tracker,
+                      const NGP_GamePadState* state,
+                      NGP_GestureEvent*       gestures) {
+    NGP_Timestamp now   = state->Timestamp;
+    int           count = 0;
+    int           down  = 0;
+    tracker->dirty      = false;
+
+    for (int i = 0; i < NGP_MAX_TOUCHPAD_FINGERS; i++) {
+        const NGP_GamePadStateFinger* finger = &state->Fingers[i];
+        NGP_TouchTrack*               track  = &tracker->tracks[i];
+        if (track->down && (!finger->State || finger->ID != track->id)) {
+            /* lifted, or lifted and replaced by a new contact between two reports */
+            track->down = false;
+            if (!tracker->multi && End(track, now, &gestures[count])) {
+                count++;
+            }
+        }
+        if (finger->State) {
+            if (track->down) {
+                Move(track, finger, now);
+            } else {
+                Begin(track, finger, now);
+            }
+            down++;
+        }
+    }
+
+    if (down == NGP_MAX_TOUCHPAD_FINGERS) {
+        tracker->multi = true;
+        if (TwoFingers(tracker, &gestures[count])) {
+            count++;
+        }
+    } else {
+        tracker->two_finger = NGP_TwoFingerNone;
+        if (down == 0) {
+            tracker->multi = false;
+        }
+    }
+    return count;
+}
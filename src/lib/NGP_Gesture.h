@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "NGP_Internal.h"
+
+#define NGP_GESTURE_TAP_NS 250000000LL   /* longest touch that still counts as a tap */
+#define NGP_GESTURE_TAP_SLOP 0.03f       /* farthest a tapping finger may wander */
+#define NGP_GESTURE_SWIPE_TRAVEL 0.2f    /* shortest swipe */
+#define NGP_GESTURE_SWIPE_SPEED 1.0f     /* slowest swipe at the moment it lifts, per second */
+#define NGP_GESTURE_STALE_NS 50000000LL  /* a finger this still before lifting has no speed */
+#define NGP_GESTURE_TWO_FINGER_SLOP 0.02f /* how far two fingers move before they scroll or pinch */
+
+/* One finger's contact, from the report it touched down in to the one it lifted in */
+typedef struct NGP_TouchTrack {
+    float         x;
+    float         y;
+    float         start_x;
+    float         start_y;
+    float         vx; /* smoothed velocity, per second */
+    float         vy;
+    float         travel; /* farthest it has been from where it started */
+    NGP_Timestamp start;
+    NGP_Timestamp moved; /* the last report it moved in */
+    uint8_t       id;
+    bool          down;
+} NGP_TouchTrack;
+
+typedef enum {
+    NGP_TwoFingerNone,
+    NGP_TwoFingerPending, /* both down, not yet moved far enough to tell scroll from pinch */
+    NGP_TwoFingerScroll,
+    NGP_TwoFingerPinch,
+} NGP_TwoFingerMode;
+
+/*
+ * A pad's touchpad gestures, advanced by one report at a time on the I/O thread so nothing has to
+ * look back over earlier frames
+ */
+typedef struct NGP_GestureTracker {
+    NGP_TouchTrack tracks[NGP_MAX_TOUCHPAD_FINGERS];
+    uint8_t        two_finger; /* NGP_TwoFingerMode */
+    bool           multi;      /* two fingers were down since the pad was last bare, no taps */
+    bool           dirty;      /* a finger changed since the last update */
+    float          anchor_x;   /* midpoint and spread of the fingers at the last two finger event */
+    float          anchor_y;
+    float          anchor_spread;
+} NGP_GestureTracker;
+
+/**
+ * Advances the tracks to the state's Fingers and writes the gestures they complete
+ * @param tracker
+ * @param state a frame whose Fingers differ from the last one passed
+ * @param gestures room for NGP_MAX_TOUCHPAD_FINGERS gestures
+ * @return how many were written
+ */
+int NGP_GestureUpdate(NGP_GestureTracker*     tracker,
+                      const NGP_GamePadState* state,
+                      NGP_GestureEvent*       gestures);
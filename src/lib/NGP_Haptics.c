@@ -0,0 +1,309 @@
+#include <pthread.h>
+#include <string.h>
+
+#include "NGP_Device.h"
+#include "NGP_Pool.h"
+#include "NGP_Runtime.h"
+
+#define NGP_HAPTICS_TICK_NS (1000000000LL / NGP_HAPTICS_TICK_HZ)
+#define NGP_HAPTICS_MAX_PAD_EFFECTS 64
+#define NGP_HAPTICS_MAX_EFFECTS 1024
+#define NGP_HAPTICS_LEVEL_MAX 65535
+
+struct NGP_HapticsPlaying {
+    NGP_HapticsPlaying* next;
+    NGP_HapticsEffectID id;
+    NGP_HapticsEffect   effect;
+    NGP_Timestamp       start;   /* the tick it was first mixed on, 0 until then */
+    NGP_Timestamp       stopped; /* the tick it was moved to its release on, 0 until then */
+    bool                stop;    /* NGP_GamePadStopEffect was called, the next tick moves it */
+};
+
+/*
+ * Pads with effects playing are linked through haptics_link. Effects are added and stopped from
+ * any thread under haptics_lock, envelopes only advance on the I/O thread's ticks, so the mix is
+ * the same however late the thread wakes up.
+ */
+static pthread_mutex_t     haptics_lock = PTHREAD_MUTEX_INITIALIZER;
+static NGP_Device*         haptics_devices;
+static NGP_HapticsEffectID effect_counter;
+static bool                haptics_work; /* haptics_devices is non-empty */
+static NGP_Timestamp       next_tick;    /* 0 while idle, I/O thread only */
+
+static NGP_Pool effect_pool = NGP_POOL_INIT(NGP_HapticsPlaying, 64, NGP_HAPTICS_MAX_EFFECTS);
+
+static int64_t Ms(uint32_t ms) { return (int64_t)ms * 1000000; }
+
+/* A level fading linearly to 0 over release, or -1 once it got there */
+static int32_t Fade(int32_t from, int64_t t, int64_t release) {
+    if (t >= release) {
+        return -1;
+    }
+    return (int32_t)(from - from * t / release);
+}
+
+/* The envelope t ns after the start, 0 to NGP_HAPTICS_LEVEL_MAX, or -1 once it has ended */
+static int32_t EnvelopeLevel(const NGP_HapticsEffect* effect, int64_t t) {
+    int64_t attack = Ms(effect->AttackMs);
+    int64_t decay  = Ms(effect->DecayMs);
+    if (t < attack) {
+        return (int32_t)(NGP_HAPTICS_LEVEL_MAX * t / attack);
+    }
+    t -= attack;
+    if (t < decay) {
+        return (int32_t)(NGP_HAPTICS_LEVEL_MAX -
+                         (NGP_HAPTICS_LEVEL_MAX - effect->SustainLevel) * t / decay);
+    }
+    t -= decay;
+    if (effect->SustainMs == NGP_HAPTICS_INFINITE || t < Ms(effect->SustainMs)) {
+        return effect->SustainLevel;
+    }
+    return Fade(effect->SustainLevel, t - Ms(effect->SustainMs), Ms(effect->ReleaseMs));
+}
+
+static int32_t EffectLevel(const NGP_HapticsPlaying* playing, NGP_Timestamp tick) {
+    if (playing->stopped) {
+        int32_t from = EnvelopeLevel(&playing->effect, playing->stopped - playing->start);
+        return from < 0 ? -1
+                        : Fade(from, tick - playing->stopped, Ms(playing->effect.ReleaseMs));
+    }
+    return EnvelopeLevel(&playing->effect, tick - playing->start);
+}
+
+static void UpdateWork(void) {
+    __atomic_store_n(&haptics_work, haptics_devices != NULL, __ATOMIC_RELEASE);
+}
+
+/* Makes sure the next tick mixes the device, also needed after its last effect was removed */
+static void QueueDevice(NGP_Device* device) {
+    if (!device->haptics_queued) {
+        device->haptics_link   = haptics_devices;
+        device->haptics_queued = true;
+        haptics_devices        = device;
+        UpdateWork();
+    }
+}
+
+static void FreeEffect(NGP_Device* device, NGP_HapticsPlaying** link) {
+    NGP_HapticsPlaying* playing = *link;
+    *link                       = playing->next;
+    for (int slot = 0; slot < NGP_HapticsSlotMax; slot++) {
+        if (device->haptics_slots[slot] == playing->id) {
+            device->haptics_slots[slot] = 0;
+        }
+    }
+    device->effect_count--;
+    NGP_PoolFree(&effect_pool, playing);
+}
+
+static NGP_HapticsPlaying** FindEffect(NGP_Device* device, NGP_HapticsEffectID id) {
+    NGP_HapticsPlaying** link = &device->effects;
+    while (*link && (*link)->id != id) {
+        link = &(*link)->next;
+    }
+    return *link ? link : NULL;
+}
+
+static NGP_HapticsEffectID Play(NGP_Device* device, const NGP_HapticsEffect* effect) {
+    if (device->effect_count >= NGP_HAPTICS_MAX_PAD_EFFECTS) {
+        return NGP_INVALID_HAPTICS_EFFECT_ID;
+    }
+    NGP_HapticsPlaying* playing = NGP_PoolAlloc(&effect_pool);
+    if (!playing) {
+        return NGP_INVALID_HAPTICS_EFFECT_ID;
+    }
+    if (++effect_counter <= 0) {
+        effect_counter = 1;
+    }
+    playing->id      = effect_counter;
+    playing->effect  = *effect;
+    playing->next    = device->effects;
+    device->effects  = playing;
+    device->effect_count++;
+    QueueDevice(device);
+    return playing->id;
+}
+
+/* Takes the mixer lock if the pad is attached and has any of the outputs, NULL otherwise */
+static NGP_Device* LockHaptics(NGP_GamePadID id, uint8_t outputs) {
+    pthread_mutex_lock(&haptics_lock);
+    NGP_Device* device = NGP_DeviceLookup(id);
+    if (!device || !(device->outputs & outputs)) {
+        pthread_mutex_unlock(&haptics_lock);
+        return NULL;
+    }
+    return device;
+}
+
+DECLSPEC NGP_HapticsEffectID NGPCALL NGP_GamePadPlayEffect(NGP_GamePad*             p,
+                                                           const NGP_HapticsEffect* effect) {
+    NGP_Device* device =
+        effect ? LockHaptics(NGP_GamePadGetID(p), NGP_OutputRumble | NGP_OutputTriggerRumble)
+               : NULL;
+    if (!device) {
+        return NGP_INVALID_HAPTICS_EFFECT_ID;
+    }
+    NGP_HapticsEffectID id = Play(device, effect);
+    pthread_mutex_unlock(&haptics_lock);
+    if (id != NGP_INVALID_HAPTICS_EFFECT_ID) {
+        NGP_RuntimeWake();
+    }
+    return id;
+}
+
+DECLSPEC bool NGPCALL NGP_GamePadStopEffect(NGP_GamePad* p, NGP_HapticsEffectID effect) {
+    NGP_Device* device =
+        LockHaptics(NGP_GamePadGetID(p), NGP_OutputRumble | NGP_OutputTriggerRumble);
+    if (!device) {
+        return false;
+    }
+    NGP_HapticsPlaying** link    = FindEffect(device, effect);
+    bool                 stopped = link && !(*link)->stop;
+    if (stopped) {
+        (*link)->stop = true;
+    }
+    pthread_mutex_unlock(&haptics_lock);
+    return stopped;
+}
+
+DECLSPEC void NGPCALL NGP_GamePadStopAllEffects(NGP_GamePad* p) {
+    NGP_Device* device =
+        LockHaptics(NGP_GamePadGetID(p), NGP_OutputRumble | NGP_OutputTriggerRumble);
+    if (!device) {
+        return;
+    }
+    bool playing = device->effects != NULL;
+    while (device->effects) {
+        FreeEffect(device, &device->effects);
+    }
+    pthread_mutex_unlock(&haptics_lock);
+    if (playing) {
+        NGP_RuntimeWake(); /* the pad stays queued until a tick has mixed it back to 0 */
+    }
+}
+
+bool NGP_HapticsPlaySlot(NGP_GamePadID   id,
+                         NGP_HapticsSlot slot,
+                         const uint16_t  strength[NGP_HapticsMotorMax],
+                         uint32_t        duration_ms) {
+    NGP_Device* device = LockHaptics(
+        id, slot == NGP_HapticsSlotRumble ? NGP_OutputRumble : NGP_OutputTriggerRumble);
+    if (!device) {
+        return false;
+    }
+    NGP_HapticsPlaying** link = FindEffect(device, device->haptics_slots[slot]);
+    if (link) {
+        FreeEffect(device, link);
+        QueueDevice(device);
+    }
+    bool played = true;
+    if (strength[0] || strength[1] || strength[2] || strength[3]) {
+        NGP_HapticsEffect effect = { .SustainLevel = NGP_HAPTICS_LEVEL_MAX };
+        memcpy(effect.Strength, strength, sizeof(effect.Strength));
+        effect.SustainMs            = duration_ms ? duration_ms : NGP_HAPTICS_INFINITE;
+        device->haptics_slots[slot] = Play(device, &effect);
+        played = device->haptics_slots[slot] != NGP_INVALID_HAPTICS_EFFECT_ID;
+    }
+    pthread_mutex_unlock(&haptics_lock);
+    NGP_RuntimeWake();
+    return played;
+}
+
+void NGP_HapticsCancel(NGP_Device* device) {
+    pthread_mutex_lock(&haptics_lock);
+    while (device->effects) {
+        FreeEffect(device, &device->effects);
+    }
+    for (NGP_Device** link = &haptics_devices; *link; link = &(*link)->haptics_link) {
+        if (*link == device) {
+            *link = device->haptics_link;
+            break;
+        }
+    }
+    device->haptics_queued = false;
+    UpdateWork();
+    pthread_mutex_unlock(&haptics_lock);
+}
+
+/* Advances the device's effects to tick, freeing the ones that ended, and mixes them per motor */
+static void Mix(NGP_Device* device, NGP_Timestamp tick, uint16_t motors[NGP_HapticsMotorMax]) {
+    int32_t  top[NGP_HapticsMotorMax];
+    uint32_t sum[NGP_HapticsMotorMax] = { 0 };
+    for (int motor = 0; motor < NGP_HapticsMotorMax; motor++) {
+        top[motor] = INT32_MIN;
+    }
+    for (NGP_HapticsPlaying** link = &device->effects; *link;) {
+        NGP_HapticsPlaying* playing = *link;
+        if (!playing->start) {
+            playing->start = tick;
+        }
+        if (playing->stop && !playing->stopped) {
+            playing->stopped = tick;
+        }
+        int32_t level = EffectLevel(playing, tick);
+        if (level < 0) {
+            FreeEffect(device, link);
+            continue;
+        }
+        for (int motor = 0; motor < NGP_HapticsMotorMax; motor++) {
+            uint32_t value = (uint32_t)playing->effect.Strength[motor] * (uint32_t)level /
+                             NGP_HAPTICS_LEVEL_MAX;
+            if (value == 0 || playing->effect.Priority < top[motor]) {
+                continue; /* silent effects do not mask quieter, lower priority ones */
+            }
+            if (playing->effect.Priority > top[motor]) {
+                top[motor] = playing->effect.Priority;
+                sum[motor] = 0;
+            }
+            sum[motor] += value;
+        }
+        link = &playing->next;
+    }
+    for (int motor = 0; motor < NGP_HapticsMotorMax; motor++) {
+        motors[motor] = (uint16_t)(sum[motor] > UINT16_MAX ? UINT16_MAX : sum[motor]);
+    }
+}
+
+int NGP_HapticsTick(void) {
+    if (!__atomic_load_n(&haptics_work, __ATOMIC_ACQUIRE)) {
+        next_tick = 0;
+        return -1;
+    }
+    return NGP_HapticsMixAt(NGP_GetTicksNS());
+}
+
+int NGP_HapticsMixAt(NGP_Timestamp now) {
+    if (next_tick && now < next_tick) {
+        return (int)((next_tick - now + 999999) / 1000000);
+    }
+    /* a late thread mixes the last tick that is due, not one per tick it missed */
+    NGP_Timestamp tick =
+        next_tick ? next_tick + (now - next_tick) / NGP_HAPTICS_TICK_NS * NGP_HAPTICS_TICK_NS : now;
+    next_tick = tick + NGP_HAPTICS_TICK_NS;
+
+    pthread_mutex_lock(&haptics_lock);
+    for (NGP_Device** link = &haptics_devices; *link;) {
+        NGP_Device* device = *link;
+        uint16_t    motors[NGP_HapticsMotorMax];
+        Mix(device, tick, motors);
+        if (memcmp(motors, device->haptics_mixed, sizeof(motors)) != 0) {
+            memcpy(device->haptics_mixed, motors, sizeof(motors));
+            NGP_OutputSetMotors(device, motors);
+        }
+        if (!device->effects) {
+            *link                  = device->haptics_link;
+            device->haptics_queued = false;
+            continue;
+        }
+        link = &device->haptics_link;
+    }
+    UpdateWork();
+    bool idle = haptics_devices == NULL;
+    pthread_mutex_unlock(&haptics_lock);
+
+    if (idle) {
+        next_tick = 0;
+        return -1;
+    }
+    return (int)((next_tick - now + 999999) / 1000000);
+}
@@ -0,0 +1,88 @@
+#include "NGP_Intern.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#include "NGP_Pool.h"
+
+#define NGP_INTERN_SLOTS (NGP_INTERN_CAPACITY * 2) /* open addressing, kept at most half full */
+#define NGP_INTERN_ARENA 16384
+
+typedef struct NGP_InternSlot {
+    const char* string;
+    uint32_t    hash;
+    uint32_t    length;
+} NGP_InternSlot;
+
+/*
+ * A hash set of every string interned so far. The strings themselves are packed into arenas that
+ * are allocated as they fill up and never freed, so a reconnecting pad finds its name in place.
+ */
+typedef struct NGP_InternTable {
+    pthread_mutex_t lock;
+    NGP_InternSlot  slots[NGP_INTERN_SLOTS];
+    uint32_t        count;
+    char*           arena;
+    size_t          arena_used;
+} NGP_InternTable;
+
+static NGP_InternTable table = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+/* FNV-1a */
+static uint32_t Hash(const char* string, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)string[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static char* ArenaCopy(const char* string, size_t length) {
+    size_t size = length + 1;
+    if (size > NGP_INTERN_ARENA) {
+        return NULL;
+    }
+    if (!table.arena || table.arena_used + size > NGP_INTERN_ARENA) {
+        if (!(table.arena = NGP_MallocPermanent(NGP_INTERN_ARENA, 1))) {
+            return NULL;
+        }
+        table.arena_used = 0;
+    }
+    char* copy = table.arena + table.arena_used;
+    memcpy(copy, string, length);
+    copy[length] = '\0';
+    table.arena_used += size;
+    return copy;
+}
+
+const char* NGP_InternString(const char* string, size_t length) {
+    if (!string || length == 0) {
+        return "";
+    }
+    uint32_t    hash   = Hash(string, length);
+    const char* result = "";
+    pthread_mutex_lock(&table.lock);
+    for (uint32_t i = hash % NGP_INTERN_SLOTS;; i = (i + 1) % NGP_INTERN_SLOTS) {
+        NGP_InternSlot* slot = &table.slots[i];
+        if (!slot->string) {
+            if (table.count < NGP_INTERN_CAPACITY && (slot->string = ArenaCopy(string, length))) {
+                slot->hash   = hash;
+                slot->length = (uint32_t)length;
+                result       = slot->string;
+                table.count++;
+            }
+            break;
+        }
+        if (slot->hash == hash && slot->length == length &&
+            memcmp(slot->string, string, length) == 0) {
+            result = slot->string;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&table.lock);
+    return result;
+}
+
+const char* NGP_Intern(const char* string) {
+    return NGP_InternString(string, string ? strlen(string) : 0);
+}
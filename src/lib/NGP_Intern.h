@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stddef.h>
+#include "NGP_Internal.h"
+
+#define NGP_INTERN_CAPACITY 8192 /* distinct strings, two per pad the registry can hold */
+
+/**
+ * Returns the one shared copy of a string, adding it the first time it is seen. Interned strings
+ * are never freed, so the pointer stays valid after the pad it was for is gone. Thread safe.
+ * @param string need not be NUL terminated
+ * @param length
+ * @return the interned copy, or "" if the string was NULL or the table is full
+ */
+const char* NGP_InternString(const char* string, size_t length);
+
+/**
+ * Like NGP_InternString for a NUL terminated string
+ * @param string
+ */
+const char* NGP_Intern(const char* string);
@@ -1,4 +1,11 @@
 #pragma once
 
+#include "../include/NGP_Calibration.h"
 #include "../include/NGP_Event.h"
-#include "../include/NGP_GamePad.h"
\ No newline at end of file
+#include "../include/NGP_GamePad.h"
+#include "../include/NGP_Haptics.h"
+#include "../include/NGP_Latency.h"
+#include "../include/NGP_Memory.h"
+#include "../include/NGP_Recording.h"
+#include "../include/NGP_SharedState.h"
+#include "../include/NGP_Virtual.h"
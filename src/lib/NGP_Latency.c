@@ -0,0 +1,183 @@
+#include <string.h>
+#include <time.h>
+
+#include "NGP_EventQueue.h"
+#include "NGP_Pool.h"
+#include "NGP_Registry.h"
+
+/*
+ * Log-linear buckets in the style of HDR histograms. Values below 64 get a bucket each, above that
+ * every power of two is split into 32 buckets, so a bucket is never wider than 1/32 of its value.
+ * Values of 2^40 ns (about 18 minutes) and up share the last bucket.
+ */
+#define NGP_LATENCY_SUB_BITS 5
+#define NGP_LATENCY_MAX_BITS 40
+#define NGP_LATENCY_BUCKETS \
+    ((NGP_LATENCY_MAX_BITS - NGP_LATENCY_SUB_BITS + 1) << NGP_LATENCY_SUB_BITS)
+
+typedef struct NGP_LatencyHistogram {
+    uint64_t count;
+    uint64_t max;
+    uint32_t buckets[NGP_LATENCY_BUCKETS]; /* 32 bits keeps a pad's histograms at 14K */
+} NGP_LatencyHistogram;
+
+typedef struct NGP_LatencyPad {
+    NGP_GamePadID        id; /* the pad the slot's histograms belong to, reset when it is reused */
+    NGP_LatencyHistogram stages[NGP_LatencyStageMax];
+} NGP_LatencyPad;
+
+/*
+ * Indexed by registry slot and allocated the first time an event for the slot is polled. Only the
+ * polling thread writes, so the counters are bumped with relaxed stores rather than atomic adds.
+ */
+static NGP_LatencyPad* latency_pads[NGP_REGISTRY_CAPACITY];
+
+/* When the device source started and how long its first pad took, for NGP_GetTimeToFirstGamePad */
+static NGP_Timestamp enumeration_start;
+static NGP_Timestamp first_pad;
+
+DECLSPEC NGP_Timestamp NGPCALL NGP_GetTicksNS(void) {
+    struct timespec ts;
+#ifdef __APPLE__
+    /* the mach_absolute_time clock IOKit stamps reports with */
+    clock_gettime(CLOCK_UPTIME_RAW, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (NGP_Timestamp)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int BucketIndex(uint64_t value) {
+    if (value >= (1ULL << NGP_LATENCY_MAX_BITS)) {
+        return NGP_LATENCY_BUCKETS - 1;
+    }
+    int msb   = 63 - __builtin_clzll(value | 1);
+    int shift = msb > NGP_LATENCY_SUB_BITS ? msb - NGP_LATENCY_SUB_BITS : 0;
+    return (shift << NGP_LATENCY_SUB_BITS) + (int)(value >> shift);
+}
+
+/* The largest value that lands in the bucket */
+static uint64_t BucketValue(int index) {
+    if (index < (2 << NGP_LATENCY_SUB_BITS)) {
+        return (uint64_t)index;
+    }
+    int shift = (index >> NGP_LATENCY_SUB_BITS) - 1;
+    return ((uint64_t)(index - (shift << NGP_LATENCY_SUB_BITS)) << shift) + (1ULL << shift) - 1;
+}
+
+static void Record(NGP_LatencyHistogram* histogram, NGP_Timestamp from, NGP_Timestamp to) {
+    if (from <= 0 || to < from) {
+        return; /* not stamped, e.g. a source without report times */
+    }
+    uint64_t  value  = (uint64_t)(to - from);
+    uint32_t* bucket = &histogram->buckets[BucketIndex(value)];
+    __atomic_store_n(bucket, *bucket + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&histogram->count, histogram->count + 1, __ATOMIC_RELAXED);
+    if (value > histogram->max) {
+        __atomic_store_n(&histogram->max, value, __ATOMIC_RELAXED);
+    }
+}
+
+static NGP_LatencyPad* PadForEvent(NGP_GamePadID id) {
+    int             slot = NGP_RegistrySlot(id);
+    NGP_LatencyPad* pad  = latency_pads[slot];
+    if (!pad) {
+        if (!(pad = NGP_Calloc(1, sizeof(NGP_LatencyPad)))) {
+            return NULL;
+        }
+        pad->id = id;
+        __atomic_store_n(&latency_pads[slot], pad, __ATOMIC_RELEASE);
+    } else if (pad->id != id) {
+        __atomic_store_n(&pad->id, id, __ATOMIC_RELAXED);
+        memset(pad->stages, 0, sizeof(pad->stages));
+    }
+    return pad;
+}
+
+void NGP_LatencyRecordEvents(NGP_Event* events, int count) {
+    if (count <= 0) {
+        return;
+    }
+    NGP_Timestamp   now = NGP_GetTicksNS();
+    NGP_LatencyPad* pad = NULL;
+    for (int i = 0; i < count; i++) {
+        NGP_Event* e        = &events[i];
+        e->DequeueTimestamp = now;
+        if (e->GamePadID < 0) {
+            continue;
+        }
+        if (!pad || pad->id != e->GamePadID) {
+            if (!(pad = PadForEvent(e->GamePadID))) {
+                continue;
+            }
+        }
+        Record(&pad->stages[NGP_LatencyStageDelivery], e->Timestamp, e->EnqueueTimestamp);
+        Record(&pad->stages[NGP_LatencyStageQueue], e->EnqueueTimestamp, now);
+        Record(&pad->stages[NGP_LatencyStageTotal], e->Timestamp, now);
+    }
+}
+
+/* The smallest bucket value with at least fraction of the count at or below it */
+static uint64_t Percentile(const NGP_LatencyHistogram* histogram, uint64_t count, double fraction) {
+    uint64_t target = (uint64_t)((double)count * fraction + 0.5);
+    uint64_t seen   = 0;
+    if (target == 0) {
+        target = 1;
+    }
+    for (int i = 0; i < NGP_LATENCY_BUCKETS; i++) {
+        seen += __atomic_load_n(&histogram->buckets[i], __ATOMIC_RELAXED);
+        if (seen >= target) {
+            return BucketValue(i);
+        }
+    }
+    return __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+}
+
+DECLSPEC bool NGPCALL NGP_GetLatencyStats(NGP_GamePadID id, NGP_LatencyStats* stats) {
+    if (id < 0 || !stats) {
+        return false;
+    }
+    NGP_LatencyPad* pad = __atomic_load_n(&latency_pads[NGP_RegistrySlot(id)], __ATOMIC_ACQUIRE);
+    if (!pad || __atomic_load_n(&pad->id, __ATOMIC_RELAXED) != id) {
+        return false;
+    }
+    for (int stage = 0; stage < NGP_LatencyStageMax; stage++) {
+        const NGP_LatencyHistogram* histogram = &pad->stages[stage];
+        NGP_LatencyStageStats*      out       = &stats->Stages[stage];
+        out->Count = __atomic_load_n(&histogram->count, __ATOMIC_RELAXED);
+        out->P50   = out->Count ? Percentile(histogram, out->Count, 0.50) : 0;
+        out->P99   = out->Count ? Percentile(histogram, out->Count, 0.99) : 0;
+        out->Max   = __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+        if (out->P50 > out->Max) {
+            out->P50 = out->Max; /* the top bucket's upper bound can overshoot the real maximum */
+        }
+        if (out->P99 > out->Max) {
+            out->P99 = out->Max;
+        }
+    }
+    return true;
+}
+
+DECLSPEC void NGPCALL NGP_ResetLatencyStats(void) {
+    for (int slot = 0; slot < NGP_REGISTRY_CAPACITY; slot++) {
+        if (latency_pads[slot]) {
+            memset(latency_pads[slot]->stages, 0, sizeof(latency_pads[slot]->stages));
+        }
+    }
+}
+
+void NGP_LatencyStartEnumeration(void) {
+    __atomic_store_n(&first_pad, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&enumeration_start, NGP_GetTicksNS(), __ATOMIC_RELAXED);
+}
+
+void NGP_LatencyPadAttached(void) {
+    NGP_Timestamp start = __atomic_load_n(&enumeration_start, __ATOMIC_RELAXED);
+    if (start && !__atomic_load_n(&first_pad, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&first_pad, NGP_GetTicksNS() - start, __ATOMIC_RELAXED);
+    }
+}
+
+DECLSPEC NGP_Timestamp NGPCALL NGP_GetTimeToFirstGamePad(void) {
+    return __atomic_load_n(&first_pad, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,332 @@
+#include "NGP_Normalize.h"
+
+#include <math.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define NGP_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(NGP_NORMALIZE_NEON)
+/* opt in until test_normalize has run on ARM, like the fusion kernel */
+#define NGP_NEON 1
+#include <arm_neon.h>
+#endif
+
+#define NGP_POSITIVE_SCALE (1.0f / NGP_THUMBSTICK_AXIS_MAX)
+#define NGP_NEGATIVE_SCALE (-1.0f / NGP_THUMBSTICK_AXIS_MIN)
+
+static inline float NormalizeScalar(int16_t v) {
+    float f = (float)v * (v >= 0 ? NGP_POSITIVE_SCALE : NGP_NEGATIVE_SCALE);
+    return f < -1.0f ? -1.0f : f > 1.0f ? 1.0f : f;
+}
+
+static inline float AxialScalar(float v, float deadzone, float rescale) {
+    float a = fabsf(v);
+    if (a < deadzone) {
+        return 0.0f;
+    }
+    return copysignf((a - deadzone) * rescale, v);
+}
+
+static inline float ClampUnit(float v) { return v < -1.0f ? -1.0f : v > 1.0f ? 1.0f : v; }
+
+/* deadzone and 1 / (1 - deadzone), or 0 for both when there is nothing to do */
+static void DeadzoneParams(float deadzone, NGP_DeadzoneType type, float* dz, float* rescale) {
+    if (type == NGP_DeadzoneNone || !(deadzone > 0.0f)) {
+        *dz      = 0.0f;
+        *rescale = 1.0f;
+        return;
+    }
+    if (deadzone >= 1.0f) {
+        deadzone = 1.0f;
+    }
+    *dz      = deadzone;
+    *rescale = deadzone < 1.0f ? 1.0f / (1.0f - deadzone) : 0.0f;
+}
+
+void NGP_NormalizeSticksScalar(const int16_t* x,
+                               const int16_t* y,
+                               float*         out_x,
+                               float*         out_y,
+                               int            count,
+                               float          deadzone,
+                               NGP_DeadzoneType type) {
+    float dz;
+    float rescale;
+    DeadzoneParams(deadzone, type, &dz, &rescale);
+
+    for (int i = 0; i < count; i++) {
+        float nx = NormalizeScalar(x[i]);
+        float ny = NormalizeScalar(y[i]);
+        if (type == NGP_DeadzoneAxial) {
+            nx = AxialScalar(nx, dz, rescale);
+            ny = AxialScalar(ny, dz, rescale);
+        } else if (type == NGP_DeadzoneRadial) {
+            float mag = sqrtf(nx * nx + ny * ny);
+            if (mag < dz || mag == 0.0f) {
+                nx = 0.0f;
+                ny = 0.0f;
+            } else {
+                float factor = ((mag < 1.0f ? mag : 1.0f) - dz) * rescale / mag;
+                nx           = ClampUnit(nx * factor);
+                ny           = ClampUnit(ny * factor);
+            }
+        }
+        out_x[i] = nx;
+        out_y[i] = ny;
+    }
+}
+
+#if NGP_X86
+
+static inline __m128 NormalizeSSE(__m128i v32) {
+    __m128 f     = _mm_cvtepi32_ps(v32);
+    __m128 neg   = _mm_cmplt_ps(f, _mm_setzero_ps());
+    __m128 scale = _mm_or_ps(_mm_and_ps(neg, _mm_set1_ps(NGP_NEGATIVE_SCALE)),
+                             _mm_andnot_ps(neg, _mm_set1_ps(NGP_POSITIVE_SCALE)));
+    f            = _mm_mul_ps(f, scale);
+    return _mm_min_ps(_mm_max_ps(f, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+}
+
+static inline __m128 AxialSSE(__m128 v, __m128 dz, __m128 rescale) {
+    __m128 sign = _mm_and_ps(v, _mm_set1_ps(-0.0f));
+    __m128 a    = _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+    __m128 keep = _mm_cmpge_ps(a, dz);
+    __m128 r    = _mm_mul_ps(_mm_sub_ps(a, dz), rescale);
+    return _mm_and_ps(keep, _mm_or_ps(r, sign));
+}
+
+static inline void RadialSSE(__m128* nx, __m128* ny, __m128 dz, __m128 rescale) {
+    __m128 mag    = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(*nx, *nx), _mm_mul_ps(*ny, *ny)));
+    __m128 keep   = _mm_and_ps(_mm_cmpge_ps(mag, dz), _mm_cmpgt_ps(mag, _mm_setzero_ps()));
+    __m128 capped = _mm_min_ps(mag, _mm_set1_ps(1.0f));
+    __m128 factor = _mm_div_ps(_mm_mul_ps(_mm_sub_ps(capped, dz), rescale),
+                               _mm_max_ps(mag, _mm_set1_ps(1e-30f)));
+    __m128 one    = _mm_set1_ps(1.0f);
+    __m128 minus  = _mm_set1_ps(-1.0f);
+    *nx = _mm_and_ps(keep, _mm_min_ps(_mm_max_ps(_mm_mul_ps(*nx, factor), minus), one));
+    *ny = _mm_and_ps(keep, _mm_min_ps(_mm_max_ps(_mm_mul_ps(*ny, factor), minus), one));
+}
+
+/* SSE2 is part of x86-64, so this needs no runtime check there */
+static void NormalizeSticksSSE2(const int16_t* x,
+                                const int16_t* y,
+                                float*         out_x,
+                                float*         out_y,
+                                int            count,
+                                float          deadzone,
+                                NGP_DeadzoneType type) {
+    float dz_s;
+    float rescale_s;
+    DeadzoneParams(deadzone, type, &dz_s, &rescale_s);
+    __m128 dz      = _mm_set1_ps(dz_s);
+    __m128 rescale = _mm_set1_ps(rescale_s);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        /* sign extend four int16 to int32 by unpacking into the high half and shifting down */
+        __m128i x16 = _mm_loadl_epi64((const __m128i*)(x + i));
+        __m128i y16 = _mm_loadl_epi64((const __m128i*)(y + i));
+        __m128  nx  = NormalizeSSE(_mm_srai_epi32(_mm_unpacklo_epi16(x16, x16), 16));
+        __m128  ny  = NormalizeSSE(_mm_srai_epi32(_mm_unpacklo_epi16(y16, y16), 16));
+        if (type == NGP_DeadzoneAxial) {
+            nx = AxialSSE(nx, dz, rescale);
+            ny = AxialSSE(ny, dz, rescale);
+        } else if (type == NGP_DeadzoneRadial) {
+            RadialSSE(&nx, &ny, dz, rescale);
+        }
+        _mm_storeu_ps(out_x + i, nx);
+        _mm_storeu_ps(out_y + i, ny);
+    }
+    NGP_NormalizeSticksScalar(x + i, y + i, out_x + i, out_y + i, count - i, deadzone, type);
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define NGP_HAVE_AVX2 1
+#define NGP_TARGET_AVX2 __attribute__((target("avx2")))
+
+NGP_TARGET_AVX2 static inline __m256 NormalizeAVX2(__m128i v16) {
+    __m256 f     = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v16));
+    __m256 neg   = _mm256_cmp_ps(f, _mm256_setzero_ps(), _CMP_LT_OQ);
+    __m256 scale = _mm256_blendv_ps(_mm256_set1_ps(NGP_POSITIVE_SCALE),
+                                    _mm256_set1_ps(NGP_NEGATIVE_SCALE), neg);
+    f            = _mm256_mul_ps(f, scale);
+    return _mm256_min_ps(_mm256_max_ps(f, _mm256_set1_ps(-1.0f)), _mm256_set1_ps(1.0f));
+}
+
+NGP_TARGET_AVX2 static inline __m256 AxialAVX2(__m256 v, __m256 dz, __m256 rescale) {
+    __m256 sign = _mm256_and_ps(v, _mm256_set1_ps(-0.0f));
+    __m256 a    = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v);
+    __m256 keep = _mm256_cmp_ps(a, dz, _CMP_GE_OQ);
+    __m256 r    = _mm256_mul_ps(_mm256_sub_ps(a, dz), rescale);
+    return _mm256_and_ps(keep, _mm256_or_ps(r, sign));
+}
+
+NGP_TARGET_AVX2 static inline void RadialAVX2(__m256* nx, __m256* ny, __m256 dz, __m256 rescale) {
+    __m256 mag    = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(*nx, *nx), _mm256_mul_ps(*ny, *ny)));
+    __m256 keep   = _mm256_and_ps(_mm256_cmp_ps(mag, dz, _CMP_GE_OQ),
+                                  _mm256_cmp_ps(mag, _mm256_setzero_ps(), _CMP_GT_OQ));
+    __m256 capped = _mm256_min_ps(mag, _mm256_set1_ps(1.0f));
+    __m256 factor = _mm256_div_ps(_mm256_mul_ps(_mm256_sub_ps(capped, dz), rescale),
+                                  _mm256_max_ps(mag, _mm256_set1_ps(1e-30f)));
+    __m256 one    = _mm256_set1_ps(1.0f);
+    __m256 minus  = _mm256_set1_ps(-1.0f);
+    *nx = _mm256_and_ps(keep, _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(*nx, factor), minus), one));
+    *ny = _mm256_and_ps(keep, _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(*ny, factor), minus), one));
+}
+
+NGP_TARGET_AVX2 static void NormalizeSticksAVX2(const int16_t* x,
+                                                const int16_t* y,
+                                                float*         out_x,
+                                                float*         out_y,
+                                                int            count,
+                                                float          deadzone,
+                                                NGP_DeadzoneType type) {
+    float dz_s;
+    float rescale_s;
+    DeadzoneParams(deadzone, type, &dz_s, &rescale_s);
+    __m256 dz      = _mm256_set1_ps(dz_s);
+    __m256 rescale = _mm256_set1_ps(rescale_s);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 nx = NormalizeAVX2(_mm_loadu_si128((const __m128i*)(x + i)));
+        __m256 ny = NormalizeAVX2(_mm_loadu_si128((const __m128i*)(y + i)));
+        if (type == NGP_DeadzoneAxial) {
+            nx = AxialAVX2(nx, dz, rescale);
+            ny = AxialAVX2(ny, dz, rescale);
+        } else if (type == NGP_DeadzoneRadial) {
+            RadialAVX2(&nx, &ny, dz, rescale);
+        }
+        _mm256_storeu_ps(out_x + i, nx);
+        _mm256_storeu_ps(out_y + i, ny);
+    }
+    NormalizeSticksSSE2(x + i, y + i, out_x + i, out_y + i, count - i, deadzone, type);
+}
+#endif /* __GNUC__ || __clang__ */
+
+#elif NGP_NEON
+
+static inline float32x4_t NormalizeNEON(int16x4_t v16) {
+    float32x4_t f     = vcvtq_f32_s32(vmovl_s16(v16));
+    uint32x4_t  neg   = vcltq_f32(f, vdupq_n_f32(0.0f));
+    float32x4_t scale = vbslq_f32(neg, vdupq_n_f32(NGP_NEGATIVE_SCALE),
+                                  vdupq_n_f32(NGP_POSITIVE_SCALE));
+    f                 = vmulq_f32(f, scale);
+    return vminq_f32(vmaxq_f32(f, vdupq_n_f32(-1.0f)), vdupq_n_f32(1.0f));
+}
+
+static inline float32x4_t AxialNEON(float32x4_t v, float32x4_t dz, float32x4_t rescale) {
+    float32x4_t a    = vabsq_f32(v);
+    uint32x4_t  keep = vcgeq_f32(a, dz);
+    float32x4_t r    = vmulq_f32(vsubq_f32(a, dz), rescale);
+    r                = vbslq_f32(vcltq_f32(v, vdupq_n_f32(0.0f)), vnegq_f32(r), r);
+    return vreinterpretq_f32_u32(vandq_u32(keep, vreinterpretq_u32_f32(r)));
+}
+
+static inline void RadialNEON(float32x4_t* nx, float32x4_t* ny, float32x4_t dz, float32x4_t rescale) {
+    float32x4_t mag    = vsqrtq_f32(vaddq_f32(vmulq_f32(*nx, *nx), vmulq_f32(*ny, *ny)));
+    uint32x4_t  keep   = vandq_u32(vcgeq_f32(mag, dz), vcgtq_f32(mag, vdupq_n_f32(0.0f)));
+    float32x4_t capped = vminq_f32(mag, vdupq_n_f32(1.0f));
+    float32x4_t factor = vdivq_f32(vmulq_f32(vsubq_f32(capped, dz), rescale),
+                                   vmaxq_f32(mag, vdupq_n_f32(1e-30f)));
+    float32x4_t one    = vdupq_n_f32(1.0f);
+    float32x4_t minus  = vdupq_n_f32(-1.0f);
+    float32x4_t rx     = vminq_f32(vmaxq_f32(vmulq_f32(*nx, factor), minus), one);
+    float32x4_t ry     = vminq_f32(vmaxq_f32(vmulq_f32(*ny, factor), minus), one);
+    *nx = vreinterpretq_f32_u32(vandq_u32(keep, vreinterpretq_u32_f32(rx)));
+    *ny = vreinterpretq_f32_u32(vandq_u32(keep, vreinterpretq_u32_f32(ry)));
+}
+
+static void NormalizeSticksNEON(const int16_t* x,
+                                const int16_t* y,
+                                float*         out_x,
+                                float*         out_y,
+                                int            count,
+                                float          deadzone,
+                                NGP_DeadzoneType type) {
+    float dz_s;
+    float rescale_s;
+    DeadzoneParams(deadzone, type, &dz_s, &rescale_s);
+    float32x4_t dz      = vdupq_n_f32(dz_s);
+    float32x4_t rescale = vdupq_n_f32(rescale_s);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t nx = NormalizeNEON(vld1_s16(x + i));
+        float32x4_t ny = NormalizeNEON(vld1_s16(y + i));
+        if (type == NGP_DeadzoneAxial) {
+            nx = AxialNEON(nx, dz, rescale);
+            ny = AxialNEON(ny, dz, rescale);
+        } else if (type == NGP_DeadzoneRadial) {
+            RadialNEON(&nx, &ny, dz, rescale);
+        }
+        vst1q_f32(out_x + i, nx);
+        vst1q_f32(out_y + i, ny);
+    }
+    NGP_NormalizeSticksScalar(x + i, y + i, out_x + i, out_y + i, count - i, deadzone, type);
+}
+
+#endif
+
+static NGP_NormalizeSticksFn normalize_kernel;
+static const char*           normalize_kernel_name;
+
+int NGP_NormalizeSticksKernels(NGP_NormalizeSticksFn* kernels, const char** names, int max) {
+    NGP_NormalizeSticksFn found[NGP_NORMALIZE_KERNELS_MAX]  = { NGP_NormalizeSticksScalar };
+    const char*           labels[NGP_NORMALIZE_KERNELS_MAX] = { "scalar" };
+
+    int count = 1;
+#if NGP_X86
+    found[count]    = NormalizeSticksSSE2;
+    labels[count++] = "sse2";
+#if NGP_HAVE_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        found[count]    = NormalizeSticksAVX2;
+        labels[count++] = "avx2";
+    }
+#endif
+#elif NGP_NEON
+    found[count]    = NormalizeSticksNEON;
+    labels[count++] = "neon";
+#endif
+    count = count < max ? count : max;
+    for (int i = 0; i < count; i++) {
+        kernels[i] = found[i];
+        names[i]   = labels[i];
+    }
+    return count;
+}
+
+static void SelectKernel(void) {
+    NGP_NormalizeSticksFn kernels[NGP_NORMALIZE_KERNELS_MAX];
+    const char*           names[NGP_NORMALIZE_KERNELS_MAX];
+
+    int last = NGP_NormalizeSticksKernels(kernels, names, NGP_NORMALIZE_KERNELS_MAX) - 1;
+    normalize_kernel_name = names[last];
+    __atomic_store_n(&normalize_kernel, kernels[last], __ATOMIC_RELEASE);
+}
+
+NGP_NormalizeSticksFn NGP_NormalizeSticksKernel(void) {
+    NGP_NormalizeSticksFn kernel = __atomic_load_n(&normalize_kernel, __ATOMIC_ACQUIRE);
+    if (!kernel) {
+        SelectKernel();
+        kernel = normalize_kernel;
+    }
+    return kernel;
+}
+
+const char* NGP_NormalizeSticksKernelName(void) {
+    NGP_NormalizeSticksKernel();
+    return normalize_kernel_name;
+}
+
+DECLSPEC void NGPCALL NGP_NormalizeSticks(const int16_t* x,
+                                          const int16_t* y,
+                                          float*         out_x,
+                                          float*         out_y,
+                                          int            count,
+                                          float          deadzone,
+                                          NGP_DeadzoneType type) {
+    NGP_NormalizeSticksKernel()(x, y, out_x, out_y, count, deadzone, type);
+}
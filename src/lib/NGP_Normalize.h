@@ -0,0 +1,45 @@
+#pragma once
+
+#include "NGP_Internal.h"
+
+/*
+ * The kernels behind NGP_NormalizeSticks. Each one handles any count, the SIMD kernels finish the
+ * remainder with the scalar one. Exposed so ngp_bench can compare them.
+ */
+typedef void (*NGP_NormalizeSticksFn)(const int16_t* x,
+                                      const int16_t* y,
+                                      float*         out_x,
+                                      float*         out_y,
+                                      int            count,
+                                      float          deadzone,
+                                      NGP_DeadzoneType type);
+
+void NGP_NormalizeSticksScalar(const int16_t* x,
+                               const int16_t* y,
+                               float*         out_x,
+                               float*         out_y,
+                               int            count,
+                               float          deadzone,
+                               NGP_DeadzoneType type);
+
+#define NGP_NORMALIZE_KERNELS_MAX 4
+
+/**
+ * Lists every kernel built in that the running CPU supports, slowest first, so they can be
+ * checked against each other
+ * @param kernels
+ * @param names
+ * @param max
+ * @return how many were written, the scalar kernel always is
+ */
+int NGP_NormalizeSticksKernels(NGP_NormalizeSticksFn* kernels, const char** names, int max);
+
+/**
+ * Returns the fastest kernel the running CPU supports, the last NGP_NormalizeSticksKernels lists
+ */
+NGP_NormalizeSticksFn NGP_NormalizeSticksKernel(void);
+
+/**
+ * Returns the name of the kernel NGP_NormalizeSticksKernel picked, e.g. "avx2"
+ */
+const char* NGP_NormalizeSticksKernelName(void);
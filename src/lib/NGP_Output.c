@@ -0,0 +1,258 @@
+#include "NGP_Output.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#include "NGP_Device.h"
+#include "NGP_Runtime.h"
+
+#define NGP_OUTPUT_BATCH 32 /* writes sent per pass, the rest go out on the next one */
+
+/*
+ * Pads with a write waiting are linked through output_link, reads queue up in a FIFO. Both are
+ * guarded by output_lock, the writes themselves happen outside it. The write callback is guarded by
+ * callback_lock, which is held through its calls so NGP_SetOutputCallback waits for them.
+ */
+static pthread_mutex_t    output_lock   = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t    callback_lock = PTHREAD_MUTEX_INITIALIZER;
+static NGP_Device*        output_devices;
+static NGP_FeatureRead*   reads_head;
+static NGP_FeatureRead*   reads_tail;
+static bool               output_work; /* either list is non-empty, lets the flush skip the lock */
+static NGP_OutputCallback output_callback;
+static void*              output_userdata;
+
+static void UpdateWork(void) {
+    __atomic_store_n(&output_work, output_devices || reads_head, __ATOMIC_RELEASE);
+}
+
+bool NGP_OutputQueueRead(NGP_FeatureRead*    read,
+                         NGP_Device*         device,
+                         uint8_t             report_id,
+                         NGP_FeatureReadDone done,
+                         void*               userdata) {
+    if (!device->transport || !device->transport->ReadFeature) {
+        return false;
+    }
+    pthread_mutex_lock(&output_lock);
+    bool queued = !read->queued;
+    if (queued) {
+        read->next      = NULL;
+        read->device    = device;
+        read->done      = done;
+        read->userdata  = userdata;
+        read->report_id = report_id;
+        read->queued    = true;
+        if (reads_tail) {
+            reads_tail->next = read;
+        } else {
+            reads_head = read;
+        }
+        reads_tail = read;
+        UpdateWork();
+    }
+    pthread_mutex_unlock(&output_lock);
+    if (queued) {
+        NGP_RuntimeWake();
+    }
+    return queued;
+}
+
+/* Takes the output lock if the pad is attached and can write type, NULL otherwise */
+static NGP_Device* LockOutput(NGP_GamePadID id, uint8_t type) {
+    pthread_mutex_lock(&output_lock);
+    /* looked up under the lock so a pad released meanwhile is cancelled after this, not before */
+    NGP_Device* device = NGP_DeviceLookup(id);
+    if (!device || !(device->outputs & type)) {
+        pthread_mutex_unlock(&output_lock);
+        return NULL;
+    }
+    return device;
+}
+
+/* Marks type dirty and links the pad into the write list, called with the output lock held */
+static void MarkDirty(NGP_Device* device, uint8_t type) {
+    device->output_dirty |= type;
+    if (!device->output_queued) {
+        device->output_link   = output_devices;
+        device->output_queued = true;
+        output_devices        = device;
+        UpdateWork();
+    }
+}
+
+/* Marks type for writing, returns whether the I/O thread needs waking for it */
+static bool QueueOutput(NGP_Device* device, uint8_t type) {
+    bool wake = !device->output_dirty; /* otherwise the I/O thread already has a deadline for it */
+    device->output.valid |= type;
+    MarkDirty(device, type);
+    return wake;
+}
+
+bool NGP_OutputSetLED(NGP_GamePadID id, uint8_t red, uint8_t green, uint8_t blue) {
+    NGP_Device* device = LockOutput(id, NGP_OutputLED);
+    if (!device) {
+        return false;
+    }
+    device->output.led[0] = red;
+    device->output.led[1] = green;
+    device->output.led[2] = blue;
+    bool wake             = QueueOutput(device, NGP_OutputLED);
+    pthread_mutex_unlock(&output_lock);
+    if (wake) {
+        NGP_RuntimeWake();
+    }
+    return true;
+}
+
+void NGP_OutputSetMotors(NGP_Device* device, const uint16_t motors[NGP_HapticsMotorMax]) {
+    uint8_t changed = 0;
+    pthread_mutex_lock(&output_lock);
+    for (int motor = 0; motor < NGP_HapticsMotorMax; motor++) {
+        if (device->output.motors[motor] != motors[motor]) {
+            device->output.motors[motor] = motors[motor];
+            changed |= motor >= NGP_HapticsMotorLeftTrigger ? NGP_OutputTriggerRumble
+                                                             : NGP_OutputRumble;
+        }
+    }
+    changed &= device->outputs;
+    if (changed) {
+        QueueOutput(device, changed); /* no wake, the I/O thread flushes right after mixing */
+    }
+    pthread_mutex_unlock(&output_lock);
+}
+
+void NGP_OutputCancel(NGP_Device* device) {
+    pthread_mutex_lock(&output_lock);
+    for (NGP_Device** link = &output_devices; *link; link = &(*link)->output_link) {
+        if (*link == device) {
+            *link = device->output_link;
+            break;
+        }
+    }
+    device->output_queued = false;
+    device->output_dirty  = 0;
+
+    NGP_FeatureRead* previous = NULL;
+    for (NGP_FeatureRead* read = reads_head; read;) {
+        NGP_FeatureRead* next = read->next;
+        if (read->device == device) {
+            read->queued = false;
+            if (previous) {
+                previous->next = next;
+            } else {
+                reads_head = next;
+            }
+            if (reads_tail == read) {
+                reads_tail = previous;
+            }
+        } else {
+            previous = read;
+        }
+        read = next;
+    }
+    UpdateWork();
+    pthread_mutex_unlock(&output_lock);
+}
+
+typedef struct NGP_OutputWrite {
+    NGP_Device*      device;
+    NGP_DeviceOutput output;
+    uint8_t          dirty; /* the types it was written for, marked again if the write fails */
+    bool             sent;
+} NGP_OutputWrite;
+
+DECLSPEC void NGPCALL NGP_SetOutputCallback(NGP_OutputCallback callback, void* userdata) {
+    pthread_mutex_lock(&callback_lock);
+    output_callback = callback;
+    output_userdata = userdata;
+    pthread_mutex_unlock(&callback_lock);
+}
+
+int NGP_OutputFlush(void) {
+    if (!__atomic_load_n(&output_work, __ATOMIC_ACQUIRE)) {
+        return -1;
+    }
+    NGP_OutputWrite  writes[NGP_OUTPUT_BATCH];
+    int              count  = 0;
+    int              failed = 0;
+    NGP_Timestamp    now    = NGP_GetTicksNS();
+    NGP_Timestamp    next   = INT64_MAX;
+    NGP_FeatureRead* read   = NULL;
+
+    pthread_mutex_lock(&output_lock);
+    for (NGP_Device** link = &output_devices; *link;) {
+        NGP_Device* device = *link;
+        if (device->output_dirty && device->output_due <= now && count < NGP_OUTPUT_BATCH) {
+            writes[count].device = device;
+            writes[count].output = device->output;
+            writes[count].dirty  = device->output_dirty;
+            count++;
+            device->output_dirty = 0;
+            device->output_due   = now + NGP_OUTPUT_INTERVAL_NS;
+        }
+        if (!device->output_dirty) {
+            *link                 = device->output_link;
+            device->output_queued = false;
+            continue;
+        }
+        next = device->output_due < next ? device->output_due : next;
+        link = &device->output_link;
+    }
+    if ((read = reads_head) != NULL) {
+        reads_head   = read->next;
+        read->queued = false;
+        if (!reads_head) {
+            reads_tail = NULL;
+        } else {
+            next = now; /* one read per pass so input keeps flowing between slow reads */
+        }
+    }
+    UpdateWork();
+    pthread_mutex_unlock(&output_lock);
+
+    /* only the I/O thread releases devices, so every device taken above is still valid here */
+    for (int i = 0; i < count; i++) {
+        NGP_Device* device = writes[i].device;
+        /* set back to what the pad already has before the write went out, nothing to send */
+        writes[i].sent =
+            memcmp(&writes[i].output, &device->output_sent, sizeof(NGP_DeviceOutput)) == 0 ||
+            device->transport->WriteOutput(device, &writes[i].output);
+        if (writes[i].sent) {
+            device->output_sent = writes[i].output;
+        } else {
+            failed++;
+        }
+    }
+    if (failed) {
+        /* e.g. EAGAIN from a full Bluetooth queue, the latest values go out at the next interval */
+        pthread_mutex_lock(&output_lock);
+        for (int i = 0; i < count; i++) {
+            if (!writes[i].sent) {
+                MarkDirty(writes[i].device, writes[i].dirty);
+                next = writes[i].device->output_due < next ? writes[i].device->output_due : next;
+            }
+        }
+        pthread_mutex_unlock(&output_lock);
+    }
+    if (count) {
+        pthread_mutex_lock(&callback_lock);
+        for (int i = 0; output_callback && i < count; i++) {
+            output_callback(writes[i].device->id, writes[i].sent, output_userdata);
+        }
+        pthread_mutex_unlock(&callback_lock);
+    }
+    if (read) {
+        uint8_t data[NGP_FEATURE_REPORT_LEN] = { read->report_id };
+        int     length = read->device->transport->ReadFeature(read->device, data, sizeof(data));
+        if (read->done) {
+            read->done(read->device, data, length, read->userdata);
+        }
+    }
+
+    if (next == INT64_MAX) {
+        return -1;
+    }
+    now = NGP_GetTicksNS();
+    return next <= now ? 0 : (int)((next - now + 999999) / 1000000);
+}
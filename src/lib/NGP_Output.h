@@ -0,0 +1,153 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "NGP_Internal.h"
+
+#define NGP_FEATURE_REPORT_LEN 64 /* the longest feature report read, one full USB packet */
+
+/* Output reports go out at most this often per pad, Bluetooth pads drop writes that come faster */
+#define NGP_OUTPUT_INTERVAL_NS 8000000LL
+
+typedef struct NGP_Device NGP_Device;
+
+typedef enum NGP_OutputType {
+    NGP_OutputLED           = 1 << 0,
+    NGP_OutputRumble        = 1 << 1, /* the low and high frequency motors */
+    NGP_OutputTriggerRumble = 1 << 2,
+} NGP_OutputType;
+
+typedef struct NGP_HapticsPlaying NGP_HapticsPlaying;
+
+/* The per pad slots the rumble calls play their effect in, so each call replaces its last one */
+typedef enum NGP_HapticsSlot {
+    NGP_HapticsSlotRumble,
+    NGP_HapticsSlotLeftTrigger,
+    NGP_HapticsSlotRightTrigger,
+    NGP_HapticsSlotMax,
+} NGP_HapticsSlot;
+
+/*
+ * Everything a pad's output report should say. Each request overwrites its own fields, so however
+ * many requests arrive between two writes the pad only ever gets the latest of each.
+ */
+typedef struct NGP_DeviceOutput {
+    uint8_t  led[3];
+    uint8_t  valid; /* NGP_OutputType bits that were ever set, the pad keeps its own for the rest */
+    uint16_t motors[NGP_HapticsMotorMax]; /* the haptics mix */
+} NGP_DeviceOutput;
+
+/* How the output queue reaches a pad, set by the device source before the pad is attached */
+typedef struct NGP_DeviceTransport {
+    /* Encodes output into the pad's output report and sends it, false if the write failed */
+    bool (*WriteOutput)(NGP_Device* device, const NGP_DeviceOutput* output);
+    /* Reads the feature report whose id is in data[0] into data, returns its length or -1 */
+    int (*ReadFeature)(NGP_Device* device, uint8_t* data, size_t size);
+} NGP_DeviceTransport;
+
+/**
+ * Called on the I/O thread once a queued feature report has been read
+ * @param device
+ * @param data the report, report id first
+ * @param length how much of data was read, or -1 if the read failed
+ * @param userdata
+ */
+typedef void (*NGP_FeatureReadDone)(NGP_Device* device,
+                                    const uint8_t* data,
+                                    int            length,
+                                    void*          userdata);
+
+/* One queued feature report read. Device sources embed these in their own records. */
+typedef struct NGP_FeatureRead {
+    struct NGP_FeatureRead* next;
+    NGP_Device*             device;
+    NGP_FeatureReadDone     done;
+    void*                   userdata;
+    uint8_t                 report_id;
+    bool                    queued;
+} NGP_FeatureRead;
+
+/**
+ * Queues a feature report read, for device sources that would otherwise block in their hot-plug
+ * callback. Reads run one per pass of the I/O thread, between pumps, in the order they were queued.
+ * The read itself is still synchronous on the I/O thread: no input is read while it waits for the
+ * pad, one read per pass only bounds that stall to a single read.
+ * @param read where the request is kept until it completes, must stay valid until then
+ * @param device a device with a transport, attached or not
+ * @param report_id
+ * @param done called with the result, may be NULL
+ * @param userdata
+ * @return false if read is already queued or the device has no transport
+ */
+bool NGP_OutputQueueRead(NGP_FeatureRead*    read,
+                         NGP_Device*         device,
+                         uint8_t             report_id,
+                         NGP_FeatureReadDone done,
+                         void*               userdata);
+
+/**
+ * Sets the light bar colour, from any thread. The write goes out on the I/O thread.
+ * @param id
+ * @param red
+ * @param green
+ * @param blue
+ * @return false if the pad is gone or has no LED
+ */
+bool NGP_OutputSetLED(NGP_GamePadID id, uint8_t red, uint8_t green, uint8_t blue);
+
+/**
+ * Sets the motors to a new haptics mix, called on the I/O thread by the mixer
+ * @param device
+ * @param motors
+ */
+void NGP_OutputSetMotors(NGP_Device* device, const uint16_t motors[NGP_HapticsMotorMax]);
+
+/**
+ * Drops every write and read still queued for the device, called when it is released. Queued
+ * reads are dropped without their done callback running.
+ * @param device
+ */
+void NGP_OutputCancel(NGP_Device* device);
+
+/**
+ * Sends every output write that is due and runs the next queued feature read, called by the I/O
+ * thread between pumps. A pad whose write fails stays dirty and is written again one interval
+ * later. The write callback set by NGP_SetOutputCallback runs once per write, after the batch.
+ * @return how long until there is more to do in ms, for the next pump's timeout, or -1
+ */
+int NGP_OutputFlush(void);
+
+/**
+ * Plays an effect in one of the pad's rumble slots, replacing whatever the slot played before.
+ * From any thread.
+ * @param id
+ * @param slot
+ * @param strength peak strength per motor, all 0 just stops the slot's effect
+ * @param duration_ms how long to hold it, 0 to hold it until the slot is set again
+ * @return false if the pad is gone or has none of the motors
+ */
+bool NGP_HapticsPlaySlot(NGP_GamePadID   id,
+                         NGP_HapticsSlot slot,
+                         const uint16_t  strength[NGP_HapticsMotorMax],
+                         uint32_t        duration_ms);
+
+/**
+ * Stops every effect on the device and frees them, called when it is released
+ * @param device
+ */
+void NGP_HapticsCancel(NGP_Device* device);
+
+/**
+ * Mixes every pad's effects if a tick is due and hands changed mixes to the output queue, called
+ * by the I/O thread between pumps
+ * @return how long until the next tick in ms, or -1 while nothing is playing
+ */
+int NGP_HapticsTick(void);
+
+/**
+ * NGP_HapticsTick for a given time, ticks land on multiples of the tick period from the first
+ * @param now
+ * @return how long until the next tick in ms, or -1 while nothing is playing
+ */
+int NGP_HapticsMixAt(NGP_Timestamp now);
@@ -0,0 +1,101 @@
+#include "NGP_Pool.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct NGP_MemoryFunctions {
+    NGP_MallocFunc  malloc_func;
+    NGP_CallocFunc  calloc_func;
+    NGP_ReallocFunc realloc_func;
+    NGP_FreeFunc    free_func;
+} NGP_MemoryFunctions;
+
+static NGP_MemoryFunctions memory = { malloc, calloc, realloc, free };
+
+DECLSPEC bool NGPCALL NGP_SetMemoryFunctions(NGP_MallocFunc  malloc_func,
+                                             NGP_CallocFunc  calloc_func,
+                                             NGP_ReallocFunc realloc_func,
+                                             NGP_FreeFunc    free_func) {
+    if (!malloc_func || !calloc_func || !realloc_func || !free_func) {
+        return false;
+    }
+    memory.malloc_func  = malloc_func;
+    memory.calloc_func  = calloc_func;
+    memory.realloc_func = realloc_func;
+    memory.free_func    = free_func;
+    return true;
+}
+
+DECLSPEC void NGPCALL NGP_GetMemoryFunctions(NGP_MallocFunc*  malloc_func,
+                                             NGP_CallocFunc*  calloc_func,
+                                             NGP_ReallocFunc* realloc_func,
+                                             NGP_FreeFunc*    free_func) {
+    if (malloc_func) {
+        *malloc_func = memory.malloc_func;
+    }
+    if (calloc_func) {
+        *calloc_func = memory.calloc_func;
+    }
+    if (realloc_func) {
+        *realloc_func = memory.realloc_func;
+    }
+    if (free_func) {
+        *free_func = memory.free_func;
+    }
+}
+
+void* NGP_Malloc(size_t size) { return memory.malloc_func(size); }
+
+void* NGP_Calloc(size_t count, size_t size) { return memory.calloc_func(count, size); }
+
+void* NGP_Realloc(void* ptr, size_t size) { return memory.realloc_func(ptr, size); }
+
+void NGP_Free(void* ptr) {
+    if (ptr) {
+        memory.free_func(ptr);
+    }
+}
+
+void* NGP_MallocPermanent(size_t size, size_t align) {
+    /* never freed, so the unaligned pointer does not need to be kept */
+    uintptr_t raw = (uintptr_t)NGP_Malloc(size + align - 1);
+    if (!raw) {
+        return NULL;
+    }
+    return (void*)((raw + align - 1) & ~(uintptr_t)(align - 1));
+}
+
+void* NGP_PoolAlloc(NGP_Pool* pool) {
+    void* object = NULL;
+    pthread_mutex_lock(&pool->lock);
+    if (pool->free_list) {
+        object          = pool->free_list;
+        pool->free_list = pool->free_list->next;
+    } else if (pool->carved < pool->capacity) {
+        uint32_t offset = pool->carved % pool->chunk_objects;
+        if (offset == 0) {
+            size_t size = pool->object_size * pool->chunk_objects;
+            pool->chunk = NGP_MallocPermanent(size, NGP_POOL_ALIGN);
+        }
+        if (pool->chunk) {
+            object = pool->chunk + (size_t)offset * pool->object_size;
+            pool->carved++;
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    if (object) {
+        memset(object, 0, pool->object_size);
+    }
+    return object;
+}
+
+void NGP_PoolFree(NGP_Pool* pool, void* object) {
+    if (!object) {
+        return;
+    }
+    NGP_PoolNode* node = object;
+    pthread_mutex_lock(&pool->lock);
+    node->next      = pool->free_list;
+    pool->free_list = node;
+    pthread_mutex_unlock(&pool->lock);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "NGP_Internal.h"
+
+/* The allocation functions set by NGP_SetMemoryFunctions, the library calls nothing else */
+void* NGP_Malloc(size_t size);
+void* NGP_Calloc(size_t count, size_t size);
+void* NGP_Realloc(void* ptr, size_t size);
+void  NGP_Free(void* ptr);
+
+/**
+ * Allocates memory that is never freed, aligned for align (a power of two)
+ * @param size
+ * @param align
+ */
+void* NGP_MallocPermanent(size_t size, size_t align);
+
+typedef struct NGP_PoolNode {
+    struct NGP_PoolNode* next;
+} NGP_PoolNode;
+
+/*
+ * Fixed capacity pool of same sized objects for records that come and go with pads. Objects are
+ * carved out of chunks that are allocated the first time the pool grows into them and never freed,
+ * freed objects go on a free list and are handed out again first. Once the pool has grown as far
+ * as its busiest moment needed, allocating and freeing never reach the allocator.
+ */
+typedef struct NGP_Pool {
+    pthread_mutex_t lock;
+    size_t          object_size;
+    uint32_t        chunk_objects;
+    uint32_t        capacity;
+    uint32_t        carved; /* objects taken out of chunks so far, in use or on the free list */
+    NGP_PoolNode*   free_list;
+    unsigned char*  chunk; /* the chunk being carved from */
+} NGP_Pool;
+
+#define NGP_POOL_ALIGN _Alignof(max_align_t)
+#define NGP_POOL_OBJECT_SIZE(type) \
+    ((sizeof(type) + NGP_POOL_ALIGN - 1) / NGP_POOL_ALIGN * NGP_POOL_ALIGN)
+
+/**
+ * Static initializer for a pool of type
+ * @param type
+ * @param chunk_objects how many objects each chunk holds
+ * @param capacity the most objects the pool hands out at once
+ */
+#define NGP_POOL_INIT(type, chunk_objects, capacity)                                             \
+    {                                                                                            \
+        PTHREAD_MUTEX_INITIALIZER, NGP_POOL_OBJECT_SIZE(type), (chunk_objects), (capacity), 0, \
+            NULL, NULL                                                                           \
+    }
+
+/**
+ * Takes a zeroed object from the pool, thread safe
+ * @param pool
+ * @return the object, or NULL if capacity objects are in use or a chunk could not be allocated
+ */
+void* NGP_PoolAlloc(NGP_Pool* pool);
+
+/**
+ * Returns an object to the pool, thread safe
+ * @param pool
+ * @param object from NGP_PoolAlloc on the same pool, or NULL
+ */
+void NGP_PoolFree(NGP_Pool* pool, void* object);
@@ -0,0 +1,407 @@
+#include "NGP_RecordingFormat.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "NGP_Pool.h"
+
+#define FRAME_MASK_BUTTONS 0x40
+#define FRAME_MASK_EXTRAS 0x80
+
+#define EXTRA_FINGERS 0x01
+#define EXTRA_ACCEL 0x02
+#define EXTRA_GYRO 0x04
+
+/* Encoding helpers, out always has room for the largest value */
+
+static uint8_t* PutVarint(uint8_t* out, uint64_t value) {
+    while (value >= 0x80) {
+        *out++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (uint8_t)value;
+    return out;
+}
+
+static uint64_t ZigZag(int64_t value) { return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63); }
+
+static int64_t UnZigZag(uint64_t value) { return (int64_t)(value >> 1) ^ -(int64_t)(value & 1); }
+
+static uint8_t* PutU16(uint8_t* out, uint16_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    return out + 2;
+}
+
+static uint8_t* PutF32(uint8_t* out, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 4; i++) {
+        out[i] = (uint8_t)(bits >> (i * 8));
+    }
+    return out + 4;
+}
+
+static uint8_t* PutBytes(uint8_t* out, const void* data, size_t size) {
+    memcpy(out, data, size);
+    return out + size;
+}
+
+/* Decoding helpers, each one fails instead of reading past the end */
+
+static bool GetVarint(NGP_RecordingReader* reader, uint64_t* value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (reader->data == reader->end) {
+            return false;
+        }
+        uint8_t byte = *reader->data++;
+        result |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool GetBytes(NGP_RecordingReader* reader, void* out, size_t size) {
+    if ((size_t)(reader->end - reader->data) < size) {
+        return false;
+    }
+    memcpy(out, reader->data, size);
+    reader->data += size;
+    return true;
+}
+
+static bool GetU16(NGP_RecordingReader* reader, uint16_t* value) {
+    uint8_t bytes[2];
+    if (!GetBytes(reader, bytes, sizeof(bytes))) {
+        return false;
+    }
+    *value = (uint16_t)(bytes[0] | (bytes[1] << 8));
+    return true;
+}
+
+static bool GetF32(NGP_RecordingReader* reader, float* value) {
+    uint8_t bytes[4];
+    if (!GetBytes(reader, bytes, sizeof(bytes))) {
+        return false;
+    }
+    uint32_t bits = (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) |
+                    ((uint32_t)bytes[3] << 24);
+    memcpy(value, &bits, sizeof(bits));
+    return true;
+}
+
+static bool GetString(NGP_RecordingReader* reader, const char** str, size_t* len) {
+    uint64_t size;
+    if (!GetVarint(reader, &size) || size >= NGP_NAME_LEN ||
+        (uint64_t)(reader->end - reader->data) < size) {
+        return false;
+    }
+    *str = (const char*)reader->data;
+    *len = (size_t)size;
+    reader->data += size;
+    return true;
+}
+
+size_t NGP_RecordingEncodeHeader(uint8_t* out) {
+    memcpy(out, NGP_RECORDING_MAGIC, 4);
+    out[4] = NGP_RECORDING_VERSION;
+    out[5] = out[6] = out[7] = 0;
+    return NGP_RECORDING_HEADER_SIZE;
+}
+
+size_t NGP_RecordingEncodeDevice(uint8_t* out, int pad, const NGP_Device* device) {
+    uint8_t* p    = out;
+    size_t   name = strnlen(device->name, NGP_NAME_LEN - 1);
+    size_t   sn   = strnlen(device->serial, NGP_NAME_LEN - 1);
+
+    *p++ = NGP_RecordTypeDeviceAdded;
+    p    = PutVarint(p, (uint64_t)pad);
+    p    = PutBytes(p, device->guid.data, sizeof(device->guid.data));
+    p    = PutU16(p, device->bus);
+    p    = PutU16(p, device->vendor_id);
+    p    = PutU16(p, device->product_id);
+    p    = PutU16(p, device->version);
+    *p++ = device->touchpads;
+    p    = PutVarint(p, name);
+    p    = PutBytes(p, device->name, name);
+    p    = PutVarint(p, sn);
+    p    = PutBytes(p, device->serial, sn);
+    return (size_t)(p - out);
+}
+
+size_t NGP_RecordingEncodeRemoved(uint8_t* out, int pad) {
+    out[0] = NGP_RecordTypeDeviceRemoved;
+    return (size_t)(PutVarint(out + 1, (uint64_t)pad) - out);
+}
+
+size_t NGP_RecordingEncodeFrame(uint8_t*                out,
+                                int                     pad,
+                                NGP_Timestamp*          last_time,
+                                const NGP_GamePadState* prev,
+                                const NGP_GamePadState* state) {
+    uint8_t* p = out;
+    *p++       = NGP_RecordTypeFrame;
+    p          = PutVarint(p, (uint64_t)pad);
+    p          = PutVarint(p, ZigZag(state->Timestamp - *last_time));
+    *last_time = state->Timestamp;
+
+    uint8_t* mask = p++;
+    *mask         = 0;
+    for (int axis = 0; axis < NGP_GamePadAxisTypeMax; axis++) {
+        if (state->Axes[axis] != prev->Axes[axis]) {
+            *mask |= (uint8_t)(1u << axis);
+            p = PutVarint(p, ZigZag((int64_t)state->Axes[axis] - prev->Axes[axis]));
+        }
+    }
+    if (state->Buttons != prev->Buttons) {
+        *mask |= FRAME_MASK_BUTTONS;
+        p = PutVarint(p, state->Buttons);
+    }
+
+    uint8_t extras = 0;
+    if (memcmp(state->Fingers, prev->Fingers, sizeof(state->Fingers)) != 0) {
+        extras |= EXTRA_FINGERS;
+    }
+    if (memcmp(state->Accel, prev->Accel, sizeof(state->Accel)) != 0) {
+        extras |= EXTRA_ACCEL;
+    }
+    if (memcmp(state->Gyro, prev->Gyro, sizeof(state->Gyro)) != 0) {
+        extras |= EXTRA_GYRO;
+    }
+    if (extras) {
+        *mask |= FRAME_MASK_EXTRAS;
+        *p++ = extras;
+    }
+    if (extras & EXTRA_FINGERS) {
+        for (int i = 0; i < NGP_MAX_TOUCHPAD_FINGERS; i++) {
+            const NGP_GamePadStateFinger* finger = &state->Fingers[i];
+            p    = PutF32(p, finger->X);
+            p    = PutF32(p, finger->Y);
+            p    = PutF32(p, finger->Pressure);
+            *p++ = finger->State;
+            *p++ = finger->ID;
+        }
+    }
+    for (int i = 0; (extras & EXTRA_ACCEL) && i < 3; i++) {
+        p = PutF32(p, state->Accel[i]);
+    }
+    for (int i = 0; (extras & EXTRA_GYRO) && i < 3; i++) {
+        p = PutF32(p, state->Gyro[i]);
+    }
+    return (size_t)(p - out);
+}
+
+bool NGP_RecordingReaderInit(NGP_RecordingReader* reader, const uint8_t* data, size_t size) {
+    if (size < NGP_RECORDING_HEADER_SIZE || memcmp(data, NGP_RECORDING_MAGIC, 4) != 0 ||
+        data[4] != NGP_RECORDING_VERSION) {
+        return false;
+    }
+    reader->data = data + NGP_RECORDING_HEADER_SIZE;
+    reader->end  = data + size;
+    reader->time = 0;
+    return true;
+}
+
+int NGP_RecordingNext(NGP_RecordingReader* reader, NGP_RecordingRecord* record) {
+    if (reader->data == reader->end) {
+        return 0;
+    }
+    uint8_t  type;
+    uint64_t pad;
+    if (!GetBytes(reader, &type, 1) || type < NGP_RecordTypeDeviceAdded ||
+        type > NGP_RecordTypeFrame || !GetVarint(reader, &pad) || pad >= NGP_RECORDING_MAX_PADS) {
+        return -1;
+    }
+    record->type = (NGP_RecordType)type;
+    record->pad  = (int)pad;
+    if (record->type == NGP_RecordTypeFrame) {
+        uint64_t delta;
+        if (!GetVarint(reader, &delta)) {
+            return -1;
+        }
+        reader->time += UnZigZag(delta);
+        record->time = reader->time;
+    }
+    return 1;
+}
+
+bool NGP_RecordingReadDevice(NGP_RecordingReader* reader, NGP_RecordingDeviceInfo* info) {
+    return GetBytes(reader, info->guid.data, sizeof(info->guid.data)) &&
+           GetU16(reader, &info->bus) && GetU16(reader, &info->vendor_id) &&
+           GetU16(reader, &info->product_id) && GetU16(reader, &info->version) &&
+           GetBytes(reader, &info->touchpads, 1) && GetString(reader, &info->name, &info->name_len) &&
+           GetString(reader, &info->serial, &info->serial_len);
+}
+
+bool NGP_RecordingReadFrame(NGP_RecordingReader* reader, NGP_GamePadState* state) {
+    uint8_t  mask;
+    uint64_t value;
+    if (!GetBytes(reader, &mask, 1)) {
+        return false;
+    }
+    state->Timestamp = reader->time;
+    for (int axis = 0; axis < NGP_GamePadAxisTypeMax; axis++) {
+        if (mask & (1u << axis)) {
+            if (!GetVarint(reader, &value)) {
+                return false;
+            }
+            state->Axes[axis] = (int16_t)(state->Axes[axis] + UnZigZag(value));
+        }
+    }
+    if (mask & FRAME_MASK_BUTTONS) {
+        if (!GetVarint(reader, &value)) {
+            return false;
+        }
+        state->Buttons = (uint32_t)value;
+    }
+    if (!(mask & FRAME_MASK_EXTRAS)) {
+        return true;
+    }
+
+    uint8_t extras;
+    if (!GetBytes(reader, &extras, 1)) {
+        return false;
+    }
+    if (extras & EXTRA_FINGERS) {
+        for (int i = 0; i < NGP_MAX_TOUCHPAD_FINGERS; i++) {
+            NGP_GamePadStateFinger* finger = &state->Fingers[i];
+            if (!GetF32(reader, &finger->X) || !GetF32(reader, &finger->Y) ||
+                !GetF32(reader, &finger->Pressure) || !GetBytes(reader, &finger->State, 1) ||
+                !GetBytes(reader, &finger->ID, 1)) {
+                return false;
+            }
+        }
+    }
+    for (int i = 0; (extras & EXTRA_ACCEL) && i < 3; i++) {
+        if (!GetF32(reader, &state->Accel[i])) {
+            return false;
+        }
+    }
+    for (int i = 0; (extras & EXTRA_GYRO) && i < 3; i++) {
+        if (!GetF32(reader, &state->Gyro[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * The recorder. Pads are numbered by their registry slot, which is unique among attached pads. The
+ * I/O thread writes frames through the hooks, NGP_StartRecording adds the pads that are already
+ * attached from the calling thread, both under the recorder's lock.
+ */
+typedef struct NGP_Recorder {
+    pthread_mutex_t  lock;
+    FILE*            file;
+    NGP_Timestamp    last_time;
+    NGP_GamePadID     pads[NGP_RECORDING_MAX_PADS]; /* who each pad number is, or invalid */
+    NGP_GamePadState* last;                         /* the last frame recorded for each pad */
+} NGP_Recorder;
+
+bool NGP_RecordingEnabled;
+
+static NGP_Recorder recorder = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static void WriteRecord(const uint8_t* data, size_t size) {
+    if (fwrite(data, 1, size, recorder.file) != size) {
+        /* out of space, keep going so the recording is at least valid up to here */
+    }
+}
+
+static void RecordRemoved(int pad) {
+    uint8_t data[2];
+    WriteRecord(data, NGP_RecordingEncodeRemoved(data, pad));
+    recorder.pads[pad] = NGP_INVALID_GAMEPAD_ID;
+}
+
+static void RecordFrame(const NGP_Device* device, const NGP_GamePadState* state) {
+    int pad = NGP_RegistrySlot(device->id);
+    if (recorder.pads[pad] != device->id) {
+        uint8_t data[NGP_RECORDING_MAX_DEVICE];
+        if (recorder.pads[pad] != NGP_INVALID_GAMEPAD_ID) {
+            RecordRemoved(pad);
+        }
+        WriteRecord(data, NGP_RecordingEncodeDevice(data, pad, device));
+        recorder.pads[pad] = device->id;
+        memset(&recorder.last[pad], 0, sizeof(recorder.last[pad]));
+    } else if (state->Sequence == recorder.last[pad].Sequence) {
+        return; /* already recorded by NGP_StartRecording */
+    }
+
+    uint8_t data[NGP_RECORDING_MAX_FRAME];
+    WriteRecord(data, NGP_RecordingEncodeFrame(data, pad, &recorder.last_time,
+                                               &recorder.last[pad], state));
+    recorder.last[pad] = *state;
+}
+
+void NGP_RecordDeviceFrame(const NGP_Device* device) {
+    pthread_mutex_lock(&recorder.lock);
+    if (recorder.file) {
+        RecordFrame(device, &device->state);
+    }
+    pthread_mutex_unlock(&recorder.lock);
+}
+
+void NGP_RecordDeviceRemoved(const NGP_Device* device) {
+    pthread_mutex_lock(&recorder.lock);
+    int pad = NGP_RegistrySlot(device->id);
+    if (recorder.file && recorder.pads[pad] == device->id) {
+        RecordRemoved(pad);
+    }
+    pthread_mutex_unlock(&recorder.lock);
+}
+
+DECLSPEC bool NGPCALL NGP_StartRecording(const char* path) {
+    pthread_mutex_lock(&recorder.lock);
+    if (!recorder.file) {
+        recorder.last = NGP_Calloc(NGP_RECORDING_MAX_PADS, sizeof(*recorder.last));
+    }
+    if (recorder.file || !recorder.last) {
+        pthread_mutex_unlock(&recorder.lock);
+        return false;
+    }
+    if (!(recorder.file = fopen(path, "wb"))) {
+        NGP_Free(recorder.last);
+        recorder.last = NULL;
+        pthread_mutex_unlock(&recorder.lock);
+        return false;
+    }
+    setvbuf(recorder.file, NULL, _IOFBF, 1 << 16);
+
+    uint8_t header[NGP_RECORDING_HEADER_SIZE];
+    WriteRecord(header, NGP_RecordingEncodeHeader(header));
+    recorder.last_time = 0;
+    for (int pad = 0; pad < NGP_RECORDING_MAX_PADS; pad++) {
+        recorder.pads[pad] = NGP_INVALID_GAMEPAD_ID;
+    }
+    __atomic_store_n(&NGP_RecordingEnabled, true, __ATOMIC_RELAXED);
+
+    /* pads that already sit idle would otherwise only show up once they report something */
+    for (int i = 0; i < NGP_DeviceCount(); i++) {
+        NGP_Device* device = NGP_DeviceLookup(NGP_DeviceAtIndex(i));
+        if (device) {
+            NGP_GamePadState state;
+            NGP_DeviceReadState(device, &state);
+            RecordFrame(device, &state);
+        }
+    }
+    pthread_mutex_unlock(&recorder.lock);
+    return true;
+}
+
+DECLSPEC void NGPCALL NGP_StopRecording(void) {
+    pthread_mutex_lock(&recorder.lock);
+    __atomic_store_n(&NGP_RecordingEnabled, false, __ATOMIC_RELAXED);
+    if (recorder.file) {
+        fclose(recorder.file);
+        NGP_Free(recorder.last);
+        recorder.file = NULL;
+        recorder.last = NULL;
+    }
+    pthread_mutex_unlock(&recorder.lock);
+}
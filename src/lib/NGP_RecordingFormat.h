@@ -0,0 +1,137 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "NGP_Device.h"
+
+/*
+ * Recording file format, little endian throughout:
+ *
+ *   header   "NGPR", u8 version, 3 reserved bytes
+ *   records  u8 type, varint pad, then
+ *     DeviceAdded    guid[16], u16 bus, vendor, product, version, u8 touchpads,
+ *                    varint name length, name, varint serial length, serial
+ *     DeviceRemoved  nothing
+ *     Frame          zigzag varint nanoseconds since the previous frame (of any pad), u8 mask,
+ *                    then for each set mask bit 0-5 the zigzag varint delta of that axis,
+ *                    for bit 6 the button bitmask as a varint,
+ *                    for bit 7 a u8 of which extras follow (fingers, accel, gyro) and their raw bytes
+ *
+ * Pads are numbered by the recorder, a number is reused once its pad was removed. A frame is one
+ * NGP_DevicePublish, so a replay publishes exactly the frames that were recorded. Each is stamped
+ * with the time the replay started plus its recorded offset from the first frame, so the spacing
+ * between frames is the recorded one at any speed.
+ */
+#define NGP_RECORDING_MAGIC "NGPR"
+#define NGP_RECORDING_VERSION 1
+#define NGP_RECORDING_HEADER_SIZE 8
+#define NGP_RECORDING_MAX_PADS NGP_MAX_GAMEPADS
+
+#define NGP_RECORDING_MAX_FRAME 128   /* upper bound of an encoded frame record */
+#define NGP_RECORDING_MAX_DEVICE 1024 /* upper bound of an encoded device record */
+
+typedef enum NGP_RecordType {
+    NGP_RecordTypeDeviceAdded = 1,
+    NGP_RecordTypeDeviceRemoved,
+    NGP_RecordTypeFrame,
+} NGP_RecordType;
+
+typedef struct NGP_RecordingDeviceInfo {
+    NGP_DeviceGUID guid;
+    uint16_t       bus;
+    uint16_t       vendor_id;
+    uint16_t       product_id;
+    uint16_t       version;
+    uint8_t        touchpads;
+    const char*    name; /* points into the recording, not terminated */
+    size_t         name_len;
+    const char*    serial;
+    size_t         serial_len;
+} NGP_RecordingDeviceInfo;
+
+typedef struct NGP_RecordingRecord {
+    NGP_RecordType type;
+    int            pad;
+    NGP_Timestamp  time; /* frames only, the recorded timestamp */
+} NGP_RecordingRecord;
+
+/* Decodes a recording in place, nothing is copied out of the buffer it was given */
+typedef struct NGP_RecordingReader {
+    const uint8_t* data;
+    const uint8_t* end;
+    NGP_Timestamp  time;
+} NGP_RecordingReader;
+
+/**
+ * Checks the header and positions the reader on the first record
+ * @param reader
+ * @param data
+ * @param size
+ * @return false if data is not a recording this version can read
+ */
+bool NGP_RecordingReaderInit(NGP_RecordingReader* reader, const uint8_t* data, size_t size);
+
+/**
+ * Reads the type and pad of the next record, plus the time for frames. The record's payload has to
+ * be consumed next with NGP_RecordingReadDevice or NGP_RecordingReadFrame.
+ * @param reader
+ * @param record
+ * @return 1 for a record, 0 at the end of the recording, -1 if the recording is malformed
+ */
+int NGP_RecordingNext(NGP_RecordingReader* reader, NGP_RecordingRecord* record);
+
+/**
+ * Reads a DeviceAdded payload
+ * @param reader
+ * @param info
+ * @return false if the recording is malformed
+ */
+bool NGP_RecordingReadDevice(NGP_RecordingReader* reader, NGP_RecordingDeviceInfo* info);
+
+/**
+ * Reads a Frame payload, applying its deltas to the pad's previous state
+ * @param reader
+ * @param state the pad's previous frame, updated in place
+ * @return false if the recording is malformed
+ */
+bool NGP_RecordingReadFrame(NGP_RecordingReader* reader, NGP_GamePadState* state);
+
+/**
+ * Writes the file header
+ * @param out at least NGP_RECORDING_HEADER_SIZE bytes
+ * @return the number of bytes written
+ */
+size_t NGP_RecordingEncodeHeader(uint8_t* out);
+
+/**
+ * Writes a DeviceAdded record
+ * @param out at least NGP_RECORDING_MAX_DEVICE bytes
+ * @param pad
+ * @param device
+ * @return the number of bytes written
+ */
+size_t NGP_RecordingEncodeDevice(uint8_t* out, int pad, const NGP_Device* device);
+
+/**
+ * Writes a DeviceRemoved record
+ * @param out at least 4 bytes
+ * @param pad
+ * @return the number of bytes written
+ */
+size_t NGP_RecordingEncodeRemoved(uint8_t* out, int pad);
+
+/**
+ * Writes a Frame record holding what changed from prev to state
+ * @param out at least NGP_RECORDING_MAX_FRAME bytes
+ * @param pad
+ * @param last_time the previous frame's time in this recording, advanced to state's
+ * @param prev the pad's previously recorded frame, zeroed for its first one
+ * @param state
+ * @return the number of bytes written
+ */
+size_t NGP_RecordingEncodeFrame(uint8_t*                out,
+                                int                     pad,
+                                NGP_Timestamp*          last_time,
+                                const NGP_GamePadState* prev,
+                                const NGP_GamePadState* state);
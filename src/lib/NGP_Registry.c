@@ -0,0 +1,82 @@
+#include "NGP_Registry.h"
+
+#include <string.h>
+
+#define NGP_GENERATION_MASK 0x7fffffffu /* keeps handles positive */
+
+static NGP_GamePadID MakeID(uint32_t generation, int slot) {
+    return ((NGP_GamePadID)(generation & NGP_GENERATION_MASK) << 32) | (NGP_GamePadID)slot;
+}
+
+static bool ValidSlot(const NGP_Registry* registry, NGP_GamePadID id, int* slot) {
+    if (id < 0) {
+        return false;
+    }
+    *slot = NGP_RegistrySlot(id);
+    if (*slot >= NGP_REGISTRY_CAPACITY || (id & 0xffff0000) != 0) {
+        return false;
+    }
+    uint32_t generation = __atomic_load_n(&registry->generations[*slot], __ATOMIC_ACQUIRE);
+    return (generation & 1) && (generation & NGP_GENERATION_MASK) == (uint32_t)(id >> 32);
+}
+
+void NGP_RegistryInit(NGP_Registry* registry) {
+    memset(registry, 0, sizeof(*registry));
+    memset(registry->free_words, 0xff, sizeof(registry->free_words));
+    registry->free_summary = ~0ULL;
+}
+
+NGP_GamePadID NGP_RegistryInsert(NGP_Registry* registry, void* item) {
+    if (registry->free_summary == 0) {
+        return NGP_INVALID_GAMEPAD_ID;
+    }
+    int word = __builtin_ctzll(registry->free_summary);
+    int slot = word * 64 + __builtin_ctzll(registry->free_words[word]);
+    registry->free_words[word] &= ~(1ULL << (slot % 64));
+    if (registry->free_words[word] == 0) {
+        registry->free_summary &= ~(1ULL << word);
+    }
+
+    __atomic_store_n(&registry->items[slot], item, __ATOMIC_RELAXED);
+    uint32_t generation = registry->generations[slot] + 1;
+    __atomic_store_n(&registry->generations[slot], generation, __ATOMIC_RELEASE);
+
+    registry->position[slot]           = (uint16_t)registry->count;
+    registry->order[registry->count++] = (uint16_t)slot;
+    return MakeID(generation, slot);
+}
+
+void* NGP_RegistryRemove(NGP_Registry* registry, NGP_GamePadID id) {
+    int slot;
+    if (!ValidSlot(registry, id, &slot)) {
+        return NULL;
+    }
+    void* item = registry->items[slot];
+    __atomic_store_n(&registry->generations[slot], registry->generations[slot] + 1,
+                     __ATOMIC_RELEASE);
+    __atomic_store_n(&registry->items[slot], NULL, __ATOMIC_RELAXED);
+    registry->free_words[slot / 64] |= 1ULL << (slot % 64);
+    registry->free_summary |= 1ULL << (slot / 64);
+
+    uint16_t index           = registry->position[slot];
+    uint16_t last            = registry->order[--registry->count];
+    registry->order[index]   = last;
+    registry->position[last] = index;
+    return item;
+}
+
+void* NGP_RegistryLookup(const NGP_Registry* registry, NGP_GamePadID id) {
+    int slot;
+    if (!ValidSlot(registry, id, &slot)) {
+        return NULL;
+    }
+    return __atomic_load_n(&registry->items[slot], __ATOMIC_RELAXED);
+}
+
+NGP_GamePadID NGP_RegistryAt(const NGP_Registry* registry, int index) {
+    if (index < 0 || index >= registry->count) {
+        return NGP_INVALID_GAMEPAD_ID;
+    }
+    int slot = registry->order[index];
+    return MakeID(registry->generations[slot], slot);
+}
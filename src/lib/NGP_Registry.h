@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "NGP_Internal.h"
+
+#define NGP_REGISTRY_CAPACITY 4096 /* 64 free mask words of 64 slots each */
+#define NGP_REGISTRY_WORDS (NGP_REGISTRY_CAPACITY / 64)
+#define NGP_INVALID_GAMEPAD_ID ((NGP_GamePadID)-1)
+
+/*
+ * Slot array of device pointers, shared by every backend. Handles are NGP_GamePadIDs made of the
+ * slot and a per slot generation, so a handle to a removed device never matches whatever reuses
+ * its slot. Insert and lookup are O(1): a two level free mask finds the lowest free slot and
+ * handles index slots directly. The order list holds the occupied slots densely, which is what an
+ * index passed to NGP_GamePadOpen refers to, and each slot remembers its position in it. Remove is
+ * O(1) as well: the last entry of the list moves into the removed one's place, so a pad keeps its
+ * index for as long as it is attached, except the most recently listed pad, which takes over the
+ * index of one that goes away.
+ *
+ * Mutations are not thread safe, callers serialize them. NGP_RegistryLookup can run concurrently
+ * with them, it only reads the slot's generation and item atomically.
+ */
+typedef struct NGP_Registry {
+    void*    items[NGP_REGISTRY_CAPACITY];
+    uint32_t generations[NGP_REGISTRY_CAPACITY]; /* odd while the slot is occupied */
+    uint64_t free_words[NGP_REGISTRY_WORDS];     /* bit n of word w set when slot w*64+n is free */
+    uint64_t free_summary;                       /* bit w set when word w has a free slot */
+    uint16_t order[NGP_REGISTRY_CAPACITY];       /* occupied slots, see above */
+    uint16_t position[NGP_REGISTRY_CAPACITY];    /* where each occupied slot sits in order */
+    int      count;
+} NGP_Registry;
+
+/**
+ * Empties the registry
+ * @param registry
+ */
+void NGP_RegistryInit(NGP_Registry* registry);
+
+/**
+ * Stores item in the lowest free slot and appends it to the index order
+ * @param registry
+ * @param item
+ * @return the new handle, or NGP_INVALID_GAMEPAD_ID if the registry is full
+ */
+NGP_GamePadID NGP_RegistryInsert(NGP_Registry* registry, void* item);
+
+/**
+ * Frees the handle's slot, moving the last pad in the index order into its index
+ * @param registry
+ * @param id
+ * @return the item that was stored, or NULL if the handle was stale
+ */
+void* NGP_RegistryRemove(NGP_Registry* registry, NGP_GamePadID id);
+
+/**
+ * Returns the item for a handle, or NULL if it was removed
+ * @param registry
+ * @param id
+ */
+void* NGP_RegistryLookup(const NGP_Registry* registry, NGP_GamePadID id);
+
+/**
+ * Returns the handle at the given position of the index order
+ * @param registry
+ * @param index
+ * @return the handle, or NGP_INVALID_GAMEPAD_ID if index is out of range
+ */
+NGP_GamePadID NGP_RegistryAt(const NGP_Registry* registry, int index);
+
+/**
+ * Returns the slot a handle refers to, for callers keeping per slot side tables
+ * @param id
+ */
+static inline int NGP_RegistrySlot(NGP_GamePadID id) { return (int)(id & 0xffff); }
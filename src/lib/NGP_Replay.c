@@ -0,0 +1,256 @@
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "NGP_CondVar.h"
+#include "NGP_Pool.h"
+#include "NGP_RecordingFormat.h"
+#include "NGP_Runtime.h"
+
+#define NGP_REPLAY_BATCH 256       /* records handled per Pump, so a stop request is seen quickly */
+#define NGP_REPLAY_QUEUE_SPACE 256 /* max speed waits for this much room in the event queue */
+#define NGP_REPLAY_RETRY_MS 1
+
+/*
+ * A device source that plays a recording back. The file is mapped and decoded in place. Frames are
+ * applied with NGP_DeviceApplyState and published like a backend would, so the public API and the
+ * event queue see the same frames and events the recorded pads produced.
+ */
+typedef struct NGP_Replay {
+    const uint8_t*      map;
+    size_t              size;
+    NGP_ReplaySpeed     speed;
+    NGP_RecordingReader reader;
+
+    NGP_RecordingRecord record;  /* the next record, read ahead so its time can be waited for */
+    bool                pending;
+    bool                finished;
+
+    NGP_Timestamp   first_time;  /* recorded time of the first frame */
+    NGP_Timestamp   start;       /* monotonic time the first frame was delivered at */
+    bool            started;     /* frames are stamped start + their recorded offset from then */
+
+    NGP_Device*       devices[NGP_RECORDING_MAX_PADS];
+    NGP_GamePadState* states; /* each pad's last decoded frame */
+
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    bool            woken;
+} NGP_Replay;
+
+static NGP_Replay     replay    = { .lock = PTHREAD_MUTEX_INITIALIZER };
+static pthread_once_t cond_once = PTHREAD_ONCE_INIT;
+
+static void InitCond(void) { NGP_CondInit(&replay.cond); }
+
+/* Sleeps until the deadline (monotonic ns, or -1 for none) or a Wake, whichever is first */
+static void WaitUntil(NGP_Timestamp deadline) {
+    pthread_mutex_lock(&replay.lock);
+    if (!replay.woken) {
+        if (deadline < 0) {
+            pthread_cond_wait(&replay.cond, &replay.lock);
+        } else {
+            NGP_CondWaitUntil(&replay.cond, &replay.lock, deadline);
+        }
+    }
+    replay.woken = false;
+    pthread_mutex_unlock(&replay.lock);
+}
+
+static NGP_Timestamp Deadline(int timeout_ms) {
+    return timeout_ms < 0 ? -1 : NGP_GetTicksNS() + (NGP_Timestamp)timeout_ms * 1000000LL;
+}
+
+static void RemovePad(int pad) {
+    if (replay.devices[pad]) {
+        NGP_DeviceRelease(replay.devices[pad]);
+        replay.devices[pad] = NULL;
+    }
+}
+
+static bool AddPad(int pad) {
+    NGP_RecordingDeviceInfo info;
+    if (!NGP_RecordingReadDevice(&replay.reader, &info)) {
+        return false;
+    }
+    RemovePad(pad);
+    memset(&replay.states[pad], 0, sizeof(replay.states[pad]));
+
+    NGP_Device* device = NGP_DeviceAcquire();
+    if (!device) {
+        return true; /* more pads than this build supports, its frames are skipped */
+    }
+    device->guid       = info.guid;
+    device->bus        = info.bus;
+    device->vendor_id  = info.vendor_id;
+    device->product_id = info.product_id;
+    device->version    = info.version;
+    device->touchpads  = info.touchpads;
+    device->name       = NGP_InternString(info.name, info.name_len);
+    device->serial     = NGP_InternString(info.serial, info.serial_len);
+    replay.devices[pad] = device;
+    return true;
+}
+
+static bool ApplyFrame(int pad, NGP_Timestamp time) {
+    NGP_GamePadState* state = &replay.states[pad];
+    if (!NGP_RecordingReadFrame(&replay.reader, state)) {
+        return false;
+    }
+    NGP_Device* device = replay.devices[pad];
+    if (device) {
+        /* the recorded spacing, not the delivery time, so filters see the same frames each run */
+        NGP_DeviceBeginReport(device, replay.start + (time - replay.first_time));
+        NGP_DeviceApplyState(device, state);
+        NGP_DevicePublish(device);
+        /* the recorder writes a pad's first frame right after it attaches, so attach on it */
+        if (!device->attached && !NGP_DeviceAttach(device)) {
+            NGP_DeviceRelease(device);
+            replay.devices[pad] = NULL;
+        }
+    }
+    return true;
+}
+
+static bool HandleRecord(const NGP_RecordingRecord* record) {
+    switch (record->type) {
+        case NGP_RecordTypeDeviceAdded:
+            return AddPad(record->pad);
+        case NGP_RecordTypeDeviceRemoved:
+            RemovePad(record->pad);
+            return true;
+        case NGP_RecordTypeFrame:
+            return ApplyFrame(record->pad, record->time);
+    }
+    return false;
+}
+
+static bool ReplaySetup(void* userdata) {
+    (void)userdata;
+    pthread_once(&cond_once, InitCond); /* before the I/O thread or a Wake can use it */
+    return replay.map != NULL;
+}
+
+static bool ReplayOpen(void* userdata) {
+    (void)userdata;
+    replay.pending = false;
+    replay.started = false;
+    replay.woken   = false;
+    __atomic_store_n(&replay.finished, false, __ATOMIC_RELEASE);
+    memset(replay.devices, 0, sizeof(replay.devices));
+    replay.states = NGP_Calloc(NGP_RECORDING_MAX_PADS, sizeof(*replay.states));
+    return replay.states != NULL;
+}
+
+static void ReplayPump(void* userdata, int timeout_ms) {
+    (void)userdata;
+    NGP_Timestamp deadline = Deadline(timeout_ms);
+
+    for (int handled = 0; handled < NGP_REPLAY_BATCH; handled++) {
+        if (__atomic_load_n(&replay.finished, __ATOMIC_ACQUIRE)) {
+            WaitUntil(deadline); /* nothing left, sleep until shut down */
+            return;
+        }
+        if (!replay.pending) {
+            if (NGP_RecordingNext(&replay.reader, &replay.record) <= 0) {
+                __atomic_store_n(&replay.finished, true, __ATOMIC_RELEASE);
+                continue;
+            }
+            replay.pending = true;
+        }
+
+        if (replay.record.type == NGP_RecordTypeFrame) {
+            if (!replay.started) {
+                replay.first_time = replay.record.time;
+                replay.start      = NGP_GetTicksNS();
+                replay.started    = true;
+            }
+            if (replay.speed == NGP_ReplaySpeedRealTime) {
+                NGP_Timestamp due = replay.start + (replay.record.time - replay.first_time);
+                if (due > NGP_GetTicksNS()) {
+                    WaitUntil(deadline < 0 || due < deadline ? due : deadline);
+                    return;
+                }
+            } else if (NGP_EventQueueSpace(NGP_GetEventQueue()) < NGP_REPLAY_QUEUE_SPACE) {
+                WaitUntil(NGP_GetTicksNS() + NGP_REPLAY_RETRY_MS * 1000000LL);
+                return;
+            }
+        }
+
+        replay.pending = false;
+        if (!HandleRecord(&replay.record)) {
+            __atomic_store_n(&replay.finished, true, __ATOMIC_RELEASE); /* truncated or corrupt */
+        }
+    }
+}
+
+static void ReplayWake(void* userdata) {
+    (void)userdata;
+    pthread_mutex_lock(&replay.lock);
+    replay.woken = true;
+    pthread_cond_signal(&replay.cond);
+    pthread_mutex_unlock(&replay.lock);
+}
+
+static void ReplayClose(void* userdata) {
+    (void)userdata;
+    for (int pad = 0; pad < NGP_RECORDING_MAX_PADS; pad++) {
+        RemovePad(pad);
+    }
+    NGP_Free(replay.states);
+    replay.states = NULL;
+    munmap((void*)replay.map, replay.size);
+    replay.map  = NULL;
+    replay.size = 0;
+}
+
+static const NGP_DeviceSource replay_source = {
+    .name  = "replay",
+    .Setup = ReplaySetup,
+    .Open  = ReplayOpen,
+    .Pump  = ReplayPump,
+    .Wake  = ReplayWake,
+    .Close = ReplayClose,
+};
+
+DECLSPEC bool NGPCALL NGP_InitializeReplay(const char* path, NGP_ReplaySpeed speed) {
+    if (NGP_RuntimeIsRunning()) {
+        return false;
+    }
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    void*       map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size >= NGP_RECORDING_HEADER_SIZE) {
+        map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    if (!NGP_RecordingReaderInit(&replay.reader, map, (size_t)st.st_size)) {
+        munmap(map, (size_t)st.st_size);
+        return false;
+    }
+    replay.map   = map;
+    replay.size  = (size_t)st.st_size;
+    replay.speed = speed;
+    if (!NGP_RuntimeStart(&replay_source)) {
+        munmap(map, (size_t)st.st_size);
+        replay.map = NULL;
+        return false;
+    }
+    return true;
+}
+
+DECLSPEC bool NGPCALL NGP_ReplayFinished(void) {
+    return __atomic_load_n(&replay.finished, __ATOMIC_ACQUIRE);
+}
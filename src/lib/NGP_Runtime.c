@@ -0,0 +1,125 @@
+#include "NGP_Runtime.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "NGP_Device.h"
+
+typedef struct NGP_Runtime {
+    const NGP_DeviceSource* source;
+    pthread_t               thread;
+    pthread_mutex_t         lock;
+    pthread_cond_t          cond;
+    bool                    ready;   /* initial enumeration finished, opened tells how it went */
+    bool                    opened;
+    bool                    running; /* owned by the thread calling start/stop */
+    bool                    stop;
+    int                     waking; /* NGP_RuntimeWake calls that may still reach source */
+} NGP_Runtime;
+
+static NGP_Runtime runtime = { .lock = PTHREAD_MUTEX_INITIALIZER, .cond = PTHREAD_COND_INITIALIZER };
+
+static void SignalReady(bool opened) {
+    pthread_mutex_lock(&runtime.lock);
+    runtime.opened = opened;
+    runtime.ready  = true;
+    pthread_cond_broadcast(&runtime.cond);
+    pthread_mutex_unlock(&runtime.lock);
+}
+
+/* Timeouts in ms where -1 means none */
+static int EarliestTimeout(int a, int b) {
+    if (a < 0) {
+        return b;
+    }
+    return b < 0 || a < b ? a : b;
+}
+
+static void* RuntimeThread(void* arg) {
+    const NGP_DeviceSource* source = arg;
+
+    if (!source->Open(source->userdata)) {
+        SignalReady(false);
+        return NULL;
+    }
+    SignalReady(true);
+
+    while (!__atomic_load_n(&runtime.stop, __ATOMIC_ACQUIRE)) {
+        int axes    = NGP_DeviceFlushDue();
+        int haptics = NGP_HapticsTick(); /* before the flush so a changed mix goes out this pass */
+        int output  = NGP_OutputFlush();
+        source->Pump(source->userdata, EarliestTimeout(EarliestTimeout(axes, haptics), output));
+    }
+    source->Close(source->userdata);
+    return NULL;
+}
+
+bool NGP_RuntimeStart(const NGP_DeviceSource* source) {
+    if (runtime.running || !source) {
+        return false;
+    }
+    NGP_LatencyStartEnumeration();
+    if (source->Setup && !source->Setup(source->userdata)) {
+        return false;
+    }
+
+    __atomic_store_n(&runtime.source, source, __ATOMIC_RELEASE);
+    runtime.ready  = false;
+    runtime.opened = false;
+    __atomic_store_n(&runtime.stop, false, __ATOMIC_RELEASE);
+    if (pthread_create(&runtime.thread, NULL, RuntimeThread, (void*)source) != 0) {
+        __atomic_store_n(&runtime.source, NULL, __ATOMIC_RELEASE);
+        return false;
+    }
+
+    pthread_mutex_lock(&runtime.lock);
+    while (!runtime.ready) {
+        pthread_cond_wait(&runtime.cond, &runtime.lock);
+    }
+    bool opened = runtime.opened;
+    pthread_mutex_unlock(&runtime.lock);
+
+    if (!opened) {
+        pthread_join(runtime.thread, NULL);
+        __atomic_store_n(&runtime.source, NULL, __ATOMIC_RELEASE);
+        return false;
+    }
+    runtime.running = true;
+    return true;
+}
+
+void NGP_RuntimeStop(void) {
+    if (!runtime.running) {
+        return;
+    }
+    /*
+     * Cleared first so NGP_RuntimeWake stops reaching the source, then the calls that loaded it
+     * before that are waited out, so none is still in Wake once the thread runs Close
+     */
+    const NGP_DeviceSource* source = runtime.source;
+    __atomic_store_n(&runtime.source, NULL, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&runtime.waking, __ATOMIC_SEQ_CST)) {
+        sched_yield();
+    }
+    __atomic_store_n(&runtime.stop, true, __ATOMIC_RELEASE);
+    source->Wake(source->userdata);
+    pthread_join(runtime.thread, NULL);
+    runtime.running = false;
+    NGP_EventQueueUpdateLibraryCursor(false); /* the next run may only use the callback */
+}
+
+void NGP_RuntimeWake(void) {
+    /* counted before source is loaded, pairs with NGP_RuntimeStop clearing it before it counts */
+    __atomic_add_fetch(&runtime.waking, 1, __ATOMIC_SEQ_CST);
+    const NGP_DeviceSource* source = __atomic_load_n(&runtime.source, __ATOMIC_SEQ_CST);
+    if (source) {
+        source->Wake(source->userdata);
+    }
+    __atomic_sub_fetch(&runtime.waking, 1, __ATOMIC_RELEASE);
+}
+
+bool NGP_RuntimeIsRunning(void) { return runtime.running; }
+
+bool NGP_Initialize(void) { return NGP_RuntimeStart(NGP_PlatformDeviceSource()); }
+
+void NGP_Shutdown(void) { NGP_RuntimeStop(); }
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdbool.h>
+#include "NGP_Internal.h"
+
+/*
+ * A device source is how a backend plugs into the library owned I/O thread. The IOKit, evdev and
+ * any fake source used to exercise the core all implement the same callbacks.
+ */
+typedef struct NGP_DeviceSource {
+    const char* name;
+    void*       userdata;
+
+    /* Optional. Runs on the thread calling NGP_Initialize, before the I/O thread is started. */
+    bool (*Setup)(void* userdata);
+    /* Runs on the I/O thread, opens the source and attaches every device already present. */
+    bool (*Open)(void* userdata);
+    /* Runs on the I/O thread in a loop, waits up to timeout_ms (-1 forever) and handles I/O. */
+    void (*Pump)(void* userdata, int timeout_ms);
+    /* Called from any thread, makes a blocked Pump return as soon as possible. */
+    void (*Wake)(void* userdata);
+    /* Runs on the I/O thread after the last Pump, releases every device the source attached. */
+    void (*Close)(void* userdata);
+} NGP_DeviceSource;
+
+/**
+ * Returns the device source for the platform this library was built for
+ */
+const NGP_DeviceSource* NGP_PlatformDeviceSource(void);
+
+/**
+ * Starts the I/O thread for the given source and waits for its initial enumeration to finish
+ * @param source
+ * @return false if the source failed to open or the library is already running
+ */
+bool NGP_RuntimeStart(const NGP_DeviceSource* source);
+
+/**
+ * Wakes and joins the I/O thread, the source's Close runs before this returns
+ */
+void NGP_RuntimeStop(void);
+
+/**
+ * Makes the I/O thread run a pass soon, from any thread. Does nothing while it is not running.
+ */
+void NGP_RuntimeWake(void);
+
+/**
+ * Returns whether an I/O thread is currently running
+ */
+bool NGP_RuntimeIsRunning(void);
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Sequence lock for data with a single writer and any number of readers. The writer makes the
+ * sequence odd while it writes, readers copy the data and retry if the sequence was odd or changed
+ * underneath them. Readers never block the writer, which matters when the writer is the I/O thread.
+ */
+typedef struct NGP_SeqLock {
+    uint32_t sequence;
+} NGP_SeqLock;
+
+static inline void NGP_SeqLockWriteBegin(NGP_SeqLock* lock) {
+    __atomic_store_n(&lock->sequence, lock->sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void NGP_SeqLockWriteEnd(NGP_SeqLock* lock) {
+    __atomic_store_n(&lock->sequence, lock->sequence + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Copies size bytes of data guarded by lock into out, retrying until the copy is consistent
+ * @param lock
+ * @param out
+ * @param data
+ * @param size
+ */
+static inline void NGP_SeqLockRead(const NGP_SeqLock* lock, void* out, const void* data, size_t size) {
+    uint32_t before;
+    uint32_t after;
+    do {
+        before = __atomic_load_n(&lock->sequence, __ATOMIC_ACQUIRE);
+        memcpy(out, data, size);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        after = __atomic_load_n(&lock->sequence, __ATOMIC_RELAXED);
+    } while ((before & 1) || before != after);
+}
@@ -0,0 +1,230 @@
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "NGP_Device.h"
+#include "NGP_Pool.h"
+
+#define NGP_SHARED_MAGIC 0x5350474eu /* "NGPS" */
+#define NGP_SHARED_VERSION 1
+#define NGP_SHARED_SLOTS NGP_REGISTRY_CAPACITY /* one per registry slot, so a pad keeps its slot */
+#define NGP_SHARED_READ_TRIES 64 /* a writer that died mid write must not hang a client */
+
+/* The segment's layout, the header then one slot per registry slot */
+typedef struct NGP_SharedHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slots;
+    uint32_t slot_size; /* so a client built against another NGP_GamePadState refuses the segment */
+    uint32_t live;      /* cleared by NGP_StopSharedState */
+    uint64_t occupied[NGP_SHARED_SLOTS / 64]; /* bit n set while slot n holds a pad */
+} NGP_SharedHeader;
+
+typedef struct NGP_SharedSlot {
+    _Alignas(NGP_CACHE_LINE) NGP_SeqLock lock;
+    NGP_SharedGamePad pad;
+} NGP_SharedSlot;
+
+typedef struct NGP_SharedSegment {
+    _Alignas(NGP_CACHE_LINE) NGP_SharedHeader header;
+    NGP_SharedSlot   slots[NGP_SHARED_SLOTS];
+} NGP_SharedSegment;
+
+/*
+ * The exporter. The I/O thread writes frames through the hooks, NGP_StartSharedState publishes the
+ * pads that are already attached from the calling thread, both under the exporter's lock, so each
+ * slot's sequence lock only ever has one writer.
+ */
+typedef struct NGP_SharedExporter {
+    pthread_mutex_t    lock;
+    NGP_SharedSegment* segment;
+    char               name[NGP_NAME_LEN];
+} NGP_SharedExporter;
+
+struct NGP_SharedStateClient {
+    const NGP_SharedSegment* segment;
+};
+
+bool NGP_SharedStateEnabled;
+
+static NGP_SharedExporter exporter = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static void Publish(const NGP_Device* device, const NGP_GamePadState* state) {
+    int             index = NGP_RegistrySlot(device->id);
+    NGP_SharedSlot* slot  = &exporter.segment->slots[index];
+    NGP_SeqLockWriteBegin(&slot->lock);
+    if (slot->pad.ID != device->id) {
+        slot->pad.ID        = device->id;
+        slot->pad.VendorID  = device->vendor_id;
+        slot->pad.ProductID = device->product_id;
+        snprintf(slot->pad.Name, sizeof(slot->pad.Name), "%s", device->name);
+    }
+    slot->pad.State = *state;
+    NGP_SeqLockWriteEnd(&slot->lock);
+    __atomic_fetch_or(&exporter.segment->header.occupied[index / 64], 1ULL << (index % 64),
+                      __ATOMIC_RELEASE);
+}
+
+void NGP_SharedStatePublish(const NGP_Device* device) {
+    pthread_mutex_lock(&exporter.lock);
+    if (exporter.segment) {
+        Publish(device, &device->state);
+    }
+    pthread_mutex_unlock(&exporter.lock);
+}
+
+void NGP_SharedStateRemove(const NGP_Device* device) {
+    pthread_mutex_lock(&exporter.lock);
+    int index = NGP_RegistrySlot(device->id);
+    if (exporter.segment && exporter.segment->slots[index].pad.ID == device->id) {
+        NGP_SharedSlot* slot = &exporter.segment->slots[index];
+        __atomic_fetch_and(&exporter.segment->header.occupied[index / 64],
+                           ~(1ULL << (index % 64)), __ATOMIC_RELEASE);
+        NGP_SeqLockWriteBegin(&slot->lock);
+        slot->pad.ID = NGP_INVALID_GAMEPAD_ID;
+        NGP_SeqLockWriteEnd(&slot->lock);
+    }
+    pthread_mutex_unlock(&exporter.lock);
+}
+
+DECLSPEC bool NGPCALL NGP_StartSharedState(const char* name) {
+    pthread_mutex_lock(&exporter.lock);
+    if (exporter.segment || !name) {
+        pthread_mutex_unlock(&exporter.lock);
+        return false;
+    }
+    /* a fresh object rather than whatever a crashed exporter left behind */
+    shm_unlink(name);
+    int   fd      = shm_open(name, O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0644);
+    void* segment = MAP_FAILED;
+    if (fd >= 0) {
+        if (ftruncate(fd, sizeof(NGP_SharedSegment)) == 0) {
+            segment =
+                mmap(NULL, sizeof(NGP_SharedSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+    }
+    if (segment == MAP_FAILED) {
+        if (fd >= 0) {
+            shm_unlink(name);
+        }
+        pthread_mutex_unlock(&exporter.lock);
+        return false;
+    }
+    snprintf(exporter.name, sizeof(exporter.name), "%s", name);
+    exporter.segment = segment;
+    for (int i = 0; i < NGP_SHARED_SLOTS; i++) {
+        exporter.segment->slots[i].pad.ID = NGP_INVALID_GAMEPAD_ID;
+    }
+    NGP_SharedHeader* header = &exporter.segment->header;
+    header->slots            = NGP_SHARED_SLOTS;
+    header->slot_size        = sizeof(NGP_SharedSlot);
+    header->version          = NGP_SHARED_VERSION;
+    header->live             = 1;
+    __atomic_store_n(&header->magic, NGP_SHARED_MAGIC, __ATOMIC_RELEASE);
+    __atomic_store_n(&NGP_SharedStateEnabled, true, __ATOMIC_RELAXED);
+
+    /* pads that already sit idle would otherwise only show up once they report something */
+    for (int i = 0; i < NGP_DeviceCount(); i++) {
+        NGP_Device* device = NGP_DeviceLookup(NGP_DeviceAtIndex(i));
+        if (device) {
+            NGP_GamePadState state;
+            NGP_DeviceReadState(device, &state);
+            Publish(device, &state);
+        }
+    }
+    pthread_mutex_unlock(&exporter.lock);
+    return true;
+}
+
+DECLSPEC void NGPCALL NGP_StopSharedState(void) {
+    pthread_mutex_lock(&exporter.lock);
+    __atomic_store_n(&NGP_SharedStateEnabled, false, __ATOMIC_RELAXED);
+    if (exporter.segment) {
+        __atomic_store_n(&exporter.segment->header.live, 0, __ATOMIC_RELEASE);
+        munmap(exporter.segment, sizeof(NGP_SharedSegment));
+        shm_unlink(exporter.name);
+        exporter.segment = NULL;
+    }
+    pthread_mutex_unlock(&exporter.lock);
+}
+
+DECLSPEC NGP_SharedStateClient* NGPCALL NGP_SharedStateOpen(const char* name) {
+    int fd = name ? shm_open(name, O_RDONLY | O_CLOEXEC, 0) : -1;
+    if (fd < 0) {
+        return NULL;
+    }
+    /* a segment not grown to full size yet, or someone else's, faults past its end */
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(NGP_SharedSegment)) {
+        close(fd);
+        return NULL;
+    }
+    void* segment = mmap(NULL, sizeof(NGP_SharedSegment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (segment == MAP_FAILED) {
+        return NULL;
+    }
+    const NGP_SharedHeader* header = segment;
+    if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != NGP_SHARED_MAGIC ||
+        header->version != NGP_SHARED_VERSION || header->slots != NGP_SHARED_SLOTS ||
+        header->slot_size != sizeof(NGP_SharedSlot)) {
+        munmap(segment, sizeof(NGP_SharedSegment));
+        return NULL;
+    }
+    NGP_SharedStateClient* client = NGP_Malloc(sizeof(*client));
+    if (!client) {
+        munmap(segment, sizeof(NGP_SharedSegment));
+        return NULL;
+    }
+    client->segment = segment;
+    return client;
+}
+
+DECLSPEC void NGPCALL NGP_SharedStateClose(NGP_SharedStateClient* client) {
+    if (client) {
+        munmap((void*)client->segment, sizeof(NGP_SharedSegment));
+        NGP_Free(client);
+    }
+}
+
+DECLSPEC bool NGPCALL NGP_SharedStateIsLive(const NGP_SharedStateClient* client) {
+    return __atomic_load_n(&client->segment->header.live, __ATOMIC_ACQUIRE) != 0;
+}
+
+DECLSPEC int NGPCALL NGP_SharedStateNextGamePad(const NGP_SharedStateClient* client, int slot) {
+    const uint64_t* occupied = client->segment->header.occupied;
+    for (int index = slot + 1; index >= 0 && index < NGP_SHARED_SLOTS;) {
+        uint64_t word = __atomic_load_n(&occupied[index / 64], __ATOMIC_ACQUIRE);
+        word &= ~0ULL << (index % 64);
+        if (word) {
+            return (index & ~63) + __builtin_ctzll(word);
+        }
+        index = (index & ~63) + 64;
+    }
+    return -1;
+}
+
+DECLSPEC bool NGPCALL NGP_SharedStateRead(const NGP_SharedStateClient* client,
+                                          int                          slot,
+                                          NGP_SharedGamePad*           pad) {
+    if (slot < 0 || slot >= NGP_SHARED_SLOTS) {
+        return false;
+    }
+    /* NGP_SeqLockRead, but giving up rather than spinning on a writer that may be gone */
+    const NGP_SharedSlot* shared = &client->segment->slots[slot];
+    for (int tries = 0; tries < NGP_SHARED_READ_TRIES; tries++) {
+        uint32_t before = __atomic_load_n(&shared->lock.sequence, __ATOMIC_ACQUIRE);
+        memcpy(pad, &shared->pad, sizeof(*pad));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        uint32_t after = __atomic_load_n(&shared->lock.sequence, __ATOMIC_RELAXED);
+        if (!(before & 1) && before == after) {
+            return pad->ID != NGP_INVALID_GAMEPAD_ID;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,292 @@
+#include "NGP_SonyReport.h"
+
+#include <string.h>
+
+/*
+ * Report layouts follow SDL's hidapi PS4/PS5 drivers. Offsets below are from the start of the state
+ * packet, which sits after the report id (and two more header bytes on DS4 Bluetooth, one on DS5
+ * Bluetooth).
+ */
+#define DS4_LEFT_X 0
+#define DS4_BUTTONS 4
+#define DS4_TRIGGER_LEFT 7
+#define DS4_TRIGGER_RIGHT 8
+#define DS4_GYRO 12
+#define DS4_ACCEL 18
+#define DS4_TOUCH 34
+#define DS4_PACKET_SIZE 42
+
+#define DS5_LEFT_X 0
+#define DS5_TRIGGER_LEFT 4
+#define DS5_TRIGGER_RIGHT 5
+#define DS5_BUTTONS 7
+#define DS5_GYRO 15
+#define DS5_ACCEL 21
+#define DS5_TOUCH 32
+#define DS5_PACKET_SIZE 40
+
+/* The short Bluetooth report both pads send until they are asked for full reports */
+#define SHORT_BUTTONS 4
+#define SHORT_TRIGGER_LEFT 7
+#define SHORT_TRIGGER_RIGHT 8
+#define SHORT_PACKET_SIZE 9
+
+/* Uncalibrated sensor resolution, the same defaults SDL falls back to */
+#define SONY_ACCEL_RES_PER_G 8192.0f
+#define SONY_GYRO_RES_PER_DEGREE 16.0f
+#define STANDARD_GRAVITY 9.80665f
+#define DEGREES_TO_RADIANS 0.017453292519943295f
+
+/* Output reports, offsets are from the start of the effects block */
+#define DS4_USB_OUTPUT_SIZE 32
+#define DS4_BT_OUTPUT_SIZE 78
+#define DS4_RUMBLE 0 /* high frequency motor, then low frequency */
+#define DS4_LED 2
+
+#define DS5_USB_OUTPUT_SIZE 48
+#define DS5_BT_OUTPUT_SIZE 78
+#define DS5_ENABLE_BITS1 0
+#define DS5_ENABLE_BITS2 1
+#define DS5_RUMBLE 2
+#define DS5_LED 44
+
+#define DS4_TOUCHPAD_WIDTH 1920.0f
+#define DS4_TOUCHPAD_HEIGHT 920.0f
+#define DS5_TOUCHPAD_WIDTH 1920.0f
+#define DS5_TOUCHPAD_HEIGHT 1070.0f
+
+static int16_t StickValue(uint8_t value) { return (int16_t)((int)value * 257 - 32768); }
+
+static int16_t TriggerValue(uint8_t value) { return (int16_t)((value << 7) | (value >> 1)); }
+
+static int16_t ReadLE16(const uint8_t* data) { return (int16_t)(data[0] | (data[1] << 8)); }
+
+static void ReadSticks(const uint8_t* packet, uint8_t left, uint8_t right, NGP_GamePadState* state) {
+    state->Axes[NGP_GamePadAxisTypeLeftX]        = StickValue(packet[0]);
+    state->Axes[NGP_GamePadAxisTypeLeftY]        = StickValue(packet[1]);
+    state->Axes[NGP_GamePadAxisTypeRightX]       = StickValue(packet[2]);
+    state->Axes[NGP_GamePadAxisTypeRightY]       = StickValue(packet[3]);
+    state->Axes[NGP_GamePadAxisTypeTriggerLeft]  = TriggerValue(left);
+    state->Axes[NGP_GamePadAxisTypeTriggerRight] = TriggerValue(right);
+}
+
+#define BUTTON(b) (1u << NGP_GamePadButton##b)
+
+/* The three button bytes share one layout on both pads: hat and face buttons, shoulders and
+ * menu buttons, then PS, touchpad click and (DS5 only) the mic button */
+static uint32_t ReadButtons(const uint8_t* buttons) {
+    /* d-pad directions for hat values 0 (north) to 7 (north west), 8 and up is released */
+    static const uint32_t hat[16] = {
+        BUTTON(DPadUp),
+        BUTTON(DPadUp) | BUTTON(DPadRight),
+        BUTTON(DPadRight),
+        BUTTON(DPadDown) | BUTTON(DPadRight),
+        BUTTON(DPadDown),
+        BUTTON(DPadDown) | BUTTON(DPadLeft),
+        BUTTON(DPadLeft),
+        BUTTON(DPadUp) | BUTTON(DPadLeft),
+    };
+    uint32_t mask = hat[buttons[0] & 0x0f];
+
+    mask |= (buttons[0] & 0x10) ? BUTTON(X) : 0;
+    mask |= (buttons[0] & 0x20) ? BUTTON(A) : 0;
+    mask |= (buttons[0] & 0x40) ? BUTTON(B) : 0;
+    mask |= (buttons[0] & 0x80) ? BUTTON(Y) : 0;
+
+    mask |= (buttons[1] & 0x01) ? BUTTON(LeftShoulder) : 0;
+    mask |= (buttons[1] & 0x02) ? BUTTON(RightShoulder) : 0;
+    mask |= (buttons[1] & 0x10) ? BUTTON(Back) : 0;
+    mask |= (buttons[1] & 0x20) ? BUTTON(Start) : 0;
+    mask |= (buttons[1] & 0x40) ? BUTTON(LeftStick) : 0;
+    mask |= (buttons[1] & 0x80) ? BUTTON(RightStick) : 0;
+
+    mask |= (buttons[2] & 0x01) ? BUTTON(Guide) : 0;
+    mask |= (buttons[2] & 0x02) ? BUTTON(Touchpad) : 0;
+    mask |= (buttons[2] & 0x04) ? BUTTON(Misc1) : 0;
+    return mask;
+}
+
+static void ReadSensors(const uint8_t* gyro, const uint8_t* accel, NGP_GamePadState* state) {
+    const float gyro_scale  = DEGREES_TO_RADIANS / SONY_GYRO_RES_PER_DEGREE;
+    const float accel_scale = STANDARD_GRAVITY / SONY_ACCEL_RES_PER_G;
+    for (int i = 0; i < 3; i++) {
+        state->Gyro[i]  = ReadLE16(gyro + i * 2) * gyro_scale;
+        state->Accel[i] = ReadLE16(accel + i * 2) * accel_scale;
+    }
+}
+
+/* Each finger is a counter byte (bit 7 set while lifted, the rest is the touch id) followed by
+ * 12 bit X and Y */
+static void ReadFingers(const uint8_t* touch, float width, float height, NGP_GamePadState* state) {
+    for (int i = 0; i < NGP_SONY_TOUCHPAD_FINGERS; i++) {
+        const uint8_t*          data   = touch + i * 4;
+        NGP_GamePadStateFinger* finger = &state->Fingers[i];
+        int                     x      = data[1] | ((data[2] & 0x0f) << 8);
+        int                     y      = (data[2] >> 4) | (data[3] << 4);
+
+        finger->State    = (data[0] & 0x80) == 0;
+        finger->ID       = data[0] & 0x7f;
+        finger->X        = x / width;
+        finger->Y        = y / height;
+        finger->Pressure = finger->State ? 1.0f : 0.0f;
+    }
+}
+
+static void ReadShortReport(const uint8_t* packet, NGP_GamePadState* state) {
+    ReadSticks(packet, packet[SHORT_TRIGGER_LEFT], packet[SHORT_TRIGGER_RIGHT], state);
+    /* the top six bits of the third button byte are a report counter here */
+    state->Buttons = ReadButtons(packet + SHORT_BUTTONS) & ~BUTTON(Misc1);
+}
+
+static bool ParseDS4(const uint8_t* data, size_t size, NGP_GamePadState* state) {
+    const uint8_t* packet;
+    if (data[0] == 0x01 && size >= 1 + DS4_PACKET_SIZE) {
+        packet = data + 1;
+    } else if (data[0] == 0x11 && size >= 3 + DS4_PACKET_SIZE) {
+        packet = data + 3;
+    } else if (data[0] == 0x01 && size >= 1 + SHORT_PACKET_SIZE) {
+        ReadShortReport(data + 1, state);
+        return true;
+    } else {
+        return false;
+    }
+
+    ReadSticks(packet + DS4_LEFT_X, packet[DS4_TRIGGER_LEFT], packet[DS4_TRIGGER_RIGHT], state);
+    /* no mic button, the top six bits of the third button byte are a report counter on DS4 */
+    state->Buttons = ReadButtons(packet + DS4_BUTTONS) & ~BUTTON(Misc1);
+    ReadSensors(packet + DS4_GYRO, packet + DS4_ACCEL, state);
+    ReadFingers(packet + DS4_TOUCH, DS4_TOUCHPAD_WIDTH, DS4_TOUCHPAD_HEIGHT, state);
+    return true;
+}
+
+static bool ParseDS5(const uint8_t* data, size_t size, NGP_GamePadState* state) {
+    const uint8_t* packet;
+    if (data[0] == 0x01 && size >= 1 + DS5_PACKET_SIZE) {
+        packet = data + 1;
+    } else if (data[0] == 0x31 && size >= 2 + DS5_PACKET_SIZE) {
+        packet = data + 2;
+    } else if (data[0] == 0x01 && size >= 1 + SHORT_PACKET_SIZE) {
+        ReadShortReport(data + 1, state);
+        return true;
+    } else {
+        return false;
+    }
+
+    ReadSticks(packet + DS5_LEFT_X, packet[DS5_TRIGGER_LEFT], packet[DS5_TRIGGER_RIGHT], state);
+    state->Buttons = ReadButtons(packet + DS5_BUTTONS);
+    ReadSensors(packet + DS5_GYRO, packet + DS5_ACCEL, state);
+    ReadFingers(packet + DS5_TOUCH, DS5_TOUCHPAD_WIDTH, DS5_TOUCHPAD_HEIGHT, state);
+    return true;
+}
+
+bool NGP_SonyParseReport(NGP_SonyModel     model,
+                         const uint8_t*    data,
+                         size_t            size,
+                         NGP_GamePadState* state) {
+    if (!data || size == 0) {
+        return false;
+    }
+    switch (model) {
+        case NGP_SonyModelDS4:
+            return ParseDS4(data, size, state);
+        case NGP_SonyModelDS5:
+            return ParseDS5(data, size, state);
+        default:
+            return false;
+    }
+}
+
+/* zlib's CRC-32, Bluetooth output reports end with one over a 0xa2 header byte and the report */
+static uint32_t Crc32(uint32_t crc, const uint8_t* data, size_t size) {
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xedb88320u & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+static void WriteBluetoothCrc(uint8_t* data, size_t size) {
+    static const uint8_t header = 0xa2;
+    uint32_t             crc    = Crc32(Crc32(0, &header, 1), data, size - 4);
+    data[size - 4]              = (uint8_t)crc;
+    data[size - 3]              = (uint8_t)(crc >> 8);
+    data[size - 2]              = (uint8_t)(crc >> 16);
+    data[size - 1]              = (uint8_t)(crc >> 24);
+}
+
+/* The motors and the light bar sit at different offsets on each pad but are encoded the same */
+static void WriteEffects(uint8_t* rumble, uint8_t* led, const NGP_DeviceOutput* output) {
+    rumble[0] = (uint8_t)(output->motors[NGP_HapticsMotorHigh] >> 8); /* the motors take 8 bits */
+    rumble[1] = (uint8_t)(output->motors[NGP_HapticsMotorLow] >> 8);
+    memcpy(led, output->led, sizeof(output->led));
+}
+
+static size_t EncodeDS4(bool bluetooth, const NGP_DeviceOutput* output, uint8_t* data) {
+    uint8_t flags = ((output->valid & NGP_OutputRumble) ? 0x01 : 0) |
+                    ((output->valid & NGP_OutputLED) ? 0x02 : 0);
+    size_t  size;
+    size_t  offset;
+    if (bluetooth) {
+        size    = DS4_BT_OUTPUT_SIZE;
+        offset  = 6;
+        data[0] = 0x11;
+        data[1] = 0xc0 | 0x04; /* HID report with CRC, 4 ms report interval */
+        data[3] = flags;
+    } else {
+        size    = DS4_USB_OUTPUT_SIZE;
+        offset  = 4;
+        data[0] = 0x05;
+        data[1] = flags;
+    }
+    WriteEffects(data + offset + DS4_RUMBLE, data + offset + DS4_LED, output);
+    return size;
+}
+
+static size_t EncodeDS5(bool bluetooth, const NGP_DeviceOutput* output, uint8_t* data) {
+    size_t size;
+    size_t offset;
+    if (bluetooth) {
+        size    = DS5_BT_OUTPUT_SIZE;
+        offset  = 2;
+        data[0] = 0x31;
+        data[1] = 0x02; /* HID output report tag */
+    } else {
+        size    = DS5_USB_OUTPUT_SIZE;
+        offset  = 1;
+        data[0] = 0x02;
+    }
+    uint8_t* effects = data + offset;
+    if (output->valid & NGP_OutputRumble) {
+        effects[DS5_ENABLE_BITS1] |= 0x01 | 0x02; /* classic rumble instead of audio haptics */
+    }
+    if (output->valid & NGP_OutputLED) {
+        effects[DS5_ENABLE_BITS2] |= 0x04;
+    }
+    WriteEffects(effects + DS5_RUMBLE, effects + DS5_LED, output);
+    return size;
+}
+
+size_t NGP_SonyEncodeOutput(NGP_SonyModel           model,
+                            bool                    bluetooth,
+                            const NGP_DeviceOutput* output,
+                            uint8_t*                data) {
+    size_t size;
+    memset(data, 0, NGP_SONY_OUTPUT_REPORT_LEN);
+    switch (model) {
+        case NGP_SonyModelDS4:
+            size = EncodeDS4(bluetooth, output, data);
+            break;
+        case NGP_SonyModelDS5:
+            size = EncodeDS5(bluetooth, output, data);
+            break;
+        default:
+            return 0;
+    }
+    if (bluetooth) {
+        WriteBluetoothCrc(data, size);
+    }
+    return size;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "NGP_Internal.h"
+#include "NGP_Output.h"
+
+#define NGP_SONY_TOUCHPAD_FINGERS 2
+#define NGP_SONY_OUTPUT_REPORT_LEN 78 /* the Bluetooth reports, the USB ones are shorter */
+
+typedef enum NGP_SonyModel {
+    NGP_SonyModelNone,
+    NGP_SonyModelDS4,
+    NGP_SonyModelDS5,
+} NGP_SonyModel;
+
+/**
+ * Decodes one DualShock 4 or DualSense input report into state. Handles the USB report (0x01), the
+ * full Bluetooth reports (0x11 on DS4, 0x31 on DS5) and the short Bluetooth report pads send
+ * before they are switched to full reports, which only carries sticks, triggers and buttons. Fields
+ * a report does not carry are left alone, as are Timestamp and Sequence.
+ *
+ * Never reads outside data, any byte string is safe to pass in.
+ * @param model
+ * @param data the report as read from the device, report id first
+ * @param size
+ * @param state
+ * @return false if the report is not an input report this model sends, state is untouched then
+ */
+bool NGP_SonyParseReport(NGP_SonyModel     model,
+                         const uint8_t*    data,
+                         size_t            size,
+                         NGP_GamePadState* state);
+
+/**
+ * Encodes the output report that sets a DualShock 4 or DualSense light bar and rumble motors to
+ * output. Only the parts set in output->valid are enabled, the pad keeps its own for the rest.
+ * @param model
+ * @param bluetooth whether to encode the Bluetooth report, which carries a CRC, or the USB one
+ * @param output
+ * @param data at least NGP_SONY_OUTPUT_REPORT_LEN bytes
+ * @return the size of the report, report id first, or 0 for NGP_SonyModelNone
+ */
+size_t NGP_SonyEncodeOutput(NGP_SonyModel           model,
+                            bool                    bluetooth,
+                            const NGP_DeviceOutput* output,
+                            uint8_t*                data);
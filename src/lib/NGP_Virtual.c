@@ -0,0 +1,526 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "NGP_CondVar.h"
+#include "NGP_Device.h"
+#include "NGP_Pool.h"
+#include "NGP_Runtime.h"
+
+#define NGP_VIRTUAL_SCRIPT_PADS 256
+#define NGP_VIRTUAL_SCRIPT_LINE 512
+
+typedef enum NGP_VirtualCommandType {
+    NGP_VirtualCommandCreate,
+    NGP_VirtualCommandDestroy,
+    NGP_VirtualCommandAxis,
+    NGP_VirtualCommandButton,
+    NGP_VirtualCommandFinger,
+    NGP_VirtualCommandSensor,
+    NGP_VirtualCommandCommit,
+} NGP_VirtualCommandType;
+
+typedef struct NGP_VirtualCommand {
+    NGP_VirtualCommandType type;
+    NGP_VirtualGamePad*    pad;
+    NGP_Timestamp          time;  /* when it was queued, set on the first command of each frame */
+    int                    index; /* the axis, button, finger or sensor */
+    union {
+        int16_t                value;
+        bool                   pressed;
+        NGP_GamePadStateFinger finger;
+        float                  data[3];
+    };
+} NGP_VirtualCommand;
+
+typedef struct NGP_VirtualCommandList {
+    NGP_VirtualCommand* commands;
+    size_t              count;
+    size_t              capacity;
+} NGP_VirtualCommandList;
+
+struct NGP_VirtualGamePad {
+    NGP_Device* device; /* everything below is only touched on the I/O thread */
+    const char* name; /* interned */
+    uint16_t    vendor_id;
+    uint16_t    product_id;
+    bool        changed; /* set since the last commit, the frame's report time is already set */
+    bool        queued;  /* the same for the commands queued so far, guarded by the lock */
+
+    NGP_VirtualGamePad* prev; /* every live pad, so shutting down can free the ones left over */
+    NGP_VirtualGamePad* next;
+};
+
+/*
+ * The virtual device source. Callers queue commands under the lock, the I/O thread swaps the queue
+ * out and applies it, so the I/O thread stays the only one touching device state and pushing
+ * events.
+ */
+typedef struct NGP_Virtual {
+    pthread_mutex_t        lock;
+    pthread_cond_t         queued_cond;  /* commands were queued, or Wake was called */
+    pthread_cond_t         applied_cond; /* applied moved forward */
+    NGP_VirtualCommandList queued;
+    NGP_VirtualCommandList applying;
+    uint64_t               submitted;
+    uint64_t               applied;
+    bool                   woken;
+    bool                   running;
+
+    NGP_VirtualGamePad* pads;
+} NGP_Virtual;
+
+static NGP_Virtual virtual = { .lock         = PTHREAD_MUTEX_INITIALIZER,
+                               .applied_cond = PTHREAD_COND_INITIALIZER };
+
+static pthread_once_t queued_cond_once = PTHREAD_ONCE_INIT;
+
+static void InitQueuedCond(void) { NGP_CondInit(&virtual.queued_cond); }
+
+static NGP_Pool pad_pool = NGP_POOL_INIT(NGP_VirtualGamePad, 64, NGP_MAX_GAMEPADS);
+
+static bool Submit(const NGP_VirtualCommand* command) {
+    pthread_mutex_lock(&virtual.lock);
+    NGP_VirtualCommandList* list = &virtual.queued;
+    if (!virtual.running) {
+        pthread_mutex_unlock(&virtual.lock);
+        return false;
+    }
+    if (list->count == list->capacity) {
+        size_t              capacity = list->capacity ? list->capacity * 2 : 256;
+        NGP_VirtualCommand* commands = NGP_Realloc(list->commands, capacity * sizeof(*commands));
+        if (!commands) {
+            pthread_mutex_unlock(&virtual.lock);
+            return false;
+        }
+        list->commands = commands;
+        list->capacity = capacity;
+    }
+    /* the frame's report time, one clock read per frame rather than per change */
+    list->commands[list->count] = *command;
+    if (!command->pad->queued) {
+        list->commands[list->count].time = NGP_GetTicksNS();
+    }
+    command->pad->queued = command->type != NGP_VirtualCommandCreate &&
+                           command->type != NGP_VirtualCommandCommit;
+    list->count++;
+    virtual.submitted++;
+    pthread_cond_signal(&virtual.queued_cond);
+    pthread_mutex_unlock(&virtual.lock);
+    return true;
+}
+
+static void CreatePad(NGP_VirtualGamePad* pad) {
+    pad->next = virtual.pads;
+    pad->prev = NULL;
+    if (virtual.pads) {
+        virtual.pads->prev = pad;
+    }
+    virtual.pads = pad;
+
+    NGP_Device* device = NGP_DeviceAcquire();
+    if (!device) {
+        return; /* out of records, the pad's commands are ignored */
+    }
+    device->name       = pad->name;
+    device->bus        = NGP_HARDWARE_BUS_VIRTUAL;
+    device->vendor_id  = pad->vendor_id;
+    device->product_id = pad->product_id;
+    device->touchpads  = 1;
+    device->backend    = pad;
+    NGP_DeviceMakeGUID(device);
+    NGP_DeviceBeginReport(device, NGP_GetTicksNS());
+    NGP_DevicePublish(device);
+    if (!NGP_DeviceAttach(device)) {
+        NGP_DeviceRelease(device);
+        return;
+    }
+    pad->device = device;
+}
+
+static void DestroyPad(NGP_VirtualGamePad* pad) {
+    if (pad->device) {
+        NGP_DeviceRelease(pad->device);
+    }
+    if (pad->prev) {
+        pad->prev->next = pad->next;
+    } else {
+        virtual.pads = pad->next;
+    }
+    if (pad->next) {
+        pad->next->prev = pad->prev;
+    }
+    NGP_PoolFree(&pad_pool, pad);
+}
+
+static void Apply(const NGP_VirtualCommand* command) {
+    NGP_VirtualGamePad* pad    = command->pad;
+    NGP_Device*         device = pad->device;
+    switch (command->type) {
+        case NGP_VirtualCommandCreate:
+            CreatePad(pad);
+            return;
+        case NGP_VirtualCommandDestroy:
+            DestroyPad(pad);
+            return;
+        default:
+            break;
+    }
+    if (!device) {
+        return;
+    }
+    if (!pad->changed) {
+        NGP_DeviceBeginReport(device, command->time);
+        pad->changed = true;
+    }
+    switch (command->type) {
+        case NGP_VirtualCommandAxis:
+            NGP_DeviceSetAxis(device, (NGP_GamePadAxisType)command->index, command->value);
+            break;
+        case NGP_VirtualCommandButton:
+            NGP_DeviceSetButton(device, (NGP_GamePadButtonType)command->index, command->pressed);
+            break;
+        case NGP_VirtualCommandFinger:
+            NGP_DeviceSetFinger(device, command->index, &command->finger);
+            break;
+        case NGP_VirtualCommandSensor:
+            NGP_DeviceSetSensor(device, (NGP_GamePadSensorType)command->index, command->data);
+            break;
+        case NGP_VirtualCommandCommit:
+            NGP_DevicePublish(device);
+            pad->changed = false;
+            break;
+        default:
+            break;
+    }
+}
+
+/* Applies whatever is queued, returns false if there was nothing */
+static bool ApplyQueued(void) {
+    NGP_VirtualCommandList list = virtual.queued;
+    virtual.queued              = virtual.applying;
+    virtual.queued.count        = 0;
+    virtual.applying            = list;
+    if (list.count == 0) {
+        return false;
+    }
+
+    pthread_mutex_unlock(&virtual.lock);
+    for (size_t i = 0; i < list.count; i++) {
+        Apply(&list.commands[i]);
+    }
+    pthread_mutex_lock(&virtual.lock);
+
+    virtual.applied += list.count;
+    pthread_cond_broadcast(&virtual.applied_cond);
+    return true;
+}
+
+static bool VirtualSetup(void* userdata) {
+    (void)userdata;
+    pthread_once(&queued_cond_once, InitQueuedCond); /* nothing signals it before running is set */
+    pthread_mutex_lock(&virtual.lock);
+    virtual.running = true;
+    virtual.woken   = false;
+    pthread_mutex_unlock(&virtual.lock);
+    return true;
+}
+
+static bool VirtualOpen(void* userdata) {
+    (void)userdata;
+    return true;
+}
+
+static void VirtualPump(void* userdata, int timeout_ms) {
+    (void)userdata;
+    pthread_mutex_lock(&virtual.lock);
+    if (virtual.queued.count == 0 && !virtual.woken) {
+        if (timeout_ms < 0) {
+            pthread_cond_wait(&virtual.queued_cond, &virtual.lock);
+        } else {
+            NGP_CondWaitUntil(&virtual.queued_cond, &virtual.lock,
+                              NGP_GetTicksNS() + (NGP_Timestamp)timeout_ms * 1000000LL);
+        }
+    }
+    virtual.woken = false;
+    ApplyQueued();
+    pthread_mutex_unlock(&virtual.lock);
+}
+
+static void VirtualWake(void* userdata) {
+    (void)userdata;
+    pthread_mutex_lock(&virtual.lock);
+    virtual.woken = true;
+    pthread_cond_signal(&virtual.queued_cond);
+    pthread_mutex_unlock(&virtual.lock);
+}
+
+static void VirtualClose(void* userdata) {
+    (void)userdata;
+    pthread_mutex_lock(&virtual.lock);
+    virtual.running = false;
+    while (ApplyQueued()) {
+        /* frees pads destroyed just before shutting down */
+    }
+    pthread_mutex_unlock(&virtual.lock);
+
+    while (virtual.pads) {
+        DestroyPad(virtual.pads);
+    }
+
+    pthread_mutex_lock(&virtual.lock);
+    for (int i = 0; i < 2; i++) {
+        NGP_VirtualCommandList* list = i ? &virtual.applying : &virtual.queued;
+        NGP_Free(list->commands);
+        memset(list, 0, sizeof(*list));
+    }
+    virtual.applied = virtual.submitted;
+    pthread_cond_broadcast(&virtual.applied_cond);
+    pthread_mutex_unlock(&virtual.lock);
+}
+
+static const NGP_DeviceSource virtual_source = {
+    .name  = "virtual",
+    .Setup = VirtualSetup,
+    .Open  = VirtualOpen,
+    .Pump  = VirtualPump,
+    .Wake  = VirtualWake,
+    .Close = VirtualClose,
+};
+
+DECLSPEC bool NGPCALL NGP_InitializeVirtual(void) {
+    if (NGP_RuntimeIsRunning()) {
+        return false;
+    }
+    if (!NGP_RuntimeStart(&virtual_source)) {
+        pthread_mutex_lock(&virtual.lock);
+        virtual.running = false;
+        pthread_mutex_unlock(&virtual.lock);
+        return false;
+    }
+    return true;
+}
+
+DECLSPEC NGP_VirtualGamePad* NGPCALL NGP_VirtualGamePadCreate(const char* name,
+                                                              uint16_t    vendor_id,
+                                                              uint16_t    product_id) {
+    NGP_VirtualGamePad* pad = NGP_PoolAlloc(&pad_pool);
+    if (!pad) {
+        return NULL;
+    }
+    pad->name       = NGP_Intern(name ? name : "Virtual Game Pad");
+    pad->vendor_id  = vendor_id;
+    pad->product_id = product_id;
+
+    NGP_VirtualCommand command = { .type = NGP_VirtualCommandCreate, .pad = pad };
+    if (!Submit(&command)) {
+        NGP_PoolFree(&pad_pool, pad);
+        return NULL;
+    }
+    return pad;
+}
+
+DECLSPEC void NGPCALL NGP_VirtualGamePadDestroy(NGP_VirtualGamePad* pad) {
+    NGP_VirtualCommand command = { .type = NGP_VirtualCommandDestroy, .pad = pad };
+    if (pad) {
+        Submit(&command);
+    }
+}
+
+DECLSPEC void NGPCALL NGP_VirtualGamePadSetAxis(NGP_VirtualGamePad* pad,
+                                                NGP_GamePadAxisType axis,
+                                                int16_t             value) {
+    NGP_VirtualCommand command = { .type = NGP_VirtualCommandAxis, .pad = pad, .index = axis };
+    command.value              = value;
+    if (pad && axis >= NGP_GamePadAxisTypeLeftX && axis < NGP_GamePadAxisTypeMax) {
+        Submit(&command);
+    }
+}
+
+DECLSPEC void NGPCALL NGP_VirtualGamePadSetButton(NGP_VirtualGamePad*   pad,
+                                                  NGP_GamePadButtonType button,
+                                                  bool                  pressed) {
+    NGP_VirtualCommand command = { .type = NGP_VirtualCommandButton, .pad = pad, .index = button };
+    command.pressed            = pressed;
+    if (pad && button > NGP_GamePadButtonInvalid && button < NGP_GamePadButtonMax) {
+        Submit(&command);
+    }
+}
+
+DECLSPEC void NGPCALL NGP_VirtualGamePadSetFinger(NGP_VirtualGamePad* pad,
+                                                  int                 finger,
+                                                  bool                down,
+                                                  float               x,
+                                                  float               y,
+                                                  float               pressure) {
+    NGP_VirtualCommand command = { .type = NGP_VirtualCommandFinger, .pad = pad, .index = finger };
+    command.finger.X           = x;
+    command.finger.Y           = y;
+    command.finger.Pressure    = down ? pressure : 0.0f;
+    command.finger.State       = down;
+    command.finger.ID          = (uint8_t)finger;
+    if (pad && finger >= 0 && finger < NGP_MAX_TOUCHPAD_FINGERS) {
+        Submit(&command);
+    }
+}
+
+DECLSPEC void NGPCALL NGP_VirtualGamePadSetSensor(NGP_VirtualGamePad*   pad,
+                                                  NGP_GamePadSensorType sensor,
+                                                  const float           data[3]) {
+    NGP_VirtualCommand command = { .type = NGP_VirtualCommandSensor, .pad = pad, .index = sensor };
+    if (pad && data) {
+        memcpy(command.data, data, sizeof(command.data));
+        Submit(&command);
+    }
+}
+
+DECLSPEC void NGPCALL NGP_VirtualGamePadCommit(NGP_VirtualGamePad* pad) {
+    NGP_VirtualCommand command = { .type = NGP_VirtualCommandCommit, .pad = pad };
+    if (pad) {
+        Submit(&command);
+    }
+}
+
+DECLSPEC void NGPCALL NGP_VirtualSync(void) {
+    pthread_mutex_lock(&virtual.lock);
+    uint64_t target = virtual.submitted;
+    while (virtual.running && virtual.applied < target) {
+        pthread_cond_wait(&virtual.applied_cond, &virtual.lock);
+    }
+    pthread_mutex_unlock(&virtual.lock);
+}
+
+/* Script runner */
+
+static const char* const axis_names[NGP_GamePadAxisTypeMax] = {
+    "leftx", "lefty", "rightx", "righty", "lefttrigger", "righttrigger",
+};
+
+static int ParseAxis(const char* name) {
+    for (int axis = 0; axis < NGP_GamePadAxisTypeMax; axis++) {
+        if (strcmp(name, axis_names[axis]) == 0) {
+            return axis;
+        }
+    }
+    return -1;
+}
+
+static int ParseButton(const char* name) {
+    for (int button = 0; button < NGP_GamePadButtonMax; button++) {
+        if (strcmp(name, NGP_GamePadButtonName((NGP_GamePadButtonType)button)) == 0) {
+            return button;
+        }
+    }
+    return -1;
+}
+
+static bool ParsePad(const char* arg, NGP_VirtualGamePad** pads, int* index) {
+    char* end;
+    long  value = strtol(arg, &end, 10);
+    if (*arg == '\0' || *end != '\0' || value < 0 || value >= NGP_VIRTUAL_SCRIPT_PADS) {
+        return false;
+    }
+    *index = (int)value;
+    return pads == NULL || pads[value] != NULL;
+}
+
+/* Runs one tokenized line, returns false if it is malformed or refers to a pad that is not there */
+static bool RunLine(char** args, int count, NGP_VirtualGamePad** pads) {
+    const char* command = args[0];
+    int         pad;
+    if (strcmp(command, "sync") == 0 && count == 1) {
+        NGP_VirtualSync();
+        return true;
+    }
+    if (strcmp(command, "wait") == 0 && count == 2) {
+        long            ms = strtol(args[1], NULL, 10);
+        struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+        nanosleep(&ts, NULL);
+        return ms >= 0;
+    }
+    if (strcmp(command, "create") == 0 && count >= 2) {
+        if (!ParsePad(args[1], NULL, &pad) || pads[pad]) {
+            return false;
+        }
+        pads[pad] = NGP_VirtualGamePadCreate(count >= 3 ? args[2] : NULL, 0, 0);
+        return pads[pad] != NULL;
+    }
+    if (count < 2 || !ParsePad(args[1], pads, &pad)) {
+        return false;
+    }
+
+    if (strcmp(command, "destroy") == 0 && count == 2) {
+        NGP_VirtualGamePadDestroy(pads[pad]);
+        pads[pad] = NULL;
+    } else if (strcmp(command, "commit") == 0 && count == 2) {
+        NGP_VirtualGamePadCommit(pads[pad]);
+    } else if (strcmp(command, "axis") == 0 && count == 4) {
+        int axis = ParseAxis(args[2]);
+        if (axis < 0) {
+            return false;
+        }
+        NGP_VirtualGamePadSetAxis(pads[pad], (NGP_GamePadAxisType)axis,
+                                  (int16_t)strtol(args[3], NULL, 10));
+    } else if (strcmp(command, "button") == 0 && count == 4) {
+        int button = ParseButton(args[2]);
+        if (button < 0) {
+            return false;
+        }
+        NGP_VirtualGamePadSetButton(pads[pad], (NGP_GamePadButtonType)button, atoi(args[3]) != 0);
+    } else if (strcmp(command, "touch") == 0 && (count == 6 || count == 7)) {
+        bool down = atoi(args[3]) != 0;
+        NGP_VirtualGamePadSetFinger(pads[pad], atoi(args[2]), down, strtof(args[4], NULL),
+                                    strtof(args[5], NULL),
+                                    count == 7 ? strtof(args[6], NULL) : 1.0f);
+    } else if (strcmp(command, "sensor") == 0 && count == 6) {
+        float data[3] = { strtof(args[3], NULL), strtof(args[4], NULL), strtof(args[5], NULL) };
+        if (strcmp(args[2], "accel") == 0) {
+            NGP_VirtualGamePadSetSensor(pads[pad], NGP_GamePadSensorAccelerometer, data);
+        } else if (strcmp(args[2], "gyro") == 0) {
+            NGP_VirtualGamePadSetSensor(pads[pad], NGP_GamePadSensorGyroscope, data);
+        } else {
+            return false;
+        }
+    } else {
+        return false;
+    }
+    return true;
+}
+
+DECLSPEC int NGPCALL NGP_VirtualRunScript(const char* script) {
+    NGP_VirtualGamePad* pads[NGP_VIRTUAL_SCRIPT_PADS] = { 0 };
+    int                 line_number              = 0;
+
+    while (script && *script) {
+        char        line[NGP_VIRTUAL_SCRIPT_LINE];
+        const char* end = strchr(script, '\n');
+        size_t      len = end ? (size_t)(end - script) : strlen(script);
+        line_number++;
+        if (len >= sizeof(line)) {
+            return line_number;
+        }
+        memcpy(line, script, len);
+        line[len] = '\0';
+        script += len + (end ? 1 : 0);
+
+        char* args[8];
+        int   count = 0;
+        char* save;
+        char* token = strtok_r(line, " \t\r", &save);
+        for (; token; token = strtok_r(NULL, " \t\r", &save)) {
+            if (count == 8) {
+                return line_number;
+            }
+            args[count++] = token;
+        }
+        if (count == 0 || args[0][0] == '#') {
+            continue;
+        }
+        if (!RunLine(args, count, pads)) {
+            return line_number;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <dirent.h>
+#include <string.h>
+
+#include "NGP_SonyReport.h"
+#include "NGP_Test.h"
+
+/*
+ * Fuzz harness for NGP_SonyParseReport. The first input byte picks the model, the rest is the
+ * report. Built with -fsanitize=fuzzer (NGP_BUILD_FUZZERS) libFuzzer drives it, otherwise main
+ * below replays a corpus directory along with every truncation and single bit flip of each file.
+ */
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    NGP_GamePadState state, before;
+    memset(&before, 0x5a, sizeof(before));
+    state = before;
+    if (!NGP_SonyParseReport((NGP_SonyModel)(data[0] % 3), data + 1, size - 1, &state)) {
+        NGP_CHECK(memcmp(&state, &before, sizeof(state)) == 0);
+        return 0;
+    }
+    /* Sony pads have no paddles */
+    const uint32_t paddles = (1u << NGP_GamePadButtonTouchpad) - (1u << NGP_GamePadButtonPaddle1);
+    NGP_CHECK((state.Buttons & paddles) == 0 && state.Buttons < 1u << NGP_GamePadButtonMax);
+    for (int i = 0; i < NGP_SONY_TOUCHPAD_FINGERS; i++) {
+        const NGP_GamePadStateFinger* finger = &state.Fingers[i];
+        if (memcmp(finger, &before.Fingers[i], sizeof(*finger)) != 0) { /* not in short reports */
+            NGP_CHECK(finger->X >= 0.0f && finger->X <= 4095 / 1920.0f);
+            NGP_CHECK(finger->Y >= 0.0f && finger->Y <= 4095 / 920.0f);
+            NGP_CHECK(finger->Pressure == (finger->State ? 1.0f : 0.0f));
+        }
+    }
+    return 0;
+}
+
+#ifndef NGP_FUZZ_LIBFUZZER
+
+#define MAX_INPUT_SIZE 256
+
+/* Each input is copied to a buffer of exactly its size, so a sanitizer build catches over reads */
+static void Run(const uint8_t* data, size_t size) {
+    uint8_t* copy = malloc(size ? size : 1);
+    NGP_CHECK(copy != NULL);
+    memcpy(copy, data, size);
+    LLVMFuzzerTestOneInput(copy, size);
+    free(copy);
+}
+
+static size_t RunFile(const char* dir, const char* name) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE* file = fopen(path, "rb");
+    NGP_CHECK(file != NULL);
+    uint8_t data[MAX_INPUT_SIZE];
+    size_t  size = fread(data, 1, sizeof(data), file);
+    fclose(file);
+
+    for (size_t length = 0; length <= size; length++) {
+        Run(data, length);
+    }
+    for (size_t bit = 8; bit < size * 8; bit++) { /* the model byte is left alone */
+        data[bit / 8] ^= (uint8_t)(1u << bit % 8);
+        Run(data, size);
+        data[bit / 8] ^= (uint8_t)(1u << bit % 8);
+    }
+    return size;
+}
+
+/* Usage: fuzz_sony_report <corpus directory> */
+int main(int argc, char** argv) {
+    NGP_CHECK(argc == 2);
+    DIR* dir = opendir(argv[1]);
+    NGP_CHECK(dir != NULL);
+    int            files = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] != '.') {
+            NGP_CHECK(RunFile(argv[1], entry->d_name) > 0);
+            files++;
+        }
+    }
+    closedir(dir);
+    NGP_CHECK(files > 0);
+
+    /* and inputs no corpus file is near, every size and model with random bytes */
+    uint8_t  data[MAX_INPUT_SIZE];
+    uint32_t seed = 12345;
+    for (int i = 0; i < 100000; i++) {
+        size_t size = (size_t)i % 96;
+        for (size_t b = 0; b < size; b++) {
+            seed    = seed * 1664525u + 1013904223u;
+            data[b] = (uint8_t)(seed >> 24);
+        }
+        if (size > 1 && i % 2) {
+            static const uint8_t ids[] = { 0x01, 0x11, 0x31 };
+            data[1] = ids[i % 3]; /* a known report id, so the layouts are reached */
+        }
+        Run(data, size);
+    }
+    return 0;
+}
+
+#endif
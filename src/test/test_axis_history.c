@@ -0,0 +1,170 @@
+#include <math.h>
+#include <string.h>
+
+#include "NGP_AxisHistory.h"
+#include "NGP_Test.h"
+
+#define MS 1000000LL
+#define BASE (1000 * MS) /* traces start a second in, so nothing sits at time 0 */
+
+/* One report of a recorded trace, an evdev pad only reports when something changed */
+typedef struct Report {
+    int     ms;
+    int16_t x;       /* LeftX */
+    int16_t trigger; /* TriggerRight */
+} Report;
+
+/* A flick of the left stick to its edge with the right trigger squeezed along, at 250 Hz */
+static const Report flick[] = {
+    { 0, 0, 0 },          { 4, 2100, 1000 },     { 8, 6400, 4000 },
+    { 12, 12800, 9000 },  { 16, 19500, 16000 },  { 20, 25600, 24000 },
+    { 24, 30100, 30000 }, { 28, 32767, 32767 },
+};
+
+static NGP_AxisHistory history;
+
+static void Push(NGP_Timestamp time, int16_t x, int16_t trigger) {
+    NGP_GamePadState state;
+    memset(&state, 0, sizeof(state));
+    state.Timestamp                             = time;
+    state.Axes[NGP_GamePadAxisTypeLeftX]        = x;
+    state.Axes[NGP_GamePadAxisTypeTriggerRight] = trigger;
+    NGP_AxisHistoryPush(&history, &state);
+}
+
+/* Starts a fresh history with the trace's first reports */
+static void Replay(const Report* trace, int reports) {
+    memset(&history, 0, sizeof(history));
+    for (int i = 0; i < reports; i++) {
+        Push(BASE + trace[i].ms * MS, trace[i].x, trace[i].trigger);
+    }
+}
+
+static float X(NGP_Timestamp target, NGP_Timestamp now) {
+    return NGP_AxisHistorySample(&history, NGP_GamePadAxisTypeLeftX, target, now);
+}
+
+static float Trigger(NGP_Timestamp target, NGP_Timestamp now) {
+    return NGP_AxisHistorySample(&history, NGP_GamePadAxisTypeTriggerRight, target, now);
+}
+
+static bool Near(float a, float b) { return fabsf(a - b) < 0.5f; }
+
+static void TestInterpolation(void) {
+    memset(&history, 0, sizeof(history));
+    NGP_CHECK(X(BASE, BASE) == 0.0f); /* no reports */
+
+    Replay(flick, 8);
+    NGP_Timestamp now = BASE + 28 * MS;
+    for (int i = 0; i < 8; i++) {
+        NGP_CHECK(X(BASE + flick[i].ms * MS, now) == flick[i].x);
+    }
+    NGP_CHECK(Near(X(BASE + 6 * MS, now), 4250.0f));
+    NGP_CHECK(Near(X(BASE + 9 * MS, now), 8000.0f));
+    NGP_CHECK(Near(Trigger(BASE + 14 * MS, now), 12500.0f));
+    NGP_CHECK(X(BASE - 10 * MS, now) == 0.0f); /* before the first report */
+
+    /* a long trace only keeps the newest reports, before them is the oldest kept value */
+    memset(&history, 0, sizeof(history));
+    for (int i = 0; i < NGP_AXIS_HISTORY + 4; i++) {
+        Push(BASE + i * 4 * MS, (int16_t)(i * 100), 0);
+    }
+    now = BASE + (NGP_AXIS_HISTORY + 3) * 4 * MS;
+    NGP_CHECK(X(BASE, now) == 400.0f);
+    NGP_CHECK(Near(X(BASE + 18 * MS, now), 450.0f));
+
+    /* a second report with the same time replaces the first, a clock that went back starts over */
+    Replay(flick, 3);
+    Push(BASE + 8 * MS, 7000, 0);
+    NGP_CHECK(history.count == 3 && X(BASE + 8 * MS, BASE + 8 * MS) == 7000.0f);
+    Push(BASE, 500, 0);
+    NGP_CHECK(history.count == 1 && X(BASE + 4 * MS, BASE + 4 * MS) == 500.0f);
+}
+
+static void TestPrediction(void) {
+    /* along the slope of the last two reports */
+    Replay(flick, 6);
+    NGP_Timestamp newest = BASE + 20 * MS;
+    NGP_CHECK(Near(X(newest + 4 * MS, newest + MS), 31700.0f));
+    NGP_CHECK(Near(Trigger(newest + 2 * MS, newest + MS), 28000.0f));
+
+    /* no farther than NGP_AXIS_PREDICT_MAX_NS */
+    static const Report slow[] = { { 0, 0, 0 }, { 4, 400, 400 } };
+    Replay(slow, 2);
+    newest = BASE + 4 * MS;
+    float capped = 400.0f + 100.0f * (float)(NGP_AXIS_PREDICT_MAX_NS / MS);
+    NGP_CHECK(Near(X(newest + 100 * MS, newest + MS), capped));
+    NGP_CHECK(Near(X(newest + NGP_AXIS_PREDICT_MAX_NS, newest + MS), capped));
+
+    /* and within the axis' range, triggers never go below 0 */
+    static const Report falling[] = { { 0, -30000, 1000 }, { 4, -32000, 200 } };
+    Replay(falling, 2);
+    NGP_CHECK(X(newest + 8 * MS, newest + MS) == -32768.0f);
+    NGP_CHECK(Trigger(newest + 8 * MS, newest + MS) == 0.0f);
+    Replay(flick, 8);
+    newest = BASE + 28 * MS;
+    NGP_CHECK(X(newest + 8 * MS, newest + MS) == 32767.0f);
+}
+
+/* A pad that stopped reporting has stopped moving, evdev sends nothing for a still stick */
+static void TestQuiet(void) {
+    Replay(flick, 6);
+    NGP_Timestamp newest = BASE + 20 * MS;
+    NGP_CHECK(X(newest + 4 * MS, newest + 8 * MS) > 25600.0f); /* two intervals, still moving */
+    NGP_CHECK(X(newest + 4 * MS, newest + 9 * MS) == 25600.0f);
+    NGP_CHECK(X(newest + 40 * MS, newest + 40 * MS) == 25600.0f);
+
+    Replay(flick, 1);
+    NGP_CHECK(X(BASE + 4 * MS, BASE + MS) == 0.0f); /* one report has no slope */
+}
+
+/*
+ * A stick swept back and forth at 2 Hz, reported at 250 Hz with the timing wobble of a USB pad.
+ * Predicting a frame's worth ahead must beat holding the last report by far and stay within a few
+ * hundred of the real position, looking back must be all but exact.
+ */
+static void TestErrorBound(void) {
+    static const int wobble[] = { 0, 310, -240, 120, -400, 50, 270, -130 }; /* microseconds */
+    const double     amplitude = 20000.0;
+    const double     omega     = 2.0 * 3.14159265358979 * 2.0;
+    memset(&history, 0, sizeof(history));
+
+    double predicted         = 0.0; /* summed errors */
+    double held              = 0.0;
+    double worst_predicted   = 0.0;
+    double worst_looked_back = 0.0;
+    int    predictions       = 0;
+    for (int i = 0; i < 250; i++) {
+        NGP_Timestamp time = BASE + i * 4 * MS + wobble[i % 8] * 1000LL;
+        int16_t       x    = (int16_t)lrint(amplitude * sin(omega * (double)(time - BASE) / 1e9));
+        Push(time, x, 0);
+        if (i < 2) {
+            continue;
+        }
+        NGP_Timestamp target = time + 8 * MS;
+        double        truth  = amplitude * sin(omega * (double)(target - BASE) / 1e9);
+        double        error  = fabs(X(target, time + MS) - truth);
+        worst_predicted      = error > worst_predicted ? error : worst_predicted;
+        predicted += error;
+        held += fabs(x - truth);
+        predictions++;
+
+        NGP_Timestamp back = time - 6 * MS;
+        truth              = amplitude * sin(omega * (double)(back - BASE) / 1e9);
+        error              = fabs(X(back, time) - truth);
+        worst_looked_back  = error > worst_looked_back ? error : worst_looked_back;
+    }
+    printf("axis history error: predicted %.0f, worst %.0f, held %.0f, looked back worst %.0f\n",
+           predicted / predictions, worst_predicted, held / predictions, worst_looked_back);
+    NGP_CHECK(worst_predicted < 400.0);
+    NGP_CHECK(predicted < held / 4.0);
+    NGP_CHECK(worst_looked_back < 40.0);
+}
+
+int main(void) {
+    TestInterpolation();
+    TestPrediction();
+    TestQuiet();
+    TestErrorBound();
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include "NGP_Device.h"
+#include "NGP_Test.h"
+
+#define A NGP_BUTTON_MASK(NGP_GamePadButtonA)
+#define B NGP_BUTTON_MASK(NGP_GamePadButtonB)
+#define L1 NGP_BUTTON_MASK(NGP_GamePadButtonLeftShoulder)
+#define R1 NGP_BUTTON_MASK(NGP_GamePadButtonRightShoulder)
+
+static NGP_VirtualGamePad* pad;
+static NGP_GamePad*        gp;
+
+/* One report from the pad, the I/O thread has handled it once this returns */
+static void Report(NGP_GamePadButtonType button, bool down) {
+    NGP_VirtualGamePadSetButton(pad, button, down);
+    NGP_VirtualGamePadCommit(pad);
+    NGP_VirtualSync();
+}
+
+/* Ends the frame, the masks then hold what happened since the last one */
+static uint32_t Frame(void) { return NGP_GamePadButtons(gp); }
+
+static void TestHeld(void) {
+    NGP_CHECK(Frame() == 0);
+    Report(NGP_GamePadButtonA, true);
+    NGP_CHECK(Frame() == A);
+    NGP_CHECK(NGP_GamePadButtonsPressed(gp) == A && NGP_GamePadButtonsReleased(gp) == 0);
+    NGP_CHECK(Frame() == A); /* still held, no new edge */
+    NGP_CHECK(NGP_GamePadButtonsPressed(gp) == 0 && NGP_GamePadButtonsReleased(gp) == 0);
+    Report(NGP_GamePadButtonA, false);
+    NGP_CHECK(Frame() == 0);
+    NGP_CHECK(NGP_GamePadButtonsPressed(gp) == 0 && NGP_GamePadButtonsReleased(gp) == A);
+    NGP_CHECK(Frame() == 0);
+    NGP_CHECK(NGP_GamePadButtonsReleased(gp) == 0);
+}
+
+/* A tap quicker than a frame is never seen held, its edges still are */
+static void TestTapWithinFrame(void) {
+    Report(NGP_GamePadButtonB, true);
+    Report(NGP_GamePadButtonB, false);
+    NGP_CHECK(Frame() == 0);
+    NGP_CHECK(NGP_GamePadButtonsPressed(gp) == B && NGP_GamePadButtonsReleased(gp) == B);
+    NGP_CHECK(Frame() == 0);
+    NGP_CHECK(NGP_GamePadButtonsPressed(gp) == 0 && NGP_GamePadButtonsReleased(gp) == 0);
+
+    /* and the other way round, let go and pressed again while held */
+    Report(NGP_GamePadButtonA, true);
+    NGP_CHECK(Frame() == A);
+    Report(NGP_GamePadButtonA, false);
+    Report(NGP_GamePadButtonA, true);
+    NGP_CHECK(Frame() == A);
+    NGP_CHECK(NGP_GamePadButtonsPressed(gp) == A && NGP_GamePadButtonsReleased(gp) == A);
+    Report(NGP_GamePadButtonA, false);
+    Frame();
+}
+
+/* A chord fires on the frame its last button goes down, once, whichever order they went in */
+static void TestChord(void) {
+    Report(NGP_GamePadButtonLeftShoulder, true);
+    Frame();
+    NGP_CHECK(!NGP_GamePadChordPressed(gp, L1 | R1));
+    Report(NGP_GamePadButtonRightShoulder, true);
+    NGP_CHECK(Frame() == (L1 | R1));
+    NGP_CHECK(NGP_GamePadChordPressed(gp, L1 | R1));
+    NGP_CHECK(NGP_GamePadChordPressed(gp, R1) && !NGP_GamePadChordPressed(gp, L1));
+    Frame();
+    NGP_CHECK(!NGP_GamePadChordPressed(gp, L1 | R1)); /* still held, not made again */
+
+    /* an unrelated button going down does not make it again */
+    Report(NGP_GamePadButtonA, true);
+    Frame();
+    NGP_CHECK(!NGP_GamePadChordPressed(gp, L1 | R1) && NGP_GamePadChordPressed(gp, A));
+
+    /* letting one go and pressing it again does */
+    Report(NGP_GamePadButtonLeftShoulder, false);
+    Frame();
+    NGP_CHECK(!NGP_GamePadChordPressed(gp, L1 | R1));
+    Report(NGP_GamePadButtonLeftShoulder, true);
+    Frame();
+    NGP_CHECK(NGP_GamePadChordPressed(gp, L1 | R1));
+    NGP_CHECK(!NGP_GamePadChordPressed(gp, 0));
+
+    /* both down in one frame */
+    Report(NGP_GamePadButtonLeftShoulder, false);
+    Report(NGP_GamePadButtonRightShoulder, false);
+    Frame();
+    Report(NGP_GamePadButtonLeftShoulder, true);
+    Report(NGP_GamePadButtonRightShoulder, true);
+    Frame();
+    NGP_CHECK(NGP_GamePadChordPressed(gp, L1 | R1));
+}
+
+/* Unplugging lets go of everything held, once */
+static void TestDetach(void) {
+    NGP_CHECK(Frame() == (A | L1 | R1));
+    NGP_VirtualGamePadDestroy(pad);
+    NGP_VirtualSync();
+    NGP_CHECK(Frame() == 0);
+    NGP_CHECK(NGP_GamePadButtonsPressed(gp) == 0);
+    NGP_CHECK(NGP_GamePadButtonsReleased(gp) == (A | L1 | R1));
+    NGP_CHECK(Frame() == 0);
+    NGP_CHECK(NGP_GamePadButtonsReleased(gp) == 0);
+}
+
+int main(void) {
+    NGP_CHECK(NGP_InitializeVirtual());
+    pad = NGP_VirtualGamePadCreate("Test Pad", 0, 0);
+    NGP_CHECK(pad != NULL);
+    NGP_VirtualSync();
+    gp = NGP_GamePadOpen(0);
+    NGP_CHECK(gp != NULL);
+
+    TestHeld();
+    TestTapWithinFrame();
+    TestChord();
+    TestDetach();
+
+    NGP_GamePadFree(gp);
+    NGP_Shutdown();
+    return 0;
+}
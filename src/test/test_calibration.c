@@ -0,0 +1,261 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "NGP_Device.h"
+#include "NGP_Test.h"
+
+#define LX NGP_GamePadAxisTypeLeftX
+#define LY NGP_GamePadAxisTypeLeftY
+#define LT NGP_GamePadAxisTypeTriggerLeft
+#define FILE_NAME "test_calibration.txt"
+
+static NGP_VirtualGamePad* pad;
+static NGP_GamePad*        gp;
+
+static void Sleep(int ms) {
+    struct timespec ts = { 0, ms * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+/* One report moving an axis to a raw value, the I/O thread has handled it once this returns */
+static int16_t Report(NGP_GamePadAxisType axis, int16_t raw) {
+    NGP_VirtualGamePadSetAxis(pad, axis, raw);
+    NGP_VirtualGamePadCommit(pad);
+    NGP_VirtualSync();
+    return NGP_GamePadAxis(gp, axis);
+}
+
+/* A report after the rebuild interval, so a range that grew since is in the table */
+static int16_t ReportRebuilt(NGP_GamePadAxisType axis, int16_t raw) {
+    Sleep((int)(NGP_CALIBRATION_REBUILD_NS / 1000000) + 10);
+    return Report(axis, raw);
+}
+
+static NGP_AxisCalibration Range(NGP_GamePadAxisType axis) {
+    NGP_AxisCalibration range;
+    NGP_CHECK(NGP_GamePadGetAxisCalibration(gp, axis, &range));
+    return range;
+}
+
+static bool RangeIs(NGP_GamePadAxisType axis, int min, int center, int max) {
+    NGP_AxisCalibration range = Range(axis);
+    return range.Min == min && range.Center == center && range.Max == max;
+}
+
+static bool IsDefault(void) {
+    int extent = NGP_CALIBRATION_EXTENT;
+    return RangeIs(LX, -extent, 0, extent) && RangeIs(LY, -extent, 0, extent) &&
+           RangeIs(LT, 0, 0, extent);
+}
+
+/* Until an axis reaches further it reads full at 3/4, then its range grows to what it reached */
+static void CheckLearnRange(void) {
+    NGP_CHECK(IsDefault());
+    NGP_CHECK(Report(LX, NGP_CALIBRATION_EXTENT) == 32767);
+    NGP_CHECK(Report(LX, NGP_CALIBRATION_EXTENT / 2) == 16384);
+    NGP_CHECK(Report(LX, -NGP_CALIBRATION_EXTENT) == -32768);
+    NGP_CHECK(Report(LT, NGP_CALIBRATION_EXTENT) == 32767);
+
+    /* reaching further grows the range, the table follows once the rebuild interval has passed */
+    NGP_CHECK(Report(LX, 32767) == 32767);
+    NGP_CHECK(Report(LX, -32768) == -32768);
+    NGP_CHECK(ReportRebuilt(LX, NGP_CALIBRATION_EXTENT) == NGP_CALIBRATION_EXTENT);
+    NGP_CHECK(RangeIs(LX, -32768, 0, 32767)); /* kept with the pad as the table is rebuilt */
+    NGP_CHECK(Report(LX, -NGP_CALIBRATION_EXTENT) == -NGP_CALIBRATION_EXTENT);
+    NGP_CHECK(Report(LX, 32767) == 32767 && Report(LX, -32768) == -32768);
+
+    NGP_CHECK(Report(LT, 30000) == 32767);
+    NGP_CHECK(ReportRebuilt(LT, 15000) == 16384);
+    NGP_CHECK(RangeIs(LT, 0, 0, 30000));
+    NGP_CHECK(RangeIs(LY, -NGP_CALIBRATION_EXTENT, 0, NGP_CALIBRATION_EXTENT)); /* untouched */
+}
+
+/* A stick held near 0 for long enough is resting, its average position becomes the center */
+static void CheckRestCenter(void) {
+    NGP_CHECK(Report(LY, 600) != 0); /* off center, and where the resting starts */
+    for (int i = 0; i < NGP_CALIBRATION_REST_REPORTS; i++) {
+        NGP_VirtualGamePadSetAxis(pad, LY, i % 2 ? 640 : 560); /* jitter around 600 */
+        NGP_VirtualGamePadCommit(pad);
+    }
+    NGP_VirtualSync();
+    NGP_CHECK(ReportRebuilt(LY, 600) == 0);
+    NGP_CHECK(Range(LY).Center == 600);
+    NGP_CHECK(Report(LY, NGP_CALIBRATION_EXTENT) == 32767);
+    NGP_CHECK(Report(LY, (int16_t)(600 + (NGP_CALIBRATION_EXTENT - 600) / 2)) == 16384);
+
+    /* held still but too far out to be resting, the center stays */
+    for (int i = 0; i < NGP_CALIBRATION_REST_REPORTS + 1; i++) {
+        NGP_VirtualGamePadSetAxis(pad, LY, 5000);
+        NGP_VirtualGamePadCommit(pad);
+    }
+    NGP_VirtualSync();
+    NGP_CHECK(Range(LY).Center == 600);
+}
+
+/* Reset forgets the ranges and centers, the next report maps through the default ones at once */
+static void CheckReset(void) {
+    NGP_CHECK(!IsDefault());
+    NGP_CHECK(NGP_GamePadResetCalibration(gp));
+    NGP_CHECK(IsDefault());
+    NGP_CHECK(Report(LX, NGP_CALIBRATION_EXTENT / 2) == 16384);
+    NGP_CHECK(Report(LY, 0) == 0);
+    NGP_CHECK(IsDefault());
+}
+
+static void WriteFile(const char* text) {
+    FILE* file = fopen(FILE_NAME, "w");
+    NGP_CHECK(file != NULL);
+    fputs(text, file);
+    NGP_CHECK(fclose(file) == 0);
+}
+
+/* Saved and loaded back ranges are the same, a file with a bad line loads nothing at all */
+static void CheckSaveLoad(void) {
+    NGP_CHECK(ReportRebuilt(LX, 30000) == 32767);
+    NGP_AxisCalibration saved[NGP_GamePadAxisTypeMax];
+    for (int axis = 0; axis < NGP_GamePadAxisTypeMax; axis++) {
+        saved[axis] = Range((NGP_GamePadAxisType)axis);
+    }
+    NGP_CHECK(saved[LX].Max == 30000 && saved[LT].Max == NGP_CALIBRATION_EXTENT);
+    NGP_CHECK(NGP_SaveCalibrations(FILE_NAME));
+
+    NGP_CHECK(NGP_GamePadResetCalibration(gp));
+    NGP_CHECK(IsDefault());
+    NGP_CHECK(NGP_LoadCalibrations(FILE_NAME));
+    for (int axis = 0; axis < NGP_GamePadAxisTypeMax; axis++) {
+        NGP_AxisCalibration range = Range((NGP_GamePadAxisType)axis);
+        NGP_CHECK(memcmp(&range, &saved[axis], sizeof(range)) == 0);
+    }
+    NGP_CHECK(Report(LX, 15000) == 16384); /* mapped through the loaded range straight away */
+
+    /* this pad's line is fine, but the next one is cut short */
+    char  line[512];
+    FILE* file = fopen(FILE_NAME, "r");
+    NGP_CHECK(file != NULL && fgets(line, sizeof(line), file) && fgets(line, sizeof(line), file));
+    fclose(file);
+    char good[1024];
+    char guid[33];
+    memcpy(guid, line, 32);
+    guid[32] = '\0';
+    snprintf(good, sizeof(good), "# NGP calibration 1\n%s", guid);
+    for (int axis = 0; axis < NGP_GamePadAxisTypeMax; axis++) {
+        strcat(good, axis < LT ? " -100 0 100" : " 0 0 100");
+    }
+    strcat(good, "\n");
+
+    char text[2048];
+    snprintf(text, sizeof(text), "%s%s 1 2 3\n", good, guid);
+    WriteFile(text);
+    NGP_CHECK(!NGP_LoadCalibrations(FILE_NAME));
+    snprintf(text, sizeof(text), "%s%s", good, "zz\n");
+    WriteFile(text);
+    NGP_CHECK(!NGP_LoadCalibrations(FILE_NAME));
+    snprintf(text, sizeof(text), "%s%s -5 10 0", good, guid); /* center outside its range */
+    WriteFile(text);
+    NGP_CHECK(!NGP_LoadCalibrations(FILE_NAME));
+    for (int axis = 0; axis < NGP_GamePadAxisTypeMax; axis++) {
+        NGP_AxisCalibration range = Range((NGP_GamePadAxisType)axis);
+        NGP_CHECK(memcmp(&range, &saved[axis], sizeof(range)) == 0);
+    }
+
+    /* the good lines alone load */
+    WriteFile(good);
+    NGP_CHECK(NGP_LoadCalibrations(FILE_NAME));
+    NGP_CHECK(RangeIs(LX, -100, 0, 100) && RangeIs(LT, 0, 0, 100));
+    WriteFile("not a calibration file\n");
+    NGP_CHECK(!NGP_LoadCalibrations(FILE_NAME));
+    remove(FILE_NAME);
+    NGP_CHECK(!NGP_LoadCalibrations(FILE_NAME));
+    NGP_CHECK(NGP_GamePadResetCalibration(gp));
+}
+
+/* Off again, the axes read their raw values from the next report on */
+static void CheckDisable(void) {
+    NGP_CHECK(Report(LX, 20000) != 20000);
+    NGP_CHECK(Report(LT, 100) != 100);
+    NGP_SetCalibrationEnabled(false);
+    NGP_CHECK(Report(LY, 0) == 0);
+    NGP_CHECK(NGP_GamePadAxis(gp, LX) == 20000 && NGP_GamePadAxis(gp, LT) == 100);
+    NGP_CHECK(Report(LX, NGP_CALIBRATION_EXTENT) == NGP_CALIBRATION_EXTENT);
+    NGP_SetCalibrationEnabled(true);
+    NGP_CHECK(Report(LX, NGP_CALIBRATION_EXTENT) == 32767);
+}
+
+/* Every curve maps the whole raw range without ever going back, from full one way to the other */
+static void CheckTable(NGP_GamePadAxisType axis) {
+    NGP_Device* device = NGP_DeviceLookup(NGP_GamePadGetID(gp));
+    NGP_CHECK(device != NULL && device->calibration != NULL);
+    const int16_t* table = device->calibration->tables[axis];
+    for (int raw = INT16_MIN + 1; raw <= INT16_MAX; raw++) {
+        NGP_CHECK(table[(uint16_t)raw] >= table[(uint16_t)(raw - 1)]);
+    }
+    NGP_AxisCalibration range = Range(axis);
+    NGP_CHECK(table[(uint16_t)range.Center] == 0);
+    NGP_CHECK(table[(uint16_t)range.Max] == 32767);
+    if (axis < LT) {
+        NGP_CHECK(table[(uint16_t)range.Min] == -32768);
+    } else {
+        NGP_CHECK(table[(uint16_t)INT16_MIN] == 0);
+    }
+}
+
+static void CheckCurves(void) {
+    NGP_AxisResponse responses[] = {
+        { .Type = NGP_CurveLinear },
+        { .Type = NGP_CurveExponential, .Shape = 2.5f },
+        { .Type = NGP_CurveExponential, .Shape = 0.5f },
+        { .Type = NGP_CurveSCurve, .Shape = 3.0f },
+        { .Type       = NGP_CurveSpline,
+          .PointCount = 3,
+          .Points     = { { 0.25f, 0.1f }, { 0.5f, 0.6f }, { 0.8f, 0.65f } } },
+        { .Type = NGP_CurveSpline }, /* no points, a straight line */
+        { .Type = NGP_CurveSCurve, .Shape = 2.0f, .Deadzone = 0.2f, .AntiDeadzone = 0.1f },
+    };
+    for (size_t i = 0; i < sizeof(responses) / sizeof(responses[0]); i++) {
+        NGP_CHECK(NGP_GamePadSetAxisResponse(gp, LX, &responses[i]));
+        NGP_CHECK(NGP_GamePadSetAxisResponse(gp, LT, &responses[i]));
+        Report(LX, 0); /* the next report picks the responses up and rebuilds */
+        CheckTable(LX);
+        CheckTable(LT);
+    }
+
+    /* the deadzone reads 0 and leaving it jumps to the anti-deadzone */
+    int16_t edge = (int16_t)(NGP_CALIBRATION_EXTENT / 5);
+    NGP_CHECK(Report(LX, edge) == 0 && Report(LX, (int16_t)-edge) == 0);
+    NGP_CHECK(Report(LX, (int16_t)(edge + 10)) >= 3276);
+    NGP_CHECK(Report(LX, (int16_t)(-edge - 10)) <= -3276);
+
+    /* out of range responses are refused, NULL is linear again */
+    NGP_AxisResponse bad = { .Type = NGP_CurveExponential, .Shape = 0.0f };
+    NGP_CHECK(!NGP_GamePadSetAxisResponse(gp, LX, &bad));
+    bad = (NGP_AxisResponse){ .Type       = NGP_CurveSpline,
+                              .PointCount = 2,
+                              .Points     = { { 0.5f, 0.5f }, { 0.4f, 0.6f } } };
+    NGP_CHECK(!NGP_GamePadSetAxisResponse(gp, LX, &bad));
+    bad = (NGP_AxisResponse){ .Type = NGP_CurveLinear, .Deadzone = 1.0f };
+    NGP_CHECK(!NGP_GamePadSetAxisResponse(gp, LX, &bad));
+    NGP_CHECK(NGP_GamePadSetAxisResponse(gp, LX, NULL));
+    NGP_CHECK(Report(LX, NGP_CALIBRATION_EXTENT / 2) == 16384);
+}
+
+int main(void) {
+    NGP_CHECK(NGP_InitializeVirtual());
+    NGP_SetCalibrationEnabled(true);
+    pad = NGP_VirtualGamePadCreate("Calibration Test Pad", 0x1234, 0x5678);
+    NGP_CHECK(pad != NULL);
+    NGP_VirtualSync();
+    gp = NGP_GamePadOpen(0);
+    NGP_CHECK(gp != NULL);
+
+    CheckLearnRange();
+    CheckRestCenter();
+    CheckReset();
+    CheckSaveLoad();
+    CheckDisable();
+    CheckCurves();
+
+    NGP_GamePadFree(gp);
+    NGP_Shutdown();
+    return 0;
+}
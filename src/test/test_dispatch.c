@@ -0,0 +1,151 @@
+#include <math.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "NGP_Device.h"
+#include "NGP_Test.h"
+
+#define PERIOD_NS 1000000LL /* a 1 kHz pad */
+#define PACED_REPORTS 500
+
+static uint64_t events;
+static int64_t  latency[PACED_REPORTS];
+static int      samples;
+static bool     timing;
+
+static void OnEvents(const NGP_Event* e, int count, void* userdata) {
+    (void)userdata;
+    if (timing && samples < PACED_REPORTS) {
+        latency[samples++] = NGP_GetTicksNS() - e[0].Timestamp;
+    }
+    __atomic_store_n(&events, events + (uint64_t)count, __ATOMIC_RELEASE);
+}
+
+static uint64_t Now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Waits up to five seconds for the callback to have seen count events, returns how many it saw */
+static uint64_t WaitForEvents(uint64_t count) {
+    uint64_t deadline = Now() + 5000000000ULL;
+    while (__atomic_load_n(&events, __ATOMIC_ACQUIRE) < count && Now() < deadline) {
+        struct timespec ts = { 0, 100000 };
+        nanosleep(&ts, NULL);
+    }
+    return __atomic_load_n(&events, __ATOMIC_ACQUIRE);
+}
+
+/* The pad's nth report, every one changes the stick and the button so each queues two events */
+static uint64_t reports;
+
+static void Report(NGP_VirtualGamePad* pad) {
+    reports++;
+    NGP_VirtualGamePadSetAxis(pad, NGP_GamePadAxisTypeLeftX, (int16_t)(reports & 0x7fff));
+    NGP_VirtualGamePadSetButton(pad, NGP_GamePadButtonA, reports & 1);
+    NGP_VirtualGamePadCommit(pad);
+}
+
+/* Several queues' worth of reports, in batches the callback's own cursor keeps up with */
+static void Burst(NGP_VirtualGamePad* pad, int count) {
+    for (int i = 1; i <= count; i++) {
+        Report(pad);
+        if (i % 64 == 0) {
+            NGP_VirtualSync();
+        }
+    }
+    NGP_VirtualSync();
+}
+
+/* Nothing polls, the callback still gets every event long after the first queue's worth */
+static void TestNoPoller(NGP_VirtualGamePad* pad) {
+    uint64_t before = events;
+    Burst(pad, 3 * NGP_EVENT_QUEUE_CAPACITY);
+    NGP_CHECK(WaitForEvents(before + 6 * NGP_EVENT_QUEUE_CAPACITY) ==
+              before + 6 * NGP_EVENT_QUEUE_CAPACITY);
+    NGP_CHECK(NGP_EventCallbackDropped() == 0);
+    NGP_CHECK(NGP_EventsDropped() == 0);
+}
+
+static int CompareLatency(const void* a, const void* b) {
+    int64_t x = *(const int64_t*)a;
+    int64_t y = *(const int64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Reports at 1 kHz reach the callback promptly and evenly. The bounds are loose, they catch a
+ * callback that waits for something like a poll or a timer, not scheduler noise on a busy machine.
+ */
+static void TestJitter(NGP_VirtualGamePad* pad) {
+    uint64_t before = events;
+    samples         = 0;
+    timing          = true;
+    uint64_t start  = Now();
+    for (int i = 0; i < PACED_REPORTS; i++) {
+        uint64_t        due = start + (uint64_t)(i + 1) * PERIOD_NS;
+        struct timespec ts  = { (time_t)(due / 1000000000ULL), (long)(due % 1000000000ULL) };
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+        Report(pad);
+    }
+    NGP_VirtualSync();
+    NGP_CHECK(WaitForEvents(before + 2 * PACED_REPORTS) == before + 2 * PACED_REPORTS);
+    timing = false;
+    NGP_CHECK(samples == PACED_REPORTS);
+
+    double mean = 0.0;
+    for (int i = 0; i < samples; i++) {
+        mean += (double)latency[i] / samples;
+    }
+    double variance = 0.0;
+    for (int i = 0; i < samples; i++) {
+        double d = (double)latency[i] - mean;
+        variance += d * d / samples;
+    }
+    qsort(latency, (size_t)samples, sizeof(latency[0]), CompareLatency);
+    int64_t p50 = latency[samples / 2];
+    int64_t p99 = latency[samples * 99 / 100];
+    printf("dispatch latency p50 %lld ns, p99 %lld ns, jitter %.0f ns\n", (long long)p50,
+           (long long)p99, sqrt(variance));
+    NGP_CHECK(latency[0] >= 0);
+    NGP_CHECK(p50 < 2 * PERIOD_NS);
+    NGP_CHECK(p99 < 20 * PERIOD_NS);
+    NGP_CHECK(sqrt(variance) < 5.0 * PERIOD_NS);
+}
+
+/*
+ * Once the program has polled, its cursor holds the queue up again. Events it then leaves unread
+ * past a whole queue are dropped for the callback too, and counted. The poll itself finds the
+ * events the callback took while nothing polled already overtaken, those count for the poller only.
+ */
+static void TestPollerStops(NGP_VirtualGamePad* pad) {
+    NGP_Event drained[64];
+    while (NGP_PollEvents(drained, 64) > 0) {
+    }
+    NGP_CHECK(NGP_EventsDropped() > 0 && NGP_EventCallbackDropped() == 0);
+    uint64_t before      = events;
+    uint64_t polled_lost = NGP_EventsDropped();
+    Burst(pad, NGP_EVENT_QUEUE_CAPACITY);
+    uint64_t pushed    = 2 * NGP_EVENT_QUEUE_CAPACITY;
+    uint64_t dropped   = NGP_EventCallbackDropped();
+    uint64_t delivered = WaitForEvents(before + pushed - dropped) - before;
+    NGP_CHECK(dropped > 0 && dropped == NGP_EventsDropped() - polled_lost);
+    NGP_CHECK(delivered + dropped == pushed);
+}
+
+int main(void) {
+    NGP_CHECK(NGP_InitializeVirtual());
+    NGP_VirtualGamePad* pad = NGP_VirtualGamePadCreate("Test Pad", 0, 0);
+    NGP_CHECK(pad != NULL);
+    NGP_VirtualSync();
+    NGP_CHECK(NGP_SetEventCallback(OnEvents, NULL, NGP_EVENT_MASK_ALL));
+
+    TestNoPoller(pad);
+    TestJitter(pad);
+    TestPollerStops(pad);
+
+    NGP_SetEventCallback(NULL, NULL, 0);
+    NGP_Shutdown();
+    return 0;
+}
@@ -0,0 +1,238 @@
+#include <string.h>
+#include <time.h>
+
+#include "NGP_Enumeration.h"
+#include "NGP_Test.h"
+
+#define CAPACITY NGP_ENUMERATION_CAPACITY
+#define MASK (CAPACITY - 1)
+#define KEYS 65536
+
+/*
+ * Keys are only compared by pointer, so any distinct addresses do. The devices are their indices
+ * plus one, so none is NULL.
+ */
+static char            keys[KEYS];
+static NGP_Enumeration table;
+
+static void* Device(int key) { return (void*)(uintptr_t)(key + 1); }
+
+/* The slot a key lands in when it is alone in the table */
+static int Home(int key) {
+    static NGP_Enumeration alone;
+    memset(&alone, 0, sizeof(alone));
+    NGP_CHECK(NGP_EnumerationAdd(&alone, &keys[key], Device(key)));
+    for (int i = 0; i < CAPACITY; i++) {
+        if (alone.entries[i].key) {
+            return i;
+        }
+    }
+    NGP_CHECK(false);
+    return -1;
+}
+
+/* A key with the given home, other than the ones already taken */
+static int KeyAt(int home, const int* taken, int count) {
+    for (int key = 0; key < KEYS; key++) {
+        bool used = false;
+        for (int i = 0; i < count; i++) {
+            used |= taken[i] == key;
+        }
+        if (!used && Home(key) == home) {
+            return key;
+        }
+    }
+    NGP_CHECK(false);
+    return -1;
+}
+
+static int SlotOf(int key) {
+    for (int i = 0; i < CAPACITY; i++) {
+        if (table.entries[i].key == &keys[key]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void CheckBasics(void) {
+    memset(&table, 0, sizeof(table));
+    NGP_CHECK(NGP_EnumerationFind(&table, &keys[0]) == NULL);
+    NGP_CHECK(NGP_EnumerationRemove(&table, &keys[0]) == NULL);
+    NGP_CHECK(!NGP_EnumerationAdd(&table, NULL, Device(0)));
+    NGP_CHECK(NGP_EnumerationFind(&table, NULL) == NULL);
+
+    NGP_CHECK(NGP_EnumerationAdd(&table, &keys[0], Device(0)));
+    NGP_CHECK(!NGP_EnumerationAdd(&table, &keys[0], Device(1))); /* already tracked */
+    NGP_CHECK(NGP_EnumerationFind(&table, &keys[0]) == Device(0));
+    NGP_CHECK(NGP_EnumerationFind(&table, &keys[1]) == NULL);
+    NGP_CHECK(NGP_EnumerationRemove(&table, &keys[0]) == Device(0));
+    NGP_CHECK(NGP_EnumerationRemove(&table, &keys[0]) == NULL);
+    NGP_CHECK(table.count == 0);
+
+    /* kept at most half full */
+    for (int key = 0; key < CAPACITY / 2; key++) {
+        NGP_CHECK(NGP_EnumerationAdd(&table, &keys[key], Device(key)));
+    }
+    NGP_CHECK(!NGP_EnumerationAdd(&table, &keys[CAPACITY / 2], Device(CAPACITY / 2)));
+    for (int key = 0; key < CAPACITY / 2; key++) {
+        NGP_CHECK(NGP_EnumerationFind(&table, &keys[key]) == Device(key));
+    }
+    NGP_CHECK(NGP_EnumerationRemove(&table, &keys[7]) == Device(7));
+    NGP_CHECK(NGP_EnumerationAdd(&table, &keys[CAPACITY / 2], Device(CAPACITY / 2)));
+    NGP_CHECK(table.count == CAPACITY / 2);
+
+    /* removing in any order leaves every other key findable */
+    for (int key = CAPACITY / 2; key >= 0; key -= 3) {
+        if (key != 7) {
+            NGP_CHECK(NGP_EnumerationRemove(&table, &keys[key]) == Device(key));
+        }
+    }
+    for (int key = 0; key <= CAPACITY / 2; key++) {
+        bool removed = key == 7 || (CAPACITY / 2 - key) % 3 == 0;
+        NGP_CHECK(NGP_EnumerationFind(&table, &keys[key]) == (removed ? NULL : Device(key)));
+    }
+}
+
+/*
+ * A probe chain that wraps from the last slot to the first: a at 254, b and d both home at 255,
+ * c at home in 1 and e home at 0. d wraps to 0, which pushes e past c to 2. Removing b has to pull
+ * d back across the wrap and e back into 0, but leave c where it is.
+ */
+static int chain[5];
+
+static void BuildChain(void) {
+    memset(&table, 0, sizeof(table));
+    chain[0] = KeyAt(MASK - 1, chain, 0);
+    chain[1] = KeyAt(MASK, chain, 1);
+    chain[2] = KeyAt(1, chain, 2);
+    chain[3] = KeyAt(MASK, chain, 3);
+    chain[4] = KeyAt(0, chain, 4);
+    for (int i = 0; i < 5; i++) {
+        NGP_CHECK(NGP_EnumerationAdd(&table, &keys[chain[i]], Device(chain[i])));
+    }
+    NGP_CHECK(SlotOf(chain[0]) == MASK - 1 && SlotOf(chain[1]) == MASK);
+    NGP_CHECK(SlotOf(chain[2]) == 1 && SlotOf(chain[3]) == 0 && SlotOf(chain[4]) == 2);
+}
+
+static void CheckWrappedDelete(void) {
+    BuildChain();
+    NGP_CHECK(NGP_EnumerationRemove(&table, &keys[chain[1]]) == Device(chain[1]));
+    NGP_CHECK(SlotOf(chain[0]) == MASK - 1 && SlotOf(chain[3]) == MASK);
+    NGP_CHECK(SlotOf(chain[4]) == 0 && SlotOf(chain[2]) == 1);
+    NGP_CHECK(table.entries[2].key == NULL && table.count == 4);
+    for (int i = 0; i < 5; i++) {
+        void* device = i == 1 ? NULL : Device(chain[i]);
+        NGP_CHECK(NGP_EnumerationFind(&table, &keys[chain[i]]) == device);
+    }
+
+    /* the head of the chain, everything after it shifts back one more */
+    NGP_CHECK(NGP_EnumerationRemove(&table, &keys[chain[0]]) == Device(chain[0]));
+    NGP_CHECK(SlotOf(chain[3]) == MASK && SlotOf(chain[4]) == 0 && SlotOf(chain[2]) == 1);
+    NGP_CHECK(table.entries[MASK - 1].key == NULL);
+}
+
+/* Marks which of the tracked devices came back from EndScan, each exactly once */
+static void Collect(void** gone, int count, int* seen) {
+    for (int i = 0; i < count; i++) {
+        int key = (int)(uintptr_t)gone[i] - 1;
+        NGP_CHECK(key >= 0 && key < KEYS && seen[key] == 0);
+        seen[key]++;
+    }
+}
+
+static void CheckScan(void) {
+    static int gone_count[KEYS];
+    void*      gone[CAPACITY];
+
+    /* devices 0-19 tracked, the scan finds the even ones and a new one */
+    memset(&table, 0, sizeof(table));
+    for (int key = 0; key < 20; key++) {
+        NGP_CHECK(NGP_EnumerationAdd(&table, &keys[key], Device(key)));
+    }
+    NGP_EnumerationBeginScan(&table);
+    for (int key = 0; key < 20; key += 2) {
+        NGP_CHECK(NGP_EnumerationSeen(&table, &keys[key]));
+    }
+    NGP_CHECK(!NGP_EnumerationSeen(&table, &keys[100])); /* the source opens and adds it */
+    NGP_CHECK(NGP_EnumerationAdd(&table, &keys[100], Device(100)));
+
+    /* fewer at a time than are gone, the rest are left for the next call */
+    memset(gone_count, 0, sizeof(gone_count));
+    int total = 0;
+    for (int count; (count = NGP_EnumerationEndScan(&table, gone, 3)) > 0; total += count) {
+        NGP_CHECK(count <= 3);
+        Collect(gone, count, gone_count);
+    }
+    NGP_CHECK(total == 10 && table.count == 11);
+    for (int key = 0; key < 20; key++) {
+        NGP_CHECK(gone_count[key] == key % 2);
+        NGP_CHECK(NGP_EnumerationFind(&table, &keys[key]) == (key % 2 ? NULL : Device(key)));
+    }
+    NGP_CHECK(NGP_EnumerationFind(&table, &keys[100]) == Device(100));
+
+    /* a scan that sees everything removes nothing */
+    NGP_EnumerationBeginScan(&table);
+    for (int key = 0; key <= 100; key++) {
+        NGP_EnumerationSeen(&table, &keys[key]);
+    }
+    NGP_CHECK(NGP_EnumerationEndScan(&table, gone, CAPACITY) == 0 && table.count == 11);
+
+    /*
+     * Along the wrapped chain, removing an entry shifts the next one into its slot, which has to be
+     * looked at again: only a and c are seen, b, d and e all go
+     */
+    BuildChain();
+    NGP_EnumerationBeginScan(&table);
+    NGP_CHECK(NGP_EnumerationSeen(&table, &keys[chain[0]]));
+    NGP_CHECK(NGP_EnumerationSeen(&table, &keys[chain[2]]));
+    memset(gone_count, 0, sizeof(gone_count));
+    int count = NGP_EnumerationEndScan(&table, gone, CAPACITY);
+    Collect(gone, count, gone_count);
+    NGP_CHECK(count == 3 && table.count == 2);
+    NGP_CHECK(gone_count[chain[1]] && gone_count[chain[3]] && gone_count[chain[4]]);
+    NGP_CHECK(SlotOf(chain[0]) == MASK - 1 && SlotOf(chain[2]) == 1);
+}
+
+static void Sleep(int ms) {
+    struct timespec ts = { 0, ms * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+/* From the start of enumeration to the first attach, through the virtual device source */
+static void CheckTimeToFirstGamePad(void) {
+    NGP_CHECK(NGP_GetTimeToFirstGamePad() == 0);
+    NGP_Timestamp start = NGP_GetTicksNS();
+    NGP_CHECK(NGP_InitializeVirtual());
+    Sleep(20);
+    NGP_CHECK(NGP_GetTimeToFirstGamePad() == 0); /* nothing attached yet */
+
+    NGP_VirtualGamePad* first = NGP_VirtualGamePadCreate("First Pad", 0, 0);
+    NGP_CHECK(first != NULL);
+    NGP_VirtualSync();
+    NGP_Timestamp took = NGP_GetTimeToFirstGamePad();
+    NGP_CHECK(took >= 20000000LL && took <= NGP_GetTicksNS() - start);
+
+    /* later pads do not move it */
+    NGP_VirtualGamePad* second = NGP_VirtualGamePadCreate("Second Pad", 0, 0);
+    NGP_CHECK(second != NULL);
+    NGP_VirtualSync();
+    NGP_CHECK(NGP_GetTimeToFirstGamePad() == took);
+    NGP_Shutdown();
+
+    /* every start measures again */
+    NGP_CHECK(NGP_InitializeVirtual());
+    NGP_CHECK(NGP_GetTimeToFirstGamePad() == 0);
+    NGP_CHECK(NGP_VirtualGamePadCreate("Third Pad", 0, 0) != NULL);
+    NGP_VirtualSync();
+    NGP_CHECK(NGP_GetTimeToFirstGamePad() > 0);
+    NGP_Shutdown();
+}
+
+int main(void) {
+    CheckBasics();
+    CheckWrappedDelete();
+    CheckScan();
+    CheckTimeToFirstGamePad();
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include <math.h>
+#include <string.h>
+
+#include "NGP_Gesture.h"
+#include "NGP_Test.h"
+
+#define MS 1000000LL
+
+/* One report of a touch trace, fingers with id 0 are up */
+typedef struct Frame {
+    int   ms;
+    int   id[2];
+    float x[2];
+    float y[2];
+} Frame;
+
+static NGP_GestureEvent gestures[64];
+
+/* Feeds the trace through a fresh tracker and returns every gesture it produced */
+static int Run(const Frame* trace, int frames) {
+    NGP_GestureTracker tracker;
+    memset(&tracker, 0, sizeof(tracker));
+    int count = 0;
+    for (int f = 0; f < frames; f++) {
+        NGP_GamePadState state;
+        memset(&state, 0, sizeof(state));
+        state.Timestamp = (NGP_Timestamp)trace[f].ms * MS;
+        for (int i = 0; i < 2; i++) {
+            state.Fingers[i].State = trace[f].id[i] != 0;
+            state.Fingers[i].ID    = trace[f].id[i];
+            state.Fingers[i].X     = trace[f].x[i];
+            state.Fingers[i].Y     = trace[f].y[i];
+        }
+        NGP_CHECK(count + NGP_MAX_TOUCHPAD_FINGERS <= 64);
+        count += NGP_GestureUpdate(&tracker, &state, &gestures[count]);
+    }
+    return count;
+}
+
+#define RUN(trace) Run(trace, (int)(sizeof(trace) / sizeof(trace[0])))
+
+static bool Near(float a, float b) { return fabsf(a - b) < 1e-3f; }
+
+static void TestTap(void) {
+    static const Frame tap[] = {
+        { 0, { 1, 0 }, { 0.50f, 0 }, { 0.50f, 0 } },
+        { 50, { 1, 0 }, { 0.51f, 0 }, { 0.50f, 0 } }, /* within the slop */
+        { 120, { 0, 0 }, { 0, 0 }, { 0, 0 } },
+    };
+    NGP_CHECK(RUN(tap) == 1);
+    NGP_CHECK(gestures[0].Gesture == NGP_GestureTap);
+    NGP_CHECK(Near(gestures[0].X, 0.51f) && Near(gestures[0].Y, 0.5f));
+
+    static const Frame held[] = {
+        { 0, { 1, 0 }, { 0.5f, 0 }, { 0.5f, 0 } },
+        { 400, { 0, 0 }, { 0, 0 }, { 0, 0 } }, /* too long for a tap */
+    };
+    NGP_CHECK(RUN(held) == 0);
+
+    /* the finger lifted and a new one touched down between two reports, the first still taps */
+    static const Frame replaced[] = {
+        { 0, { 1, 0 }, { 0.2f, 0 }, { 0.2f, 0 } },
+        { 100, { 2, 0 }, { 0.8f, 0 }, { 0.8f, 0 } },
+        { 200, { 0, 0 }, { 0, 0 }, { 0, 0 } },
+    };
+    NGP_CHECK(RUN(replaced) == 2);
+    NGP_CHECK(gestures[0].Gesture == NGP_GestureTap && Near(gestures[0].X, 0.2f));
+    NGP_CHECK(gestures[1].Gesture == NGP_GestureTap && Near(gestures[1].X, 0.8f));
+}
+
+static void TestSwipe(void) {
+    static const Frame swipe[] = {
+        { 0, { 1, 0 }, { 0.2f, 0 }, { 0.5f, 0 } },  { 8, { 1, 0 }, { 0.3f, 0 }, { 0.5f, 0 } },
+        { 16, { 1, 0 }, { 0.4f, 0 }, { 0.5f, 0 } }, { 24, { 1, 0 }, { 0.5f, 0 }, { 0.5f, 0 } },
+        { 32, { 1, 0 }, { 0.6f, 0 }, { 0.5f, 0 } }, { 40, { 0, 0 }, { 0, 0 }, { 0, 0 } },
+    };
+    NGP_CHECK(RUN(swipe) == 1);
+    NGP_CHECK(gestures[0].Gesture == NGP_GestureSwipe);
+    NGP_CHECK(Near(gestures[0].X, 0.6f));
+    NGP_CHECK(gestures[0].DX > 10.0f && gestures[0].DX < 12.6f); /* 12.5 per second, smoothed */
+    NGP_CHECK(Near(gestures[0].DY, 0.0f));
+
+    /* the same stroke, held still before lifting */
+    static const Frame stopped[] = {
+        { 0, { 1, 0 }, { 0.2f, 0 }, { 0.5f, 0 } },  { 8, { 1, 0 }, { 0.3f, 0 }, { 0.5f, 0 } },
+        { 16, { 1, 0 }, { 0.4f, 0 }, { 0.5f, 0 } }, { 24, { 1, 0 }, { 0.5f, 0 }, { 0.5f, 0 } },
+        { 32, { 1, 0 }, { 0.6f, 0 }, { 0.5f, 0 } }, { 150, { 0, 0 }, { 0, 0 }, { 0, 0 } },
+    };
+    NGP_CHECK(RUN(stopped) == 0);
+
+    /* far enough but too slow */
+    static const Frame drag[] = {
+        { 0, { 1, 0 }, { 0.2f, 0 }, { 0.5f, 0 } },
+        { 200, { 1, 0 }, { 0.3f, 0 }, { 0.5f, 0 } },
+        { 400, { 1, 0 }, { 0.4f, 0 }, { 0.5f, 0 } },
+        { 420, { 0, 0 }, { 0, 0 }, { 0, 0 } },
+    };
+    NGP_CHECK(RUN(drag) == 0);
+}
+
+static void TestTwoFingers(void) {
+    static const Frame scroll[] = {
+        { 0, { 1, 2 }, { 0.3f, 0.5f }, { 0.40f, 0.40f } },
+        { 8, { 1, 2 }, { 0.3f, 0.5f }, { 0.45f, 0.45f } },
+        { 16, { 1, 2 }, { 0.3f, 0.5f }, { 0.50f, 0.50f } },
+        { 24, { 1, 2 }, { 0.3f, 0.5f }, { 0.50f, 0.50f } }, /* no move, no event */
+        { 32, { 1, 2 }, { 0.3f, 0.5f }, { 0.55f, 0.55f } },
+        { 40, { 1, 0 }, { 0.3f, 0 }, { 0.55f, 0 } },
+        { 48, { 0, 0 }, { 0, 0 }, { 0, 0 } }, /* no tap once two fingers were down */
+    };
+    NGP_CHECK(RUN(scroll) == 3);
+    for (int i = 0; i < 3; i++) {
+        NGP_CHECK(gestures[i].Gesture == NGP_GestureScroll);
+        NGP_CHECK(Near(gestures[i].DX, 0.0f) && Near(gestures[i].DY, 0.05f));
+        NGP_CHECK(Near(gestures[i].X, 0.4f) && gestures[i].Scale == 1.0f);
+    }
+    NGP_CHECK(Near(gestures[2].Y, 0.55f));
+
+    static const Frame pinch[] = {
+        { 0, { 1, 2 }, { 0.4f, 0.6f }, { 0.5f, 0.5f } },
+        { 8, { 1, 2 }, { 0.35f, 0.65f }, { 0.5f, 0.5f } },
+        { 16, { 1, 2 }, { 0.3f, 0.7f }, { 0.5f, 0.5f } },
+        { 24, { 0, 0 }, { 0, 0 }, { 0, 0 } },
+    };
+    NGP_CHECK(RUN(pinch) == 2);
+    NGP_CHECK(gestures[0].Gesture == NGP_GesturePinch && Near(gestures[0].Scale, 1.5f));
+    NGP_CHECK(gestures[1].Gesture == NGP_GesturePinch && Near(gestures[1].Scale, 4.0f / 3.0f));
+    NGP_CHECK(Near(gestures[1].X, 0.5f) && Near(gestures[1].Y, 0.5f));
+
+    /* fingers moving less than the slop either way are neither */
+    static const Frame still[] = {
+        { 0, { 1, 2 }, { 0.4f, 0.6f }, { 0.5f, 0.5f } },
+        { 8, { 1, 2 }, { 0.41f, 0.6f }, { 0.5f, 0.51f } },
+        { 16, { 0, 0 }, { 0, 0 }, { 0, 0 } },
+    };
+    NGP_CHECK(RUN(still) == 0);
+}
+
+int main(void) {
+    TestTap();
+    TestSwipe();
+    TestTwoFingers();
+    return 0;
+}
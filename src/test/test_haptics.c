@@ -0,0 +1,206 @@
+#include <string.h>
+#include <time.h>
+
+#include "NGP_Device.h"
+#include "NGP_Test.h"
+
+#define TICK_NS (1000000000LL / NGP_HAPTICS_TICK_HZ)
+#define MAX_WRITES 256
+
+/* A transport that records every output it is asked to write */
+static NGP_DeviceOutput outputs[MAX_WRITES];
+static int              writes;
+
+static bool WriteOutput(NGP_Device* device, const NGP_DeviceOutput* output) {
+    (void)device;
+    NGP_CHECK(writes < MAX_WRITES);
+    outputs[writes++] = *output;
+    return true;
+}
+
+static const NGP_DeviceTransport transport = { .WriteOutput = WriteOutput };
+
+static NGP_GamePad*  pad;
+static NGP_Timestamp now = 1000000000LL; /* simulated, the mixer only ever sees this */
+
+/* Sends whatever the mix queued, waiting out the output interval in real time where it must */
+static void Drain(void) {
+    int timeout;
+    while ((timeout = NGP_OutputFlush()) >= 0) {
+        struct timespec ts = { 0, (timeout + 1) * 1000000L };
+        nanosleep(&ts, NULL);
+    }
+}
+
+/* One mixer tick, the way the I/O thread runs it, then on to the next tick boundary */
+static void Tick(void) {
+    NGP_HapticsMixAt(now);
+    Drain();
+    now += TICK_NS;
+}
+
+/* Runs one tick and checks the pad was left with the given motors, written by it or not */
+static void TickExpect(bool written, uint16_t low, uint16_t high, uint16_t left, uint16_t right) {
+    int before = writes;
+    Tick();
+    NGP_CHECK(writes == before + (written ? 1 : 0));
+    const uint16_t* motors = outputs[writes - 1].motors;
+    NGP_CHECK(motors[NGP_HapticsMotorLow] == low && motors[NGP_HapticsMotorHigh] == high);
+    NGP_CHECK(motors[NGP_HapticsMotorLeftTrigger] == left);
+    NGP_CHECK(motors[NGP_HapticsMotorRightTrigger] == right);
+}
+
+/* Back to silence between the cases, the pad is written once more with every motor at 0 */
+static void StopAll(void) {
+    NGP_GamePadStopAllEffects(pad);
+    TickExpect(true, 0, 0, 0, 0);
+    NGP_CHECK(NGP_HapticsMixAt(now) == -1); /* nothing left playing, the mixer goes idle */
+}
+
+/*
+ * Attack over 5 ticks, decay over 2, sustain for 4 and release over 3. Each tick mixes the level
+ * at its boundary, measured from the tick the effect was first mixed on.
+ */
+static void CheckEnvelope(void) {
+    NGP_HapticsEffect effect = {
+        .Strength     = { 65535, 32768 },
+        .SustainLevel = 32768,
+        .AttackMs     = 20,
+        .DecayMs      = 8,
+        .SustainMs    = 16,
+        .ReleaseMs    = 12,
+    };
+    static const uint16_t levels[] = {
+        0,                          /* the effect's first tick */
+        13107, 26214, 39321, 52428, /* attack, a fifth of the peak per tick */
+        65535, 49152,               /* decay to half */
+        32768, 32768, 32768, 32768, /* sustain */
+        32768, 21846, 10923,        /* release */
+        0,                          /* ended and freed */
+    };
+    int count = (int)(sizeof(levels) / sizeof(levels[0]));
+    NGP_CHECK(NGP_GamePadPlayEffect(pad, &effect) != NGP_INVALID_HAPTICS_EFFECT_ID);
+
+    int first = writes;
+    for (int i = 0; i < count; i++) {
+        uint16_t prev = i ? levels[i - 1] : 0;
+        uint16_t high = (uint16_t)((uint32_t)levels[i] * 32768 / 65535);
+        TickExpect(levels[i] != prev, levels[i], high, 0, 0); /* one write per change, no more */
+    }
+    NGP_CHECK(writes - first == 10);
+    NGP_CHECK(NGP_HapticsMixAt(now) == -1);
+
+    /* between two boundaries nothing is mixed, a late one mixes the last boundary that is due */
+    effect.Strength[NGP_HapticsMotorHigh] = 0;
+    effect.AttackMs                       = 8;
+    NGP_CHECK(NGP_GamePadPlayEffect(pad, &effect) != NGP_INVALID_HAPTICS_EFFECT_ID);
+    TickExpect(false, 0, 0, 0, 0);
+    int before = writes;
+    NGP_CHECK(NGP_HapticsMixAt(now - TICK_NS / 2) == (int)(TICK_NS / 2 / 1000000));
+    Drain();
+    NGP_CHECK(writes == before);
+    NGP_CHECK(NGP_HapticsMixAt(now + TICK_NS + TICK_NS / 2) > 0); /* the attack has ended there */
+    Drain();
+    NGP_CHECK(writes == before + 1 && outputs[writes - 1].motors[NGP_HapticsMotorLow] == 65535);
+    now += 2 * TICK_NS;
+    StopAll();
+}
+
+static NGP_HapticsEffect Constant(uint16_t low, uint16_t high, int32_t priority) {
+    NGP_HapticsEffect effect = {
+        .Strength     = { low, high },
+        .SustainLevel = 65535,
+        .SustainMs    = NGP_HAPTICS_INFINITE,
+        .Priority     = priority,
+    };
+    return effect;
+}
+
+/* Per motor, the highest priority effects that are not silent on it are the only ones heard */
+static void CheckPriority(void) {
+    NGP_HapticsEffect low  = Constant(10000, 0, 1);
+    NGP_HapticsEffect both = Constant(20000, 30000, 0);
+    NGP_GamePadPlayEffect(pad, &both);
+    NGP_HapticsEffectID id = NGP_GamePadPlayEffect(pad, &low);
+    TickExpect(true, 10000, 30000, 0, 0);
+    TickExpect(false, 10000, 30000, 0, 0);
+
+    /* once the higher one is gone the lower one is heard again, a release of 0 ends it at once */
+    NGP_CHECK(NGP_GamePadStopEffect(pad, id));
+    NGP_CHECK(!NGP_GamePadStopEffect(pad, id));
+    TickExpect(true, 20000, 30000, 0, 0);
+    StopAll();
+}
+
+/* Equal priorities add up per motor and saturate at the motor's maximum */
+static void CheckSum(void) {
+    NGP_HapticsEffect a = Constant(40000, 10000, 2);
+    NGP_HapticsEffect b = Constant(40000, 20000, 2);
+    NGP_HapticsEffect c = Constant(65535, 65535, 1); /* masked on both motors */
+    NGP_GamePadPlayEffect(pad, &a);
+    NGP_GamePadPlayEffect(pad, &b);
+    NGP_GamePadPlayEffect(pad, &c);
+    TickExpect(true, 65535, 30000, 0, 0);
+    StopAll();
+}
+
+/* Each rumble call replaces the effect its own slot played, and mixes with the others */
+static void CheckRumble(void) {
+    NGP_CHECK(NGP_GamePadRumble(pad, 1000, 2000, 0) == 0);
+    TickExpect(true, 1000, 2000, 0, 0);
+    NGP_CHECK(NGP_GamePadRumble(pad, 3000, 0, 0) == 0);
+    TickExpect(true, 3000, 0, 0, 0); /* not 4000, the first call's effect is gone */
+
+    NGP_CHECK(NGP_GamePadRumbleLeftTrigger(pad, 100, 0) == 0);
+    NGP_CHECK(NGP_GamePadRumbleRightTrigger(pad, 200, 0) == 0);
+    TickExpect(true, 3000, 0, 100, 200);
+    NGP_CHECK(NGP_GamePadRumbleLeftTrigger(pad, 300, 0) == 0);
+    TickExpect(true, 3000, 0, 300, 200);
+
+    NGP_HapticsEffect effect = Constant(500, 500, 0); /* the rumble calls play at priority 0 */
+    NGP_GamePadPlayEffect(pad, &effect);
+    TickExpect(true, 3500, 500, 300, 200);
+
+    NGP_CHECK(NGP_GamePadRumble(pad, 0, 0, 0) == 0); /* all 0 only stops the slot's effect */
+    TickExpect(true, 500, 500, 300, 200);
+    StopAll();
+}
+
+/* A duration of 0 holds the motors until the next call, any other stops them after it */
+static void CheckDuration(void) {
+    NGP_CHECK(NGP_GamePadRumble(pad, 5000, 0, 0) == 0);
+    TickExpect(true, 5000, 0, 0, 0);
+    for (int i = 0; i < 10 * NGP_HAPTICS_TICK_HZ; i++) {
+        TickExpect(false, 5000, 0, 0, 0);
+    }
+
+    NGP_CHECK(NGP_GamePadRumble(pad, 6000, 0, 40) == 0);
+    for (int i = 0; i < 40 / (int)(TICK_NS / 1000000); i++) {
+        TickExpect(i == 0, 6000, 0, 0, 0);
+    }
+    TickExpect(true, 0, 0, 0, 0);
+    NGP_CHECK(NGP_HapticsMixAt(now) == -1);
+}
+
+int main(void) {
+    NGP_Device* device = NGP_DeviceAcquire();
+    NGP_CHECK(device != NULL);
+    device->transport = &transport;
+    device->outputs   = NGP_OutputRumble | NGP_OutputTriggerRumble;
+    NGP_CHECK(NGP_DeviceAttach(device));
+    pad = NGP_GamePadOpenID(device->id);
+    NGP_CHECK(pad != NULL);
+
+    writes = 1; /* the zeroed outputs[0] stands in for the silent pad the checks start from */
+
+    CheckEnvelope();
+    CheckPriority();
+    CheckSum();
+    CheckRumble();
+    CheckDuration();
+
+    NGP_GamePadFree(pad);
+    NGP_DeviceRelease(device);
+    printf("%d writes\n", writes - 1);
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <stdint.h>
+
+#include "NGP_Normalize.h"
+#include "NGP_Test.h"
+
+#define VALUES 65536 /* every int16 */
+#define PAIRINGS 6
+
+static int16_t x[VALUES];
+static int16_t y[VALUES];
+static float   expected_x[VALUES];
+static float   expected_y[VALUES];
+static float   out_x[VALUES];
+static float   out_y[VALUES];
+
+/*
+ * Pairs every x with a y, each pairing runs x over the whole int16 range. The radial deadzone
+ * depends on both, so the pairings put x against the edges, itself, its mirror and a scramble.
+ */
+static void Pair(int pairing) {
+    for (int i = 0; i < VALUES; i++) {
+        x[i] = (int16_t)(i - 32768);
+        switch (pairing) {
+            case 0:
+                y[i] = 0;
+                break;
+            case 1:
+                y[i] = INT16_MIN;
+                break;
+            case 2:
+                y[i] = INT16_MAX;
+                break;
+            case 3:
+                y[i] = x[i];
+                break;
+            case 4:
+                y[i] = (int16_t)(-x[i] - 1);
+                break;
+            default:
+                y[i] = (int16_t)((uint32_t)i * 40503u);
+                break;
+        }
+    }
+}
+
+/* Every kernel gives the scalar kernel's result exactly, over the whole range and any count */
+static void Check(NGP_NormalizeSticksFn kernel, float deadzone, NGP_DeadzoneType type) {
+    NGP_NormalizeSticksScalar(x, y, expected_x, expected_y, VALUES, deadzone, type);
+    kernel(x, y, out_x, out_y, VALUES, deadzone, type);
+    for (int i = 0; i < VALUES; i++) {
+        NGP_CHECK(out_x[i] == expected_x[i] && out_y[i] == expected_y[i]);
+        NGP_CHECK(out_x[i] >= -1.0f && out_x[i] <= 1.0f && out_y[i] >= -1.0f && out_y[i] <= 1.0f);
+    }
+
+    /* counts and offsets that leave a remainder for the scalar tail of each SIMD width */
+    for (int start = 0; start < 3; start++) {
+        for (int count = 0; count <= 19; count++) {
+            int base = 32768 - 9 + start; /* around center, where the deadzones cut in */
+            for (int i = 0; i < 24; i++) {
+                out_x[base + i] = 2.0f;
+            }
+            kernel(x + base, y + base, out_x + base, out_y + base, count, deadzone, type);
+            for (int i = 0; i < count; i++) {
+                NGP_CHECK(out_x[base + i] == expected_x[base + i]);
+                NGP_CHECK(out_y[base + i] == expected_y[base + i]);
+            }
+            NGP_CHECK(out_x[base + count] == 2.0f); /* nothing past count is written */
+        }
+    }
+}
+
+int main(void) {
+    NGP_NormalizeSticksFn kernels[NGP_NORMALIZE_KERNELS_MAX];
+    const char*           names[NGP_NORMALIZE_KERNELS_MAX];
+
+    int count = NGP_NormalizeSticksKernels(kernels, names, NGP_NORMALIZE_KERNELS_MAX);
+    NGP_CHECK(count >= 1 && kernels[0] == NGP_NormalizeSticksScalar);
+    NGP_CHECK(kernels[count - 1] == NGP_NormalizeSticksKernel());
+    NGP_CHECK(names[count - 1] == NGP_NormalizeSticksKernelName());
+
+    static const float deadzones[] = { 0.0f, 0.1f, 0.25f, 0.999f, 1.0f, 2.0f };
+    static const NGP_DeadzoneType types[] = { NGP_DeadzoneNone, NGP_DeadzoneAxial,
+                                              NGP_DeadzoneRadial };
+    for (int pairing = 0; pairing < PAIRINGS; pairing++) {
+        Pair(pairing);
+        for (int k = 1; k < count; k++) {
+            for (int t = 0; t < 3; t++) {
+                for (int d = 0; d < (int)(sizeof(deadzones) / sizeof(deadzones[0])); d++) {
+                    Check(kernels[k], deadzones[d], types[t]);
+                }
+            }
+        }
+    }
+
+    /* the scalar kernel itself: the ends of the range map to -1 and 1, a deadzone zeroes center */
+    Pair(0);
+    NGP_NormalizeSticksScalar(x, y, out_x, out_y, VALUES, 0.1f, NGP_DeadzoneRadial);
+    NGP_CHECK(out_x[0] == -1.0f && out_x[VALUES - 1] == 1.0f && out_x[32768] == 0.0f);
+    NGP_CHECK(out_x[32768 + 3000] == 0.0f && out_x[32768 + 4000] > 0.0f);
+
+    for (int k = 0; k < count; k++) {
+        printf("%s ", names[k]);
+    }
+    printf("match the scalar kernel\n");
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <string.h>
+#include <time.h>
+
+#include "NGP_Device.h"
+#include "NGP_Test.h"
+
+/* A transport whose writes fail while busy is set, like a Bluetooth pad returning EAGAIN */
+static bool             busy;
+static int              writes;
+static NGP_DeviceOutput written;
+
+static bool WriteOutput(NGP_Device* device, const NGP_DeviceOutput* output) {
+    (void)device;
+    writes++;
+    if (busy) {
+        return false;
+    }
+    written = *output;
+    return true;
+}
+
+static const NGP_DeviceTransport transport = { .WriteOutput = WriteOutput };
+
+static int  reports;
+static bool last_sent;
+
+static void OnOutput(NGP_GamePadID id, bool sent, void* userdata) {
+    NGP_CHECK(id == *(NGP_GamePadID*)userdata);
+    reports++;
+    last_sent = sent;
+}
+
+static void Sleep(int ms) {
+    struct timespec ts = { 0, ms * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+/* Runs flushes until the pad's next write is due, the way the I/O thread would */
+static void FlushWhenDue(void) {
+    int timeout = NGP_OutputFlush();
+    NGP_CHECK(timeout >= 0);
+    Sleep(timeout + 1);
+    NGP_OutputFlush();
+}
+
+/* A failed write leaves the pad dirty, the latest colour goes out at the next interval */
+int main(void) {
+    NGP_Device* device = NGP_DeviceAcquire();
+    NGP_CHECK(device != NULL);
+    device->transport = &transport;
+    device->outputs   = NGP_OutputLED;
+    NGP_CHECK(NGP_DeviceAttach(device));
+    NGP_GamePadID id = device->id;
+    NGP_SetOutputCallback(OnOutput, &id);
+
+    busy = true;
+    NGP_CHECK(NGP_OutputSetLED(id, 255, 0, 0));
+    int timeout = NGP_OutputFlush();
+    NGP_CHECK(writes == 1 && reports == 1 && !last_sent);
+    NGP_CHECK(timeout > 0); /* the retry is waiting for the interval, not dropped */
+
+    FlushWhenDue(); /* still busy, nothing new was set but the colour is retried */
+    NGP_CHECK(writes == 2 && reports == 2 && !last_sent);
+
+    NGP_CHECK(NGP_OutputSetLED(id, 0, 255, 0)); /* changed while waiting, this is what is sent */
+    busy = false;
+    FlushWhenDue();
+    NGP_CHECK(writes == 3 && reports == 3 && last_sent);
+    NGP_CHECK(written.led[0] == 0 && written.led[1] == 255 && written.led[2] == 0);
+    NGP_CHECK(NGP_OutputFlush() == -1); /* nothing left */
+
+    /* a write of what the pad already shows is skipped but still reported */
+    NGP_CHECK(NGP_OutputSetLED(id, 0, 0, 255));
+    NGP_CHECK(NGP_OutputSetLED(id, 0, 255, 0));
+    FlushWhenDue();
+    NGP_CHECK(writes == 3 && reports == 4 && last_sent);
+
+    NGP_SetOutputCallback(NULL, NULL);
+    NGP_DeviceRelease(device);
+    return 0;
+}
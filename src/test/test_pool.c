@@ -0,0 +1,74 @@
+#include <stdlib.h>
+
+#include "NGP_GamePad.h"
+#include "NGP_Memory.h"
+#include "NGP_Test.h"
+#include "NGP_Virtual.h"
+
+static uint64_t allocations;
+
+static void* CountingMalloc(size_t size) {
+    __atomic_add_fetch(&allocations, 1, __ATOMIC_RELAXED);
+    return malloc(size);
+}
+
+static void* CountingCalloc(size_t count, size_t size) {
+    __atomic_add_fetch(&allocations, 1, __ATOMIC_RELAXED);
+    return calloc(count, size);
+}
+
+static void* CountingRealloc(void* ptr, size_t size) {
+    __atomic_add_fetch(&allocations, 1, __ATOMIC_RELAXED);
+    return realloc(ptr, size);
+}
+
+static void DrainEvents(void) {
+    NGP_Event events[64];
+    while (NGP_PollEvents(events, 64) > 0) {
+    }
+}
+
+/* Two pads attaching, each opened twice, closed and detached again */
+static void HotplugCycle(void) {
+    NGP_VirtualGamePad* first  = NGP_VirtualGamePadCreate("Test Pad", 0x054c, 0x0ce6);
+    NGP_VirtualGamePad* second = NGP_VirtualGamePadCreate("Other Pad", 0x045e, 0x0b12);
+    NGP_CHECK(first && second);
+    NGP_VirtualSync();
+    NGP_CHECK(NGP_NumGamePads() == 2);
+    NGP_GamePad* handles[4];
+    for (int i = 0; i < 4; i++) {
+        handles[i] = NGP_GamePadOpen(i % 2);
+        NGP_CHECK(handles[i] != NULL);
+    }
+    for (int i = 0; i < 4; i++) {
+        NGP_GamePadFree(handles[i]);
+    }
+    NGP_VirtualGamePadDestroy(second);
+    NGP_VirtualGamePadDestroy(first);
+    NGP_VirtualSync();
+    NGP_CHECK(NGP_NumGamePads() == 0);
+    DrainEvents();
+}
+
+/* Once every pad has been seen, hotplug and opening handles never reach the allocator */
+int main(void) {
+    NGP_CHECK(NGP_SetMemoryFunctions(CountingMalloc, CountingCalloc, CountingRealloc, free));
+    NGP_CHECK(NGP_InitializeVirtual());
+    HotplugCycle();
+
+    uint64_t before = __atomic_load_n(&allocations, __ATOMIC_RELAXED);
+    NGP_CHECK(before > 0); /* the counting functions are the ones in use */
+    for (int i = 0; i < 100; i++) {
+        HotplugCycle();
+    }
+    uint64_t after = __atomic_load_n(&allocations, __ATOMIC_RELAXED);
+    NGP_Shutdown();
+    NGP_SetMemoryFunctions(malloc, calloc, realloc, free);
+
+    if (after != before) {
+        fprintf(stderr, "%llu allocations in 100 warm hotplug cycles\n",
+                (unsigned long long)(after - before));
+    }
+    NGP_CHECK(after == before);
+    return 0;
+}
@@ -0,0 +1,326 @@
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "NGP_RecordingFormat.h"
+#include "NGP_Test.h"
+
+#define MAX_RECORDS 16
+#define PAD_A 0
+#define PAD_B (NGP_RECORDING_MAX_PADS - 1) /* the highest pad number, a two byte varint */
+
+/* What was encoded, record by record, for the decoder to be compared against */
+typedef struct Expected {
+    NGP_RecordType          type;
+    int                     pad;
+    const NGP_Device*       device;
+    const NGP_GamePadState* state;
+    size_t                  end; /* offset just past the record */
+} Expected;
+
+static uint8_t          buffer[4096];
+static size_t           size;
+static Expected         expected[MAX_RECORDS];
+static int              count;
+static NGP_Timestamp    last_time;
+static NGP_GamePadState last[NGP_RECORDING_MAX_PADS];
+
+static NGP_Device       device_a;
+static NGP_Device       device_b;
+static NGP_GamePadState frames[5];
+
+static void Add(NGP_RecordType type, int pad, const NGP_Device* device,
+                const NGP_GamePadState* state) {
+    expected[count] = (Expected){ type, pad, device, state, size };
+    switch (type) {
+        case NGP_RecordTypeDeviceAdded:
+            size += NGP_RecordingEncodeDevice(buffer + size, pad, device);
+            memset(&last[pad], 0, sizeof(last[pad]));
+            break;
+        case NGP_RecordTypeDeviceRemoved:
+            size += NGP_RecordingEncodeRemoved(buffer + size, pad);
+            break;
+        case NGP_RecordTypeFrame:
+            size += NGP_RecordingEncodeFrame(buffer + size, pad, &last_time, &last[pad], state);
+            last[pad] = *state;
+            break;
+    }
+    expected[count++].end = size;
+}
+
+static void MakeDevice(NGP_Device* device, uint8_t seed, const char* name, const char* serial) {
+    memset(device, 0, sizeof(*device));
+    for (int i = 0; i < 16; i++) {
+        device->guid.data[i] = (uint8_t)(seed + i * 17);
+    }
+    device->bus        = 0x0003;
+    device->vendor_id  = (uint16_t)(0x054c + seed);
+    device->product_id = 0xffff;
+    device->version    = (uint16_t)(0x8100 | seed);
+    device->touchpads  = seed & 1;
+    device->name       = name;
+    device->serial     = serial;
+}
+
+/*
+ * Two pads interleaved: a first frame, one that goes back in time, one where only the time moves,
+ * one that swings every axis end to end with every extra set, and one back to rest
+ */
+static void Encode(void) {
+    MakeDevice(&device_a, 1, "Wireless Controller", "a4:ae:12:00:00:01");
+    MakeDevice(&device_b, 2, "", ""); /* unknown name and serial */
+
+    frames[0].Timestamp = 1000000;
+    frames[0].Axes[0]   = 1234;
+    frames[0].Axes[5]   = -1;
+    frames[0].Buttons   = 1u << 3;
+
+    frames[1].Timestamp = 999000; /* pad B's report was received before pad A's was published */
+    frames[1].Axes[2]   = INT16_MIN;
+    frames[1].Accel[2]  = 9.80665f;
+
+    frames[2]           = frames[0];
+    frames[2].Timestamp = 5000000000LL;
+
+    frames[3].Timestamp = 5000000001LL;
+    for (int axis = 0; axis < NGP_GamePadAxisTypeMax; axis++) {
+        frames[3].Axes[axis] = axis & 1 ? INT16_MIN : INT16_MAX;
+    }
+    frames[3].Buttons    = UINT32_MAX;
+    frames[3].Fingers[0] = (NGP_GamePadStateFinger){ 0.25f, 1.0f, 0.5f, 1, 255 };
+    frames[3].Fingers[1] = (NGP_GamePadStateFinger){ -0.0f, 1e-30f, INFINITY, 0, 7 };
+    frames[3].Accel[0]   = NAN;
+    frames[3].Gyro[1]    = -3.5f;
+
+    frames[4].Timestamp = 5000000002LL;
+
+    size = NGP_RecordingEncodeHeader(buffer);
+    Add(NGP_RecordTypeDeviceAdded, PAD_A, &device_a, NULL);
+    Add(NGP_RecordTypeFrame, PAD_A, NULL, &frames[0]);
+    Add(NGP_RecordTypeDeviceAdded, PAD_B, &device_b, NULL);
+    Add(NGP_RecordTypeFrame, PAD_B, NULL, &frames[1]);
+    Add(NGP_RecordTypeFrame, PAD_A, NULL, &frames[2]);
+    Add(NGP_RecordTypeFrame, PAD_A, NULL, &frames[3]);
+    Add(NGP_RecordTypeDeviceRemoved, PAD_B, NULL, NULL);
+    Add(NGP_RecordTypeFrame, PAD_A, NULL, &frames[4]);
+    NGP_CHECK(size <= sizeof(buffer));
+}
+
+static void CheckDevice(const NGP_RecordingDeviceInfo* info, const NGP_Device* device) {
+    NGP_CHECK(memcmp(info->guid.data, device->guid.data, sizeof(info->guid.data)) == 0);
+    NGP_CHECK(info->bus == device->bus);
+    NGP_CHECK(info->vendor_id == device->vendor_id);
+    NGP_CHECK(info->product_id == device->product_id);
+    NGP_CHECK(info->version == device->version);
+    NGP_CHECK(info->touchpads == device->touchpads);
+    NGP_CHECK(info->name_len == strlen(device->name));
+    NGP_CHECK(memcmp(info->name, device->name, info->name_len) == 0);
+    NGP_CHECK(info->serial_len == strlen(device->serial));
+    NGP_CHECK(memcmp(info->serial, device->serial, info->serial_len) == 0);
+}
+
+/* Field by field, floats bit for bit so NaN and -0 count too */
+static void CheckFrame(const NGP_GamePadState* state, const NGP_GamePadState* frame) {
+    NGP_CHECK(state->Timestamp == frame->Timestamp);
+    NGP_CHECK(memcmp(state->Axes, frame->Axes, sizeof(state->Axes)) == 0);
+    NGP_CHECK(state->Buttons == frame->Buttons);
+    for (int i = 0; i < NGP_MAX_TOUCHPAD_FINGERS; i++) {
+        const NGP_GamePadStateFinger* a = &state->Fingers[i];
+        const NGP_GamePadStateFinger* b = &frame->Fingers[i];
+        NGP_CHECK(memcmp(&a->X, &b->X, sizeof(float)) == 0);
+        NGP_CHECK(memcmp(&a->Y, &b->Y, sizeof(float)) == 0);
+        NGP_CHECK(memcmp(&a->Pressure, &b->Pressure, sizeof(float)) == 0);
+        NGP_CHECK(a->State == b->State && a->ID == b->ID);
+    }
+    NGP_CHECK(memcmp(state->Accel, frame->Accel, sizeof(state->Accel)) == 0);
+    NGP_CHECK(memcmp(state->Gyro, frame->Gyro, sizeof(state->Gyro)) == 0);
+}
+
+/*
+ * Decodes data from a buffer of exactly its size, so a read past the end is one a sanitizer sees.
+ * Returns how many records decoded, each compared against what was encoded, and sets result to 0
+ * for a clean end or -1 for malformed input.
+ */
+static int Decode(const uint8_t* data, size_t data_size, int* result) {
+    uint8_t* copy = malloc(data_size ? data_size : 1);
+    NGP_CHECK(copy);
+    memcpy(copy, data, data_size);
+
+    static NGP_GamePadState states[NGP_RECORDING_MAX_PADS];
+    memset(states, 0, sizeof(states));
+
+    NGP_RecordingReader reader;
+    NGP_RecordingRecord record;
+    int                 decoded = 0;
+    *result                     = -1;
+    if (!NGP_RecordingReaderInit(&reader, copy, data_size)) {
+        free(copy);
+        return 0;
+    }
+    for (;;) {
+        int next = NGP_RecordingNext(&reader, &record);
+        if (next <= 0) {
+            *result = next;
+            break;
+        }
+        NGP_CHECK(decoded < count);
+        const Expected* e = &expected[decoded];
+        NGP_CHECK(record.type == e->type && record.pad == e->pad);
+
+        bool ok = true;
+        if (record.type == NGP_RecordTypeDeviceAdded) {
+            NGP_RecordingDeviceInfo info;
+            ok = NGP_RecordingReadDevice(&reader, &info);
+            if (ok) {
+                CheckDevice(&info, e->device);
+                NGP_CHECK(info.name >= (const char*)copy && info.serial >= (const char*)copy);
+                NGP_CHECK(info.serial + info.serial_len <= (const char*)copy + data_size);
+                memset(&states[record.pad], 0, sizeof(states[record.pad]));
+            }
+        } else if (record.type == NGP_RecordTypeFrame) {
+            ok = NGP_RecordingReadFrame(&reader, &states[record.pad]);
+            if (ok) {
+                NGP_CHECK(record.time == e->state->Timestamp);
+                CheckFrame(&states[record.pad], e->state);
+            }
+        }
+        if (!ok) {
+            break;
+        }
+        decoded++;
+    }
+    free(copy);
+    return decoded;
+}
+
+/* The encoded recording with one record's bytes replaced, decoded up to that record */
+static int DecodePatched(int index, const uint8_t* bytes, size_t bytes_size) {
+    static uint8_t patched[sizeof(buffer)];
+    size_t         at = index ? expected[index - 1].end : NGP_RECORDING_HEADER_SIZE;
+    memcpy(patched, buffer, at);
+    memcpy(patched + at, bytes, bytes_size);
+
+    int result;
+    NGP_CHECK(Decode(patched, at + bytes_size, &result) == index);
+    return result;
+}
+
+static void CheckRoundTrip(void) {
+    int result;
+    NGP_CHECK(Decode(buffer, size, &result) == count);
+    NGP_CHECK(result == 0);
+
+    /* the unchanged frame is just its header and an empty mask */
+    NGP_CHECK(expected[4].end - expected[3].end == 1 + 1 + 5 + 1);
+
+    /* a header and nothing else is an empty recording */
+    NGP_CHECK(Decode(buffer, NGP_RECORDING_HEADER_SIZE, &result) == 0);
+    NGP_CHECK(result == 0);
+}
+
+/* Cut anywhere, a recording decodes up to its last whole record, then ends or fails cleanly */
+static void CheckTruncated(void) {
+    for (size_t cut = 0; cut < size; cut++) {
+        int result;
+        int decoded = Decode(buffer, cut, &result);
+        int whole   = 0;
+        while (whole < count && expected[whole].end <= cut) {
+            whole++;
+        }
+        if (cut < NGP_RECORDING_HEADER_SIZE) {
+            NGP_CHECK(decoded == 0 && result == -1);
+        } else {
+            NGP_CHECK(decoded == whole);
+            size_t boundary = whole ? expected[whole - 1].end : NGP_RECORDING_HEADER_SIZE;
+            NGP_CHECK(result == (cut == boundary ? 0 : -1));
+        }
+    }
+}
+
+static void CheckCorrupt(void) {
+    static uint8_t patched[sizeof(buffer)];
+    int            result;
+
+    /* the header */
+    memcpy(patched, buffer, size);
+    patched[0] = 'X';
+    NGP_CHECK(Decode(patched, size, &result) == 0 && result == -1);
+    memcpy(patched, buffer, size);
+    patched[4] = NGP_RECORDING_VERSION + 1;
+    NGP_CHECK(Decode(patched, size, &result) == 0 && result == -1);
+
+    /* record types either side of the known ones, a pad number past the last one */
+    static const uint8_t type_0[]   = { 0, 0 };
+    static const uint8_t type_4[]   = { NGP_RecordTypeFrame + 1, 0 };
+    static const uint8_t pad_past[] = { NGP_RecordTypeDeviceRemoved,
+                                        0x80 | (NGP_RECORDING_MAX_PADS & 0x7f),
+                                        NGP_RECORDING_MAX_PADS >> 7 };
+    static const uint8_t pad_huge[] = { NGP_RecordTypeDeviceRemoved, 0xff, 0xff, 0xff, 0x0f };
+    NGP_CHECK(NGP_RECORDING_MAX_PADS >= 128 && NGP_RECORDING_MAX_PADS < 16384);
+    NGP_CHECK(DecodePatched(1, type_0, sizeof(type_0)) == -1);
+    NGP_CHECK(DecodePatched(1, type_4, sizeof(type_4)) == -1);
+    NGP_CHECK(DecodePatched(1, pad_past, sizeof(pad_past)) == -1);
+    NGP_CHECK(DecodePatched(1, pad_huge, sizeof(pad_huge)) == -1);
+
+    /* a varint that never ends, even with bytes to spare after it */
+    uint8_t endless[16] = { NGP_RecordTypeFrame, 0 };
+    memset(endless + 2, 0xff, sizeof(endless) - 2);
+    NGP_CHECK(DecodePatched(1, endless, sizeof(endless)) == -1);
+
+    /* in place of the first device: name lengths of NGP_NAME_LEN and over, then past the end */
+    uint8_t device[96] = { NGP_RecordTypeDeviceAdded, 0 };
+    size_t  strings    = 2 + 16 + 4 * 2 + 1;
+    device[strings]     = 0x80 | (NGP_NAME_LEN & 0x7f);
+    device[strings + 1] = NGP_NAME_LEN >> 7;
+    NGP_CHECK(DecodePatched(0, device, sizeof(device)) == -1);
+    device[strings]     = 0xff;
+    device[strings + 1] = 0xff;
+    device[strings + 2] = 0xff;
+    device[strings + 3] = 0x7f;
+    NGP_CHECK(DecodePatched(0, device, sizeof(device)) == -1);
+    device[strings]     = 40; /* under NGP_NAME_LEN, but past the end */
+    NGP_CHECK(DecodePatched(0, device, strings + 1 + 39) == -1);
+    device[strings + 1 + 40] = 255; /* the serial's, past the end too */
+    NGP_CHECK(DecodePatched(0, device, sizeof(device)) == -1);
+
+    /* a frame's mask promising an axis and extras that are not there */
+    static const uint8_t frame_axis[]   = { NGP_RecordTypeFrame, 0, 0, 0x01 };
+    static const uint8_t frame_extras[] = { NGP_RecordTypeFrame, 0, 0, 0x80, 0x07, 0, 0 };
+    NGP_CHECK(DecodePatched(1, frame_axis, sizeof(frame_axis)) == -1);
+    NGP_CHECK(DecodePatched(1, frame_extras, sizeof(frame_extras)) == -1);
+
+    /* any single byte of any value decodes without reading past the end */
+    for (size_t at = NGP_RECORDING_HEADER_SIZE; at < size; at++) {
+        for (int value = 0; value < 256; value += 15) {
+            memcpy(patched, buffer, size);
+            patched[at] = (uint8_t)value;
+            NGP_RecordingReader reader;
+            NGP_RecordingRecord record;
+            NGP_GamePadState    state;
+            memset(&state, 0, sizeof(state));
+            NGP_CHECK(NGP_RecordingReaderInit(&reader, patched, size));
+            while (NGP_RecordingNext(&reader, &record) > 0) {
+                NGP_RecordingDeviceInfo info;
+                if (record.type == NGP_RecordTypeDeviceAdded &&
+                    !NGP_RecordingReadDevice(&reader, &info)) {
+                    break;
+                }
+                if (record.type == NGP_RecordTypeFrame &&
+                    !NGP_RecordingReadFrame(&reader, &state)) {
+                    break;
+                }
+                NGP_CHECK(reader.data <= reader.end);
+            }
+            NGP_CHECK(reader.data >= patched && reader.data <= patched + size);
+        }
+    }
+}
+
+int main(void) {
+    Encode();
+    CheckRoundTrip();
+    CheckTruncated();
+    CheckCorrupt();
+    printf("%d records in %zu bytes round trip\n", count, size);
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include "NGP_Registry.h"
+#include "NGP_Test.h"
+
+static NGP_Registry registry;
+static int          items[NGP_REGISTRY_CAPACITY];
+
+/* Handles resolve until removed and never again after, even once their slot is reused */
+static void TestHandles(void) {
+    NGP_RegistryInit(&registry);
+    NGP_GamePadID a = NGP_RegistryInsert(&registry, &items[0]);
+    NGP_GamePadID b = NGP_RegistryInsert(&registry, &items[1]);
+    NGP_CHECK(a != NGP_INVALID_GAMEPAD_ID && b != NGP_INVALID_GAMEPAD_ID && a != b);
+    NGP_CHECK(a >= 0 && b >= 0);
+    NGP_CHECK(NGP_RegistryLookup(&registry, a) == &items[0]);
+    NGP_CHECK(NGP_RegistryLookup(&registry, b) == &items[1]);
+
+    NGP_CHECK(NGP_RegistryRemove(&registry, a) == &items[0]);
+    NGP_CHECK(NGP_RegistryLookup(&registry, a) == NULL);
+    NGP_CHECK(NGP_RegistryRemove(&registry, a) == NULL);
+
+    NGP_GamePadID c = NGP_RegistryInsert(&registry, &items[2]);
+    NGP_CHECK(NGP_RegistrySlot(c) == NGP_RegistrySlot(a)); /* the lowest free slot */
+    NGP_CHECK(c != a);
+    NGP_CHECK(NGP_RegistryLookup(&registry, a) == NULL);
+    NGP_CHECK(NGP_RegistryLookup(&registry, c) == &items[2]);
+
+    NGP_CHECK(NGP_RegistryLookup(&registry, NGP_INVALID_GAMEPAD_ID) == NULL);
+    NGP_CHECK(NGP_RegistryLookup(&registry, c | 0x10000) == NULL);
+}
+
+/* Indices stay dense, a removal only moves the pad at the last index into the hole */
+static void TestIndices(void) {
+    NGP_RegistryInit(&registry);
+    NGP_GamePadID ids[5];
+    for (int i = 0; i < 5; i++) {
+        ids[i] = NGP_RegistryInsert(&registry, &items[i]);
+        NGP_CHECK(NGP_RegistryAt(&registry, i) == ids[i]);
+    }
+    NGP_RegistryRemove(&registry, ids[1]);
+    NGP_CHECK(registry.count == 4);
+    NGP_CHECK(NGP_RegistryAt(&registry, 0) == ids[0]);
+    NGP_CHECK(NGP_RegistryAt(&registry, 1) == ids[4]);
+    NGP_CHECK(NGP_RegistryAt(&registry, 2) == ids[2]);
+    NGP_CHECK(NGP_RegistryAt(&registry, 3) == ids[3]);
+    NGP_CHECK(NGP_RegistryAt(&registry, 4) == NGP_INVALID_GAMEPAD_ID);
+    NGP_CHECK(NGP_RegistryAt(&registry, -1) == NGP_INVALID_GAMEPAD_ID);
+
+    NGP_RegistryRemove(&registry, ids[3]); /* the last index, nothing moves */
+    NGP_CHECK(NGP_RegistryAt(&registry, 1) == ids[4]);
+    NGP_CHECK(NGP_RegistryAt(&registry, 2) == ids[2]);
+
+    NGP_GamePadID again = NGP_RegistryInsert(&registry, &items[5]);
+    NGP_CHECK(NGP_RegistryAt(&registry, 3) == again);
+    for (int i = 0; i < registry.count; i++) {
+        NGP_CHECK(NGP_RegistryLookup(&registry, NGP_RegistryAt(&registry, i)) != NULL);
+    }
+}
+
+/* Every slot can be filled, emptied in any order and filled again */
+static void TestCapacity(void) {
+    static NGP_GamePadID ids[NGP_REGISTRY_CAPACITY];
+    NGP_RegistryInit(&registry);
+    for (int i = 0; i < NGP_REGISTRY_CAPACITY; i++) {
+        ids[i] = NGP_RegistryInsert(&registry, &items[i]);
+        NGP_CHECK(ids[i] != NGP_INVALID_GAMEPAD_ID);
+    }
+    NGP_CHECK(NGP_RegistryInsert(&registry, &items[0]) == NGP_INVALID_GAMEPAD_ID);
+    for (int i = 0; i < NGP_REGISTRY_CAPACITY; i += 2) {
+        NGP_CHECK(NGP_RegistryRemove(&registry, ids[i]) == &items[i]);
+    }
+    NGP_CHECK(registry.count == NGP_REGISTRY_CAPACITY / 2);
+    for (int i = 1; i < NGP_REGISTRY_CAPACITY; i += 2) {
+        NGP_CHECK(NGP_RegistryLookup(&registry, ids[i]) == &items[i]);
+    }
+    for (int i = 0; i < registry.count; i++) {
+        int slot = NGP_RegistrySlot(NGP_RegistryAt(&registry, i));
+        NGP_CHECK(slot % 2 == 1);
+    }
+    for (int i = NGP_REGISTRY_CAPACITY - 1; i > 0; i -= 2) {
+        NGP_CHECK(NGP_RegistryRemove(&registry, ids[i]) == &items[i]);
+    }
+    NGP_CHECK(registry.count == 0);
+    NGP_CHECK(NGP_RegistrySlot(NGP_RegistryInsert(&registry, &items[0])) == 0);
+}
+
+int main(void) {
+    TestHandles();
+    TestIndices();
+    TestCapacity();
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include <math.h>
+#include <string.h>
+
+#include "NGP_SonyReport.h"
+#include "NGP_Test.h"
+
+#define BUTTON(b) (1u << NGP_GamePadButton##b)
+
+/* Where the fields sit in each pad's state packet, see NGP_SonyReport.c */
+typedef struct Layout {
+    NGP_SonyModel model;
+    size_t        triggers; /* left, then right */
+    size_t        buttons;
+    size_t        gyro;
+    size_t        accel;
+    size_t        touch;
+    float         height; /* of the touchpad, both are 1920 wide */
+} Layout;
+
+static const Layout ds4 = { NGP_SonyModelDS4, 7, 4, 12, 18, 34, 920.0f };
+static const Layout ds5 = { NGP_SonyModelDS5, 4, 7, 15, 21, 32, 1070.0f };
+
+static bool Near(float a, float b) { return fabsf(a - b) < 1e-4f; }
+
+/* A full report with every field set to something recognisable */
+static void MakeReport(uint8_t* data, size_t size, uint8_t id, size_t header, const Layout* l) {
+    static const uint8_t sticks[]  = { 0x80, 0x7f, 0x20, 0xe0 };
+    static const uint8_t buttons[] = { 0x28, 0x31, 0x07 }; /* A, L1, Share, Options, PS, pad, mic */
+    static const uint8_t touch[]   = { 0x05, 0x34, 0x12, 0x20, 0x86 }; /* finger 5 down, 6 up */
+    memset(data, 0, size);
+    data[0] = id;
+    uint8_t* packet = data + header;
+    memcpy(packet, sticks, sizeof(sticks));
+    packet[l->triggers]     = 0x40;
+    packet[l->triggers + 1] = 0xff;
+    memcpy(packet + l->buttons, buttons, sizeof(buttons));
+    packet[l->gyro]      = 16;   /* one degree per second */
+    packet[l->accel + 5] = 0x20; /* 1 g on Z */
+    memcpy(packet + l->touch, touch, sizeof(touch));
+}
+
+static void CheckFull(const Layout* l, uint8_t id, size_t size, size_t header) {
+    uint8_t          data[128];
+    NGP_GamePadState state;
+    memset(&state, 0, sizeof(state));
+    MakeReport(data, size, id, header, l);
+    NGP_CHECK(NGP_SonyParseReport(l->model, data, size, &state));
+
+    NGP_CHECK(state.Axes[NGP_GamePadAxisTypeLeftX] == 128);
+    NGP_CHECK(state.Axes[NGP_GamePadAxisTypeLeftY] == -129);
+    NGP_CHECK(state.Axes[NGP_GamePadAxisTypeRightX] == -24544);
+    NGP_CHECK(state.Axes[NGP_GamePadAxisTypeRightY] == 24800);
+    NGP_CHECK(state.Axes[NGP_GamePadAxisTypeTriggerLeft] == 8224);
+    NGP_CHECK(state.Axes[NGP_GamePadAxisTypeTriggerRight] == 32767);
+
+    uint32_t buttons = BUTTON(A) | BUTTON(LeftShoulder) | BUTTON(Back) | BUTTON(Start) |
+                       BUTTON(Guide) | BUTTON(Touchpad);
+    /* the DS4 has no mic button, those bits count reports */
+    NGP_CHECK(state.Buttons == (l->model == NGP_SonyModelDS5 ? buttons | BUTTON(Misc1) : buttons));
+
+    NGP_CHECK(Near(state.Gyro[0], 0.017453292f) && state.Gyro[1] == 0.0f);
+    NGP_CHECK(Near(state.Accel[2], 9.80665f) && state.Accel[0] == 0.0f);
+
+    NGP_CHECK(state.Fingers[0].State && state.Fingers[0].ID == 5);
+    NGP_CHECK(Near(state.Fingers[0].X, 564 / 1920.0f));
+    NGP_CHECK(Near(state.Fingers[0].Y, 513 / l->height));
+    NGP_CHECK(state.Fingers[0].Pressure == 1.0f);
+    NGP_CHECK(!state.Fingers[1].State && state.Fingers[1].ID == 6);
+    NGP_CHECK(state.Fingers[1].Pressure == 0.0f);
+}
+
+/* Both pads send this one over Bluetooth until asked for full reports */
+static void CheckShort(NGP_SonyModel model) {
+    uint8_t          data[10] = { 0x01, 0x00, 0xff, 0x80, 0x80, 0x46, 0x02, 0xfc, 0x01, 0x00 };
+    NGP_GamePadState state;
+    memset(&state, 0, sizeof(state));
+    NGP_CHECK(NGP_SonyParseReport(model, data, sizeof(data), &state));
+    NGP_CHECK(state.Axes[NGP_GamePadAxisTypeLeftX] == -32768);
+    NGP_CHECK(state.Axes[NGP_GamePadAxisTypeLeftY] == 32767);
+    NGP_CHECK(state.Axes[NGP_GamePadAxisTypeTriggerLeft] == 128);
+    NGP_CHECK(state.Axes[NGP_GamePadAxisTypeTriggerRight] == 0);
+    /* hat 6 is west, and the report counter in the third byte is not the mic button */
+    NGP_CHECK(state.Buttons == (BUTTON(DPadLeft) | BUTTON(B) | BUTTON(RightShoulder)));
+}
+
+/* Unknown ids and every length too short for any layout leave the state alone */
+static void CheckRejected(void) {
+    uint8_t          data[128];
+    NGP_GamePadState state, before;
+    memset(&before, 0x5a, sizeof(before));
+
+    MakeReport(data, sizeof(data), 0x05, 1, &ds5);
+    state = before;
+    NGP_CHECK(!NGP_SonyParseReport(NGP_SonyModelDS5, data, sizeof(data), &state));
+    NGP_CHECK(!NGP_SonyParseReport(NGP_SonyModelNone, data, sizeof(data), &state));
+    NGP_CHECK(!NGP_SonyParseReport(NGP_SonyModelDS5, NULL, sizeof(data), &state));
+    data[0] = 0x31; /* DS5 Bluetooth, which the DS4 does not send */
+    NGP_CHECK(!NGP_SonyParseReport(NGP_SonyModelDS4, data, sizeof(data), &state));
+    NGP_CHECK(memcmp(&state, &before, sizeof(state)) == 0);
+
+    static const struct {
+        NGP_SonyModel model;
+        uint8_t       id;
+        size_t        shortest; /* the first length that parses */
+    } reports[] = {
+        { NGP_SonyModelDS4, 0x01, 10 },
+        { NGP_SonyModelDS4, 0x11, 45 },
+        { NGP_SonyModelDS5, 0x01, 10 },
+        { NGP_SonyModelDS5, 0x31, 42 },
+    };
+    for (size_t r = 0; r < sizeof(reports) / sizeof(reports[0]); r++) {
+        data[0] = reports[r].id;
+        for (size_t size = 0; size < reports[r].shortest; size++) {
+            NGP_CHECK(!NGP_SonyParseReport(reports[r].model, data, size, &state));
+        }
+        NGP_CHECK(memcmp(&state, &before, sizeof(state)) == 0);
+        NGP_CHECK(NGP_SonyParseReport(reports[r].model, data, reports[r].shortest, &state));
+        state = before;
+    }
+}
+
+int main(void) {
+    CheckFull(&ds4, 0x01, 64, 1);
+    CheckFull(&ds4, 0x11, 78, 3);
+    CheckFull(&ds5, 0x01, 64, 1);
+    CheckFull(&ds5, 0x31, 78, 2);
+    CheckFull(&ds4, 0x01, 43, 1); /* the shortest full reports */
+    CheckFull(&ds5, 0x31, 42, 2);
+    CheckShort(NGP_SonyModelDS4);
+    CheckShort(NGP_SonyModelDS5);
+    CheckRejected();
+    return 0;
+}
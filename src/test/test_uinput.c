@@ -0,0 +1,157 @@
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/uinput.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "NGP_GamePad.h"
+#include "NGP_Test.h"
+
+#define SKIP 77 /* SKIP_RETURN_CODE, see CMakeLists.txt */
+#define PAD_NAME "NGP uinput Test Pad"
+
+static int          fd = -1;
+static NGP_GamePad* gp;
+
+static bool Setup(int request, unsigned long code) { return ioctl(fd, request, code) >= 0; }
+
+static bool SetupAbs(uint16_t code, int32_t minimum, int32_t maximum) {
+    struct uinput_abs_setup abs;
+    memset(&abs, 0, sizeof(abs));
+    abs.code            = code;
+    abs.absinfo.minimum = minimum;
+    abs.absinfo.maximum = maximum;
+    return Setup(UI_SET_ABSBIT, code) && ioctl(fd, UI_ABS_SETUP, &abs) >= 0;
+}
+
+/* A pad the backend takes for a gamepad: BTN_GAMEPAD and both axes of the left stick */
+static bool CreatePad(void) {
+    struct uinput_setup setup;
+    memset(&setup, 0, sizeof(setup));
+    setup.id.bustype = BUS_USB;
+    setup.id.vendor  = 0x1234;
+    setup.id.product = 0x5678;
+    strcpy(setup.name, PAD_NAME);
+    return Setup(UI_SET_EVBIT, EV_KEY) && Setup(UI_SET_EVBIT, EV_ABS) &&
+           Setup(UI_SET_KEYBIT, BTN_SOUTH) && Setup(UI_SET_KEYBIT, BTN_EAST) &&
+           SetupAbs(ABS_X, -32768, 32767) && SetupAbs(ABS_Y, -32768, 32767) &&
+           SetupAbs(ABS_RZ, 0, 255) && ioctl(fd, UI_DEV_SETUP, &setup) >= 0 &&
+           ioctl(fd, UI_DEV_CREATE) >= 0;
+}
+
+static void Emit(uint16_t type, uint16_t code, int32_t value) {
+    struct input_event e;
+    memset(&e, 0, sizeof(e));
+    e.type  = type;
+    e.code  = code;
+    e.value = value;
+    NGP_CHECK(write(fd, &e, sizeof(e)) == (ssize_t)sizeof(e));
+}
+
+/* Whether the evdev node uinput made for the pad can be read, udev decides that */
+static bool NodeReadable(void) {
+    char sysname[64];
+    if (ioctl(fd, UI_GET_SYSNAME(sizeof(sysname)), sysname) < 0) {
+        return false;
+    }
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "/sys/devices/virtual/input/%s", sysname);
+    DIR* dir = opendir(path);
+    if (!dir) {
+        return false;
+    }
+    bool           readable = false;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, "event", 5) == 0) {
+            snprintf(path, sizeof(path), "/dev/input/%s", entry->d_name);
+            readable = access(path, R_OK) == 0;
+        }
+    }
+    closedir(dir);
+    return readable;
+}
+
+/* Opens the test pad once the backend has attached it */
+static bool FindPad(void) {
+    for (int i = 0; i < NGP_NumGamePads(); i++) {
+        NGP_GamePad* p    = NGP_GamePadOpen(i);
+        const char*  name = NGP_GamePadName(p);
+        if (name && strcmp(name, PAD_NAME) == 0) {
+            gp = p;
+            return true;
+        }
+        NGP_GamePadFree(p);
+    }
+    return false;
+}
+
+static bool LeftXIs12345(void) { return NGP_GamePadAxis(gp, NGP_GamePadAxisTypeLeftX) == 12345; }
+
+static bool AReleased(void) { return !NGP_GamePadButton(gp, NGP_GamePadButtonA); }
+
+static bool Detached(void) { return !NGP_GamePadIsAttached(gp); }
+
+/* Polls for up to five seconds, the I/O thread handles hot-plug and input on its own */
+static bool WaitFor(bool (*done)(void)) {
+    for (int i = 0; i < 5000; i++) {
+        if (done()) {
+            return true;
+        }
+        struct timespec ts = { 0, 1000000 };
+        nanosleep(&ts, NULL);
+    }
+    return done();
+}
+
+int main(void) {
+    fd = open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        printf("skipped, /dev/uinput: %s\n", strerror(errno));
+        return SKIP;
+    }
+    NGP_CHECK(NGP_Initialize());
+    NGP_CHECK(CreatePad());
+
+    /* attach, through the backend's hot-plug path since the library was already running */
+    if (!WaitFor(FindPad)) {
+        NGP_CHECK(!NodeReadable());
+        printf("skipped, the pad's evdev node is not readable\n");
+        NGP_Shutdown();
+        return SKIP;
+    }
+    NGP_CHECK(NGP_GamePadIsAttached(gp));
+    NGP_CHECK(NGP_GamePadAxis(gp, NGP_GamePadAxisTypeLeftX) == 0);
+    NGP_CHECK(!NGP_GamePadButton(gp, NGP_GamePadButtonA));
+
+    /* one report, every value lands at once and rescaled into the NGP range */
+    Emit(EV_ABS, ABS_Y, -20000);
+    Emit(EV_ABS, ABS_RZ, 255);
+    Emit(EV_KEY, BTN_SOUTH, 1);
+    Emit(EV_ABS, ABS_X, 12345);
+    Emit(EV_SYN, SYN_REPORT, 0);
+    NGP_CHECK(WaitFor(LeftXIs12345));
+    NGP_CHECK(NGP_GamePadAxis(gp, NGP_GamePadAxisTypeLeftY) == -20000);
+    NGP_CHECK(NGP_GamePadAxis(gp, NGP_GamePadAxisTypeTriggerRight) == 32767);
+    NGP_CHECK(NGP_GamePadButton(gp, NGP_GamePadButtonA));
+    NGP_CHECK(!NGP_GamePadButton(gp, NGP_GamePadButtonB));
+
+    Emit(EV_KEY, BTN_SOUTH, 0);
+    Emit(EV_SYN, SYN_REPORT, 0);
+    NGP_CHECK(WaitFor(AReleased));
+    NGP_CHECK(NGP_GamePadAxis(gp, NGP_GamePadAxisTypeLeftX) == 12345);
+
+    /* detach */
+    NGP_CHECK(ioctl(fd, UI_DEV_DESTROY) >= 0);
+    NGP_CHECK(WaitFor(Detached));
+    NGP_CHECK(NGP_GamePadAxis(gp, NGP_GamePadAxisTypeLeftX) == 0);
+
+    NGP_GamePadFree(gp);
+    NGP_Shutdown();
+    close(fd);
+    return 0;
+}